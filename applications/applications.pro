@@ -46,6 +46,7 @@ SUBDIRS += \
         mne_browse \
         mne_forward_solution \
         mne_matching_pursuit \
+        mne_mp_dict_builder \
         mne_sample_set_downloader
 
         qtHaveModule(charts) {
@@ -80,6 +80,11 @@ RawModel::RawModel(QObject *parent)
 , m_bReloadBefore(0)
 , m_iAbsFiffCursor(0)
 , m_iCurAbsScrollPos(0)
+, m_iPrefetchStart(0)
+, m_iTileRevision(0)
+, m_iPrefetchRevision(0)
+, m_iProcessingRevision(0)
+, m_iOperatorRevision(0)
 {
     m_iWindowSize = MODEL_WINDOW_SIZE;
     m_reloadPos = MODEL_RELOAD_POS;
@@ -97,6 +102,11 @@ RawModel::RawModel(QObject *parent)
         insertReloadedData(m_reloadFutureWatcher.future().result());
     });
 
+    //connect prefetching - this is done concurrently
+    connect(&m_prefetchFutureWatcher,&QFutureWatcher<QPair<MatrixXd,MatrixXd> >::finished,[this](){
+        insertPrefetchedData(m_prefetchFutureWatcher.future().result());
+    });
+
     //connect filtering reloading - this is done after a new block has been loaded
     connect(this,&RawModel::dataReloaded,[this](){
         if(!m_assignedOperators.empty())
@@ -127,6 +137,11 @@ RawModel::RawModel(QFile &qFile, QObject *parent)
 , m_pFiffInfo(new FiffInfo())
 , m_pfiffIO(QSharedPointer<FiffIO>(new FiffIO()))
 , m_filterChType("All")
+, m_iPrefetchStart(0)
+, m_iTileRevision(0)
+, m_iPrefetchRevision(0)
+, m_iProcessingRevision(0)
+, m_iOperatorRevision(0)
 {
     m_iWindowSize = MODEL_WINDOW_SIZE;
     m_reloadPos = MODEL_RELOAD_POS;
@@ -144,6 +159,11 @@ RawModel::RawModel(QFile &qFile, QObject *parent)
         insertReloadedData(m_reloadFutureWatcher.future().result());
     });
 
+    //connect prefetching - this is done concurrently
+    connect(&m_prefetchFutureWatcher,&QFutureWatcher<QPair<MatrixXd,MatrixXd> >::finished,[this](){
+        insertPrefetchedData(m_prefetchFutureWatcher.future().result());
+    });
+
     connect(this,&RawModel::dataReloaded,[this](){
         if(!m_assignedOperators.empty())
             updateOperatorsConcurrently();
@@ -205,7 +225,7 @@ QVariant RawModel::data(const QModelIndex &index, int role) const
 
                 for(qint16 i=0; i < m_data.size(); ++i) {
                     //if channel is not filtered or background Processing pending...
-                    if(!m_assignedOperators.contains(index.row()) || (m_bProcessing && m_bReloadBefore && i==0) || (m_bProcessing && !m_bReloadBefore && i==m_data.size()-1)) {
+                    if(useRawData(index.row(), i)) {
                         rowVectorPair.first = m_data[i]->dataRaw().data() + index.row()*m_data[i]->dataRaw().cols();
                         rowVectorPair.second  = m_data[i]->dataRaw().cols();
                     }
@@ -273,6 +293,15 @@ QVariant RawModel::data(const QModelIndex &index, int role) const
 }
 
 
+//*************************************************************************************************************
+
+bool RawModel::useRawData(int row, int windowIndex) const
+{
+    //if channel is not filtered or background Processing pending...
+    return !m_assignedOperators.contains(row) || (m_bProcessing && m_bReloadBefore && windowIndex==0) || (m_bProcessing && !m_bReloadBefore && windowIndex==m_data.size()-1);
+}
+
+
 //*************************************************************************************************************
 
 QVariant RawModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -496,15 +525,20 @@ void RawModel::loadFiffInfos()
 
 void RawModel::clearModel()
 {
+    //wait for a pending prefetch since it reads from the FiffIO object
+    m_prefetchFutureWatcher.waitForFinished();
+
     //FiffIO object
     m_pfiffIO.clear();
     m_chInfolist.clear();
 
     //data model structure
     m_data.clear();
+    invalidateTiles();
 
     //MNEOperators
     m_assignedOperators.clear();
+    m_iOperatorRevision++;
 
     //View parameters
     m_iAbsFiffCursor = 0;
@@ -536,32 +570,42 @@ void RawModel::resetPosition(qint32 position)
 
     m_iAbsFiffCursor = firstSample() + mult*m_iWindowSize;
 
-    MatrixXd t_data,t_times; //type is later on (when append to m_data) casted into MatrixXdR (Row-Major)
-
     int start = m_iAbsFiffCursor;
     int end = start + m_iWindowSize - 1;
 
-    m_Mutex.lock();
-    if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(t_data, t_times, start, end))
-        qDebug() << "RawModel: Error resetting position of Fiff file!";
-    m_Mutex.unlock();
+    //take block from the tile cache if it was loaded before, otherwise read it from file
+    QSharedPointer<DataPackage> newDataPackage = m_tileCache.take(start);
 
-    //build data package
-    QSharedPointer<DataPackage> newDataPackage;
-    newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)t_data, (MatrixXdR)t_times));
+    if(newDataPackage.isNull()) {
+        MatrixXd t_data,t_times; //type is later on (when append to m_data) casted into MatrixXdR (Row-Major)
+
+        m_Mutex.lock();
+        if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(t_data, t_times, start, end))
+            qDebug() << "RawModel: Error resetting position of Fiff file!";
+        m_Mutex.unlock();
+
+        //build data package
+        newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)t_data, (MatrixXdR)t_times));
+    }
 
     //append loaded block
     m_data.append(newDataPackage);
 
-    if(!m_assignedOperators.empty())
-        updateOperators();
+    //process block if it was not processed with the current operators yet
+    if(!m_assignedOperators.empty() && newDataPackage->procRevision() != m_iOperatorRevision) {
+        m_bProcessing = true;
+        updateOperatorsConcurrently(0);
+        m_bProcessing = false;
+    }
 
     endResetModel();
 
+    prefetchTiles();
+
 //    if(!(m_iAbsFiffCursor<=firstSample()))
 //        updateScrollPos(m_iCurAbsScrollPos-firstSample()); //little hack: if the m_iCurAbsScrollPos is now close to the edge -> force reloading w/o scrolling
 
-    qDebug() << "RawModel: Model Position RESET, samples from " << m_iAbsFiffCursor << "to" << m_iAbsFiffCursor+m_iWindowSize-1 << "reloaded. actual loaded t_data cols: " << t_data.cols();
+    qDebug() << "RawModel: Model Position RESET, samples from " << m_iAbsFiffCursor << "to" << m_iAbsFiffCursor+m_iWindowSize-1 << "reloaded. actual loaded data cols: " << newDataPackage->dataRaw().cols();
 
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size(),1));
 }
@@ -609,6 +653,12 @@ void RawModel::reloadFiffData(bool before)
 
     m_bReloading = true;
 
+    //take data from the tile cache if it was loaded or prefetched before
+    if(m_tileCache.contains(start)) {
+        insertDataPackage(m_tileCache.take(start));
+        return;
+    }
+
     //read data with respect to start and end point
     QFuture<QPair<MatrixXd,MatrixXd> > future = QtConcurrent::run(this,&RawModel::readSegment,start,end);
 
@@ -629,6 +679,7 @@ QPair<MatrixXd,MatrixXd> RawModel::readSegment(fiff_int_t from, fiff_int_t to)
     m_Mutex.lock();
     if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(datatime.first, datatime.second, from, to)) {
         printf("RawModel: Error when reading raw data!");
+        m_Mutex.unlock();
         return datatime;
     }
     m_Mutex.unlock();
@@ -647,6 +698,7 @@ void RawModel::updateScrollPos(int value)
     //if a scroll position is selected, which is not within the loaded data range -> reset position of model
     if(m_iCurAbsScrollPos > (m_iAbsFiffCursor+sizeOfPreloadedData()+m_iWindowSize) || m_iCurAbsScrollPos < m_iAbsFiffCursor) {
         qDebug() << "RawModel: Reset position requested, m_iAbsFiffCursor:" << m_iAbsFiffCursor << "m_iCurAbsScrollPos:" << m_iCurAbsScrollPos;
+        cacheLoadedWindows();
         resetPosition(m_iCurAbsScrollPos);
         return;
     }
@@ -716,6 +768,7 @@ void RawModel::applyOperator(QModelIndexList chlist, const QSharedPointer<MNEOpe
     }
 
     m_bProcessing = true;
+    m_iOperatorRevision++;
 
     for(int i=0; i<m_data.size(); i++)
         updateOperatorsConcurrently(i);
@@ -754,6 +807,7 @@ void RawModel::applyOperator(QModelIndexList chlist, const QSharedPointer<MNEOpe
     }
 
     m_bProcessing = true;
+    m_iOperatorRevision++;
 
     for(int i=0; i<m_data.size(); i++)
         updateOperatorsConcurrently(i);
@@ -805,6 +859,7 @@ void RawModel::updateOperators(QModelIndex chan)
     }
 
     m_bProcessing = true;
+    m_iOperatorRevision++;
 
     for(int i=0; i<m_data.size(); i++)
         updateOperatorsConcurrently(i);
@@ -833,6 +888,7 @@ void RawModel::updateOperators(QModelIndexList chlist)
     }
 
     m_bProcessing = true;
+    m_iOperatorRevision++;
 
     for(int i=0; i<m_data.size(); i++)
         updateOperatorsConcurrently(i);
@@ -890,6 +946,8 @@ void RawModel::undoFilter(QModelIndexList chlist)
         qDebug() << "RawModel: All filter operator removed of type for channel" << chlist[i].row();
     }
 
+    m_iOperatorRevision++;
+
     emit assignedOperatorsChanged(m_assignedOperators);
 }
 
@@ -905,6 +963,8 @@ void RawModel::undoFilter(const QString &chType)
         for(qint32 i=0; i < m_chInfolist.size(); ++i)
             if(m_chInfolist.at(i).ch_name.contains(chType))
                 m_assignedOperators.remove(i);
+
+        m_iOperatorRevision++;
     }
 
     emit assignedOperatorsChanged(m_assignedOperators);
@@ -916,6 +976,7 @@ void RawModel::undoFilter(const QString &chType)
 void RawModel::undoFilter()
 {
     m_assignedOperators.clear();
+    m_iOperatorRevision++;
 
     emit assignedOperatorsChanged(m_assignedOperators);
 }
@@ -975,6 +1036,9 @@ void RawModel::updateProjections()
             m_pfiffIO->m_qlistRaw[0]->proj.resize(0,0);
         }
 
+        //cached tiles were read with the old projector
+        invalidateTiles();
+
         if(m_iCurAbsScrollPos == 0)
             resetPosition(m_iCurAbsScrollPos + firstSample());
         else
@@ -1008,6 +1072,9 @@ void RawModel::updateCompensator(int to)
         //set compensator for upcoming read raw segement calls
         m_pfiffIO->m_qlistRaw[0]->comp = newComp;
 
+        //cached tiles were read with the old compensator
+        invalidateTiles();
+
         if(m_iCurAbsScrollPos == 0)
             resetPosition(m_iCurAbsScrollPos + firstSample());
         else
@@ -1020,23 +1087,48 @@ void RawModel::updateCompensator(int to)
 //private SLOTS
 void RawModel::insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
 {
-    QSharedPointer<DataPackage> newDataPackage = QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)dataTimesPair.first, (MatrixXdR)dataTimesPair.second));
+    insertDataPackage(QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)dataTimesPair.first, (MatrixXdR)dataTimesPair.second)));
+
+    if(dataTimesPair.second.cols() > 0)
+        qDebug() << "RawModel: Fiff data Reloaded from " << dataTimesPair.second.coeff(0) << "secs to" << dataTimesPair.second.coeff(dataTimesPair.second.cols()-1) << "secs";
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::insertPrefetchedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
+{
+    //drop data which was read before the tiles were invalidated
+    if(m_iPrefetchRevision != m_iTileRevision || dataTimesPair.first.cols() == 0)
+        return;
+
+    m_tileCache.insert(m_iPrefetchStart, QSharedPointer<DataPackage>(new DataPackage((MatrixXdR)dataTimesPair.first, (MatrixXdR)dataTimesPair.second)));
 
+    qDebug() << "RawModel: Prefetched samples from" << m_iPrefetchStart << "to" << m_iPrefetchStart+dataTimesPair.first.cols()-1 << ", cached tiles:" << m_tileCache.size();
+
+    prefetchTiles();
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::insertDataPackage(QSharedPointer<DataPackage> dataPackage)
+{
     //extend m_data with reloaded data
     if(m_bReloadBefore) {
-        m_data.prepend(newDataPackage);
+        m_data.prepend(dataPackage);
 
-        //maintain at maximum m_maxWindows data windows and drop the rest
+        //maintain at maximum m_maxWindows data windows and move the rest to the tile cache
         if(m_data.size() > m_maxWindows) {
-            m_data.removeLast();
+            m_tileCache.insert(m_iAbsFiffCursor + (m_data.size()-1)*m_iWindowSize, m_data.takeLast());
         }
     }
     else {
-        m_data.append(newDataPackage);
+        m_data.append(dataPackage);
 
-        //maintain at maximum m_maxWindows data windows and drop the rest
+        //maintain at maximum m_maxWindows data windows and move the rest to the tile cache
         if(m_data.size() > m_maxWindows) {
-            m_data.removeFirst();
+            m_tileCache.insert(m_iAbsFiffCursor, m_data.takeFirst());
             m_iAbsFiffCursor += m_iWindowSize;
         }
     }
@@ -1046,7 +1138,57 @@ void RawModel::insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size()-1,1));
     emit dataReloaded();
 
-    qDebug() << "RawModel: Fiff data Reloaded from " << dataTimesPair.second.coeff(0) << "secs to" << dataTimesPair.second.coeff(dataTimesPair.second.cols()-1) << "secs";
+    prefetchTiles();
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::cacheLoadedWindows()
+{
+    for(int i = 0; i < m_data.size(); ++i)
+        m_tileCache.insert(m_iAbsFiffCursor + i*m_iWindowSize, m_data[i]);
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::invalidateTiles()
+{
+    m_tileCache.clear();
+    m_iTileRevision++;
+}
+
+
+//*************************************************************************************************************
+
+void RawModel::prefetchTiles()
+{
+    if(m_pfiffIO.isNull() || m_pfiffIO->m_qlistRaw.empty() || m_prefetchFutureWatcher.isRunning())
+        return;
+
+    //prefetch the next windows in scroll direction which are neither loaded nor cached
+    for(int i = 0; i < MODEL_PREFETCH_TILES; ++i) {
+        fiff_int_t start = m_bReloadBefore ? m_iAbsFiffCursor - (i+1)*m_iWindowSize : m_iAbsFiffCursor + sizeOfPreloadedData() + i*m_iWindowSize;
+        fiff_int_t end = start + m_iWindowSize - 1;
+
+        if(start < firstSample() || start > lastSample())
+            return;
+
+        if(m_tileCache.contains(start))
+            continue;
+
+        if(end > lastSample())
+            end = lastSample();
+
+        m_iPrefetchStart = start;
+        m_iPrefetchRevision = m_iTileRevision;
+
+        QFuture<QPair<MatrixXd,MatrixXd> > future = QtConcurrent::run(this,&RawModel::readSegment,start,end);
+        m_prefetchFutureWatcher.setFuture(future);
+
+        return;
+    }
 }
 
 
@@ -1054,18 +1196,28 @@ void RawModel::insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair)
 
 void RawModel::updateOperatorsConcurrently()
 {
+    if(m_data.empty())
+        return;
+
+    QSharedPointer<DataPackage> dataPackage = m_bReloadBefore ? m_data.first() : m_data.last();
+
+    //windows from the tile cache were already processed with the current operators
+    if(dataPackage->procRevision() == m_iOperatorRevision) {
+        performOverlapAdd();
+        emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size()-1,1));
+        return;
+    }
+
     m_bProcessing = true;
+    m_pProcessingPackage = dataPackage;
+    m_iProcessingRevision = m_iOperatorRevision;
 
     QList<int> listFilteredChs = m_assignedOperators.keys();
     m_listTmpChData.clear();
 
     //get the rows which are to be filtered out of the m_data matrix. Note that this is done windows wise, hence jumps in the filtered signal might be visible
-    for(qint32 i=0; i < listFilteredChs.size(); ++i) {
-        if(m_bReloadBefore)
-            m_listTmpChData.append(QPair<int,RowVectorXd>(listFilteredChs[i],m_data.first()->dataRawOrig().row(listFilteredChs[i])));
-        else
-            m_listTmpChData.append(QPair<int,RowVectorXd>(listFilteredChs[i],m_data.last()->dataRawOrig().row(listFilteredChs[i])));
-    }
+    for(qint32 i=0; i < listFilteredChs.size(); ++i)
+        m_listTmpChData.append(QPair<int,RowVectorXd>(listFilteredChs[i],dataPackage->dataRawOrig().row(listFilteredChs[i])));
 
     qDebug() << "RawModel: Starting of concurrent PROCESSING operation of" << listFilteredChs.size() << "items";
 
@@ -1188,6 +1340,8 @@ void RawModel::insertProcessedDataAll(int windowIndex)
     for(int i=0; i < listFilteredChs.size(); ++i)
         m_data[windowIndex]->setOrigProcData(m_listTmpChData[i].second, listFilteredChs[i], cutFront, cutBack);
 
+    m_data[windowIndex]->setProcRevision(m_iOperatorRevision);
+
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size(),1));
 
     qDebug() << "RawModel: Finished inserting" << listFilteredChs.size() << "channels in window "<<windowIndex;
@@ -1198,30 +1352,28 @@ void RawModel::insertProcessedDataAll(int windowIndex)
 
 void RawModel::insertProcessedDataAll()
 {
-    QList<int> listFilteredChs = m_assignedOperators.keys();
+    if(m_pProcessingPackage.isNull() || m_listTmpChData.isEmpty()) {
+        m_bProcessing = false;
+        return;
+    }
 
-    int dataLength = m_iWindowSize;
-    if(m_bReloadBefore)
-        dataLength = m_data.first()->dataRaw().cols();
-    else
-        dataLength = m_data.last()->dataRaw().cols();
+    int dataLength = m_pProcessingPackage->dataRaw().cols();
 
     int cutFront = m_iCurrentFFTLength/4;
     int cutBack = m_iCurrentFFTLength/4 + (m_listTmpChData[0].second.cols()-m_iCurrentFFTLength/2-dataLength);
 
-    //Set and cut original data to window size and calculate mean for filtered data
-    for(int i=0; i < listFilteredChs.size(); ++i) {
-        if(m_bReloadBefore)
-            m_data.first()->setOrigProcData(m_listTmpChData[i].second, listFilteredChs[i], cutFront, cutBack);
-        else
-            m_data.last()->setOrigProcData(m_listTmpChData[i].second, listFilteredChs[i], cutFront, cutBack);
-    }
+    //Set and cut original data to window size and calculate mean for filtered data. The processed window might have been moved to the tile cache meanwhile.
+    for(int i=0; i < m_listTmpChData.size(); ++i)
+        m_pProcessingPackage->setOrigProcData(m_listTmpChData[i].second, m_listTmpChData[i].first, cutFront, cutBack);
+
+    m_pProcessingPackage->setProcRevision(m_iProcessingRevision);
+    m_pProcessingPackage.clear();
 
     performOverlapAdd();
 
     emit dataChanged(createIndex(0,1),createIndex(m_chInfolist.size(),1));
 
-    qDebug() << "RawModel: Finished inserting" << listFilteredChs.size() << "channels.";
+    qDebug() << "RawModel: Finished inserting" << m_listTmpChData.size() << "channels.";
     m_bProcessing = false;
 }
 
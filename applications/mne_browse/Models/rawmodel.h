@@ -47,6 +47,8 @@
 *           block is to be loaded, the first or last block (depending on whether the user scrolls to the right or left edge)
 *           is removed from m_data, pretty much like a circular buffer. The logic of the reloading is managed by the
 *           slot updateScrollPos, which obtains the value from the horizontal QScrollBar being part of the connected TableView.
+*           Removed blocks are kept in a LRU tile cache (m_tileCache) together with their processed data, so that scrolling
+*           back does not reread or refilter them. The next block in scroll direction is prefetched into the tile cache.
 *
 *           In order to not freeze the GUI when reloading new data or filtering data, the RawModel class makes heavy use
 *           of the QtConcurrent features. [2]
@@ -75,6 +77,7 @@
 #include "../Utils/filteroperator.h"
 #include "../Utils/rawsettings.h"
 #include "../Utils/datapackage.h"
+#include "../Utils/tilecache.h"
 
 
 //*************************************************************************************************************
@@ -187,6 +190,16 @@ public:
     QMap<QString,QSharedPointer<MNEOperator> >  m_Operators;    /**< generated MNEOperator types (FilterOperator,PCA etc.) */
 
 private:
+    //=========================================================================================================
+    /**
+    * useRawData checks whether the raw or the processed data is to be displayed for a channel and window.
+    *
+    * @param row the channel row
+    * @param windowIndex the window index
+    * @return true if the raw data is to be displayed
+    */
+    bool useRawData(int row, int windowIndex) const;
+
     //=========================================================================================================
     /**
     * genStdFilters generates a set of standard FilterOperators
@@ -232,6 +245,33 @@ private:
     */
     QPair<MatrixXd,MatrixXd> readSegment(fiff_int_t from, fiff_int_t to);
 
+    //=========================================================================================================
+    /**
+    * insertDataPackage inserts a loaded data window in front or at the back of m_data (depending on m_bReloadBefore)
+    * and moves the dropped window to the tile cache.
+    *
+    * @param dataPackage the data window to insert
+    */
+    void insertDataPackage(QSharedPointer<DataPackage> dataPackage);
+
+    //=========================================================================================================
+    /**
+    * cacheLoadedWindows moves all windows of m_data to the tile cache, i.e. before the position is reset.
+    */
+    void cacheLoadedWindows();
+
+    //=========================================================================================================
+    /**
+    * invalidateTiles drops all cached and prefetched tiles, i.e. when the projectors or compensators changed.
+    */
+    void invalidateTiles();
+
+    //=========================================================================================================
+    /**
+    * prefetchTiles reads the next not yet cached windows in scroll direction in a background-thread.
+    */
+    void prefetchTiles();
+
     //VARIABLES
     //Reload control
     bool                                    m_bStartReached;            /**< signals, whether the start of the fiff data file is reached. */
@@ -242,11 +282,20 @@ private:
     QFutureWatcher<QPair<MatrixXd,MatrixXd> > m_reloadFutureWatcher;    /**< QFutureWatcher for watching process of reloading fiff data. */
     bool                                    m_bReloading;               /**< signals when the reloading is ongoing. */
 
+    //Tile cache and prefetching
+    TileCache                               m_tileCache;                /**< LRU cache of already loaded windows which are not part of m_data anymore. */
+    QFutureWatcher<QPair<MatrixXd,MatrixXd> > m_prefetchFutureWatcher;  /**< QFutureWatcher for watching process of prefetching fiff data. */
+    qint32                                  m_iPrefetchStart;           /**< The first sample of the window which is currently prefetched. */
+    int                                     m_iTileRevision;            /**< Incremented whenever the cached tiles become invalid, i.e. new projectors. */
+    int                                     m_iPrefetchRevision;        /**< The tile revision the currently prefetched window was requested with. */
+
     //Concurrent processing
 //    QFutureWatcher<QPair<int,RowVectorXd> > m_operatorFutureWatcher; /**< QFutureWatcher for watching process of applying Operators to reloaded fiff data. */
     QFutureWatcher<void>                    m_operatorFutureWatcher;    /**< QFutureWatcher for watching process of applying Operators to reloaded fiff data. */
     QList<QPair<int,RowVectorXd> >          m_listTmpChData;            /**< contains pairs with a channel number and the corresponding RowVectorXd. */
     bool                                    m_bProcessing;              /**< true when processing in a background-thread is ongoing.*/
+    QSharedPointer<DataPackage>             m_pProcessingPackage;       /**< The data window which is processed in the background-thread. */
+    int                                     m_iProcessingRevision;      /**< The operator revision which is used by the background processing. */
     QString                                 m_filterChType;
 
     QMutex                                  m_Mutex;                    /**< mutex for locking against simultaenous access to shared objects >. */
@@ -256,6 +305,7 @@ private:
 
     //Filter operators
     QMap<int,QSharedPointer<MNEOperator> >  m_assignedOperators;        /**< Map of MNEOperator types to channels.*/
+    int                                     m_iOperatorRevision;        /**< Incremented whenever m_assignedOperators changes, used to lazily reprocess cached windows. */
 
     qint32                                  m_iAbsFiffCursor;           /**< Cursor that points to the current position in the fiff data file [in samples]. */
     qint32                                  m_iCurAbsScrollPos;         /**< the current (absolute) ScrollPosition in the fiff data file. */
@@ -413,6 +463,14 @@ private slots:
     */
     void insertReloadedData(QPair<MatrixXd,MatrixXd> dataTimesPair);
 
+    //=========================================================================================================
+    /**
+    * insertPrefetchedData inserts the prefetched data into the tile cache when the background has finished the operation
+    *
+    * @param dataTimesPair contains the prefetched matrices of the data and times
+    */
+    void insertPrefetchedData(QPair<MatrixXd,MatrixXd> dataTimesPair);
+
     //=========================================================================================================
     /**
     * updateOperatorsConcurrently runs the processing of the MNEOperators in a background-thread
@@ -60,6 +60,7 @@ DataPackage::DataPackage(const MatrixXdR &originalRawData, const MatrixXdR &orig
 , m_iCutBackRaw(cutBack)
 , m_iCutFrontProc(cutFront)
 , m_iCutBackProc(cutBack)
+, m_iProcRevision(-1)
 {
     if(originalRawData.rows() != 0 && originalRawData.cols() != 0) {
         setOrigRawData(originalRawData, m_iCutFrontRaw, m_iCutBackRaw);
@@ -269,6 +270,22 @@ double DataPackage::dataRawMean(int row)
 }
 
 
+//*************************************************************************************************************
+
+void DataPackage::setProcRevision(int revision)
+{
+    m_iProcRevision = revision;
+}
+
+
+//*************************************************************************************************************
+
+int DataPackage::procRevision() const
+{
+    return m_iProcRevision;
+}
+
+
 //*************************************************************************************************************
 
 void DataPackage::applyFFTFilter(int channelNumber, QSharedPointer<FilterOperator> filter, bool useRawData)
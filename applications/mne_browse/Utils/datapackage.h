@@ -213,6 +213,22 @@ public:
     */
     double dataRawMean(int row);
 
+    //=========================================================================================================
+    /**
+    * Sets the revision of the assigned operators which the processed data was calculated with.
+    *
+    * @param revision the operator revision
+    */
+    void setProcRevision(int revision);
+
+    //=========================================================================================================
+    /**
+    * Returns the revision of the assigned operators which the processed data was calculated with. -1 if the data was not processed yet.
+    *
+    * @return the operator revision
+    */
+    int procRevision() const;
+
     //=========================================================================================================
     /**
     * FilterOperator::FilterOperator
@@ -282,6 +298,8 @@ private:
     int m_iCutBackRaw;                  /**< The last used cut back value of the raw data*/
     int m_iCutFrontProc;                /**< The last used cut front value of the raw data */
     int m_iCutBackProc;                 /**< The last used cut back value of the raw data*/
+
+    int m_iProcRevision;                /**< The revision of the assigned operators the processed data was calculated with */
 };
 
 } // NAMESPACE
@@ -0,0 +1,130 @@
+//=============================================================================================================
+/**
+* @file     tilecache.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the TileCache class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "tilecache.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBROWSE;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+TileCache::TileCache(int maxTiles)
+: m_iMaxTiles(maxTiles < 0 ? 0 : maxTiles)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TileCache::setMaxTiles(int maxTiles)
+{
+    m_iMaxTiles = maxTiles < 0 ? 0 : maxTiles;
+
+    evict();
+}
+
+
+//*************************************************************************************************************
+
+bool TileCache::contains(qint32 startSample) const
+{
+    return m_qMapTiles.contains(startSample);
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<DataPackage> TileCache::take(qint32 startSample)
+{
+    m_qListUsage.removeOne(startSample);
+
+    return m_qMapTiles.take(startSample);
+}
+
+
+//*************************************************************************************************************
+
+void TileCache::insert(qint32 startSample, const QSharedPointer<DataPackage> &tile)
+{
+    if(tile.isNull())
+        return;
+
+    m_qListUsage.removeOne(startSample);
+    m_qListUsage.prepend(startSample);
+
+    m_qMapTiles.insert(startSample, tile);
+
+    evict();
+}
+
+
+//*************************************************************************************************************
+
+void TileCache::clear()
+{
+    m_qMapTiles.clear();
+    m_qListUsage.clear();
+}
+
+
+//*************************************************************************************************************
+
+int TileCache::size() const
+{
+    return m_qMapTiles.size();
+}
+
+
+//*************************************************************************************************************
+
+void TileCache::evict()
+{
+    while(m_qListUsage.size() > m_iMaxTiles)
+        m_qMapTiles.remove(m_qListUsage.takeLast());
+}
@@ -0,0 +1,150 @@
+//=============================================================================================================
+/**
+* @file     tilecache.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the TileCache class.
+*
+*/
+
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "datapackage.h"
+#include "rawsettings.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMap>
+#include <QList>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEBROWSE
+//=============================================================================================================
+
+namespace MNEBROWSE
+{
+
+
+//=============================================================================================================
+/**
+* TileCache...
+*
+* @brief The TileCache class keeps a bounded number of already loaded data tiles, i.e. DataPackages of one window
+*        length which start at a multiple of the window size, with a least recently used policy. This way scrolling
+*        back and forth does not reread and refilter data which was already loaded, while the memory stays constant.
+*/
+class TileCache
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a TileCache.
+    *
+    * @param maxTiles the maximum number of tiles which are kept in the cache
+    */
+    TileCache(int maxTiles = MODEL_MAX_CACHED_TILES);
+
+    //=========================================================================================================
+    /**
+    * Sets the maximum number of tiles and drops the least recently used tiles if necessary.
+    *
+    * @param maxTiles the maximum number of tiles which are kept in the cache
+    */
+    void setMaxTiles(int maxTiles);
+
+    //=========================================================================================================
+    /**
+    * Returns whether a tile starting at the given sample is cached.
+    *
+    * @param startSample the first sample of the tile
+    * @return true if the tile is cached
+    */
+    bool contains(qint32 startSample) const;
+
+    //=========================================================================================================
+    /**
+    * Removes a tile from the cache and returns it. Returns a null pointer if the tile is not cached.
+    *
+    * @param startSample the first sample of the tile
+    * @return the cached tile
+    */
+    QSharedPointer<DataPackage> take(qint32 startSample);
+
+    //=========================================================================================================
+    /**
+    * Inserts a tile as most recently used tile. If the maximum number of tiles is exceeded the least
+    * recently used tile is dropped.
+    *
+    * @param startSample the first sample of the tile
+    * @param tile the tile
+    */
+    void insert(qint32 startSample, const QSharedPointer<DataPackage> &tile);
+
+    //=========================================================================================================
+    /**
+    * Drops all cached tiles, i.e. when the projectors or compensators changed.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of cached tiles.
+    *
+    * @return the number of cached tiles
+    */
+    int size() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Drops the least recently used tiles until the maximum number of tiles is met.
+    */
+    void evict();
+
+    QMap<qint32,QSharedPointer<DataPackage> >   m_qMapTiles;        /**< The cached tiles mapped to their first sample. */
+    QList<qint32>                               m_qListUsage;       /**< The first samples of the cached tiles, most recently used first. */
+    int                                         m_iMaxTiles;        /**< The maximum number of cached tiles. */
+};
+
+} // NAMESPACE
+
+#endif // TILECACHE_H
@@ -100,6 +100,7 @@ SOURCES += \
     Windows/scalewindow.cpp \
     Windows/chinfowindow.cpp \
     Utils/datapackage.cpp \    
+    Utils/tilecache.cpp \
     Windows/noisereductionwindow.cpp
 
 HEADERS += \
@@ -128,6 +129,7 @@ HEADERS += \
     Windows/chinfowindow.h \
     Windows/noisereductionwindow.h \
     Utils/datapackage.h \
+    Utils/tilecache.h \
 
 FORMS += \
     Windows/eventwindowdock.ui \
@@ -1974,7 +1974,7 @@ void XAxisAtomWindow::paint_axis(MatrixXd atom_matrix, QSize window_size)
 void EditorWindow::on_li_all_dicts_itemSelectionChanged()
 {
     FixDictMp *fix_mp = new FixDictMp();
-    QList<Dictionary> dicts = fix_mp->parse_xml_dict(QString(QDir::homePath() + "/Matching-Pursuit-Toolbox/%1").arg( ui->li_all_dicts->selectedItems().at(0)->toolTip()));
+    QList<Dictionary> dicts = fix_mp->parse_dict(QString(QDir::homePath() + "/Matching-Pursuit-Toolbox/%1").arg( ui->li_all_dicts->selectedItems().at(0)->toolTip()));
 
     current_dict.clear();
     for(qint32 i = 0; i < dicts.length(); i++)
@@ -855,11 +855,14 @@ void MainWindow::fill_dict_combobox()
     QDir dir(QDir::homePath() + "/" + "Matching-Pursuit-Toolbox");
     QStringList filterList;
     filterList.append("*.dict");
+    filterList.append("*.bdict");
     QFileInfoList fileList =  dir.entryInfoList(filterList);
 
+    //binary dictionaries are loaded through the path of the XML dictionary, so each name is listed once
     ui->cb_Dicts->clear();
     for(int i = 0; i < fileList.length(); i++)
-        ui->cb_Dicts->addItem(QIcon(":/images/icons/DictIcon.png"), fileList.at(i).baseName());
+        if(ui->cb_Dicts->findText(fileList.at(i).baseName()) < 0)
+            ui->cb_Dicts->addItem(QIcon(":/images/icons/DictIcon.png"), fileList.at(i).baseName());
 
     //dis-/enable button calc, if dicts are existing
     if(ui->cb_Dicts->itemText(0) == "" && ui->rb_OwnDictionary->isChecked())
@@ -0,0 +1,200 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implements the mne_mp_dict_builder application, which builds binary matching pursuit dictionaries.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/mp/atom.h>
+#include <utils/mp/fixdictmp.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Builds a Gabor dictionary centered in a window of sample_count samples. The scales are the powers of two below
+* sample_count and sample_count itself, the modulations are spread evenly up to the Nyquist frequency and the
+* phases evenly over [0, pi).
+*
+* @param [in] name              name of the dictionary, stored as its source.
+* @param [in] sample_count      number of samples of the atoms.
+* @param [in] modulation_count  number of modulations per scale.
+* @param [in] phase_count       number of phases per modulation.
+*
+* @return the dictionary.
+*/
+Dictionary build_gabor_dict(const QString &name, qint32 sample_count, qint32 modulation_count, qint32 phase_count)
+{
+    Dictionary dict;
+    dict.type = GABORATOM;
+    dict.source = name;
+    dict.atom_formula = QString("Gaboratom");
+    dict.sample_count = sample_count;
+
+    QList<qreal> scales;
+    for(qint32 scale = 2; scale < sample_count; scale *= 2)
+        scales.append(scale);
+    scales.append(sample_count);
+
+    GaborAtom gabor_atom;
+    qint32 id = 0;
+
+    for(qint32 s = 0; s < scales.length(); s++)
+    {
+        for(qint32 m = 0; m < modulation_count; m++)
+        {
+            qreal modulation = m * (sample_count / 2.0) / modulation_count;
+
+            for(qint32 p = 0; p < phase_count; p++)
+            {
+                FixDictAtom atom;
+                atom.id = id++;
+                atom.sample_count = sample_count;
+                atom.dict_source = name;
+                atom.type = GABORATOM;
+                atom.gabor_atom.scale = scales.at(s);
+                atom.gabor_atom.modulation = modulation;
+                atom.gabor_atom.phase = p * PI / phase_count;
+                atom.atom_samples = gabor_atom.create_real(sample_count, scales.at(s), sample_count / 2, modulation, atom.gabor_atom.phase);
+
+                dict.atoms.append(atom);
+            }
+        }
+    }
+
+    return dict;
+}
+
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the mne_mp_dict_builder application.
+* By default, main has the storage class extern.
+*
+* @param [in] argc  (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv  (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Builds binary matching pursuit dictionaries (.bdict), either by converting an XML dictionary or by generating a Gabor dictionary.");
+    parser.addHelpOption();
+
+    QCommandLineOption xmlOption("xml", "Converts the XML dictionary <file>.", "file");
+    QCommandLineOption outOption("out", "The binary dictionary <file> to write. Defaults to the XML file name with suffix .bdict.", "file");
+    QCommandLineOption samplesOption("samples", "Generates a Gabor dictionary with atoms of <count> samples.", "count");
+    QCommandLineOption modulationsOption("modulations", "Number of modulations per scale of the generated dictionary.", "count", "32");
+    QCommandLineOption phasesOption("phases", "Number of phases per modulation of the generated dictionary.", "count", "4");
+
+    parser.addOption(xmlOption);
+    parser.addOption(outOption);
+    parser.addOption(samplesOption);
+    parser.addOption(modulationsOption);
+    parser.addOption(phasesOption);
+
+    parser.process(app);
+
+    QString out_path = parser.value(outOption);
+    bool ok = false;
+
+    if(parser.isSet(xmlOption))
+    {
+        QString xml_path = parser.value(xmlOption);
+        if(out_path.isEmpty())
+            out_path = FixDictMp::binary_dict_path(xml_path);
+
+        FixDictMp fix_dict_mp;
+        ok = fix_dict_mp.convert_xml_dict(xml_path, out_path);
+    }
+    else if(parser.isSet(samplesOption))
+    {
+        qint32 sample_count = parser.value(samplesOption).toInt();
+        qint32 modulation_count = parser.value(modulationsOption).toInt();
+        qint32 phase_count = parser.value(phasesOption).toInt();
+
+        if(out_path.isEmpty() || sample_count < 2 || modulation_count < 1 || phase_count < 1)
+        {
+            qCritical() << "mne_mp_dict_builder - --samples needs --out, at least 2 samples and positive modulation and phase counts.";
+            return 1;
+        }
+
+        QList<Dictionary> dicts;
+        dicts.append(build_gabor_dict(QFileInfo(out_path).completeBaseName(), sample_count, modulation_count, phase_count));
+        ok = FixDictMp::write_binary_dict(dicts, out_path);
+    }
+    else
+    {
+        parser.showHelp(1);
+    }
+
+    if(!ok)
+    {
+        qCritical() << "mne_mp_dict_builder - could not write" << out_path;
+        return 1;
+    }
+
+    qDebug() << "mne_mp_dict_builder - wrote" << out_path;
+
+    return 0;
+}
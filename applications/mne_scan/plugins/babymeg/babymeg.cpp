@@ -46,7 +46,6 @@
 #include "babymegclient.h"
 #include "babymeginfo.h"
 
-#include <utils/ioutils.h>
 #include <utils/detecttrigger.h>
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_dig_point_set.h>
@@ -100,9 +99,13 @@ BabyMEG::BabyMEG()
 , m_sFiffCompensators(QCoreApplication::applicationDirPath() + "/resources/mne_scan/plugins/babymeg/compensator.fif")
 , m_sBadChannels(QCoreApplication::applicationDirPath() + "/resources/mne_scan/plugins/babymeg/both.bad")
 , m_iRecordingMSeconds(5*60*1000)
-, m_iSplitCount(0)
 , m_bDoContinousHPI(false)
 {
+    //The recorder writes to disk on its own thread, the writer splits the file when it gets too large
+    m_pRawRecorder = FiffRawRecorder::SPtr(new FiffRawRecorder());
+    m_pRawWriter = FiffRollingRawWriter::SPtr(new FiffRollingRawWriter());
+    m_pRawWriter->setMaxFileSize(MAX_DATA_LEN);
+
     m_pActionSetupProject = new QAction(QIcon(":/images/database.png"), tr("Setup Project"),this);
 //    m_pActionSetupProject->setShortcut(tr("F12"));
     m_pActionSetupProject->setStatusTip(tr("Setup Project"));
@@ -351,7 +354,6 @@ QWidget* BabyMEG::setupWidget()
 void BabyMEG::run()
 {
     MatrixXf matValue;
-    qint32 size = 0;
 
     while(m_bIsRunning) {
         if(m_pRawMatrixBuffer) {
@@ -369,20 +371,9 @@ void BabyMEG::run()
             //Create digital trigger information
             createDigTrig(matValue);
 
-            //Write raw data to fif file
+            //Write raw data to fif file. The recorder only queues the data, the disk is accessed on its own thread.
             if(m_bWriteToFile) {
-                size += matValue.rows()*matValue.cols() * 4;
-
-                if(size > MAX_DATA_LEN) {
-                    size = 0;
-                    this->splitRecordingFile();
-                }
-
-                m_mutex.lock();
-                m_pOutfid->write_raw_buffer(matValue.cast<double>());
-                m_mutex.unlock();
-            } else {
-                size = 0;
+                m_pRawRecorder->write(matValue);
             }
 
             if(m_pRTMSABabyMEG) {
@@ -478,32 +469,18 @@ void BabyMEG::setFiffInfo(const FiffInfo& p_FiffInfo)
 
 //*************************************************************************************************************
 
-void BabyMEG::setFiffData(QByteArray data)
+void BabyMEG::setFiffData(const MatrixXf& matData)
 {
-    //get the first byte -- the data format
-    int dformat = data.left(1).toInt();
-
-    data.remove(0,1);
-    qint32 rows = m_pFiffInfo->nchan;
-    qint32 cols = (data.size()/dformat)/rows;
-
-    qDebug() << "[BabyMEG] Matrix " << rows << "x" << cols << " [Data bytes:" << dformat << "]";
-
-    MatrixXf rawData(Map<MatrixXf>( (float*)data.data(),rows, cols ));
-
-    for(qint32 i = 0; i < rows*cols; ++i)
-        IOUtils::swap_floatp(rawData.data()+i);
-
-
+    //The block is already decoded by the client and is reused for the next package, the buffer copies it
     if(m_bIsRunning)
     {
         if(!m_pRawMatrixBuffer)
-            m_pRawMatrixBuffer = CircularMatrixBuffer<float>::SPtr(new CircularMatrixBuffer<float>(40, rows, cols));
+            m_pRawMatrixBuffer = CircularMatrixBuffer<float>::SPtr(new CircularMatrixBuffer<float>(40, matData.rows(), matData.cols()));
 
-        m_pRawMatrixBuffer->push(&rawData);
+        m_pRawMatrixBuffer->push(&matData);
     }
 
-    emit dataToSquidCtrlGUI(rawData);
+    emit dataToSquidCtrlGUI(matData);
 }
 
 
@@ -722,55 +699,17 @@ void BabyMEG::showSqdCtrlDialog()
 }
 
 
-//*************************************************************************************************************
-
-void BabyMEG::splitRecordingFile()
-{
-    //qDebug() << "Split recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sRecordFile.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    //Write the link to the next file
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_qFileOut.setFileName(nextFileName);
-    RowVectorXd cals;
-    MatrixXi sel;
-    m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                              *m_pFiffInfo,
-                                              cals,
-                                              sel,
-                                              false);
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-}
-
-
 //*************************************************************************************************************
 
 void BabyMEG::toggleRecordingFile()
 {
     //Setup writing to file
     if(m_bWriteToFile) {
-        m_mutex.lock();
-        m_pOutfid->finish_writing_raw();
-        m_mutex.unlock();
+        //Write all queued data before finishing the file
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
 
         m_bWriteToFile = false;
-        m_iSplitCount = 0;
 
         //Stop record timer
         m_pRecordTimer->stop();
@@ -779,8 +718,6 @@ void BabyMEG::toggleRecordingFile()
 
         m_pActionRecordFile->setIcon(QIcon(":/images/record.png"));
     } else {
-        m_iSplitCount = 0;
-
         if(!m_pFiffInfo) {
             QMessageBox msgBox;
             msgBox.setText("FiffInfo missing!");
@@ -827,13 +764,17 @@ void BabyMEG::toggleRecordingFile()
         //Start/Prepare writing process. Actual writing is done in run() method.
         m_mutex.lock();
         RowVectorXd cals;
-        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                                  *m_pFiffInfo,
-                                                  cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        bool bStarted = m_pRawWriter->start(m_sRecordFile,
+                                            *m_pFiffInfo,
+                                            cals);
         m_mutex.unlock();
 
+        if(!bStarted) {
+            return;
+        }
+
+        m_pRawRecorder->startRecording(m_pRawWriter);
+
         m_bWriteToFile = true;
 
         //Start timers for record button blinking, recording timer and updating the elapsed time in the proj widget
@@ -47,6 +47,7 @@
 
 #include <fiff/fiff_info.h>
 #include <fiff/fiff_stream.h>
+#include <fiff/fiff_raw_recorder.h>
 
 #include <scShared/Interfaces/ISensor.h>
 #include <utils/generics/circularmatrixbuffer.h>
@@ -223,11 +224,11 @@ protected:
 
     //=========================================================================================================
     /**
-    * Sets the Fiff Info data.
+    * Sets the data of one received package.
     *
-    * @param[in] DATA    the Fiff Info data.
+    * @param[in] matData    the decoded data block, channels x samples.
     */
-    void setFiffData(QByteArray DATA);
+    void setFiffData(const Eigen::MatrixXf& matData);
 
     //=========================================================================================================
     /**
@@ -325,12 +326,6 @@ protected:
     */
     void showSqdCtrlDialog();
 
-    //=========================================================================================================
-    /**
-    * Determines current file. And starts a new one.
-    */
-    void splitRecordingFile();
-
     //=========================================================================================================
     /**
     * Starts or stops a file recording depending on the current recording state.
@@ -407,11 +402,11 @@ protected:
     QList<int>                              m_lTriggerChannelIndices;       /**< List of all trigger channel indices. */
 
     FIFFLIB::FiffInfo::SPtr                 m_pFiffInfo;                    /**< Fiff measurement info.*/
-    FIFFLIB::FiffStream::SPtr               m_pOutfid;                      /**< FiffStream to write to.*/
+    FIFFLIB::FiffRollingRawWriter::SPtr     m_pRawWriter;                   /**< Writes the recording to one or more fif files.*/
+    FIFFLIB::FiffRawRecorder::SPtr          m_pRawRecorder;                 /**< Writes the raw data to m_pRawWriter on its own thread.*/
 
     qint16                                  m_iBlinkStatus;                 /**< The blink status of the recording button.*/
     qint32                                  m_iBufferSize;                  /**< The raw data buffer size.*/
-    qint32                                  m_iSplitCount;                  /**< File split count */
     int                                     m_iRecordingMSeconds;           /**< Recording length in mseconds.*/
 
     bool                                    m_bWriteToFile;                 /**< Flag for for writing the received samples to a file. Defined by the user via the GUI.*/
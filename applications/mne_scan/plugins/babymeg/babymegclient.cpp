@@ -96,6 +96,9 @@ BabyMEGClient::BabyMEGClient(int myPort, QObject *parent)
     numBlock = 0;
     DataACK = false;
 
+    m_iReadPos = 0;
+    m_iWritePos = 0;
+    m_receiveBuffer.resize(1 << 20);
 }
 
 
@@ -138,16 +141,7 @@ void BabyMEGClient::DisplayError(int socketError, const QString &message)
 
 int BabyMEGClient::MGH_LM_Byte2Int(QByteArray b)
 {
-    int value= 0;
-    for (int i=0;i<2;i++)
-    {
-        QByteArray t;
-        t[0] = b[i];
-        b[i] = b[3-i];
-        b[3-i] = t[0];
-    }
-    memcpy((char *)&value,b,4);
-    return value;
+    return qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(b.constData()));
 }
 
 
@@ -155,15 +149,8 @@ int BabyMEGClient::MGH_LM_Byte2Int(QByteArray b)
 
 QByteArray BabyMEGClient::MGH_LM_Int2Byte(int a)
 {
-    QByteArray b = QByteArray::fromRawData((char *)&a,4);
-
-    for (int i=0;i<2;i++)
-    {
-        QByteArray t;
-        t[0] = b[i];
-        b[i] = b[3-i];
-        b[3-i] = t[0];
-    }
+    QByteArray b(4, 0);
+    qToBigEndian<qint32>(a, reinterpret_cast<uchar*>(b.data()));
     return b;
 }
 
@@ -173,15 +160,8 @@ QByteArray BabyMEGClient::MGH_LM_Int2Byte(int a)
 double BabyMEGClient::MGH_LM_Byte2Double(QByteArray b)
 {
     double value= 1.0;
-    // reverse the byte order
-    for (int i=0;i<4;i++)
-    {
-        QByteArray t;
-        t[0] = b[i];
-        b[i] = b[7-i];
-        b[7-i] = t[0];
-    }
-    memcpy((char *)&value,b,8);
+    quint64 bits = qFromBigEndian<quint64>(reinterpret_cast<const uchar*>(b.constData()));
+    memcpy(&value, &bits, 8);
 
     return value;
 }
@@ -221,7 +201,7 @@ void BabyMEGClient::ConnectToBabyMEG()
             qDebug()<< "Send the initial parameter request";
             if (tcpSocket->state()==QAbstractSocket::ConnectedState)
             {
-                buffer.clear();
+                clearBuffer();
 //                SendCommand("INFO");
                 SendCommand("DATA");
             }
@@ -313,17 +293,14 @@ void BabyMEGClient::SendCommandToBabyMEG()
 
 void BabyMEGClient::ReadToBuffer()
 {
-
-    QByteArray dat;
-
-    int numBytes = tcpSocket->bytesAvailable();
+    qint64 numBytes = tcpSocket->bytesAvailable();
 //    qDebug() << "1.byte available: " << numBytes;
     if (numBytes > 0){
-        dat = tcpSocket->read(numBytes); // read all pending data
-//        qDebug()<<"[dat Size]"<<dat.size();
-        if (!dat.isEmpty()){
-            buffer.append(dat); // and append it to your own buffer
-//            qDebug()<<"[ReadToBuffer: Buffer Size]"<<buffer.size();
+        // read all pending data directly behind the already received bytes
+        reserveBuffer(numBytes);
+        qint64 numRead = tcpSocket->read(m_receiveBuffer.data() + m_iWritePos, numBytes);
+        if (numRead > 0){
+            m_iWritePos += numRead;
         }
         else
         {
@@ -341,17 +318,25 @@ void BabyMEGClient::ReadToBuffer()
 
 void BabyMEGClient::handleBuffer()
 {
-    if(buffer.size()>= 8){
-        QByteArray CMD = buffer.left(4);
-        QByteArray DLEN = buffer.mid(4,4);
-        int tmp = MGH_LM_Byte2Int(DLEN);
+    if(m_iWritePos - m_iReadPos >= 8){
+        // the header is decoded in place, CMD only refers to the receive buffer
+        const char* pHeader = m_receiveBuffer.constData() + m_iReadPos;
+        QByteArray CMD = QByteArray::fromRawData(pHeader, 4);
+        int tmp = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(pHeader + 4));
 //        qDebug() << "First 4 bytes + length" << CMD << "["<<CMD.toHex()<<"]";
 //        qDebug() << "Command[" << CMD <<"]";
 //        qDebug() << "Body Length[" << tmp << "]";
 
-        if (tmp <= (buffer.size() - 8))
+        if (tmp < 0)
+        { // a corrupt header, the stream cannot be resynchronized so drop what was received
+            qWarning()<<"[BabyMEGClient] Dropping"<<m_iWritePos - m_iReadPos<<"bytes after a negative body length"<<tmp<<"in the header"<<CMD.toHex();
+            m_iReadPos = m_iWritePos;
+            return;
+        }
+
+        if (tmp <= (m_iWritePos - m_iReadPos - 8))
         {
-            buffer.remove(0,8);
+            m_iReadPos += 8;
 
             int OPT = 0;
 
@@ -374,11 +359,11 @@ void BabyMEGClient::handleBuffer()
             case 1:
                 // from buffer get data package
                 {
-                QByteArray PARA = buffer.left(tmp);
+                QByteArray PARA(m_receiveBuffer.constData() + m_iReadPos, tmp);
+                m_iReadPos += tmp;
                 qDebug()<<"[INFO]"<<PARA;
                 //Parse parameters from PARA string
                 myBabyMEGInfo->MGH_LM_Parse_Para(PARA);
-                buffer.remove(0,tmp);
                 qDebug()<<"INFO has been received!!!!";
 //                qDebug()<<"ACQ Start";
 //                SendCommand("DATA");
@@ -394,11 +379,11 @@ void BabyMEGClient::handleBuffer()
                 break;
             case 3:
                 {
-                QByteArray RESP = buffer.left(tmp);
+                QByteArray RESP(m_receiveBuffer.constData() + m_iReadPos, tmp);
+                m_iReadPos += tmp;
                 qDebug()<< "5.Readbytes:"<<RESP.size();
                 qDebug() << RESP;
                 }
-                buffer.remove(0,tmp);
 
                 break;
             case 4:  //quit
@@ -416,12 +401,12 @@ void BabyMEGClient::handleBuffer()
                 break;
             case 5://command short connection
                 {
-                QByteArray RESP = buffer.left(tmp);
+                QByteArray RESP(m_receiveBuffer.constData() + m_iReadPos, tmp);
+                m_iReadPos += tmp;
                 qDebug()<< "5.Readbytes:"<<RESP.size();
                 qDebug() << RESP;
                 myBabyMEGInfo->MGH_LM_Send_CMDPackage(RESP);
                 }
-                buffer.remove(0,tmp);
                 SendCommand("QUIT");
                 break;
             case 6:  //quit
@@ -436,11 +421,11 @@ void BabyMEGClient::handleBuffer()
                 break;
             case 7: //INFG
                 {
-                QByteArray PARA = buffer.left(tmp);
+                QByteArray PARA(m_receiveBuffer.constData() + m_iReadPos, tmp);
+                m_iReadPos += tmp;
                 qDebug()<<"[INFG]"<<PARA;
                 //Parse parameters from PARA string
                 myBabyMEGInfo->MGH_LM_Parse_Para_Infg(PARA);
-                buffer.remove(0,tmp);
                 qDebug()<<"INFG has been received!!!!";
                 }
                 break;
@@ -459,17 +444,10 @@ void BabyMEGClient::handleBuffer()
 
 void BabyMEGClient::DispatchDataPackage(int tmp)
 {
-
-//    qDebug()<<"Acq data from buffer  [buffer size() =" << buffer.size()<<"]";
-    QByteArray DATA = buffer.left(tmp);
-    qDebug()<< "5.Readbytes:"<<DATA.size();
-    myBabyMEGInfo->MGH_LM_Send_DataPackage(DATA);
-//    myBabyMEGInfo->EnQueue(DATA);
-    buffer.remove(0,tmp);
-//    qDebug()<<"Rest buffer  [buffer size() =" << buffer.size()<<"]";
+//    qDebug()<<"Acq data from buffer  [buffer size() =" << m_iWritePos - m_iReadPos<<"]";
+    DecodeDataPackage(m_receiveBuffer.constData() + m_iReadPos, tmp);
+    m_iReadPos += tmp;
     numBlock ++;
-    qDebug()<< "Next Block ..." << numBlock;
-//    DATA.clear();
 
     ReadNextBlock(tmp);
 }
@@ -479,42 +457,107 @@ void BabyMEGClient::DispatchDataPackage(int tmp)
 
 void BabyMEGClient::ReadNextBlock(int tmp)
 {
-    QByteArray CMD1;
-    QByteArray DLEN1;
-    QByteArray DATA1;
-    int tmp1;
-    while (buffer.size()>=(tmp+8))
-    { // process the extra data block to reduce the load of data buffer
-        CMD1 = buffer.left(4);
-        qDebug()<<"CMD"<< CMD1;
-        if (CMD1 == "DATR")
+    Q_UNUSED(tmp);
+
+    while (m_iWritePos - m_iReadPos >= 8)
+    { // process the extra data blocks which are already received to reduce the load of data buffer
+        const char* pHeader = m_receiveBuffer.constData() + m_iReadPos;
+        if (qstrncmp(pHeader, "DATR", 4) != 0)
         {
-            DLEN1 = buffer.mid(4,4);
-            tmp1 = MGH_LM_Byte2Int(DLEN1);
-            qDebug() << "[2]First 4 bytes + length" << CMD1 << "["<<CMD1.toHex()<<"]";
-            qDebug() << "[2]Command[" << CMD1 <<"]";
-            qDebug() << "[2]Body Length[" << tmp1 << "]";
-
-            buffer.remove(0,8);
-            DATA1 = buffer.left(tmp1);
-            myBabyMEGInfo->MGH_LM_Send_DataPackage(DATA1);
-//            myBabyMEGInfo->EnQueue(DATA1);
-            buffer.remove(0,tmp1);
-            qDebug()<<"End of DataPackeage" << buffer.left(3);
-            qDebug()<<"[2]Rest buffer  [buffer size() =" << buffer.size()<<"]";
-            numBlock ++;
-            qDebug()<< "[2]Next Block ..." << numBlock;
+            qDebug()<<"[CMD1]"<<QByteArray(pHeader, 4).toHex();
+            break;
         }
-        else
-        {
-            qDebug()<<"[CMD1]"<<CMD1.toHex();
+
+        int tmp1 = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(pHeader + 4));
+        if (tmp1 < 0)
+        { // a corrupt header, the stream cannot be resynchronized so drop what was received
+            qWarning()<<"[BabyMEGClient] Dropping"<<m_iWritePos - m_iReadPos<<"bytes after a negative body length"<<tmp1<<"in a DATR header";
+            m_iReadPos = m_iWritePos;
+            break;
+        }
+
+        if (tmp1 > m_iWritePos - m_iReadPos - 8)
+        { // the block is not complete yet
             break;
         }
-        qDebug()<<"[ReadNextBlock:buffer size]"<<buffer.size();
+
+        m_iReadPos += 8;
+        DecodeDataPackage(m_receiveBuffer.constData() + m_iReadPos, tmp1);
+        m_iReadPos += tmp1;
+        numBlock ++;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void BabyMEGClient::DecodeDataPackage(const char* pData, int iSize)
+{
+    if (iSize < 1 || !myBabyMEGInfo)
+        return;
+
+    // the first byte holds the number of bytes per sample as character
+    int iBytesPerSample = pData[0] - '0';
+    int rows = myBabyMEGInfo->chnNum;
+
+    if (iBytesPerSample != 4 || rows <= 0)
+    {
+        qDebug()<<"[BabyMEGClient] Cannot decode data package with"<<iBytesPerSample<<"bytes per sample and"<<rows<<"channels";
+        return;
     }
-    DATA1.clear();
-    CMD1.clear();
-    DLEN1.clear();
+
+    int cols = ((iSize - 1) / iBytesPerSample) / rows;
+
+    // resize does not reallocate as long as the package size stays the same
+    m_matDataBlock.resize(rows, cols);
+
+    // swap the big endian samples straight into the block, the loop is simple enough to be vectorized
+    const uchar* pSrc = reinterpret_cast<const uchar*>(pData + 1);
+    float* pDest = m_matDataBlock.data();
+    const int nel = rows * cols;
+
+    for (int i = 0; i < nel; ++i)
+    {
+        quint32 value = qFromBigEndian<quint32>(pSrc + 4*i);
+        memcpy(pDest + i, &value, 4);
+    }
+
+    myBabyMEGInfo->MGH_LM_Send_DataPackage(m_matDataBlock);
+}
+
+
+//*************************************************************************************************************
+
+void BabyMEGClient::reserveBuffer(qint64 numBytes)
+{
+    if (m_iReadPos == m_iWritePos)
+    { // everything is processed, start again at the front without moving any data
+        m_iReadPos = 0;
+        m_iWritePos = 0;
+    }
+
+    if (m_iWritePos + numBytes <= m_receiveBuffer.size())
+        return;
+
+    // move the unprocessed rest, at most one incomplete block, to the front
+    if (m_iReadPos > 0)
+    {
+        memmove(m_receiveBuffer.data(), m_receiveBuffer.constData() + m_iReadPos, m_iWritePos - m_iReadPos);
+        m_iWritePos -= m_iReadPos;
+        m_iReadPos = 0;
+    }
+
+    if (m_iWritePos + numBytes > m_receiveBuffer.size())
+        m_receiveBuffer.resize(int(qMax(qint64(2 * m_receiveBuffer.size()), m_iWritePos + numBytes)));
+}
+
+
+//*************************************************************************************************************
+
+void BabyMEGClient::clearBuffer()
+{
+    m_iReadPos = 0;
+    m_iWritePos = 0;
 }
 
 
@@ -552,7 +595,7 @@ void BabyMEGClient::SendCommand(QString s)
             qDebug()<<"Not in Connected state";
             //re-connect to server
             ConnectToBabyMEG();
-            buffer.clear();
+            clearBuffer();
             SendCommand("DATA");
         }
 //    sleep(1);
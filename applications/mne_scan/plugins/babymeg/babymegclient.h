@@ -51,6 +51,8 @@
 // Eigen INCLUDES
 //=============================================================================================================
 
+#include <Eigen/Core>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -167,6 +169,15 @@ public:
     */
     void ReadNextBlock(int tmp);
 
+    //=========================================================================================================
+    /**
+    * Decode a data package from the receive buffer into the reused data block and send it
+    *
+    * @param[in] pData -- start of the package body
+    * @param[in] iSize -- size of the package body in bytes
+    */
+    void DecodeDataPackage(const char* pData, int iSize);
+
     //=========================================================================================================
     /**
     * Send command with command format as string
@@ -237,9 +248,26 @@ public:
     bool                        DataACK;
 
     QSharedPointer<BabyMEGInfo> myBabyMEGInfo;
-    QByteArray                  buffer;
 
 private:
+    //=========================================================================================================
+    /**
+    * Make room for numBytes behind the received bytes. Only the unprocessed rest is moved to the front.
+    *
+    * @param[in] numBytes -- number of bytes to be read
+    */
+    void reserveBuffer(qint64 numBytes);
+
+    //=========================================================================================================
+    /**
+    * Discard all received bytes
+    */
+    void clearBuffer();
+
+    QByteArray                  m_receiveBuffer;        /**< Preallocated receive buffer, the packages are parsed in place. */
+    qint64                      m_iReadPos;             /**< Start of the unprocessed bytes in m_receiveBuffer. */
+    qint64                      m_iWritePos;            /**< End of the received bytes in m_receiveBuffer. */
+    Eigen::MatrixXf             m_matDataBlock;         /**< Reused block the data packages are decoded into. */
     bool                        m_bSocketIsConnected;
     QTcpSocket*                 tcpSocket;
 
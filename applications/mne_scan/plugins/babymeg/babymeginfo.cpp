@@ -84,10 +84,10 @@ void BabyMEGInfo::MGH_LM_Send_CMDPackage(QByteArray DATA)
 }
 //*************************************************************************************************************
 
-void BabyMEGInfo::MGH_LM_Send_DataPackage(QByteArray DATA)
+void BabyMEGInfo::MGH_LM_Send_DataPackage(const Eigen::MatrixXf& matData)
 {
-//    qDebug()<<"[BabyMEGInfo]Data Size:"<<DATA.size();
-    emit SendDataPackage(DATA);
+//    qDebug()<<"[BabyMEGInfo]Data Size:"<<matData.rows()<<"x"<<matData.cols();
+    emit SendDataPackage(matData);
 }
 
 //*************************************************************************************************************
@@ -52,6 +52,8 @@
 // Eigen INCLUDES
 //=============================================================================================================
 
+#include <Eigen/Core>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -141,11 +143,11 @@ public:
     void MGH_LM_Parse_Para(QByteArray cmdstr);
     //=========================================================================================================
     /**
-    * Send data package
+    * Send data package. The block is reused for the next package, receivers have to copy it if they keep it.
     *
-    * @param[in] DATA       QByteArray contains MEG data.
+    * @param[in] matData    The decoded MEG data, channels x samples.
     */
-    void MGH_LM_Send_DataPackage(QByteArray DATA);
+    void MGH_LM_Send_DataPackage(const Eigen::MatrixXf& matData);
     //=========================================================================================================
     /**
     * Send command reply package
@@ -206,7 +208,7 @@ private:
 
 signals:
     void fiffInfoAvailable(FIFFLIB::FiffInfo);
-    void SendDataPackage(QByteArray DATA);
+    void SendDataPackage(const Eigen::MatrixXf& matData);
     void SendCMDPackage(QByteArray DATA);
     void GainInfoUpdate(QStringList);
 
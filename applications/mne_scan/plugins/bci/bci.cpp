@@ -450,67 +450,27 @@ void BCI::updateSource(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
 //*************************************************************************************************************
 
-void BCI::applyMeanCorrectionConcurrently(QPair<int, RowVectorXd> &chdata)
+VectorXd BCI::calculateFeaturesOnSensorLevel(const MatrixXd &matData)
 {
-    chdata.second = chdata.second.array() - chdata.second.mean(); // Row vector needs to be transformed to a array in order to subract a scalar
-}
-
-
-//*************************************************************************************************************
-
-void BCI::applyFilterOperatorConcurrently(QPair<int, RowVectorXd> &chdata)
-{
-    chdata.second = m_filterOperator->applyFFTFilter(chdata.second);
-}
-
-
-//*************************************************************************************************************
-
-QPair< int,QList<double> > BCI::applyFeatureCalcConcurrentlyOnSensorLevel(const QPair<int, RowVectorXd> &chdata)
-{
-    RowVectorXd data = chdata.second;
-    QList<double> features;
-
     // TODO: Divide into subsignals
     switch(m_iFeatureCalculationType)
     {
-        case 0:
-            features << data.squaredNorm(); // Compute variance
-            break;
         case 1:
-            features << std::abs(log10(data.squaredNorm())); // Compute log of variance
-            break;
+            return matData.rowwise().squaredNorm().array().log10().abs().matrix(); // Compute log of variance
         default:
-            features << data.squaredNorm(); // Compute variance
-            break;
+            return matData.rowwise().squaredNorm(); // Compute variance
     }
-
-    return QPair< int,QList<double> >(chdata.first, features);
 }
 
 
 //*************************************************************************************************************
 
-double BCI::applyClassificationCalcConcurrentlyOnSensorLevel(QList<double> &featData)
+RowVectorXd BCI::classificationBoundaryValues(const MatrixXd &matFeatures)
 {
-   return classificationBoundaryValue(featData);
-}
+    RowVectorXd return_val = RowVectorXd::Zero(matFeatures.cols());
 
-
-//*************************************************************************************************************
-
-double BCI::classificationBoundaryValue(const QList<double> &featData)
-{
-    double return_val = 0;
-
-    if(featData.size() == m_vLoadedSensorBoundary[1].size())
-    {
-        VectorXd feat_temp(featData.size());
-        for(int i = 0; i<featData.size(); i++)
-            feat_temp(i) = featData.at(i);
-
-        return_val = m_vLoadedSensorBoundary[0](0) + m_vLoadedSensorBoundary[1].dot(feat_temp);
-    }
+    if(m_vLoadedSensorBoundary.size() > 1 && matFeatures.rows() == m_vLoadedSensorBoundary[1].size())
+        return_val = (m_vLoadedSensorBoundary[1].transpose() * matFeatures).array() + m_vLoadedSensorBoundary[0](0);
 
     return return_val;
 }
@@ -521,7 +481,7 @@ double BCI::classificationBoundaryValue(const QList<double> &featData)
 void BCI::clearFeatures()
 {
     m_qMutex.lock();
-        m_lFeaturesSensor.clear();
+        m_matFeaturesSensor.resize(0, 0);
     m_qMutex.unlock();
 }
 
@@ -538,23 +498,17 @@ void BCI::clearClassifications()
 
 //*************************************************************************************************************
 
-bool BCI::hasThresholdArtefact(const QList< QPair<int,RowVectorXd> > &data)
+bool BCI::hasThresholdArtefact(const MatrixXd &data)
 {
     // Perform simple threshold artefact reduction
     double max = 0;
     double min = 0;
 
-    if(m_bUseArtefactThresholdReduction)
+    if(m_bUseArtefactThresholdReduction && data.size() > 0)
     {
-        // find min max in current m_matSlidingWindowSensor/qlMatrixRows after mean was subtracted
-        for(int i = 0; i<data.size(); i++)
-        {
-            if(data.at(i).second.maxCoeff() > max)
-                max = data.at(i).second.maxCoeff();
-
-            if(data.at(i).second.minCoeff() < min)
-                min = data.at(i).second.minCoeff();
-        }
+        // find min max in current m_matSlidingWindowSensor after mean was subtracted
+        max = std::max(max, data.maxCoeff());
+        min = std::min(min, data.minCoeff());
     }
 
 //    cout<<"max: "<<max<<endl;
@@ -681,28 +635,26 @@ void BCI::BCIOnSensorLevel()
 //                    }
             }
 
-            // ----2---- Transform matrix into QList structure, so that QTConcurrent can handle it properly
+            // ----2---- Work on a copy of the window, all electrodes are processed at once as one matrix
             //cout<<"----2----"<<endl;
-            QList< QPair<int,RowVectorXd> > qlMatrixRows;
-            for(int i = 0; i< m_matSlidingWindowSensor.rows(); i++)
-                qlMatrixRows << QPair<int,RowVectorXd>(i, m_matSlidingWindowSensor.row(i));
+            MatrixXd matWindow = m_matSlidingWindowSensor;
 
-            int iNumberOfFeatures = qlMatrixRows.size();
+            int iNumberOfFeatures = matWindow.rows();
 
-            // ----3---- Subtract mean in m_matSlidingWindowSensor concurrently using map()
+            // ----3---- Subtract mean of each electrode
             //cout<<"----3----"<<endl;
             if(m_bSubtractMean)
-            {
-                QFuture<void> futureMean = QtConcurrent::map(qlMatrixRows,[this](QPair<int,RowVectorXd>& rowdata) {
-                    applyMeanCorrectionConcurrently(rowdata);
-                });
-
-                futureMean.waitForFinished();
-            }
+                matWindow.colwise() -= matWindow.rowwise().mean();
 
             // ----4---- Do simple threshold artefact reduction
             //cout<<"----4----"<<endl;
-            if(hasThresholdArtefact(qlMatrixRows) == false)
+            bool bArtefact = hasThresholdArtefact(matWindow);
+
+            // ----5---- Filter all electrodes of the window with one FFT object
+            //cout<<"----5----"<<endl;
+            MatrixXd matFiltered = m_bUseFilter ? m_filterOperator->applyFFTFilterRows(matWindow) : matWindow;
+
+            if(!bArtefact)
             {
                 // Look for trigger flag
                 if(lookForTrigger(m_matStimChannelSensor) && !m_bTriggerActivated)
@@ -712,98 +664,54 @@ void BCI::BCIOnSensorLevel()
                     m_bTriggerActivated = true;
                 }
 
-                // ----5---- Filter data in m_matSlidingWindowSensor concurrently using map()
-                //cout<<"----5----"<<endl;
-                // TODO: work only on qlMatrixRows -> filteredRows doesnt need to be created -> more efficient
-                QList< QPair<int,RowVectorXd> > filteredRows = qlMatrixRows;
-
-                if(m_bUseFilter)
-                {
-                    QFuture<void> futureFilter = QtConcurrent::map(filteredRows,[this](QPair<int,RowVectorXd>& chdata) {
-                        applyFilterOperatorConcurrently(chdata);
-                    });
-
-                    futureFilter.waitForFinished();
-                }
-
-//                    // Write data before and after filtering to debug file
-//                    for(int i=0; i<qlMatrixRows.size(); i++)
-//                        m_outStreamDebug << "qlMatrixRows at row " << i << ": " << qlMatrixRows.at(i).second << "\n";
-
-//                    m_outStreamDebug<<endl;
-
-//                    for(int i=0; i<filteredRows.size(); i++)
-//                        m_outStreamDebug << "filteredRows at row " << i << ": " << filteredRows.at(i).second << "\n";
-
-//                    m_outStreamDebug << endl << "---------------------------------------------------------" << endl << endl;
-
 //                    // Write filtered data continously to file
-//                    for(int i = 0; i<filteredRows.at(0).second.size() ;i++)
-//                        m_outStreamDebug << filteredRows.at(0).second(i)<<endl;
+//                    for(int i = 0; i<matFiltered.cols() ;i++)
+//                        m_outStreamDebug << matFiltered(0,i)<<endl;
 
-                // ----6---- Calculate features concurrently using mapped()
+                // ----6---- Calculate features of all electrodes
                 //cout<<"----6----"<<endl;
-                std::function< QPair<int,QList<double> > (QPair<int,RowVectorXd>&)> applyOpsFeatures = [this](QPair<int,RowVectorXd>& chdata) -> QPair< int,QList<double> > {
-                    return applyFeatureCalcConcurrentlyOnSensorLevel(chdata);
-                };
-
-                QFuture< QPair< int,QList<double> > > futureCalculatedFeatures = QtConcurrent::mapped(filteredRows.begin(), filteredRows.end(), applyOpsFeatures);
+                if(m_matFeaturesSensor.rows() != iNumberOfFeatures || m_matFeaturesSensor.cols() != m_iNumberFeatures)
+                {
+                    m_matFeaturesSensor.resize(iNumberOfFeatures, m_iNumberFeatures);
+                    m_iNumberOfCalculatedFeatures = 0;
+                }
 
-                futureCalculatedFeatures.waitForFinished();
+                // ----7---- Store features as the next feature point
+                //cout<<"----7----"<<endl;
+                m_matFeaturesSensor.col(m_iNumberOfCalculatedFeatures) = calculateFeaturesOnSensorLevel(matFiltered);
 
                 m_iNumberOfCalculatedFeatures++;
 
-                // ----7---- Store features
-                //cout<<"----7----"<<endl;
-                m_lFeaturesSensor.append(futureCalculatedFeatures.results());
-
                 // ----8---- If enough features (windows) have been calculated (processed) -> classify all features and average results
                 //cout<<"----8----"<<endl;
                 if(m_iNumberOfCalculatedFeatures == m_iNumberFeatures)
                 {
-                    // Transform m_lFeaturesSensor into an easier file structure -> create feature points
-                    QList< QList<double> > lFeaturesSensor_new;
+                    // Display features
+                    if(m_bDisplayFeatures)
+                    {
+                        QList< QList<double> > lFeaturesSensor;
 
-                    for(int i = 0; i<m_lFeaturesSensor.size()-iNumberOfFeatures+1; i = i + iNumberOfFeatures) // iterate over QPair feature List
-                        for(int z = 0; z<m_lFeaturesSensor.at(0).second.size(); z++) // iterate over number of sub signals
+                        for(int i = 0; i<m_matFeaturesSensor.cols(); i++)
                         {
                             QList<double> temp;
-                            for(int t = 0; t<iNumberOfFeatures; t++) // iterate over chosen features (electrodes)
-                                temp.append(m_lFeaturesSensor.at(i+t).second.at(z));
-                            lFeaturesSensor_new.append(temp);
+                            for(int t = 0; t<iNumberOfFeatures; t++)
+                                temp.append(m_matFeaturesSensor(t,i));
+                            lFeaturesSensor.append(temp);
                         }
 
-//                        //Check sizes
-//                        cout<<"lFeaturesSensor_new.size()"<<lFeaturesSensor_new.size()<<endl;
-//                        cout<<"lFeaturesSensor_new.at(0).size()"<<lFeaturesSensor_new.at(0).size()<<endl;
-//                        cout<<"m_lFeaturesSensor.size()"<<m_lFeaturesSensor.size()<<endl;
-
-                    // Display features
-                    if(m_bDisplayFeatures)
-                        emit paintFeatures((MyQList)lFeaturesSensor_new, m_bTriggerActivated);
+                        emit paintFeatures((MyQList)lFeaturesSensor, m_bTriggerActivated);
+                    }
 
                     // Reset trigger
                     m_bTriggerActivated = false;
 
-                    // ----9---- Classify features concurrently using mapped() ----------
+                    // ----9---- Classify all feature points at once
                     //cout<<"----9----"<<endl;
-
-                    std::function<double (QList<double>&)> applyOpsClassification = [this](QList<double>& featData){
-                        return applyClassificationCalcConcurrentlyOnSensorLevel(featData);
-                    };
-
-                    QFuture<double> futureClassificationResults = QtConcurrent::mapped(lFeaturesSensor_new.begin(), lFeaturesSensor_new.end(), applyOpsClassification);
-
-                    futureClassificationResults.waitForFinished();
+                    RowVectorXd classificationResults = classificationBoundaryValues(m_matFeaturesSensor);
 
                     // ----10---- Generate final classification result -> average all classification results
                     //cout<<"----10----"<<endl;
-                    double dfinalResult = 0;
-
-                    for(int i = 0; i<futureClassificationResults.resultCount() ;i++)
-                        dfinalResult += futureClassificationResults.resultAt(i);
-
-                    dfinalResult = dfinalResult/futureClassificationResults.resultCount();
+                    double dfinalResult = classificationResults.mean();
                     cout << "dfinalResult: " << dfinalResult << endl << endl;
 
                     // ----11---- Store final result
@@ -812,23 +720,16 @@ void BCI::BCIOnSensorLevel()
 
                     // ----12---- Send result to the output stream, i.e. which is connected to the triggerbox
                     //cout<<"----12----"<<endl;
-                    VectorXd variances(iNumberOfFeatures);
-                    variances.setZero();
-
-                    for(int i = 0; i<lFeaturesSensor_new.size(); i++)
-                        for(int t = 0; t<iNumberOfFeatures; t++)
-                            variances(t) = variances(t) + lFeaturesSensor_new.at(i).at(t);
-
-                    variances = variances/lFeaturesSensor_new.size();
+                    VectorXd variances = m_matFeaturesSensor.rowwise().mean();
 
                     m_pBCIOutputOne->data()->setValue(dfinalResult);
                     m_pBCIOutputTwo->data()->setValue(variances(0));
                     m_pBCIOutputThree->data()->setValue(variances(1));
 
-                    for(int i = 0; i<filteredRows.at(0).second.cols() ; i++)
+                    for(int i = 0; i<matFiltered.cols() ; i++)
                     {
-                        m_pBCIOutputFour->data()->setValue(filteredRows.at(0).second(0,i));
-                        m_pBCIOutputFive->data()->setValue(filteredRows.at(1).second(0,i));
+                        m_pBCIOutputFour->data()->setValue(matFiltered(0,i));
+                        m_pBCIOutputFive->data()->setValue(matFiltered(1,i));
                     }
 
                     // Clear classifications
@@ -845,21 +746,10 @@ void BCI::BCIOnSensorLevel()
                 m_pBCIOutputTwo->data()->setValue(0);
                 m_pBCIOutputThree->data()->setValue(0);
 
-                QList< QPair<int,RowVectorXd> > filteredRows = qlMatrixRows;
-
-                if(m_bUseFilter)
-                {
-                    QFuture<void> futureFilter = QtConcurrent::map(filteredRows,[this](QPair<int,RowVectorXd>& chdata) {
-                        applyFilterOperatorConcurrently(chdata);
-                    });
-
-                    futureFilter.waitForFinished();
-                }
-
-                for(int i = 0; i<filteredRows.at(0).second.cols() ; i++)
+                for(int i = 0; i<matFiltered.cols() ; i++)
                 {
-                    m_pBCIOutputFour->data()->setValue(filteredRows.at(0).second(0,i));
-                    m_pBCIOutputFive->data()->setValue(filteredRows.at(1).second(0,i));
+                    m_pBCIOutputFour->data()->setValue(matFiltered(0,i));
+                    m_pBCIOutputFive->data()->setValue(matFiltered(1,i));
                 }
             }
 
@@ -166,46 +166,21 @@ protected:
 
     //=========================================================================================================
     /**
-    * Calculates the filtered signal of chdata
+    * Calculates the features of all electrodes of a window at once
     *
-    * @param [in] rowdata QPair with number of the row and the data samples as a RowVectorXd.
+    * @param [in] matData the (filtered) window, one electrode per row.
+    * @param [out] VectorXd the calculated feature of each electrode, i.e. the feature data point of this window.
     */
-    void applyMeanCorrectionConcurrently(QPair<int,RowVectorXd>& rowdata);
+    VectorXd calculateFeaturesOnSensorLevel(const MatrixXd &matData);
 
     //=========================================================================================================
     /**
-    * Calculates the filtered signal of chdata
+    * Calculates the function values of the decision function (boundary) for all feature points at once
     *
-    * @param [in] chdata QPair with number of the row and the data samples as a RowVectorXd.
+    * @param [in] matFeatures holds one feature data point per column (i.e. 2 electrodes make the columns have size of 2).
+    * @param [out] RowVectorXd function value of each feature point, zero if the boundary does not fit the features.
     */
-    void applyFilterOperatorConcurrently(QPair<int,RowVectorXd> &chdata);
-
-    //=========================================================================================================
-    /**
-    * Calculates the features on sensor level
-    *
-    * @param [in] chdata QPair with number of the row and the data samples as a RowVectorXd.
-    * @param [out] QPair<int,QList<double>> calculated features.
-    */
-    QPair< int,QList<double> > applyFeatureCalcConcurrentlyOnSensorLevel(const QPair<int,RowVectorXd> &chdata);
-
-    //=========================================================================================================
-    /**
-    * Classifies the features on sensor level
-    *
-    * @param [in] featData QList<double> holds the feature data point (i.e. 2 electrodes make this parameter have size of 2).
-    * @param [out] double calculated classification value.
-    */
-    double applyClassificationCalcConcurrentlyOnSensorLevel(QList<double> &featData);
-
-    //=========================================================================================================
-    /**
-    * Calculates the function value of the decision function (boundary) for a given feature point
-    *
-    * @param [in] featData QList<double> holds the feature data point (i.e. 2 electrodes make this parameter have size of 2).
-    * @param [out] double function value.
-    */
-    double classificationBoundaryValue(const QList<double> &featData);
+    RowVectorXd classificationBoundaryValues(const MatrixXd &matFeatures);
 
     //=========================================================================================================
     /**
@@ -226,7 +201,7 @@ protected:
     * Check for artefact in data
     *
     */
-    bool hasThresholdArtefact(const QList<QPair<int, RowVectorXd> > &data);
+    bool hasThresholdArtefact(const MatrixXd &data);
 
     //=========================================================================================================
     /**
@@ -296,7 +271,7 @@ private:
     QVector< VectorXd >     m_vLoadedSensorBoundary;            /**< Sensor level: Loaded decision boundary on sensor level. */
     QStringList             m_slChosenFeatureSensor;            /**< Sensor level: Features used to calculate data points in feature space on sensor level. */
     QMap<QString, int>      m_mapElectrodePinningScheme;        /**< Sensor level: Loaded pinning scheme of the Duke 128 EEG cap. */
-    QList< QPair< int,QList<double> > >  m_lFeaturesSensor;     /**< Sensor level: Features calculated on sensor level. */
+    MatrixXd                m_matFeaturesSensor;                /**< Sensor level: Features calculated on sensor level, one feature data point (window) per column. */
     QList<double>           m_lClassResultsSensor;              /**< Sensor level: Classification results on sensor level. */
     MatrixXd                m_matStimChannelSensor;             /**< Sensor level: Stim channel. */
     MatrixXd                m_matTimeBetweenWindowsStimSensor;  /**< Sensor level: Stim channel. */
@@ -169,6 +169,10 @@ void EEGoSports::init()
     m_bIsRunning = false;
     m_bCheckImpedances = false;
 
+    //The recorder writes to disk on its own thread
+    m_pRawRecorder = FiffRawRecorder::SPtr(new FiffRawRecorder());
+    m_pRawWriter = FiffRollingRawWriter::SPtr(new FiffRollingRawWriter());
+
     QDate date;
     m_sOutputFilePath = settings.value(QString("EEGOSPORTS/outputFilePath"), QString("%1Sequence_01/Subject_01/%2_%3_%4_EEG_001_raw.fif").arg(m_qStringResourcePath).arg(date.currentDate().year()).arg(date.currentDate().month()).arg(date.currentDate().day())).toString();
 
@@ -645,8 +649,10 @@ void EEGoSports::showStartRecording()
 {
     //Setup writing to file
     if(m_bWriteToFile) {
-        m_pOutfid->finish_writing_raw();
+        //Write all queued data before finishing the file
         m_bWriteToFile = false;
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
         m_pTimerRecordingChange->stop();
         m_pActionStartRecording->setIcon(QIcon(":/images/record.png"));
     } else {
@@ -687,9 +693,11 @@ void EEGoSports::showStartRecording()
             dir.mkpath(fileDir);
         }
 
-        m_pOutfid = Fiff::start_writing_raw(m_fileOut, *m_pFiffInfo, m_cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        if(!m_pRawWriter->start(m_sOutputFilePath, *m_pFiffInfo, m_cals)) {
+            return;
+        }
+
+        m_pRawRecorder->startRecording(m_pRawWriter, m_cals);
 
         m_bWriteToFile = true;
 
@@ -746,9 +754,9 @@ void EEGoSports::run()
 
                 matValue = m_qListReceivedSamples.takeFirst();
 
-                //Write raw data to fif file
+                //Write raw data to fif file. The recorder only queues the data, the disk is accessed on its own thread.
                 if(m_bWriteToFile) {
-                    m_pOutfid->write_raw_buffer(matValue, m_cals);
+                    m_pRawRecorder->write(matValue);
                 }
 
                 //emit values to real time multi sample array
@@ -762,8 +770,10 @@ void EEGoSports::run()
 
     //Close the fif output stream
     if(m_bWriteToFile) {
-        m_pOutfid->finish_writing_raw();
+        //Write all queued data before finishing the file
         m_bWriteToFile = false;
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
         m_pTimerRecordingChange->stop();
         m_pActionStartRecording->setIcon(QIcon(":/images/record.png"));
     }
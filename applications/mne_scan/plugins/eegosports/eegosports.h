@@ -50,6 +50,7 @@
 
 #include <scShared/Interfaces/ISensor.h>
 #include <utils/generics/circularmatrixbuffer.h>
+#include <fiff/fiff_raw_recorder.h>
 #include <fstream>
 
 
@@ -260,7 +261,8 @@ private:
     QString                             m_sNasion;                          /**< The electrode to take to function as the Nasion.*/
 
     QFile                               m_fileOut;                          /**< QFile for writing to fif file.*/
-    QSharedPointer<FIFFLIB::FiffStream> m_pOutfid;                          /**< QFile for writing to fif file.*/
+    QSharedPointer<FIFFLIB::FiffRollingRawWriter> m_pRawWriter;             /**< Writes the recording to one or more fif files.*/
+    QSharedPointer<FIFFLIB::FiffRawRecorder> m_pRawRecorder;                /**< Writes the raw data to m_pRawWriter on its own thread.*/
     QSharedPointer<FIFFLIB::FiffInfo>   m_pFiffInfo;                        /**< Fiff measurement info.*/
     Eigen::RowVectorXd                  m_cals;
 
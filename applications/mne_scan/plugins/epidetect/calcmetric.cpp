@@ -92,92 +92,6 @@ CalcMetric::CalcMetric()
 }
 
 
-//*************************************************************************************************************
-
-QPair<RowVectorXd, QPair<QList<double>, int> > createInputList(RowVectorXd input, int dim, double r, double n, double mean, double stdDev)
-{
-    QPair<RowVectorXd, QPair<QList<double>, int> > funcInput;
-    funcInput.first = input;
-    QPair<QList<double>, int> inputValues;
-    QList<double> doubleInputValues;
-    doubleInputValues << mean;
-    doubleInputValues << stdDev;
-    doubleInputValues << r;
-    doubleInputValues << n;
-    inputValues.first = doubleInputValues;
-    inputValues.second = dim;
-    funcInput.second = inputValues;
-    return funcInput;
-
-}
-
-
-//*************************************************************************************************************
-
-double calcFuzzyEn(QPair<RowVectorXd, QPair<QList<double>, int> > input)//RowVectorXd data, double mean, double stdDev, int dim, double r, double n)
-{
-    RowVectorXd data = input.first;
-    QPair<QList<double>, int> inputValues = input.second;
-    QList<double> doubleInputValues= inputValues.first;
-    int dim = inputValues.second;
-    double mean = doubleInputValues[0];
-    double stdDev = doubleInputValues[1];
-    double r = doubleInputValues[2];
-    double n = doubleInputValues[3];
-    int length = data.cols();
-    double fuzzyEn;
-    ArrayXd arDataNorm = (data.array()- mean).array()/(stdDev);
-    VectorXd dataNorm = arDataNorm;
-    Vector2d phi;
-
-    for(int j=0; j<2; j++)
-    {
-        int m = dim+j;
-        MatrixXd patterns;
-        patterns.resize(m, length-m+1);
-
-        if (m==1)
-            patterns = dataNorm;
-        else
-        {
-            for(int i=0; i<m; i++)
-                patterns.row(i)=dataNorm.segment(i,length-m+1);
-
-        }
-
-        VectorXd patternsMean = patterns.colwise().mean();
-        patterns = patterns.rowwise() - patternsMean.transpose(); //check whether correct
-        VectorXd aux;
-        aux.resize(length-m+1);
-
-        for (int i = 0; i< length-m+1; i++)
-        {
-            MatrixXd column;
-            column.resize(patterns.rows(),patterns.cols());
-            for (int l= 0; l < patterns.cols(); l++)
-                column.col(l) = patterns.col(i);
-
-            VectorXd distance = ((patterns.array()-column.array()).abs()).colwise().maxCoeff();
-                //cout <<  "dist " << i << ": " << distance << "\n";
-            VectorXd similarty = (((-1)*(distance.array().pow(n)))/r).exp();
-                //cout << "simi " << i << ": " << similarty << "\n";
-
-            aux(i) = ((similarty.sum()-1)/(length-m-1));
-
-        }
-
-        phi[j] = (aux.sum()/(length-m));
-
-    }
-
-    fuzzyEn = log(phi[0])-log(phi[1]);
-
-
-    return fuzzyEn;
-
-}
-
-
 //*************************************************************************************************************
 
 VectorXd CalcMetric::getFuzzyEn()
@@ -252,37 +166,45 @@ void CalcMetric::setData(Eigen::MatrixXd input)
 VectorXd CalcMetric::onSeizureDetection(int dim, double r, double n, QList<int> checkChs)
 {
     qSort(m_lFuzzyEnUsedChs);
-    QList<QPair<RowVectorXd, QPair<QList<double>, int> > > inputList;
+    QList<int> missingChs;
 
     for (int i = 0; i < checkChs.length(); i++)
     {
         if (!m_lFuzzyEnUsedChs.contains(checkChs[i]))
-        {
-            QPair<RowVectorXd, QPair<QList<double>, int> > funcInput = createInputList(m_dmatData.row(checkChs[i]), dim, r, n, m_dvecMean(checkChs[i]), m_dvecStdDev(checkChs[i]));
-            inputList << funcInput;
-        }
+            missingChs << checkChs[i];
     }
 
-    QList<double> fuzzyEnResults;
-    QFuture<double> fuzzyEnFuture = mapped(inputList, calcFuzzyEn);
-    fuzzyEnFuture.waitForFinished();
-    QFutureIterator<double> futureResult(fuzzyEnFuture);
-    while (futureResult.hasNext())
-        fuzzyEnResults << futureResult.next();
+    m_entropyEngine.setParameters(dim, r, n);
+    VectorXd fuzzyEnResults = m_entropyEngine.fuzzyEn(m_dmatData, m_dvecStdDev, missingChs);
 
-    int j = 0;
+    for (int i = 0; i < missingChs.length(); i++)
+        m_dvecFuzzyEn(missingChs[i]) = fuzzyEnResults(i);
 
-    for (int i = 0; i < checkChs.length(); i++)
-    {
-        if (!m_lFuzzyEnUsedChs.contains(checkChs[i]))
-        {
-            m_dvecFuzzyEn(checkChs[i]) = fuzzyEnResults[j];
-            j++;
-        }
-    }
+    return m_dvecFuzzyEn;
+}
 
 
-    return m_dvecFuzzyEn;
+//*************************************************************************************************************
+
+VectorXd CalcMetric::calcSampleEn(int dim, double r, QList<int> channels)
+{
+    return m_entropyEngine.sampleEn(m_dmatData, m_dvecStdDev, channels, dim, r);
+}
+
+
+//*************************************************************************************************************
+
+VectorXd CalcMetric::calcApproximateEn(int dim, double r, QList<int> channels)
+{
+    return m_entropyEngine.approximateEn(m_dmatData, m_dvecStdDev, channels, dim, r);
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd CalcMetric::calcMultiscaleEn(int dim, double r, int maxScale, QList<int> channels)
+{
+    return m_entropyEngine.multiscaleEn(m_dmatData, m_dvecStdDev, channels, dim, r, maxScale);
 }
 
 
@@ -416,7 +338,7 @@ void CalcMetric::calcKurtosis(int start, int end)
 
 //*************************************************************************************************************
 
-void CalcMetric::calcAll(Eigen::MatrixXd input, int dim, double r, double n)
+void CalcMetric::calcAll(Eigen::MatrixXd input, int dim, double r, double n, int overlap)
 {
     this->setData(input);
     this->calcP2P();
@@ -435,29 +357,15 @@ void CalcMetric::calcAll(Eigen::MatrixXd input, int dim, double r, double n)
         }
     }
 
-    QList<QPair<RowVectorXd, QPair<QList<double>, int> > > inputList;
-
     for (int i = m_iFuzzyEnStart; i< m_iChannelCount; i=i+m_iFuzzyEnStep)
-    {
         m_lFuzzyEnUsedChs << i;
-        QPair<RowVectorXd, QPair<QList<double>, int> > funcInput = createInputList(input.row(i), dim, r, n, m_dvecMean(i), m_dvecStdDev(i));
-        inputList << funcInput;
-    }
-
-    QList<double> fuzzyEnResults;
-    QFuture<double> fuzzyEnFuture = mapped(inputList, calcFuzzyEn);
-    fuzzyEnFuture.waitForFinished();
-    QFutureIterator<double> futureResult(fuzzyEnFuture);
-    while (futureResult.hasNext())
-        fuzzyEnResults << futureResult.next();
 
-    int j = 0;
+    m_entropyEngine.setParameters(dim, r, n);
+    m_entropyEngine.setOverlap(overlap);
+    VectorXd fuzzyEnResults = m_entropyEngine.fuzzyEn(input, m_dvecStdDev, m_lFuzzyEnUsedChs);
 
-    for (int i = m_iFuzzyEnStart; i<m_iChannelCount; i=i+m_iFuzzyEnStep)
-    {
-        m_dvecFuzzyEn(i) = fuzzyEnResults[j];
-        j++;
-    }
+    for (int i = 0; i < m_lFuzzyEnUsedChs.length(); i++)
+        m_dvecFuzzyEn(m_lFuzzyEnUsedChs[i]) = fuzzyEnResults(i);
 
     if (m_iFuzzyEnStart < m_iFuzzyEnStep-1)
         m_iFuzzyEnStart++;
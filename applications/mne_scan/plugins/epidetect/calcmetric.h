@@ -42,6 +42,7 @@
 // INCLUDES
 //=============================================================================================================
 
+#include "entropyengine.h"
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -97,8 +98,9 @@ public:
     * @param [in] dim embedding dimension of fuzzy entropy.
     * @param [in] r width of fuzzy exponential function.
     * @param [in] n step of fuzzy exponential function.
+    * @param [in] overlap number of leading samples of input which continue the previous input.
     */
-    void calcAll(Eigen::MatrixXd input, int dim, double r, double n);
+    void calcAll(Eigen::MatrixXd input, int dim, double r, double n, int overlap = 0);
 
     //=========================================================================================================
     /**
@@ -128,6 +130,40 @@ public:
     */
     Eigen::VectorXd onSeizureDetection(int dim, double r, double n, QList<int> checkChs);
 
+    //=========================================================================================================
+    /**
+    * Calculates the Sample Entropy of the data set of the last calcAll() call.
+    *
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to the standard deviation of each channel.
+    * @param [in] channels list of channels to calculate.
+    * @param [out] returns the Sample Entropy in the order of channels.
+    */
+    Eigen::VectorXd calcSampleEn(int dim, double r, QList<int> channels);
+
+    //=========================================================================================================
+    /**
+    * Calculates the Approximate Entropy of the data set of the last calcAll() call.
+    *
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to the standard deviation of each channel.
+    * @param [in] channels list of channels to calculate.
+    * @param [out] returns the Approximate Entropy in the order of channels.
+    */
+    Eigen::VectorXd calcApproximateEn(int dim, double r, QList<int> channels);
+
+    //=========================================================================================================
+    /**
+    * Calculates the Multiscale Entropy of the data set of the last calcAll() call.
+    *
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to the standard deviation of each channel.
+    * @param [in] maxScale largest coarse-graining scale.
+    * @param [in] channels list of channels to calculate.
+    * @param [out] returns the Sample Entropy of the scales 1 to maxScale (columns) in the order of channels (rows).
+    */
+    Eigen::MatrixXd calcMultiscaleEn(int dim, double r, int maxScale, QList<int> channels);
+
     //=========================================================================================================
     /**
     * Returns the the value m_dvecKurtosis.
@@ -211,6 +247,8 @@ private:
 
     Eigen::VectorXd                         m_dvecStdDev;               /**< Contains the standard deviation for each channel.*/
     Eigen::VectorXd                         m_dvecMean;                 /**< Contains the mean value for each channel.*/
+
+    EntropyEngine                           m_entropyEngine;            /**< Calculates the entropies and keeps the overlap of consecutive windows.*/
 };
 
 
@@ -0,0 +1,512 @@
+//=============================================================================================================
+/**
+* @file     entropyengine.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    EntropyEngine class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "entropyengine.h"
+
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+static void fuzzySimilarity(ArrayXd &dist, double scale, double r, double n)
+{
+    //Integer steps are by far the common case, avoid the generic pow for them
+    int iN = static_cast<int>(n);
+
+    if(iN == n && iN >= 1 && iN <= 8) {
+        ArrayXd base = dist * scale;
+        dist = base;
+        for(int i = 1; i < iN; ++i) {
+            dist *= base;
+        }
+        dist = (-dist / r).exp();
+    } else {
+        dist = (-(dist * scale).pow(n) / r).exp();
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+EntropyEngine::EntropyEngine()
+: m_iDim(3)
+, m_dR(0.3)
+, m_dN(3.0)
+, m_iOverlap(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void EntropyEngine::setParameters(int dim, double r, double n)
+{
+    if(dim != m_iDim || r != m_dR || n != m_dN) {
+        m_iDim = dim;
+        m_dR = r;
+        m_dN = n;
+        reset();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void EntropyEngine::setOverlap(int overlap)
+{
+    if(overlap != m_iOverlap) {
+        m_iOverlap = overlap;
+        reset();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void EntropyEngine::reset()
+{
+    for(int i = 0; i < m_vecCache.size(); ++i) {
+        m_vecCache[i] = ChannelCache();
+    }
+}
+
+
+//*************************************************************************************************************
+
+VectorXd EntropyEngine::fuzzyEn(const MatrixXd &data, const VectorXd &stdDev, const QList<int> &channels)
+{
+    if(m_vecCache.size() != data.rows()) {
+        m_vecCache.clear();
+        m_vecCache.resize(data.rows());
+    }
+
+    QVector<EntropyJob> jobs = prepareJobs(FuzzyEntropy, data, stdDev, channels, m_iDim, m_dR, 1);
+
+    for(int i = 0; i < jobs.size(); ++i) {
+        jobs[i].dN = m_dN;
+        jobs[i].iOverlap = m_iOverlap;
+        jobs[i].pCache = &m_vecCache[channels[i]];
+    }
+
+    QtConcurrent::blockingMap(jobs, computeEntropyJob);
+
+    VectorXd result(jobs.size());
+
+    for(int i = 0; i < jobs.size(); ++i) {
+        result(i) = jobs[i].vecResult(0);
+    }
+
+    return result;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd EntropyEngine::sampleEn(const MatrixXd &data, const VectorXd &stdDev, const QList<int> &channels, int dim, double r) const
+{
+    QVector<EntropyJob> jobs = prepareJobs(SampleEntropy, data, stdDev, channels, dim, r, 1);
+    QtConcurrent::blockingMap(jobs, computeEntropyJob);
+
+    VectorXd result(jobs.size());
+
+    for(int i = 0; i < jobs.size(); ++i) {
+        result(i) = jobs[i].vecResult(0);
+    }
+
+    return result;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd EntropyEngine::approximateEn(const MatrixXd &data, const VectorXd &stdDev, const QList<int> &channels, int dim, double r) const
+{
+    QVector<EntropyJob> jobs = prepareJobs(ApproximateEntropy, data, stdDev, channels, dim, r, 1);
+    QtConcurrent::blockingMap(jobs, computeEntropyJob);
+
+    VectorXd result(jobs.size());
+
+    for(int i = 0; i < jobs.size(); ++i) {
+        result(i) = jobs[i].vecResult(0);
+    }
+
+    return result;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd EntropyEngine::multiscaleEn(const MatrixXd &data, const VectorXd &stdDev, const QList<int> &channels, int dim, double r,
+                                     int maxScale) const
+{
+    QVector<EntropyJob> jobs = prepareJobs(MultiscaleEntropy, data, stdDev, channels, dim, r, maxScale);
+    QtConcurrent::blockingMap(jobs, computeEntropyJob);
+
+    MatrixXd result(jobs.size(), maxScale);
+
+    for(int i = 0; i < jobs.size(); ++i) {
+        result.row(i) = jobs[i].vecResult.transpose();
+    }
+
+    return result;
+}
+
+
+//*************************************************************************************************************
+
+QVector<EntropyEngine::EntropyJob> EntropyEngine::prepareJobs(EntropyType type, const MatrixXd &data, const VectorXd &stdDev,
+                                                              const QList<int> &channels, int dim, double r, int maxScale)
+{
+    QVector<EntropyJob> jobs(channels.size());
+
+    for(int i = 0; i < channels.size(); ++i) {
+        jobs[i].type = type;
+        jobs[i].data = data.row(channels[i]);
+        jobs[i].dStdDev = stdDev(channels[i]);
+        jobs[i].iDim = dim;
+        jobs[i].dR = r;
+        jobs[i].dN = 0.0;
+        jobs[i].iOverlap = 0;
+        jobs[i].iMaxScale = maxScale;
+        jobs[i].pCache = 0;
+    }
+
+    return jobs;
+}
+
+
+//*************************************************************************************************************
+
+void EntropyEngine::computeEntropyJob(EntropyJob &job)
+{
+    switch(job.type) {
+        case FuzzyEntropy:
+            job.vecResult.resize(1);
+            computeFuzzyEnJob(job);
+            break;
+
+        case SampleEntropy:
+            job.vecResult = VectorXd::Constant(1, sampleEn(job.data, job.iDim, job.dR, job.dStdDev));
+            break;
+
+        case ApproximateEntropy:
+            job.vecResult = VectorXd::Constant(1, approximateEn(job.data, job.iDim, job.dR, job.dStdDev));
+            break;
+
+        case MultiscaleEntropy:
+            job.vecResult = multiscaleEn(job.data, job.iDim, job.dR, job.iMaxScale, job.dStdDev);
+            break;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void EntropyEngine::computeFuzzyEnJob(EntropyJob &job)
+{
+    ChannelCache& cache = *job.pCache;
+
+    int length = job.data.cols();
+    int m = job.iDim;
+    int overlap = job.iOverlap;
+
+    if(overlap <= 0) {
+        job.vecResult(0) = fuzzyEn(job.data, m, job.dR, job.dN, job.dStdDev);
+        return;
+    }
+
+    if(length < m + 3) {
+        cache.bValid = false;
+        job.vecResult(0) = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+
+    //The stream is normalized like its first window, so the similarities within the overlap stay the same
+    if(!(cache.dStdDev > 0.0)) {
+        cache.dStdDev = job.dStdDev;
+        cache.bValid = false;
+    }
+
+    //The overlap can only be kept for the next window if it does not reach into the reused part
+    bool bKeepTail = 2 * overlap <= length;
+
+    //Reuse the pairs within the overlap if this window continues the previous one
+    bool bReuse = bKeepTail
+                  && cache.bValid
+                  && cache.vecTail.cols() == overlap
+                  && job.data.head(overlap) == cache.vecTail;
+
+    double sum[2], sumTail[2];
+    fuzzySimilaritySums(job.data, m, job.dR, job.dN, cache.dStdDev, bReuse ? overlap : 0, bKeepTail ? overlap : 0, sum, sumTail);
+
+    if(bReuse) {
+        sum[0] += cache.dSumTail[0];
+        sum[1] += cache.dSumTail[1];
+    }
+
+    if(bKeepTail) {
+        cache.bValid = true;
+        cache.vecTail = job.data.tail(overlap);
+        cache.dSumTail[0] = sumTail[0];
+        cache.dSumTail[1] = sumTail[1];
+    } else {
+        cache.bValid = false;
+    }
+
+    //Every pair was visited once, the similarity matrix is symmetric
+    double phi0 = 2.0 * sum[0] / ((length - m - 1) * (length - m));
+    double phi1 = 2.0 * sum[1] / ((length - m - 2) * (length - m - 1));
+
+    job.vecResult(0) = log(phi0) - log(phi1);
+}
+
+
+//*************************************************************************************************************
+
+void EntropyEngine::fuzzySimilaritySums(const RowVectorXd &data, int m, double r, double n, double stdDev,
+                                        int iOverlap, int iTail, double *pSum, double *pSumTail)
+{
+    int length = data.cols();
+    double scale = 1.0 / stdDev;
+
+    pSum[0] = pSum[1] = 0.0;
+    pSumTail[0] = pSumTail[1] = 0.0;
+
+    ArrayXd diff, sum, max, min, dist;
+
+    for(int k = 1; k <= length - m; ++k) {
+        //Patterns of length m start at i = 0..length-m-k for this lag, the ones of length m+1 end one earlier
+        int numM = length - m - k + 1;
+        int numM1 = numM - 1;
+
+        //Pairs (i,i+k) whose later pattern ends within the overlap are already known
+        int startM = qMax(0, iOverlap - m + 1 - k);
+        int startM1 = qMax(0, iOverlap - m - k);
+        int tailStart = length - iTail;
+
+        if(startM1 >= numM) {
+            continue;
+        }
+
+        int count = numM - startM1;
+
+        diff = data.segment(startM1, length - k - startM1).array() - data.segment(startM1 + k, length - k - startM1).array();
+
+        //Chebyshev distance of the baseline-removed patterns: max(|e - mean(e)|) over the pattern
+        sum = diff.head(count);
+        max = sum;
+        min = sum;
+
+        for(int t = 1; t < m; ++t) {
+            sum += diff.segment(t, count);
+            max = max.max(diff.segment(t, count));
+            min = min.min(diff.segment(t, count));
+        }
+
+        dist = (max - sum / m).max(sum / m - min);
+        fuzzySimilarity(dist, scale, r, n);
+
+        if(startM < numM) {
+            pSum[0] += dist.tail(numM - startM).sum();
+        }
+        if(iTail > 0 && tailStart < numM) {
+            pSumTail[0] += dist.tail(numM - qMax(tailStart, startM1)).sum();
+        }
+
+        //Extend the patterns by one sample
+        int countM1 = numM1 - startM1;
+
+        if(countM1 > 0) {
+            sum.conservativeResize(countM1);
+            max.conservativeResize(countM1);
+            min.conservativeResize(countM1);
+
+            sum += diff.segment(m, countM1);
+            max = max.max(diff.segment(m, countM1));
+            min = min.min(diff.segment(m, countM1));
+
+            dist = (max - sum / (m + 1)).max(sum / (m + 1) - min);
+            fuzzySimilarity(dist, scale, r, n);
+
+            pSum[1] += dist.sum();
+            if(iTail > 0 && tailStart < numM1) {
+                pSumTail[1] += dist.tail(numM1 - qMax(tailStart, startM1)).sum();
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+double EntropyEngine::fuzzyEn(const RowVectorXd &data, int dim, double r, double n, double stdDev)
+{
+    int length = data.cols();
+
+    if(length < dim + 3) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double sum[2], sumTail[2];
+    fuzzySimilaritySums(data, dim, r, n, stdDev, 0, 0, sum, sumTail);
+
+    double phi0 = 2.0 * sum[0] / ((length - dim - 1) * (length - dim));
+    double phi1 = 2.0 * sum[1] / ((length - dim - 2) * (length - dim - 1));
+
+    return log(phi0) - log(phi1);
+}
+
+
+//*************************************************************************************************************
+
+double EntropyEngine::sampleEn(const RowVectorXd &data, int dim, double r, double stdDev)
+{
+    int length = data.cols();
+    double tolerance = r * stdDev;
+    double matchesM = 0.0, matchesM1 = 0.0;
+
+    ArrayXd diff, dist;
+
+    //The length-dim-1 first patterns are used for both lengths
+    for(int k = 1; k < length - dim; ++k) {
+        int count = length - dim - k;
+
+        diff = (data.head(length - k).array() - data.tail(length - k).array()).abs();
+
+        dist = diff.head(count);
+        for(int t = 1; t < dim; ++t) {
+            dist = dist.max(diff.segment(t, count));
+        }
+        matchesM += (dist <= tolerance).count();
+
+        dist = dist.max(diff.segment(dim, count));
+        matchesM1 += (dist <= tolerance).count();
+    }
+
+    return -log(matchesM1 / matchesM);
+}
+
+
+//*************************************************************************************************************
+
+double EntropyEngine::approximateEn(const RowVectorXd &data, int dim, double r, double stdDev)
+{
+    int length = data.cols();
+    int numM = length - dim + 1;
+    int numM1 = length - dim;
+
+    if(numM1 < 1) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    double tolerance = r * stdDev;
+
+    //Every pattern matches itself
+    ArrayXd countM = ArrayXd::Ones(numM);
+    ArrayXd countM1 = ArrayXd::Ones(numM1);
+
+    ArrayXd diff, dist, match;
+
+    for(int k = 1; k <= length - dim; ++k) {
+        int count = length - dim - k + 1;
+
+        diff = (data.head(length - k).array() - data.tail(length - k).array()).abs();
+
+        dist = diff.head(count);
+        for(int t = 1; t < dim; ++t) {
+            dist = dist.max(diff.segment(t, count));
+        }
+
+        match = (dist <= tolerance).cast<double>();
+        countM.head(count) += match;
+        countM.segment(k, count) += match;
+
+        if(count > 1) {
+            dist = dist.head(count - 1).max(diff.segment(dim, count - 1)).eval();
+            match = (dist <= tolerance).cast<double>();
+            countM1.head(count - 1) += match;
+            countM1.segment(k, count - 1) += match;
+        }
+    }
+
+    return (countM / numM).log().mean() - (countM1 / numM1).log().mean();
+}
+
+
+//*************************************************************************************************************
+
+VectorXd EntropyEngine::multiscaleEn(const RowVectorXd &data, int dim, double r, int maxScale, double stdDev)
+{
+    VectorXd entropy(maxScale);
+
+    for(int scale = 1; scale <= maxScale; ++scale) {
+        int length = data.cols() / scale;
+
+        //Coarse-grain by averaging non-overlapping segments of the given scale
+        RowVectorXd coarse = Map<const MatrixXd>(data.data(), scale, length).colwise().mean();
+
+        entropy(scale - 1) = sampleEn(coarse, dim, r, stdDev);
+    }
+
+    return entropy;
+}
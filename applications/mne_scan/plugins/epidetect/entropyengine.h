@@ -0,0 +1,305 @@
+//=============================================================================================================
+/**
+* @file     entropyengine.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    EntropyEngine class declaration.
+*
+*/
+
+#ifndef ENTROPYENGINE_H
+#define ENTROPYENGINE_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QList>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS EntropyEngine
+*
+* @brief Computes fuzzy, sample, approximate and multiscale entropy of time series.
+*
+* All variants compare the embedded patterns lag by lag: for a lag k the Chebyshev distances of all pattern
+* pairs (i, i+k) follow from the difference series x(t)-x(t+k) with a few vectorized min/max operations, and
+* every pair is visited only once.
+*
+* Consecutive windows of a stream which overlap share the pattern pairs within the overlap. The fuzzy entropy
+* keeps their similarity sums per channel and only evaluates the pairs touching new samples. This is exact
+* because every channel is normalized once per stream, with the standard deviation of its first window.
+*/
+
+class EntropyEngine
+{
+
+public:
+    typedef QSharedPointer<EntropyEngine> SPtr;            /**< Shared pointer type for EntropyEngine. */
+    typedef QSharedPointer<const EntropyEngine> ConstSPtr; /**< Const shared pointer type for EntropyEngine. */
+
+    //=========================================================================================================
+    /**
+    * Constructs an EntropyEngine object.
+    */
+    EntropyEngine();
+
+    //=========================================================================================================
+    /**
+    * Sets the fuzzy entropy parameters. Changing them starts a new stream.
+    *
+    * @param [in] dim embedding dimension of fuzzy entropy.
+    * @param [in] r width of fuzzy exponential function.
+    * @param [in] n step of fuzzy exponential function.
+    */
+    void setParameters(int dim, double r, double n);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of samples by which consecutive windows overlap. The leading samples of a window are
+    * compared with the trailing samples of the previous one, so a window which does not continue the previous
+    * one is computed from scratch. Overlaps of more than half a window are not reused. Changing the overlap
+    * starts a new stream.
+    *
+    * @param [in] overlap number of overlapping samples, 0 disables the reuse and the stream normalization.
+    */
+    void setOverlap(int overlap);
+
+    //=========================================================================================================
+    /**
+    * Starts a new stream: drops the cached overlaps and the per stream normalization of all channels.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Calculates the fuzzy entropy for the given channels in parallel and reuses the overlap with the previous
+    * window where possible.
+    *
+    * @param [in] data matrix containing the current window (channels x samples).
+    * @param [in] stdDev standard deviation of each channel. With an overlap it only normalizes the first window
+    *                    of a stream, all later windows of the channel are normalized the same way.
+    * @param [in] channels indices of the channels to calculate.
+    *
+    * @return the fuzzy entropy of the requested channels, in the order of channels.
+    */
+    Eigen::VectorXd fuzzyEn(const Eigen::MatrixXd &data, const Eigen::VectorXd &stdDev, const QList<int> &channels);
+
+    //=========================================================================================================
+    /**
+    * Calculates the sample entropy for the given channels in parallel.
+    *
+    * @param [in] data matrix containing the current window (channels x samples).
+    * @param [in] stdDev standard deviation of each channel, used to scale the tolerance.
+    * @param [in] channels indices of the channels to calculate.
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to the standard deviation.
+    *
+    * @return the sample entropy of the requested channels, in the order of channels.
+    */
+    Eigen::VectorXd sampleEn(const Eigen::MatrixXd &data, const Eigen::VectorXd &stdDev, const QList<int> &channels,
+                             int dim, double r) const;
+
+    //=========================================================================================================
+    /**
+    * Calculates the approximate entropy for the given channels in parallel.
+    *
+    * @param [in] data matrix containing the current window (channels x samples).
+    * @param [in] stdDev standard deviation of each channel, used to scale the tolerance.
+    * @param [in] channels indices of the channels to calculate.
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to the standard deviation.
+    *
+    * @return the approximate entropy of the requested channels, in the order of channels.
+    */
+    Eigen::VectorXd approximateEn(const Eigen::MatrixXd &data, const Eigen::VectorXd &stdDev, const QList<int> &channels,
+                                  int dim, double r) const;
+
+    //=========================================================================================================
+    /**
+    * Calculates the multiscale entropy for the given channels in parallel.
+    *
+    * @param [in] data matrix containing the current window (channels x samples).
+    * @param [in] stdDev standard deviation of each channel, used to scale the tolerance.
+    * @param [in] channels indices of the channels to calculate.
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to the standard deviation.
+    * @param [in] maxScale largest coarse-graining scale.
+    *
+    * @return the sample entropy for the scales 1 to maxScale (columns) of the requested channels (rows).
+    */
+    Eigen::MatrixXd multiscaleEn(const Eigen::MatrixXd &data, const Eigen::VectorXd &stdDev, const QList<int> &channels,
+                                 int dim, double r, int maxScale) const;
+
+    //=========================================================================================================
+    /**
+    * Calculates the fuzzy entropy of a time series.
+    *
+    * @param [in] data the time series.
+    * @param [in] dim embedding dimension.
+    * @param [in] r width of fuzzy exponential function.
+    * @param [in] n step of fuzzy exponential function.
+    * @param [in] stdDev standard deviation used to normalize the data.
+    *
+    * @return the fuzzy entropy.
+    */
+    static double fuzzyEn(const Eigen::RowVectorXd &data, int dim, double r, double n, double stdDev);
+
+    //=========================================================================================================
+    /**
+    * Calculates the sample entropy of a time series (self-matches excluded).
+    *
+    * @param [in] data the time series.
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to stdDev.
+    * @param [in] stdDev standard deviation used to scale the tolerance.
+    *
+    * @return the sample entropy, infinite if no pattern of length dim+1 matches.
+    */
+    static double sampleEn(const Eigen::RowVectorXd &data, int dim, double r, double stdDev);
+
+    //=========================================================================================================
+    /**
+    * Calculates the approximate entropy of a time series (self-matches included).
+    *
+    * @param [in] data the time series.
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to stdDev.
+    * @param [in] stdDev standard deviation used to scale the tolerance.
+    *
+    * @return the approximate entropy.
+    */
+    static double approximateEn(const Eigen::RowVectorXd &data, int dim, double r, double stdDev);
+
+    //=========================================================================================================
+    /**
+    * Calculates the multiscale entropy, i.e. the sample entropy of the coarse-grained series for the scales
+    * 1 to maxScale. The tolerance stays relative to the standard deviation of the original series.
+    *
+    * @param [in] data the time series.
+    * @param [in] dim embedding dimension.
+    * @param [in] r tolerance relative to stdDev.
+    * @param [in] maxScale largest coarse-graining scale.
+    * @param [in] stdDev standard deviation used to scale the tolerance.
+    *
+    * @return the sample entropy for every scale.
+    */
+    static Eigen::VectorXd multiscaleEn(const Eigen::RowVectorXd &data, int dim, double r, int maxScale, double stdDev);
+
+private:
+    //=========================================================================================================
+    /**
+    * Stream state of a channel.
+    */
+    struct ChannelCache {
+        ChannelCache() : bValid(false), dStdDev(0.0) { dSumTail[0] = dSumTail[1] = 0.0; }
+
+        bool                bValid;         /**< True if the cache holds the overlap of the previous window of the channel.*/
+        double              dStdDev;        /**< Standard deviation which normalizes the stream, 0 if the stream has not started.*/
+        Eigen::RowVectorXd  vecTail;        /**< Trailing samples of the previous window.*/
+        double              dSumTail[2];    /**< Similarity sums of all pattern pairs within vecTail, for dim and dim+1.*/
+    };
+
+    //=========================================================================================================
+    /**
+    * The entropy variants calculated by EntropyJob.
+    */
+    enum EntropyType {
+        FuzzyEntropy,
+        SampleEntropy,
+        ApproximateEntropy,
+        MultiscaleEntropy
+    };
+
+    //=========================================================================================================
+    /**
+    * Work item of the parallel entropy calculation of one channel.
+    */
+    struct EntropyJob {
+        EntropyType         type;           /**< The entropy variant.*/
+        Eigen::RowVectorXd  data;           /**< The time series of the channel.*/
+        double              dStdDev;        /**< Standard deviation of the channel.*/
+        int                 iDim;           /**< Embedding dimension.*/
+        double              dR;             /**< Width of fuzzy exponential function or tolerance.*/
+        double              dN;             /**< Step of fuzzy exponential function.*/
+        int                 iOverlap;       /**< Overlap with the previous window, fuzzy entropy only.*/
+        int                 iMaxScale;      /**< Largest coarse-graining scale, multiscale entropy only.*/
+        ChannelCache*       pCache;         /**< Stream state of the channel, fuzzy entropy only.*/
+        Eigen::VectorXd     vecResult;      /**< The entropy, one value per scale for multiscale entropy.*/
+    };
+
+    static void computeEntropyJob(EntropyJob &job);
+
+    static void computeFuzzyEnJob(EntropyJob &job);
+
+    //=========================================================================================================
+    /**
+    * Prepares one job per channel, without stream state.
+    */
+    static QVector<EntropyJob> prepareJobs(EntropyType type, const Eigen::MatrixXd &data, const Eigen::VectorXd &stdDev,
+                                           const QList<int> &channels, int dim, double r, int maxScale);
+
+    //=========================================================================================================
+    /**
+    * Sums the fuzzy similarities of the pattern pairs (i,j), i<j, of length m and m+1. Pairs which lie
+    * completely in the first iOverlap samples are skipped, the sums of the pairs which lie completely in the
+    * last iTail samples are additionally returned in pSumTail.
+    */
+    static void fuzzySimilaritySums(const Eigen::RowVectorXd &data, int m, double r, double n, double stdDev,
+                                    int iOverlap, int iTail, double *pSum, double *pSumTail);
+
+    int                     m_iDim;             /**< Embedding dimension.*/
+    double                  m_dR;               /**< Width of fuzzy exponential function.*/
+    double                  m_dN;               /**< Step of fuzzy exponential function.*/
+    int                     m_iOverlap;         /**< Overlap of consecutive windows in samples.*/
+
+    QVector<ChannelCache>   m_vecCache;         /**< Stream state per channel.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+
+#endif // ENTROPYENGINE_H
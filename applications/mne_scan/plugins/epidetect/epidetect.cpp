@@ -78,7 +78,7 @@ Epidetect::Epidetect()
     m_dThreshold1 = 0.75;
     m_dThreshold2 = 0.6;
     m_iListLength = 20;
-    m_iFuzzyEnStep = 12;
+    m_iFuzzyEnStep = 1;
     m_iChWeight = 15;
 }
 
@@ -336,7 +336,7 @@ void Epidetect::run()
 
         calculator.m_iListLength = m_iListLength;
         calculator.m_iFuzzyEnStep = m_iFuzzyEnStep;
-        calculator.calcAll(window, m_iDim, m_dR , m_iN);
+        calculator.calcAll(window, m_iDim, m_dR , m_iN, firstHalfTrimmed.cols());
         MatrixXd mu;
         MatrixXd p2pHistory =calculator.getP2PHistory();
         MatrixXd kurtosisHistory = calculator.getKurtosisHistory();
@@ -72,6 +72,7 @@ SOURCES += \
         FormFiles/epidetectaboutwidget.cpp \
         FormFiles/epidetectwidget.cpp \
         calcmetric.cpp \
+        entropyengine.cpp \
         fuzzymembership.cpp
 
 HEADERS += \
@@ -81,6 +82,7 @@ HEADERS += \
         FormFiles/epidetectaboutwidget.h \
         FormFiles/epidetectwidget.h \
         calcmetric.h \
+        entropyengine.h \
         fuzzymembership.h
 
 FORMS += \
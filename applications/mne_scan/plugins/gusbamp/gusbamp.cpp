@@ -86,6 +86,10 @@ GUSBAmp::GUSBAmp()
     m_vSerials.resize(1);
     m_vSerials[0]= "UB-2015.05.16";
 
+    //The recorder writes to disk on its own thread
+    m_pRawRecorder = FIFFLIB::FiffRawRecorder::SPtr(new FIFFLIB::FiffRawRecorder());
+    m_pRawWriter = FIFFLIB::FiffRollingRawWriter::SPtr(new FIFFLIB::FiffRollingRawWriter());
+
     // Create record file option action bar item/button
     m_pActionSetupProject = new QAction(QIcon(":/images/database.png"), tr("Setup project"), this);
     m_pActionSetupProject->setStatusTip(tr("Setup project"));
@@ -210,7 +214,6 @@ QSharedPointer<IPlugin> GUSBAmp::clone() const
 void GUSBAmp::init()
 {
     m_iSplitFileSizeMs = 10;
-    m_iSplitCount = 0;
     m_bSplitFile = false;
 
     QDate date;
@@ -332,8 +335,6 @@ QWidget* GUSBAmp::setupWidget()
 
 void GUSBAmp::run()
 {
-    qint32 size = 0;
-
     //get Matrix from the producer
     while(m_bIsRunning)
     {
@@ -352,60 +353,16 @@ void GUSBAmp::run()
             m_pRTMSA_GUSBAmp->data()->setValue(matValue_show.cast<double>());
             qDebug() << "PUSH!";
 
-            //Write raw data to fif file
+            //Write raw data to fif file. The recorder only queues the data, the disk is accessed on its own thread.
             if(m_bWriteToFile)
             {
-                m_pOutfid->write_raw_buffer(matValue.cast<double>(), m_cals);
-                size += matValue.cols();
-
-                //                qDebug()<<"size"<<size;
-                //                qDebug()<<"(m_iSplitFileSizeMs/1000)*m_pFiffInfo->sfreq"<<(double(m_iSplitFileSizeMs)/1000.0)*m_pFiffInfo->sfreq;
-                if(size > (double(m_iSplitFileSizeMs)/1000.0)*m_pFiffInfo->sfreq && m_bSplitFile)
-                {
-                    size = 0;
-                    splitRecordingFile();
-                }
+                m_pRawRecorder->write(matValue);
             }
-            else
-                size = 0;
         }
     }
 }
 
 
-//*************************************************************************************************************
-
-void GUSBAmp::splitRecordingFile()
-{
-    qDebug() << "Split recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sOutputFilePath.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    /*
-    * Write the link to the next file
-    */
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_fileOut.setFileName(nextFileName);
-    m_pOutfid = Fiff::start_writing_raw(m_fileOut, *m_pFiffInfo, m_cals);
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-}
-
-
 //*************************************************************************************************************
 
 void GUSBAmp::showSetupProjectDialog()
@@ -428,13 +385,13 @@ void GUSBAmp::showSetupProjectDialog()
 
 void GUSBAmp::showStartRecording()
 {
-    m_iSplitCount = 0;
-
     //Setup writing to file
     if(m_bWriteToFile)
     {
-        m_pOutfid->finish_writing_raw();
+        //Write all queued data before finishing the file
         m_bWriteToFile = false;
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
         m_pTimerRecordingChange->stop();
         m_pActionStartRecording->setIcon(QIcon(":/images/record.png"));
     }
@@ -480,9 +437,14 @@ void GUSBAmp::showStartRecording()
             dir.mkpath(fileDir);
         }
 
-        m_pOutfid = Fiff::start_writing_raw(m_fileOut, *m_pFiffInfo, m_cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        //Split the file after m_iSplitFileSizeMs of samples
+        m_pRawWriter->setMaxFileDuration(m_bSplitFile ? double(m_iSplitFileSizeMs)/1000.0 : 0.0);
+
+        if(!m_pRawWriter->start(m_sOutputFilePath, *m_pFiffInfo, m_cals)) {
+            return;
+        }
+
+        m_pRawRecorder->startRecording(m_pRawWriter, m_cals);
 
         m_bWriteToFile = true;
 
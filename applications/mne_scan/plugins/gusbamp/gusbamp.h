@@ -48,6 +48,7 @@
 #include <utils/generics/circularmatrixbuffer.h>
 #include <scMeas/newrealtimemultisamplearray.h>
 #include <fiff/fiff.h>
+#include <fiff/fiff_raw_recorder.h>
 
 #include "FormFiles/gusbampsetupwidget.h"
 #include "FormFiles/gusbampsetupprojectwidget.h"
@@ -185,12 +186,6 @@ public:
     */
     virtual QWidget* setupWidget();
 
-    //=========================================================================================================
-    /**
-    * splits the recorded FIFF file
-    */
-    void splitRecordingFile();
-
 protected:
     //=========================================================================================================
     /**
@@ -218,11 +213,11 @@ private:
     std::vector<int>            m_viSizeOfSampleMatrix;     /**< vector including the size of the two dimensional sample Matrix */
     std::vector<int>            m_viChannelsToAcquire;      /**< vector of the calling numbers of the channels to be acquired */
     bool                        m_bWriteToFile;             /**< Flag for File writing*/
-    FIFFLIB::FiffStream::SPtr   m_pOutfid;                  /**< QFile for writing to fif file.*/
+    FIFFLIB::FiffRollingRawWriter::SPtr m_pRawWriter;       /**< Writes the recording to one or more fif files.*/
+    FIFFLIB::FiffRawRecorder::SPtr m_pRawRecorder;          /**< Writes the raw data to m_pRawWriter on its own thread.*/
     Eigen::RowVectorXd          m_cals;
     bool                        m_bSplitFile;               /**< Flag for splitting the recorded file.*/
     int                         m_iSplitFileSizeMs;         /**< Holds the size of the splitted files in ms.*/
-    int                         m_iSplitCount;              /**< File split count */
     QString                     m_sOutputFilePath;          /**< Holds the path for the sample output file. Defined by the user via the GUI.*/
     QFile                       m_fileOut;                  /**< QFile for writing to fiff file.*/
     QSharedPointer<QTimer>      m_pTimerRecordingChange;    /**< timer to control blinking of the recording icon */
@@ -98,6 +98,11 @@ Neuromag::Neuromag()
 , m_bWriteToFile(false)
 , m_iRecordingMSeconds(5*60*1000)
 {
+    //The recorder writes to disk on its own thread, the writer splits the file when it gets too large
+    m_pRawRecorder = FiffRawRecorder::SPtr(new FiffRawRecorder());
+    m_pRawWriter = FiffRollingRawWriter::SPtr(new FiffRollingRawWriter());
+    m_pRawWriter->setMaxFileSize(MAX_DATA_LEN);
+
     m_pActionSetupProject = new QAction(QIcon(":/images/database.png"), tr("Setup Project"),this);
     m_pActionSetupProject->setStatusTip(tr("Setup Project"));
     connect(m_pActionSetupProject.data(), &QAction::triggered,
@@ -227,52 +232,17 @@ void Neuromag::showProjectDialog()
 }
 
 
-//*************************************************************************************************************
-
-void Neuromag::splitRecordingFile()
-{
-    qDebug() << "Neuromag::splitRecordingFile - Splitting recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sRecordFile.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    // Write the link to the next file
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_qFileOut.setFileName(nextFileName);
-    RowVectorXd cals;
-    m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                              *m_pFiffInfo,
-                                              cals);
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-}
-
-
 //*************************************************************************************************************
 
 void Neuromag::toggleRecordingFile()
 {
     //Setup writing to file
     if(m_bWriteToFile) {
-        m_mutex.lock();
-        m_pOutfid->finish_writing_raw();
-        m_mutex.unlock();
+        //Write all queued data before finishing the file
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
 
         m_bWriteToFile = false;
-        m_iSplitCount = 0;
 
         //Stop record timer
         m_pRecordTimer->stop();
@@ -281,8 +251,6 @@ void Neuromag::toggleRecordingFile()
 
         m_pActionRecordFile->setIcon(QIcon(":/images/record.png"));
     } else {
-        m_iSplitCount = 0;
-
         if(!m_pFiffInfo) {
             QMessageBox msgBox;
             msgBox.setText("FiffInfo missing!");
@@ -326,13 +294,17 @@ void Neuromag::toggleRecordingFile()
 
         m_mutex.lock();
         RowVectorXd cals;
-        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                                  *m_pFiffInfo,
-                                                  cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        bool bStarted = m_pRawWriter->start(m_sRecordFile,
+                                            *m_pFiffInfo,
+                                            cals);
         m_mutex.unlock();
 
+        if(!bStarted) {
+            return;
+        }
+
+        m_pRawRecorder->startRecording(m_pRawWriter);
+
         m_bWriteToFile = true;
 
         //Start timers for record button blinking, recording timer and updating the elapsed time in the proj widget
@@ -652,29 +624,14 @@ void Neuromag::run()
 {
     MatrixXf matValue;
 
-    qint32 size = 0;
-
     while(m_bIsRunning) {
         if(m_pRawMatrixBuffer_In) {
             //pop matrix
             matValue = m_pRawMatrixBuffer_In->pop();
 
-            //Write raw data to fif file
+            //Write raw data to fif file. The recorder only queues the data, the disk is accessed on its own thread.
             if(m_bWriteToFile) {
-                size += matValue.rows()*matValue.cols() * 4;
-
-                if(size > MAX_DATA_LEN) {
-                    size = 0;
-                    this->splitRecordingFile();
-                }
-
-                m_mutex.lock();
-                if(m_pOutfid) {
-                    m_pOutfid->write_raw_buffer(matValue.cast<double>());
-                }
-                m_mutex.unlock();
-            } else {
-                size = 0;
+                m_pRawRecorder->write(matValue);
             }
 
             if(m_pRTMSA_Neuromag) {
@@ -47,6 +47,7 @@
 
 #include <scShared/Interfaces/ISensor.h>
 #include <utils/generics/circularmatrixbuffer.h>
+#include <fiff/fiff_raw_recorder.h>
 
 
 //*************************************************************************************************************
@@ -181,12 +182,6 @@ public:
     */
     void showProjectDialog();
 
-    //=========================================================================================================
-    /**
-    * Determines current file. And starts a new one.
-    */
-    void splitRecordingFile();
-
     //=========================================================================================================
     /**
     * Starts or stops a file recording depending on the current recording state.
@@ -297,7 +292,8 @@ protected:
     QSharedPointer<QTimer>                              m_pBlinkingRecordButtonTimer;   /**< timer to control blinking recording button. */
     QSharedPointer<QTimer>                              m_pRecordTimer;                 /**< timer to control recording time. */
     QSharedPointer<DISPLIB::ProjectSettingsView>        m_pProjectSettingsView;         /**< Window to setup the recording tiem and fiel name. */
-    QSharedPointer<FIFFLIB::FiffStream>                 m_pOutfid;                      /**< FiffStream to write to.*/
+    QSharedPointer<FIFFLIB::FiffRollingRawWriter>       m_pRawWriter;                   /**< Writes the recording to one or more fif files.*/
+    QSharedPointer<FIFFLIB::FiffRawRecorder>            m_pRawRecorder;                 /**< Writes the raw data to m_pRawWriter on its own thread.*/
     QSharedPointer<FIFFLIB::FiffInfo>                   m_pFiffInfo;                    /**< Fiff measurement info.*/
     QSharedPointer<DISP3DLIB::HpiView>                  m_pHPIWidget;                   /**< HPI widget. */
 
@@ -318,7 +314,6 @@ protected:
     bool                                    m_bUseRecordTimer;              /**< Flag whether to use data recording timer.*/
 
     qint16                                  m_iBlinkStatus;                 /**< The blink status of the recording button.*/
-    qint32                                  m_iSplitCount;                  /**< File split count */
     qint32                                  m_iBufferSize;                  /**< The raw data buffer size.*/
     qint32                                  m_iActiveConnectorId;           /**< The active connector.*/
     int                                     m_iRecordingMSeconds;           /**< Recording length in mseconds.*/
@@ -59,7 +59,8 @@ contains(MNECPP_CONFIG, buildBasicMneScanVersion) {
         # eegosports \
         # brainamp \
         # tmsi \
-        natus
+        natus \
+        syntheticsource
 
     contains(MNECPP_CONFIG, useLSL) { SUBDIRS += lsladapter }
 
@@ -142,8 +142,22 @@ void RtHpi::unload()
 void RtHpi::initConnector()
 {
     qDebug() << "void RtHpi::initConnector()";
-    if(m_pFiffInfo)
+    if(m_pFiffInfo) {
         m_pRTMSAOutput->data()->initFromFiffInfo(m_pFiffInfo);
+        m_pRTMSAOutput->data()->setMultiArraySize(1);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtHpi::onNewFittingResultAvailable(const RTPROCESSINGLIB::FittingResult &fitResult)
+{
+    if(fitResult.devHeadTrans.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_qMutex);
+    m_pFiffInfo->dev_head_t = fitResult.devHeadTrans;
 }
 
 
@@ -276,11 +290,21 @@ void RtHpi::run()
 
     m_pRtHPIS = RtHPIS::SPtr(new RtHPIS(m_pFiffInfo));
 
+    //The results are emitted from within this thread, see processEvents below
+    connect(m_pRtHPIS.data(), &RtHPIS::newFittingResultAvailable,
+            this, &RtHpi::onNewFittingResultAvailable, Qt::DirectConnection);
+
     while (m_bIsRunning) {
         if(m_bProcessData) {
             MatrixXd t_mat = m_pRtHpiBuffer->pop();
             m_pRtHPIS->append(t_mat);
+
+            //Pass the data on, e.g. to RtSss which follows the head position in the measurement info
+            m_pRTMSAOutput->data()->setValue(t_mat);
         }
+
+        //This thread has no event loop, deliver the queued results of the HPI worker
+        QCoreApplication::processEvents();
         //msleep(1);
     }
     qDebug()<<"HPI estimation [Run] is done!";
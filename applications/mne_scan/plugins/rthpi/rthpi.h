@@ -160,6 +160,15 @@ private:
     */
     void initConnector();
 
+    //=========================================================================================================
+    /**
+    * Stores the fitted device to head transformation in the measurement info, which is shared with the
+    * downstream plugins.
+    *
+    * @param[in] fitResult  The result of the latest HPI fit.
+    */
+    void onNewFittingResultAvailable(const RTPROCESSINGLIB::FittingResult &fitResult);
+
     PluginInputData<RealTimeMultiSampleArray>::SPtr   m_pRTMSAInput;      /**< The RealTimeMultiSampleArray of the RtHpi input.*/
     PluginOutputData<RealTimeMultiSampleArray>::SPtr  m_pRTMSAOutput;    /**< The RealTimeMultiSampleArray of the RtHpi output.*/
 
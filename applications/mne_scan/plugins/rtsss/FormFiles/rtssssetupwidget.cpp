@@ -78,6 +78,10 @@ RtSssSetupWidget::RtSssSetupWidget(RtSss* toolbox, QWidget *parent)
     connect(ui.m_qSpinBox_LoutRR, SIGNAL(valueChanged (int)), this, SLOT(setNewLoutRR(int)));
     connect(ui.m_qSpinBox_Lin, SIGNAL(valueChanged (int)), this, SLOT(setNewLin(int)));
     connect(ui.m_qSpinBox_Lout, SIGNAL(valueChanged (int)), this, SLOT(setNewLout(int)));
+
+    connect(ui.m_qGroupBox_TSSS, &QGroupBox::toggled, this, &RtSssSetupWidget::signalNewTSSS);
+    connect(ui.m_qDoubleSpinBox_TSSSWindow, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &RtSssSetupWidget::signalNewTSSSWindow);
+    connect(ui.m_qDoubleSpinBox_TSSSCorrLimit, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), this, &RtSssSetupWidget::signalNewTSSSCorrLimit);
 }
 
 
@@ -138,6 +142,21 @@ int RtSssSetupWidget::getLout()
     return ui.m_qSpinBox_Lout->value();
 }
 
+bool RtSssSetupWidget::getTSSS()
+{
+    return ui.m_qGroupBox_TSSS->isChecked();
+}
+
+double RtSssSetupWidget::getTSSSWindow()
+{
+    return ui.m_qDoubleSpinBox_TSSSWindow->value();
+}
+
+double RtSssSetupWidget::getTSSSCorrLimit()
+{
+    return ui.m_qDoubleSpinBox_TSSSCorrLimit->value();
+}
+
 
 //*************************************************************************************************************
 
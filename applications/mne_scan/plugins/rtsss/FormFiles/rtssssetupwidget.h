@@ -109,12 +109,18 @@ public:
     int getLoutRR();
     int getLin();
     int getLout();
+    bool getTSSS();
+    double getTSSSWindow();
+    double getTSSSCorrLimit();
 
 signals:
     void signalNewLinRR(int val);
     void signalNewLoutRR(int val);
     void signalNewLin(int val);
     void signalNewLout(int val);
+    void signalNewTSSS(bool val);
+    void signalNewTSSSWindow(double val);
+    void signalNewTSSSCorrLimit(double val);
 
 private slots:
     //=========================================================================================================
@@ -79,6 +79,9 @@ RtSss::RtSss()
 , LoutRR(0)
 , Lin(0)
 , Lout(0)
+, TSSS(false)
+, TSSSWindow(10.0)
+, TSSSCorrLimit(0.98)
 {
 }
 
@@ -216,11 +219,17 @@ QWidget* RtSss::setupWidget()
     connect(widget, &RtSssSetupWidget::signalNewLoutRR, this, &RtSss::setLoutRR);
     connect(widget, &RtSssSetupWidget::signalNewLin, this, &RtSss::setLin);
     connect(widget, &RtSssSetupWidget::signalNewLout, this, &RtSss::setLout);
+    connect(widget, &RtSssSetupWidget::signalNewTSSS, this, &RtSss::setTSSS);
+    connect(widget, &RtSssSetupWidget::signalNewTSSSWindow, this, &RtSss::setTSSSWindow);
+    connect(widget, &RtSssSetupWidget::signalNewTSSSCorrLimit, this, &RtSss::setTSSSCorrLimit);
 
     LinRR = widget->getLinRR();
     LoutRR = widget->getLoutRR();
     Lin = widget->getLin();
     Lout = widget->getLout();
+    TSSS = widget->getTSSS();
+    TSSSWindow = widget->getTSSSWindow();
+    TSSSCorrLimit = widget->getTSSSCorrLimit();
 
     return widget;
 }
@@ -262,6 +271,30 @@ void RtSss::setLout(int val)
 }
 
 
+//*************************************************************************************************************
+
+void RtSss::setTSSS(bool val)
+{
+    TSSS = val;
+}
+
+
+//*************************************************************************************************************
+
+void RtSss::setTSSSWindow(double val)
+{
+    TSSSWindow = val;
+}
+
+
+//*************************************************************************************************************
+
+void RtSss::setTSSSCorrLimit(double val)
+{
+    TSSSCorrLimit = val;
+}
+
+
 //*************************************************************************************************************
 
 void RtSss::update(SCMEASLIB::Measurement::SPtr pMeasurement)
@@ -401,6 +434,16 @@ void RtSss::run()
     qDebug() << "building an initial SSS linear equation .....";
     lineqn = rsss.buildLinearEqn();
 
+    // Temporal SSS works on a sliding window of the SSS moments, which starts empty
+    rsss.setTSSSParameter(qRound(TSSSWindow * m_pFiffInfo->sfreq), TSSSCorrLimit);
+
+    // The expansion origin stays fixed relative to the head, i.e. it follows the device to head
+    // transformation of the measurement info, which is updated by RtHpi
+    FiffCoordTrans devHeadT = m_pFiffInfo->dev_head_t;
+    Vector3d headOrigin = rsss.getOrigin();
+    if(!devHeadT.isEmpty())
+        headOrigin = (devHeadT.trans.cast<double>() * headOrigin.homogeneous()).head<3>();
+
     //qDebug() << "..finished !!";
 
     // start processing data
@@ -428,6 +471,18 @@ void RtSss::run()
 
         if(nrows > 0) // check if init
         {
+            // * Follow the head position * //
+            if(!m_pFiffInfo->dev_head_t.isEmpty() && (devHeadT.isEmpty() || m_pFiffInfo->dev_head_t.trans != devHeadT.trans))
+            {
+                if(devHeadT.isEmpty())
+                    headOrigin = (m_pFiffInfo->dev_head_t.trans.cast<double>() * headOrigin.homogeneous()).head<3>();
+
+                devHeadT = m_pFiffInfo->dev_head_t;
+
+                // small movements update the linear equation to first order, large ones rebuild it
+                rsss.moveOrigin((devHeadT.invtrans.cast<double>() * headOrigin.homogeneous()).head<3>());
+            }
+
             // * Dispatch the inputs * //
             MatrixXd in_mat = m_pRtSssBuffer->pop();
 //            qDebug() << "size of in_mat (run): " << in_mat.rows() << " x " << in_mat.cols();
@@ -449,7 +504,10 @@ void RtSss::run()
 //                }
 //            in_mat_used = in_mat.block(0,0,nmegchanused,in_mat.cols());
 
-           in_mat_used = rt_sss(in_mat_used);
+            if(TSSS)
+                in_mat_used = rsss.getTSSSRR(in_mat_used);
+            else
+                in_mat_used = rt_sss(in_mat_used);
 
             // Implement Concurrent mapreduced for parallel processing
             // divide the in_mat_used into 2 or 4 matrices, which renders 50ms or 25ms data
@@ -151,6 +151,9 @@ public:
     void setLoutRR(int);
     void setLin(int);
     void setLout(int);
+    void setTSSS(bool);
+    void setTSSSWindow(double);
+    void setTSSSCorrLimit(double);
 
 protected:
     virtual void run();
@@ -175,6 +178,10 @@ private:
 
     int LinRR, LoutRR, Lin, Lout;
 
+    bool TSSS;                  /**< If temporal SSS is applied after the spatial SSS. */
+    double TSSSWindow;          /**< Length of the tSSS sliding window in seconds. */
+    double TSSSCorrLimit;       /**< Subspace correlation limit of tSSS. */
+
     QMutex m_qMutex;
 
     //    dBuffer::SPtr   m_pRtSssBuffer;      /**< Holds incoming data.*/
@@ -50,6 +50,12 @@ RtSssAlgo::RtSssAlgo()
 , LOutRR(0)
 , LInOLS(0)
 , LOutOLS(0)
+, BasisLIn(0)
+, BasisLOut(0)
+, TSSSWinSize(0)
+, TSSSCorrLimit(0.98)
+, TSSSNumSamples(0)
+, TSSSNumExpired(0)
 {
 
 }
@@ -125,20 +131,7 @@ MatrixXd RtSssAlgo::buildLinearEqn()
     EqnA.resize(NumCoil, EqnIn.cols()+EqnOut.cols());
     EqnB.resize(NumCoil,1);
 
-    // Find out if coils are all gradiometers, all magnetometers, or both.
-    // When both gradiometers and magnetometers are used,
-    //      MagScale facor of 100 must be appiled to magnetomters.
-    float MagScale;
-    if ((0 < CoilGrad.sum()) && (CoilGrad.sum() < NumCoil))  MagScale = 100;
-    else MagScale = 1;
-
-    VectorXd CoilScale;
-    CoilScale.setOnes(NumCoil);
-    for(int i=0; i<NumCoil; i++)
-    {
-        if (CoilGrad(i) == 0) CoilScale(i) = MagScale;
-//        std::cout <<  "i=" << i << "CoilGrad: " << CoilGrad(i) << ",  CoilScale: " << CoilScale(i) << std::endl;
-    }
+    VectorXd CoilScale = getCoilScale();
 
     EqnARR << EqnInRR, EqnOutRR;
     EqnA << EqnIn, EqnOut;
@@ -160,6 +153,8 @@ MatrixXd RtSssAlgo::buildLinearEqn()
 //    LinEqn.append(EqnB);
     LinEqn.append(CoilScale.asDiagonal());
 
+    factorizeLinearEqn();
+
 
 //    std::cout << "EqnInRR *********************************" << endl << EqnInRR << endl << endl;
 //    std::cout << "EqnOutRR ********************************" << endl << EqnOutRR << endl << endl;
@@ -177,6 +172,26 @@ MatrixXd RtSssAlgo::buildLinearEqn()
     return CoilScale.asDiagonal();
 }
 
+VectorXd RtSssAlgo::getCoilScale()
+{
+    // Find out if coils are all gradiometers, all magnetometers, or both.
+    // When both gradiometers and magnetometers are used,
+    //      MagScale facor of 100 must be appiled to magnetomters.
+    float MagScale;
+    if ((0 < CoilGrad.sum()) && (CoilGrad.sum() < NumCoil))  MagScale = 100;
+    else MagScale = 1;
+
+    VectorXd CoilScale;
+    CoilScale.setOnes(NumCoil);
+    for(int i=0; i<NumCoil; i++)
+    {
+        if (CoilGrad(i) == 0) CoilScale(i) = MagScale;
+//        std::cout <<  "i=" << i << "CoilGrad: " << CoilGrad(i) << ",  CoilScale: " << CoilScale(i) << std::endl;
+    }
+
+    return CoilScale;
+}
+
 void RtSssAlgo::setSSSParameter(QList<int> expansionOrder)
 {
 //    LInRR = 5;
@@ -361,6 +376,8 @@ void RtSssAlgo::setMEGInfo(FiffInfo::SPtr fiffInfo, RowVectorXi pickedChannels)
         }
     }
 
+    // Coil geometry changed, the cached basis has to be rebuilt
+    CoilPts.resize(3,0);
 
     //qDebug() << "setMEGInfo END";
 
@@ -402,92 +419,228 @@ QList<MatrixXd> RtSssAlgo::getSSSEqn(qint32 LIn, qint32 LOut)
     //qDebug() << "getSSSEqn START";
 
     int NumBIn, NumBOut;
-//    int coil_index=1;
-    double RScale;
-    VectorXd coil_distance, coil_clocation(4,1), coil_vector(4,1);
-    MatrixXd coil_location;
-    MatrixXd EqnIn, EqnOut;
     QList<MatrixXd> Eqn;
 
-//    qint32 LIn,LOut;
-//    LIn = Lexp(0);
-//    LOut = Lexp(1);
-
     //  % initialization
     NumBIn = (LIn*LIn) + 2*LIn;
     NumBOut = (LOut*LOut) + 2*LOut;
 
-//% calculate scaling factor for distance
-    coil_distance.resize(NumCoil);
+//  % the basis functions of a lower expansion order are the leading columns of a higher one,
+//  % so the cached basis is reused as long as origin and geometry did not change
+    if(CoilPts.cols() == 0 || BasisOrigin != Origin || LIn > BasisLIn || LOut > BasisLOut)
+        updateSSSBasis(qMax(LIn, qMax(LInRR, LInOLS)), qMax(LOut, qMax(LOutRR, LOutOLS)));
 
+    Eqn.append(BasisIn.leftCols(NumBIn));
+    Eqn.append(BasisOut.leftCols(NumBOut));
+
+    //qDebug() << "getSSSEqn END";
+
+    return Eqn;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% collect the integration points of all coils in device coordinates
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% CoilPts(:,k):         location of the k-th integration point
+//% CoilCenters(:,i):     location of the i-th coil
+//% CoilIntX/Y/Z(i,k):    weight of the k-th point times the coil orientation,
+//%                       i.e. EqnIn = CoilIntX*BInX + CoilIntY*BInY + CoilIntZ*BInZ
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void RtSssAlgo::buildCoilGeometry()
+{
+    int NumPts = 0;
     for(int i = 0; i<NumCoil; i++)
+        NumPts += CoilNk(i);
+
+    CoilPts.resize(3,NumPts);
+    CoilCenters.resize(3,NumCoil);
+
+    QVector<Triplet<double> > tripletX, tripletY, tripletZ;
+    tripletX.reserve(NumPts);
+    tripletY.reserve(NumPts);
+    tripletZ.reserve(NumPts);
+
+    for(int i = 0, k = 0; i<NumCoil; i++)
     {
-        coil_clocation = CoilT[i].block(0,3,3,1);
-        coil_distance(i) = (coil_clocation-Origin).norm();
+        qint32 NumCoilPts = CoilNk(i);
+        Vector3d coil_vector = CoilT[i].block(0,2,3,1);
+
+        CoilCenters.col(i) = CoilT[i].block(0,3,3,1);
+        CoilPts.middleCols(k,NumCoilPts) = (CoilT[i].block(0,0,3,3) * CoilRk[i]).colwise() + CoilCenters.col(i);
+
+        for(int j = 0; j<NumCoilPts; j++, k++)
+        {
+            tripletX.append(Triplet<double>(i, k, CoilWk[i](0,j) * coil_vector(0)));
+            tripletY.append(Triplet<double>(i, k, CoilWk[i](0,j) * coil_vector(1)));
+            tripletZ.append(Triplet<double>(i, k, CoilWk[i](0,j) * coil_vector(2)));
+        }
     }
 
-    RScale = exp(coil_distance.array().log().mean());
+    CoilIntX.resize(NumCoil,NumPts);
+    CoilIntY.resize(NumCoil,NumPts);
+    CoilIntZ.resize(NumCoil,NumPts);
+    CoilIntX.setFromTriplets(tripletX.begin(), tripletX.end());
+    CoilIntY.setFromTriplets(tripletY.begin(), tripletY.end());
+    CoilIntZ.setFromTriplets(tripletZ.begin(), tripletZ.end());
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% evaluate the internal/external basis functions at all integration points at once
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void RtSssAlgo::updateSSSBasis(qint32 LIn, qint32 LOut)
+{
+    if(CoilPts.cols() == 0)
+        buildCoilGeometry();
+
+    evalSSSBasis(Origin, LIn, LOut, BasisIn, BasisOut);
+
+    BasisOrigin = Origin;
+    BasisLIn = LIn;
+    BasisLOut = LOut;
+
+//% the origin derivatives belong to the previous basis and are recomputed on demand
+    BasisInDeriv.clear();
+    BasisOutDeriv.clear();
+
+//% the tSSS window holds moments of the previous basis
+    resetTSSS();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% basis functions of all coils for the expansion origin BasisPos
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void RtSssAlgo::evalSSSBasis(const Vector3d &BasisPos, qint32 LIn, qint32 LOut, MatrixXd &In, MatrixXd &Out)
+{
+//% calculate scaling factor for distance
+    double RScale = exp((CoilCenters.colwise() - BasisPos).colwise().norm().array().log().mean());
+
+    MatrixXd coil_location = (CoilPts.colwise() - BasisPos) / RScale;
 
 //% build linear equation for internal/external basis functions
-    EqnIn.setZero(NumCoil,NumBIn);
-    EqnOut.setZero(NumCoil,NumBOut);
+    getSSSBasis(coil_location.row(0).transpose(), coil_location.row(1).transpose(), coil_location.row(2).transpose(), LIn, LOut);
 
-    for(int i = 0; i<NumCoil; i++)
+    In = CoilIntX * BInX + CoilIntY * BInY + CoilIntZ * BInZ;
+    Out = CoilIntX * BOutX + CoilIntY * BOutY + CoilIntZ * BOutZ;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% derivatives of the cached basis with respect to the origin coordinates
+//% -- central differences at BasisOrigin, i.e. six basis evaluations
+//% -- the dependence of the distance scaling RScale on the origin is included
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% BasisInDeriv[j](i,k):     d BasisIn(i,k) / d Origin(j)
+//% BasisOutDeriv[j](i,k):    d BasisOut(i,k) / d Origin(j)
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void RtSssAlgo::updateSSSBasisDeriv()
+{
+    double Step = 0.0005;
+    MatrixXd InPlus, OutPlus, InMinus, OutMinus;
+
+    BasisInDeriv.clear();
+    BasisOutDeriv.clear();
+
+    for(int j=0; j<3; j++)
     {
-//        if (CoilName[i] == CoilTk[0])
-//            coil_index = 0;
-//        else if (CoilName[i] == CoilTk[1])
-//            coil_index = 1;
-//        else
-//        {
-//            cout<< "There is no matching coil" << endl;
-//            exit(1);
-//        }
+        Vector3d Shift = Vector3d::Zero();
+        Shift(j) = Step;
 
-//    % calculate coil orientation
-        coil_vector = CoilT[i].block(0,2,3,1);
+        evalSSSBasis(BasisOrigin + Shift, BasisLIn, BasisLOut, InPlus, OutPlus);
+        evalSSSBasis(BasisOrigin - Shift, BasisLIn, BasisLOut, InMinus, OutMinus);
 
-//    % calculate coil locations (multiple points)
-//        int NumCoilPts = CoilNk(coil_index);
-        qint32 NumCoilPts = CoilNk(i);
-        MatrixXd tmpmat; tmpmat.setOnes(4,NumCoilPts);
-//qDebug() << "pass 2";
-//        tmpmat.topRows(3) = CoilRk[coil_index];
-//        std::cout << "CoilRk: " << CoilRk[i].rows() << " x " << CoilRk[i].cols()  << std::endl;
-        tmpmat.topRows(3) = CoilRk[i];
-//qDebug() << "pass 3";
-        coil_location = CoilT[i] * tmpmat;
-        tmpmat = coil_location.topRows(3);   coil_location.resize(3,NumCoilPts);   coil_location = tmpmat;
-        coil_location = coil_location - Origin.replicate(1,NumCoilPts);
-        coil_location = coil_location / RScale;
-
-//    % build linear equation
-        getSSSBasis(coil_location.row(0).transpose(), coil_location.row(1).transpose(), coil_location.row(2).transpose(), LIn, LOut);
-//        std::cout << "NumCoilPts: " << NumCoilPts  << ",    NumBIn: " << NumBIn << ",    NumBOut: " << NumBOut << endl;
-//        std::cout << "BInX: " << BInX.rows()  << " x " << BInX.cols() << endl;
-
-        MatrixXd b_in, b_out;
-        b_in = coil_vector(0)*BInX + coil_vector(1)*BInY + coil_vector(2)*BInZ;
-        b_out = coil_vector(0)*BOutX + coil_vector(1)*BOutY + coil_vector(2)*BOutZ;
-//        std::cout << "b_in: Coil= " << i+1 << endl << b_in << endl;
-//        std::cout << "b_out: Coil= " << i+1 << endl << b_out << endl;
-
-//        EqnIn.block(i,0,1,NumBIn) = CoilWk[coil_index] * b_in;
-//        EqnOut.block(i,0,1,NumBOut) = CoilWk[coil_index] * b_out;
-        EqnIn.block(i,0,1,NumBIn) = CoilWk[i] * b_in;
-        EqnOut.block(i,0,1,NumBOut) = CoilWk[i] * b_out;
+        BasisInDeriv.append((InPlus - InMinus) / (2*Step));
+        BasisOutDeriv.append((OutPlus - OutMinus) / (2*Step));
+    }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% threshold-gated rebuild of the linear equation for a new expansion origin,
+//% e.g. to follow the head position
+//% -- shifts below MinShift are ignored, i.e. the equations stay those of the
+//%    previous origin; pass MinShift = 0 to always rebuild
+//% -- otherwise the basis is fully re-evaluated with the cached coil geometry,
+//%    the linear equation is refactorized and the tSSS window restarts
+//% -- returns true if the equations were rebuilt
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+bool RtSssAlgo::rebuildLinearEqnAtOrigin(const Vector3d &NewOrigin, double MinShift)
+{
+    if(EqnA.size() > 0 && (NewOrigin - Origin).norm() < MinShift)
+        return false;
+
+    Origin = NewOrigin;
+
+    if(NumCoil > 0 && LInRR > 0 && LInOLS > 0)
+        buildLinearEqn();
+
+    return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% follow the head position with a first-order update of the linear equation
+//% -- shifts below MinShift from the current origin are ignored
+//% -- within MaxLinearShift of the origin of the cached basis, the basis is
+//%    moved to first order, Basis(o) = Basis(o0) + sum_j (o-o0)(j) * dBasis/do(j),
+//%    and only the normal equations are refactorized. The relative error grows
+//%    with (l+2)^2*(shift/distance)^2, i.e. about 1e-2 for LIn = 8, a shift of
+//%    2 mm and coils at 10 cm.
+//% -- the tSSS window is kept, its moments change by the same small amount
+//% -- larger shifts fully rebuild the equation at the new origin, which also
+//%    becomes the expansion point of the following first-order updates
+//% -- returns true if the equations changed
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+bool RtSssAlgo::moveOrigin(const Vector3d &NewOrigin, double MinShift, double MaxLinearShift)
+{
+    if(EqnA.size() == 0 || BasisIn.size() == 0)
+        return rebuildLinearEqnAtOrigin(NewOrigin, MinShift);
+
+    if((NewOrigin - Origin).norm() < MinShift)
+        return false;
+
+    int NumBInRR = LInRR*LInRR + 2*LInRR;
+    int NumBOutRR = LOutRR*LOutRR + 2*LOutRR;
+    int NumBIn = LInOLS*LInOLS + 2*LInOLS;
+    int NumBOut = LOutOLS*LOutOLS + 2*LOutOLS;
+
+//  % large shifts and changed expansion orders need a full rebuild
+    Vector3d Shift = NewOrigin - BasisOrigin;
+    if(Shift.norm() > MaxLinearShift || EqnARR.cols() != NumBInRR+NumBOutRR || EqnA.cols() != NumBIn+NumBOut
+            || BasisIn.cols() < qMax(NumBInRR, NumBIn) || BasisOut.cols() < qMax(NumBOutRR, NumBOut))
+        return rebuildLinearEqnAtOrigin(NewOrigin, 0);
+
+    if(BasisInDeriv.size() != 3)
+        updateSSSBasisDeriv();
+
+    Origin = NewOrigin;
+
+    MatrixXd In = BasisIn;
+    MatrixXd Out = BasisOut;
+    for(int j=0; j<3; j++)
+    {
+        In.noalias() += Shift(j) * BasisInDeriv[j];
+        Out.noalias() += Shift(j) * BasisOutDeriv[j];
     }
 
-    Eqn.append(EqnIn);
-    Eqn.append(EqnOut);
-//    std::cout << "EqnIn: Coil 1 " << endl << Eqn[0].row(0) << endl;
-//    std::cout << "EqnIn: Coil 306 " << endl << Eqn[0].row(305) << endl;
-//    std::cout << "EqnOut: Coil 1 " << endl << Eqn[1].row(0) << endl;
-//    std::cout << "EqnOut: Coil 306 " << endl << Eqn[1].row(305) << endl;
+    EqnInRR = In.leftCols(NumBInRR);
+    EqnOutRR = Out.leftCols(NumBOutRR);
+    EqnIn = In.leftCols(NumBIn);
+    EqnOut = Out.leftCols(NumBOut);
 
-    //qDebug() << "getSSSEqn END";
+    VectorXd CoilScale = getCoilScale();
 
-    return Eqn;
+    EqnARR << EqnInRR, EqnOutRR;
+    EqnA << EqnIn, EqnOut;
+
+    EqnARR = CoilScale.asDiagonal() * EqnARR;
+    EqnA = CoilScale.asDiagonal() * EqnA;
+
+//% the robust solver downdates the Gram matrix, so it is recomputed exactly
+    factorizeLinearEqn();
+
+    return true;
+}
+
+Vector3d RtSssAlgo::getOrigin()
+{
+    return Origin;
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -514,7 +667,7 @@ void RtSssAlgo::getSSSBasis(VectorXd X, VectorXd Y, VectorXd Z, qint32 LIn, qint
     int LMax;
 
     QList<MatrixXd> P, dP_dx;
-    MatrixXd cur_p, cur_p1, cur_p2;
+    MatrixXd cur_p1, cur_p2;
 
     QList<MatrixXcd> YP, dY_dTHETA;
     VectorXcd cur_phi;
@@ -549,11 +702,7 @@ void RtSssAlgo::getSSSBasis(VectorXd X, VectorXd Y, VectorXd Z, qint32 LIn, qint
 //    std::cout << "R, PHI, THETA: " << endl << R.transpose() << endl << PHI.transpose() << endl << THETA.transpose() << endl;
 
 //  % calculate P
-    for(int l=1; l<=LMax; l++)
-    {
-        cur_p = legendre(l, THETA.array().cos());
-        P.append(cur_p.transpose());
-    }
+    P = legendreTable(LMax, THETA.array().cos());
 //    std::cout << "Legendre Polynomial 1-----" << endl << P[0].transpose() << endl;
 //    std::cout << "Legendre Polynomial 2-----" << endl << P[1].transpose() << endl;
 //    std::cout << "Legendre Polynomial 3-----" << endl << P[2].transpose() << endl;
@@ -817,18 +966,22 @@ void RtSssAlgo::getSphereToCartesianVector()
 //QList<MatrixXd> RtSssAlgo::getSSSRR(MatrixXd EqnIn, MatrixXd EqnOut, MatrixXd EqnARR, MatrixXd EqnA, MatrixXd EqnB)
 //QList<MatrixXd> RtSssAlgo::getSSSRR(MatrixXd EqnB)
 MatrixXd RtSssAlgo::getSSSRR(MatrixXd EqnB)
+{
+//  % recover internal MEG siganl
+    return EqnIn * getSSSRRCoeff(EqnB).topRows(EqnIn.cols());
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% Robust SSS -- returns the multipole moments sol_X = [sol_in; sol_out] of all samples
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+MatrixXd RtSssAlgo::getSSSRRCoeff(MatrixXd EqnB)
 {
     //qDebug() << "getSSSRR START";
 
-    int NumBIn, NumBOut, NumCoil, NumExp;
-    MatrixXd EqnRRInv, EqnInv, SSSIn, SSSOut, Weight; //, ErrRel;
-    VectorXd ErrRel;
+    int NumCoil, NumExp;
     double RR_K1, RR_K2, RR_K3;
-    double eqn_scale0, eqn_scale;
-    MatrixXd sol_X, sol_X_old, eqn_Y, eqn_D, temp_M, temp_N, sol_in, sol_out;
-    MatrixXd diagMat;
-    VectorXd eqn_err, weight_index;
-    QList<MatrixXd> RRsss;
+    MatrixXd Weight, sol_X, eqn_err;
+    RowVectorXd eqn_scale0;
 
 //  % error tolerance for robust regression
     double ErrTolRel = 1e-3;
@@ -836,129 +989,278 @@ MatrixXd RtSssAlgo::getSSSRR(MatrixXd EqnB)
 //  % weight threshold for robust regression
     double WeightThres = 1 - 1e-6;
 
+//  % upper bound of re-weighting iterations, a sample which did not converge by then keeps its last solution
+    int MaxIter = 100;
+
 //  % initialization
-    NumBIn = EqnIn.cols();
-    NumBOut = EqnOut.cols();
     NumCoil = EqnB.rows();
     NumExp = EqnB.cols();
 
-    EqnRRInv = (EqnARR.transpose() * EqnARR).inverse();
-    EqnInv = (EqnA.transpose() * EqnA).inverse();
+    if(EqnARRChol.rows() != EqnARR.cols() || EqnAChol.rows() != EqnA.cols())
+        factorizeLinearEqn();
 
-    SSSIn.setZero(NumCoil,NumExp);
-    SSSOut.setZero(NumCoil,NumExp);
     Weight.setZero(NumCoil,NumExp);
-    ErrRel.setZero(NumExp);
     RR_K3 = 3;
     RR_K2 = 4.685;
     RR_K1 = qSqrt(1-qSqrt(3)/2) * RR_K2;
 
-    for(int i=0; i<NumExp; i++)
+//  % solve OLS solution for all samples at once
+    sol_X = EqnARRChol.solve(EqnARR.transpose() * EqnB);
+
+//  % scale linear equation
+    eqn_err = EqnARR * sol_X - EqnB;
+    eqn_scale0 = (eqn_err.rowwise() - eqn_err.colwise().mean()).array().square().colwise().mean().sqrt();
+    eqn_err = eqn_err.cwiseAbs().array().rowwise() / eqn_scale0.array();
+
+//  % solve iteratively re-weighted least squares (Bi-Square) -- subspace
+//  % only the samples which did not converge yet take part in the next iteration
+    QVector<int> active(NumExp);
+    for(int i=0; i<NumExp; i++) active[i] = i;
+
+    MatrixXd act_B, act_err, act_W, act_X, act_res;
+    RowVectorXd act_scale;
+
+    for(int cnt=0; cnt<MaxIter && !active.isEmpty(); cnt++)
     {
-//      % solve OLS solution
-        sol_X = EqnRRInv * (EqnARR.transpose() * EqnB.col(i));
-//        std::cout << "sol_X ************************" << endl << sol_X.transpose() << endl;
-
-//      % scale linear equation
-        eqn_err = EqnARR * sol_X - EqnB.col(i);
-        eqn_scale0 = stdev(eqn_err);
-        eqn_err = eqn_err.cwiseAbs() / eqn_scale0;
-
-//      % solve iteratively re-weighted least squares (Bi-Square) -- subspace
-        sol_X_old.setConstant(sol_X.rows(), sol_X.cols(), 1e30);
-//        while (((sol_X-sol_X_old).norm() / sol_X.norm()) > ErrTolRel)
-        int cnt=0;
-        while (((sol_X.array()-sol_X_old.array()).matrix().norm() / sol_X.norm()) > ErrTolRel)
-//        for (int h=0; h<2; h++)
+        int NumAct = active.size();
+        act_B.resize(NumCoil, NumAct);
+        act_err.resize(NumCoil, NumAct);
+        for(int c=0; c<NumAct; c++)
         {
-            cnt++;
-//            cout << "while cnt: " << cnt << endl;
-            sol_X_old = sol_X;
-//            Weight(:,i) = (eqn_err <= RR_K1) + (eqn_err > RR_K1 & eqn_err <= RR_K2) .* (1-(eqn_err-RR_K1).^2/(RR_K2-RR_K1)^2).^2;
-//            Weight.col(i) = eigen_LTE(eqn_err, RR_K1) + eigen_AND(eigen_GT(eqn_err, RR_K1),eigen_LTE(eqn_err, RR_K2));
-            Weight.col(i) = eigen_LTE(eqn_err,RR_K1).array() + eigen_AND(eigen_GT(eqn_err,RR_K1),eigen_LTE(eqn_err,RR_K2)).array() * (1 - ((eqn_err.array()-RR_K1).pow(2)) / pow(RR_K2-RR_K1,2) ).pow(2);
-//            std::cout << "Weight **************************" << endl << Weight.transpose() << endl;
-
-//          % weight_index = find(Weight(:,i) < WeightThres);
-            weight_index = eigen_LT_index(Weight.col(i), WeightThres);
-//            weight_index = eigen_LT_index_test(Weight.col(i), h);
-//            std:cout << "weight_index ********************* " << endl << weight_index << endl;
-
-//          % eqn_Y = EqnARR(weight_index,:);   eqn_D = Weight(weight_index,i) - 1;
-            eqn_Y.resize(weight_index.size(), EqnARR.cols());
-            eqn_D.resize(weight_index.size(),1);
-            for(int k=0; k<weight_index.size(); k++)
-            {
-                eqn_Y.row(k) = EqnARR.row(weight_index(k));
-//                std::cout << "eqn_Y: " << eqn_Y.rows() << " x " << eqn_Y.cols() << endl;
-//                std::cout << "eqn_D: "  << eqn_D.rows() << " x " << eqn_D.cols() << endl;
-                eqn_D(k) = Weight(weight_index(k),i) - 1;
-            }
-//              std::cout << "eqn_D: " << endl << eqn_D.transpose() << endl << endl;
-            temp_M = EqnARR.transpose() * (Weight.col(i).array() * EqnB.col(i).array()).matrix();
-//              std::cout << "temp_M: " << endl << temp_M.transpose() << endl << endl;
+            act_B.col(c) = EqnB.col(active[c]);
+            act_err.col(c) = eqn_err.col(active[c]);
+        }
+
+//      % Weight = (eqn_err <= RR_K1) + (eqn_err > RR_K1 & eqn_err <= RR_K2) .* (1-(eqn_err-RR_K1).^2/(RR_K2-RR_K1)^2).^2;
+        act_W = (act_err.array() <= RR_K1).select(1.0, (act_err.array() <= RR_K2).select((1 - (act_err.array()-RR_K1).square() / pow(RR_K2-RR_K1,2)).square(), 0.0));
 
-//            std::cout << "EqnRRInv: " << EqnRRInv.rows() << " x " << EqnRRInv.cols() << endl;
-//            std::cout << "eqn_Y: " << eqn_Y.rows() << " x " << eqn_Y.cols() << endl;
-//              std::cout << "EqnRRInv: " << endl << EqnRRInv.transpose() << endl << endl;
-//              std::cout << "eqn_Y: " << endl << eqn_Y.transpose() << endl << endl;
+        act_X = solveWeighted(EqnARR, EqnARRGram, EqnARRChol, act_B, act_W, WeightThres);
+
+        act_res = (EqnARR * act_X - act_B).cwiseAbs();
+        act_scale = RR_K3 * (act_W.array() * act_res.array().square()).colwise().mean().sqrt();
+
+        QVector<int> still_active;
+        for(int c=0; c<NumAct; c++)
+        {
+            int i = active[c];
+            double eqn_scale = qMin(eqn_scale0(i), act_scale(c));
+            double rel_change = (act_X.col(c) - sol_X.col(i)).norm() / act_X.col(c).norm();
+
+            Weight.col(i) = act_W.col(c);
+            sol_X.col(i) = act_X.col(c);
+            eqn_err.col(i) = act_res.col(c) / eqn_scale;
+
+            if(rel_change > ErrTolRel)
+                still_active.append(i);
+        }
+        active = still_active;
+    }
 
-            temp_N = EqnRRInv * eqn_Y.transpose();
-//              std::cout << "temp_N: " << endl << temp_N.transpose() << endl << endl;
+//  % solve weighted SSS - full, with the weights of the last iteration
+    sol_X = solveWeighted(EqnA, EqnAGram, EqnAChol, EqnB, Weight, WeightThres);
 
+    //qDebug() << "getSSSRR END";
 
-//            diagMat = eqn_D.asDiagonal();
-//        std::cout << "diagMat ************************" << endl << diagMat.transpose() << endl;
-//            diagMat = 1 / diagMat.array();
-//        std::cout << "diagMat ************************" << endl << diagMat.transpose() << endl;
+    return sol_X;
+}
 
-            diagMat = (1 / eqn_D.array()).matrix().asDiagonal();
-//            cout << "diagMat ************************" << i+1 << endl << diagMat.rows() << " x" << diagMat.cols() << endl;
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% Weighted least squares for all samples of a block
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% Solves (A' * diag(W(:,j)) * A) x_j = A' * (W(:,j).*B(:,j)) for every column j. Coils with a weight above
+//% WeightThres are treated as unweighted, so most samples are solved by the cached Cholesky factor of A'A
+//% with one multi-RHS solve. The remaining ones get a low rank (Woodbury) correction for their down-weighted
+//% coils, or a direct solve when too many coils are down-weighted.
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+MatrixXd RtSssAlgo::solveWeighted(const MatrixXd &A, const MatrixXd &Gram, const LLT<MatrixXd> &Chol, const MatrixXd &B, const MatrixXd &W, double WeightThres)
+{
+    MatrixXd temp_M = A.transpose() * (W.array() * B.array()).matrix();
+    MatrixXd sol_X = Chol.solve(temp_M);
 
-            sol_X = EqnRRInv * temp_M - temp_N * (diagMat + eqn_Y * temp_N).inverse() * (temp_N.transpose() * temp_M);
-            eqn_err = (EqnARR * sol_X - EqnB.col(i)).cwiseAbs();
-            eqn_scale = qMin(eqn_scale0, RR_K3 * qSqrt((Weight.col(i).array() * eqn_err.array() * eqn_err.array()).mean()));
-            eqn_err = eqn_err / eqn_scale;
-//             std::cout << "temp_M: " << endl << temp_M.transpose() << endl << endl;
+    MatrixXd eqn_Y, temp_N, temp_S;
+    VectorXd eqn_D;
+    QVector<int> weight_index;
 
-//            std::cout << "(sol_X.array()-sol_X_old.array()).matrix().norm(): " << (sol_X.array()-sol_X_old.array()).matrix().norm() << endl << endl;
-//            std::cout << "sol_X.norm():  " << sol_X.norm()  << endl  << endl;
-//        std::cout << "sol_X ************************" << endl << sol_X.transpose() << endl << endl;
+    for(int i=0; i<B.cols(); i++)
+    {
+        weight_index.clear();
+        for(int k=0; k<W.rows(); k++)
+            if(W(k,i) < WeightThres) weight_index.append(k);
+
+        int NumIdx = weight_index.size();
+        if(NumIdx == 0)
+            continue;
+
+//      % eqn_Y = A(weight_index,:);   eqn_D = Weight(weight_index,i) - 1;
+        eqn_Y.resize(NumIdx, A.cols());
+        eqn_D.resize(NumIdx);
+        for(int k=0; k<NumIdx; k++)
+        {
+            eqn_Y.row(k) = A.row(weight_index[k]);
+            eqn_D(k) = W(weight_index[k],i) - 1;
+        }
 
+        if(NumIdx < A.cols())
+        {
+//          % sol_X = AInv * temp_M - temp_N * ((diag(1./eqn_D) + eqn_Y * temp_N) \ (temp_N'*temp_M));
+            temp_N = Chol.solve(eqn_Y.transpose());
+            temp_S = eqn_Y * temp_N;
+            temp_S.diagonal() += eqn_D.cwiseInverse();
+            sol_X.col(i) -= temp_N * temp_S.partialPivLu().solve(temp_N.transpose() * temp_M.col(i));
         }
-//      % solve weighted SSS - full
-//      % eqn_Y = EqnA(weight_index,:); temp_M = EqnA' * (Weight(:,i).*EqnB(:,i)); temp_N = EqnInv * eqn_Y';
-        eqn_Y.resize(weight_index.size(), NumBIn+NumBOut);
-        for(int k=0; k<weight_index.size(); k++) eqn_Y.row(k) = EqnA.row(weight_index(k));
-        temp_M = EqnA.transpose() * (Weight.col(i).array() * EqnB.col(i).array()).matrix();
-        temp_N = EqnInv * eqn_Y.transpose();
+        else
+        {
+//          % sol_X = (A'A + eqn_Y' * diag(eqn_D) * eqn_Y) \ temp_M;
+            sol_X.col(i) = (Gram + eqn_Y.transpose() * eqn_D.asDiagonal() * eqn_Y).ldlt().solve(temp_M.col(i));
+        }
+    }
+
+    return sol_X;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% Cache the normal equations of the SSS bases and their Cholesky factors.
+//% They only change with the head position, i.e. when the linear equation is rebuilt.
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void RtSssAlgo::factorizeLinearEqn()
+{
+    EqnARRGram = EqnARR.transpose() * EqnARR;
+    EqnAGram = EqnA.transpose() * EqnA;
+
+    EqnARRChol.compute(EqnARRGram);
+    EqnAChol.compute(EqnAGram);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% Temporal SSS (tSSS) on a sliding window
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% WinSize:          length of the sliding window in samples
+//% CorrLimit:        subspace correlation above which a temporal component is
+//%                   treated as interference seen by both the inner and the outer expansion
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void RtSssAlgo::setTSSSParameter(qint32 WinSize, double CorrLimit)
+{
+    TSSSWinSize = WinSize;
+    TSSSCorrLimit = CorrLimit;
+
+    resetTSSS();
+}
 
+void RtSssAlgo::resetTSSS()
+{
+    TSSSBuffer.clear();
+    TSSSNumSamples = 0;
+    TSSSNumExpired = 0;
+    TSSSGramIn.resize(0,0);
+    TSSSGramOut.resize(0,0);
+    TSSSGramInOut.resize(0,0);
+}
 
-//      % sol_X = EqnInv * temp_M - temp_N * ((diag(1./eqn_D) + eqn_Y * temp_N); // \ (temp_N'*temp_M));
-//        diagMat = eqn_D.asDiagonal();
-//        diagMat = 1 / diagMat.array();
-        diagMat = (1 / eqn_D.array()).matrix().asDiagonal();
-        sol_X = EqnInv * temp_M - temp_N * (diagMat + eqn_Y * temp_N).inverse() * (temp_N.transpose() * temp_M);
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//% The temporal subspaces of the inner and outer signals over the window are the row
+//% spaces of sol_in and sol_out, so they follow from the small Gram matrices
+//% sol_in*sol_in', sol_out*sol_out' and sol_in*sol_out'. These are kept up to date by
+//% adding the newest block and subtracting the block which leaves the window, which
+//% replaces the SVD of the whole window by eigen decompositions of the size of the
+//% SSS bases. The intersecting temporal components u = sol_in'*P are projected out of
+//% the current block only, i.e. the output has no latency beyond the block itself:
+//%     sol_in(:,blk) - sol_in*u*u(blk,:)' = (I - GramIn*P*P') * sol_in(:,blk)
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+MatrixXd RtSssAlgo::getTSSS(const MatrixXd &SolX)
+{
+    int NumBIn = EqnIn.cols();
+    int NumBOut = SolX.rows() - NumBIn;
 
-        ErrRel(i) = (EqnA * sol_X - EqnB.col(i)).norm() / EqnB.col(i).norm();
+    MatrixXd sol_in = SolX.topRows(NumBIn);
+    MatrixXd sol_out = SolX.bottomRows(NumBOut);
 
-        sol_in = sol_X.block(0,0,NumBIn,1);
-        sol_out = sol_X.block(NumBIn,0,NumBOut,1);  // sol_X(NumBIn+1:NumBIn+NumBOut,1);
+//  % restart the window if the SSS bases changed in size
+    if(TSSSGramIn.rows() != NumBIn || TSSSGramOut.rows() != NumBOut)
+    {
+        resetTSSS();
+        TSSSGramIn.setZero(NumBIn,NumBIn);
+        TSSSGramOut.setZero(NumBOut,NumBOut);
+        TSSSGramInOut.setZero(NumBIn,NumBOut);
+    }
 
-//      % recover internal/external MEG siganl
-        SSSIn.col(i) = EqnIn * sol_in;
-        SSSOut.col(i) = EqnOut * sol_out;
+//  % rank update with the newest block
+    TSSSBuffer.append(SolX);
+    TSSSNumSamples += SolX.cols();
+    TSSSGramIn.noalias() += sol_in * sol_in.transpose();
+    TSSSGramOut.noalias() += sol_out * sol_out.transpose();
+    TSSSGramInOut.noalias() += sol_in * sol_out.transpose();
 
+//  % down date with the blocks which left the window
+    while(TSSSBuffer.size() > 1 && TSSSNumSamples - TSSSBuffer.first().cols() >= TSSSWinSize)
+    {
+        const MatrixXd &old_X = TSSSBuffer.first();
+        TSSSGramIn.noalias() -= old_X.topRows(NumBIn) * old_X.topRows(NumBIn).transpose();
+        TSSSGramOut.noalias() -= old_X.bottomRows(NumBOut) * old_X.bottomRows(NumBOut).transpose();
+        TSSSGramInOut.noalias() -= old_X.topRows(NumBIn) * old_X.bottomRows(NumBOut).transpose();
+        TSSSNumSamples -= old_X.cols();
+        TSSSBuffer.removeFirst();
+        TSSSNumExpired++;
     }
-    RRsss.append(SSSIn);
-    RRsss.append(SSSOut);
-    RRsss.append(Weight);
-    RRsss.append(ErrRel);
 
-    //qDebug() << "getSSSRR END";
+//  % rebuild the Gram matrices from the buffer once per window to keep the round off of the down dates bounded
+    if(TSSSNumExpired >= TSSSBuffer.size())
+    {
+        TSSSGramIn.setZero();
+        TSSSGramOut.setZero();
+        TSSSGramInOut.setZero();
+        for(int k=0; k<TSSSBuffer.size(); k++)
+        {
+            const MatrixXd &buf_X = TSSSBuffer.at(k);
+            TSSSGramIn.noalias() += buf_X.topRows(NumBIn) * buf_X.topRows(NumBIn).transpose();
+            TSSSGramOut.noalias() += buf_X.bottomRows(NumBOut) * buf_X.bottomRows(NumBOut).transpose();
+            TSSSGramInOut.noalias() += buf_X.topRows(NumBIn) * buf_X.bottomRows(NumBOut).transpose();
+        }
+        TSSSNumExpired = 0;
+    }
 
-//    return RRsss;
-    return SSSIn;
+//  % orthonormal temporal bases: E = sol' * V * diag(1./sqrt(lambda)), only the non-degenerate directions
+    MatrixXd WIn = getTemporalBasis(TSSSGramIn);
+    MatrixXd WOut = getTemporalBasis(TSSSGramOut);
+
+    if(WIn.cols() == 0 || WOut.cols() == 0)
+        return EqnIn * sol_in;
+
+//  % principal angles between the subspaces: svd(EIn' * EOut)
+    JacobiSVD<MatrixXd> svd(WIn.transpose() * TSSSGramInOut * WOut, ComputeThinU);
+
+    int NumIntersect = 0;
+    while(NumIntersect < svd.singularValues().size() && svd.singularValues()(NumIntersect) >= TSSSCorrLimit)
+        NumIntersect++;
+
+    if(NumIntersect > 0)
+    {
+        MatrixXd P = WIn * svd.matrixU().leftCols(NumIntersect);
+        sol_in -= TSSSGramIn * (P * (P.transpose() * sol_in));
+    }
+
+//  % recover internal MEG siganl
+    return EqnIn * sol_in;
+}
+
+MatrixXd RtSssAlgo::getTSSSRR(MatrixXd EqnB)
+{
+    return getTSSS(getSSSRRCoeff(EqnB));
+}
+
+MatrixXd RtSssAlgo::getTemporalBasis(const MatrixXd &Gram)
+{
+    SelfAdjointEigenSolver<MatrixXd> eig(Gram);
+
+//  % eigenvalues are sorted in increasing order; drop the ones below the numerical rank
+    const VectorXd &lambda = eig.eigenvalues();
+    double tol = lambda.size() > 0 ? 1e-12 * lambda(lambda.size()-1) : 0;
+
+    int first = 0;
+    while(first < lambda.size() && lambda(first) <= tol)
+        first++;
+
+    int rank = lambda.size() - first;
+    return eig.eigenvectors().rightCols(rank) * lambda.tail(rank).cwiseSqrt().cwiseInverse().asDiagonal();
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
@@ -989,46 +1291,23 @@ MatrixXd RtSssAlgo::getSSSOLS(MatrixXd EqnB)
 {
     //qDebug() << "getSSSOLS START";
 
-    int NumBIn, NumBOut, NumCoil, NumExp;
-    MatrixXd EqnRRInv, EqnInv, SSSIn, SSSOut;
-    MatrixXd sol_X, sol_in, sol_out;
-    VectorXd ErrRel;
-    QList<MatrixXd> OLSsss;
+    int NumBIn;
+    MatrixXd sol_X;
 
 //  % initialization
     NumBIn = EqnIn.cols();
-    NumBOut = EqnOut.cols();
-    NumCoil = EqnB.rows();
-    NumExp = EqnB.cols();
-
-    EqnRRInv = (EqnA.transpose() * EqnA).inverse();
-    SSSIn.setZero(NumCoil,NumExp);
-    SSSOut.setZero(NumCoil,NumExp);
-    ErrRel.setZero(NumExp);
-
-    for (int i=0; i<NumExp; i++)
-    {
-//      % solve OLS solution
-        sol_X = EqnRRInv * (EqnA.transpose() * EqnB.col(i));
-
-        ErrRel(i) = (EqnA * sol_X - EqnB.col(i)).norm() / EqnB.col(i).norm();
 
-        sol_in = sol_X.block(0,0,NumBIn,1);
+    if(EqnAChol.rows() != EqnA.cols())
+        factorizeLinearEqn();
 
-        sol_out = sol_X.block(NumBIn,0, NumBOut,1);    // probably NumBIn+0 is correct.  Please debug !!!!
-
-//      % recover internal/external MEG siganl
-        SSSIn.col(i) = EqnIn * sol_in;
-        SSSOut.col(i) = EqnOut * sol_out;
-    }
+//  % solve OLS solution for all samples at once
+    sol_X = EqnAChol.solve(EqnA.transpose() * EqnB);
 
-    OLSsss.append(SSSIn);
-    OLSsss.append(SSSOut);
-    OLSsss.append(ErrRel);
+//  % recover internal MEG siganl
+    MatrixXd SSSIn = EqnIn * sol_X.topRows(NumBIn);
 
     //qDebug() << "getSSSOLS END";
 
-//    return OLSsss;
     return SSSIn;
 }
 
@@ -1094,6 +1373,37 @@ MatrixXd legendre(int l, VectorXd x)
 }
 
 
+//---------------------------------------------------------------------
+// Associated Legendre functions P_l^m(x) for l = 1..LMax and all points at once
+// -- P[l-1](k,m) = P_l^m(x(k)), same convention as plgndr
+QList<MatrixXd> legendreTable(int LMax, const VectorXd &x)
+{
+    QList<MatrixXd> P;
+    ArrayXd somx2 = (1.0 - x.array().square()).max(0.0).sqrt();
+
+    P.append(MatrixXd::Ones(x.size(),1));
+
+    for(int l=1; l<=LMax; l++)
+    {
+        P.append(MatrixXd(x.size(),l+1));
+
+        for(int m=0; m<=l; m++)
+        {
+            if(m == l)
+                P[l].col(m) = -(2*m-1) * somx2 * P[l-1].col(m-1).array();
+            else if(m == l-1)
+                P[l].col(m) = (2*m+1) * x.array() * P[l-1].col(m).array();
+            else
+                P[l].col(m) = ((2*l-1) * x.array() * P[l-1].col(m).array() - (l+m-1) * P[l-2].col(m).array()) / (l-m);
+        }
+    }
+
+    P.removeFirst();
+
+    return P;
+}
+
+
 float plgndr(int l, int m, float x)
 {
 //    void nrerror(char error_text[]);
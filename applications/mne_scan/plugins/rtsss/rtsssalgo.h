@@ -49,7 +49,9 @@
 #include <QtGlobal>
 #include <QtCore/qmath.h>
 #include <QList>
+#include <QVector>
 #include <Eigen/Dense>
+#include <Eigen/SparseCore>
 #include <iostream>
 #include <QString>
 #include <QDebug>
@@ -76,6 +78,7 @@ using namespace FIFFLIB;
 typedef std::complex<double> cplxd;
 
 MatrixXd legendre(int, VectorXd);
+QList<MatrixXd> legendreTable(int LMax, const VectorXd &x);
 float plgndr(int l, int m, float x);
 double factorial(int);
 //QList<MatrixXd> getSSSRR(MatrixXd, MatrixXd, MatrixXd, MatrixXd, MatrixXd);
@@ -102,15 +105,24 @@ public:
 //    QList<MatrixXd> getSSSRR(MatrixXd EqnIn, MatrixXd EqnOut, MatrixXd EqnARR, MatrixXd EqnA, MatrixXd EqnB);
 //    QList<MatrixXd> getSSSRR(MatrixXd EqnB);
     MatrixXd getSSSRR(MatrixXd EqnB);
+    MatrixXd getSSSRRCoeff(MatrixXd EqnB);
 
 //    QList<MatrixXd> getSSSOLS(MatrixXd EqnIn, MatrixXd EqnOut, MatrixXd EqnA, MatrixXd EqnB);
 //    QList<MatrixXd> getSSSOLS(MatrixXd EqnB);
     MatrixXd getSSSOLS(MatrixXd EqnB);
 
+    MatrixXd getTSSS(const MatrixXd &SolX);
+    MatrixXd getTSSSRR(MatrixXd EqnB);
+    void setTSSSParameter(qint32 WinSize, double CorrLimit);
+    void resetTSSS();
+
     QList<MatrixXd> getLinEqn();
 
     void setMEGInfo(FiffInfo::SPtr fiffinfo, RowVectorXi);
     void setSSSParameter(QList<int>);
+    bool rebuildLinearEqnAtOrigin(const Vector3d &NewOrigin, double MinShift = 0.001);
+    bool moveOrigin(const Vector3d &NewOrigin, double MinShift = 0.0002, double MaxLinearShift = 0.002);
+    Vector3d getOrigin();
     qint32 getNumMEGChan();
     qint32 getNumMEGChanUsed();
     qint32 getNumMEGBadChan();
@@ -123,8 +135,16 @@ private:
     QList<MatrixXd> getSSSEqn(qint32, qint32);
 //    QList<MatrixXd> getSSSEqn(VectorXi Lexp);
     void getSSSBasis(VectorXd, VectorXd, VectorXd, qint32, qint32);
+    void buildCoilGeometry();
+    void updateSSSBasis(qint32 LIn, qint32 LOut);
+    void evalSSSBasis(const Vector3d &BasisPos, qint32 LIn, qint32 LOut, MatrixXd &In, MatrixXd &Out);
+    void updateSSSBasisDeriv();
+    VectorXd getCoilScale();
     void getCartesianToSpherCoordinate(VectorXd, VectorXd, VectorXd);
     void getSphereToCartesianVector();
+    void factorizeLinearEqn();
+    MatrixXd getTemporalBasis(const MatrixXd &Gram);
+    MatrixXd solveWeighted(const MatrixXd &A, const MatrixXd &Gram, const LLT<MatrixXd> &Chol, const MatrixXd &B, const MatrixXd &W, double WeightThres);
     int strmatch(char, char);
 
     qint32 NumMEGChan, NumCoil, NumBadCoil;
@@ -140,6 +160,21 @@ private:
     Vector3d Origin;
     MatrixXd BInX, BInY, BInZ, BOutX, BOutY, BOutZ;
     MatrixXd EqnInRR, EqnOutRR, EqnIn, EqnOut, EqnARR, EqnA, EqnB;
+    MatrixXd CoilPts, CoilCenters;
+    SparseMatrix<double> CoilIntX, CoilIntY, CoilIntZ;
+    Vector3d BasisOrigin;
+    qint32 BasisLIn, BasisLOut;
+    MatrixXd BasisIn, BasisOut;
+    QList<MatrixXd> BasisInDeriv, BasisOutDeriv;
+
+    MatrixXd EqnARRGram, EqnAGram;
+    LLT<MatrixXd> EqnARRChol, EqnAChol;
+
+    qint32 TSSSWinSize;
+    double TSSSCorrLimit;
+    QList<MatrixXd> TSSSBuffer;
+    qint32 TSSSNumSamples, TSSSNumExpired;
+    MatrixXd TSSSGramIn, TSSSGramOut, TSSSGramInOut;
 
     VectorXd R, PHI, THETA;
     VectorXd R_X, R_Y, R_Z;
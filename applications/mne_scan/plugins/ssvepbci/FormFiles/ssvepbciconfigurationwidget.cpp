@@ -110,6 +110,8 @@ SsvepBciConfigurationWidget::SsvepBciConfigurationWidget(SsvepBci* pSsvepBci, QW
     // connect feature extraction behaviour signal
     connect(ui->m_RadioButton_MEC, &QRadioButton::toggled, m_pSsvepBci, &SsvepBci::setFeatureExtractionMethod);
     connect(ui->m_RadioButton_MEC, &QRadioButton::toggled, this, &SsvepBciConfigurationWidget::onRadioButtonMECtoggled);
+    connect(ui->m_RadioButton_FBCCA, &QRadioButton::toggled, m_pSsvepBci, &SsvepBci::setFilterBankCCA);
+    connect(ui->m_RadioButton_FBCCA, &QRadioButton::toggled, this, &SsvepBciConfigurationWidget::onRadioButtonMECtoggled);
 
     // connect number of harmonicssignal
     connect(ui->m_SpinBox_NumOfHarmonics, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &SsvepBciConfigurationWidget::numOfHarmonicsChanged);
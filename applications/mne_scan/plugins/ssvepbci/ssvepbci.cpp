@@ -79,6 +79,7 @@ SsvepBci::SsvepBci()
 , m_dAlpha(0.25)
 , m_iNumberOfHarmonics(2)
 , m_bUseMEC(true)
+, m_bUseFilterBankCCA(false)
 , m_bRemovePowerLine(false)
 , m_iPowerLine(50)
 , m_bChangeSSVEPParameterFlag(false)
@@ -507,6 +508,16 @@ void SsvepBci::setFeatureExtractionMethod(bool useMEC)
 }
 
 
+//*************************************************************************************************************
+
+void SsvepBci::setFilterBankCCA(bool useFilterBank)
+{
+    m_qMutex.lock();
+    m_bUseFilterBankCCA = useFilterBank;
+    m_qMutex.unlock();
+}
+
+
 //*************************************************************************************************************
 
 void SsvepBci::changeSSVEPParameter(){
@@ -604,86 +615,6 @@ QList<double> SsvepBci::getCurrentListOfFrequencies(){
 }
 
 
-//*************************************************************************************************************
-
-double SsvepBci::MEC(MatrixXd &Y, MatrixXd &X)
-{
-
-    // Remove SSVEP harmonic frequencies
-    MatrixXd X_help = X.transpose()*X;
-    MatrixXd Ytilde = Y - X*X_help.inverse()*X.transpose()*Y;
-
-    // Find eigenvalues and eigenvectors
-    SelfAdjointEigenSolver<MatrixXd> eigensolver(Ytilde.transpose()*Ytilde);    
-
-    // Determine number of channels Ns
-    int Ns;
-    VectorXd cumsum = eigensolver.eigenvalues();
-    for(int j = 1; j < eigensolver.eigenvalues().size(); j++){
-        cumsum(j) += cumsum(j - 1);
-    }
-    for(Ns = 0; Ns < eigensolver.eigenvalues().size() ; Ns++){
-        if(cumsum(Ns)/eigensolver.eigenvalues().sum() > 0.1){
-            break;
-        }
-    }
-    Ns += 1;
-
-    // Determine spatial filter matrix W
-    MatrixXd W = eigensolver.eigenvectors().block(0, 0, eigensolver.eigenvectors().rows(), Ns);   
-    for(int k = 0; k < Ns; k++){
-        W.col(k) = W.col(k)*(1/sqrt(eigensolver.eigenvalues()(k)));
-    }
-
-    // Calcuclate channel signals
-    MatrixXd S = Y*W;
-
-    // Calculate signal energy
-    MatrixXd P(2, Ns);
-    double power = 0;
-    for(int k = 0; k < m_iNumberOfHarmonics; k++){
-        P = X.block(0, 2*k, X.rows(), 2).transpose()*S;
-        P = P.array()*P.array();
-        power += 1 / double(m_iNumberOfHarmonics*Ns) * P.sum();
-    }
-
-    return power;
-}
-
-
-//*************************************************************************************************************
-
-double SsvepBci::CCA(MatrixXd &Y, MatrixXd &X)
-{
-    // CCA parameter
-    int n  = X.rows();
-    int p1 = X.cols();
-    int p2 = Y.cols();
-
-    // center data sets
-    MatrixXd X_center(n, p1);
-    MatrixXd Y_center(n, p2);
-    for(int i = 0; i < p1; i++){
-        X_center.col(i) = X.col(i).array() - X.col(i).mean();
-    }
-
-    for(int i = 0; i < p2; i++){
-        Y_center.col(i) = Y.col(i).array() - Y.col(i).mean();
-    }
-
-    // QR decomposition
-    MatrixXd Q1, Q2;
-    ColPivHouseholderQR<MatrixXd> qr1(X_center), qr2(Y_center);
-    Q1 = qr1.householderQ() * MatrixXd::Identity(n, p1);
-    Q2 = qr2.householderQ() * MatrixXd::Identity(n, p2);
-
-    // SVD decomposition, determine max correlation
-    JacobiSVD<MatrixXd> svd(Q1.transpose()*Q2); // ComputeThinU | ComputeThinV
-
-    return svd.singularValues().maxCoeff();
-}
-
-
 //*************************************************************************************************************
 
 void SsvepBci::readFromSlidingTimeWindow(MatrixXd &data)
@@ -759,42 +690,15 @@ void SsvepBci::ssvepBciOnSensor()
             MatrixXd Y;
             readFromSlidingTimeWindow(Y);
 
-            // create realtive timeline according to Y
-            int samples = Y.rows();
-            ArrayXd t = 2*M_PI/m_dSampleFrequency * ArrayXd::LinSpaced(samples, 1, samples);
-
-            // Remove 50 Hz Power line signal
-            if(m_bRemovePowerLine){
-                MatrixXd Zp(samples,2);
-                ArrayXd t_PL = t*m_iPowerLine;
-                Zp.col(0) = t_PL.sin();
-                Zp.col(1) = t_PL.cos();
-                MatrixXd Zp_help = Zp.transpose()*Zp;
-                Y = Y - Zp*Zp_help.inverse()*Zp.transpose()*Y;
-            }
-
             qDebug() << "size of Matrix:" << Y.rows() << Y.cols();
 
-            // apply feature extraction for all frequencies of interest
-            VectorXd ssvepProbabilities(m_lAllFrequencies.size());
-            for(int i = 0; i < m_lAllFrequencies.size(); i++)
-            {
-                // create reference signal matrix X
-                MatrixXd X(samples, 2*m_iNumberOfHarmonics);
-                for(int k = 0; k < m_iNumberOfHarmonics; k++){
-                    ArrayXd t_k = t*(k+1)*m_lAllFrequencies.at(i);
-                    X.col(2*k)      = t_k.sin();
-                    X.col(2*k+1)    = t_k.cos();
-                }
+            // apply feature extraction for all frequencies of interest at once, the reference signals are cached
+            // per window size inside the feature extractor
+            m_featureExtractor.setParameters(m_lAllFrequencies, m_iNumberOfHarmonics, m_dSampleFrequency, m_bRemovePowerLine, m_iPowerLine);
+            m_featureExtractor.setNumberOfSubBands(m_bUseFilterBankCCA ? m_iNumberOfHarmonics : 0);
 
-                // extracting the features from the data Y with the reference signal X
-                if(m_bUseMEC){
-                    ssvepProbabilities(i) = MEC(Y, X); // using Minimum Energy Combination as feature-extraction tool
-                }
-                else{
-                    ssvepProbabilities(i) = CCA(Y, X); // using Canonical Correlation Analysis as feature-extraction tool
-                }
-            }
+            VectorXd ssvepProbabilities = m_bUseMEC ? m_featureExtractor.MEC(Y)      // using Minimum Energy Combination as feature-extraction tool
+                                                    : m_featureExtractor.CCA(Y);     // using (filter-bank) Canonical Correlation Analysis as feature-extraction tool
 
             // normalize features to probabilities and transfering it into a softmax function
             ssvepProbabilities = m_dAlpha / ssvepProbabilities.sum() * ssvepProbabilities;
@@ -44,6 +44,7 @@
 //=============================================================================================================
 
 #include "ssvepbci_global.h"
+#include "ssvepbcifeatureextractor.h"
 
 #include <scShared/Interfaces/IAlgorithm.h>
 #include <utils/generics/circularmatrixbuffer.h>
@@ -234,32 +235,6 @@ protected:
     void clearClassifications();
 
 
-    //=========================================================================================================
-    /**
-    * Applying the Minimum Energy Combination approach in order to get the signal energy in Y detected by the
-    * reference signal X.
-    *
-    * @param [in]   Y           measured signal.
-    * @param [in]   X           reference signal.
-    *
-    * @return       signal energy of the reference signal in the measured signal.
-    *
-    */
-    double MEC(SCMEASLIB::MatrixXd &Y, SCMEASLIB::MatrixXd &X);
-
-    //=========================================================================================================
-    /**
-    * Applying Canoncial Correlation Analysis to get the correlation between the sets of signals of reference
-    * Signal X and the EEG Signal Y.
-    *
-    * @param [in]   Y           measured signal.
-    * @param [in]   X           reference signal.
-    *
-    * @return       maximal correlation between the signals.
-    *
-    */
-    double CCA(SCMEASLIB::MatrixXd &Y, SCMEASLIB::MatrixXd &X);
-
     //=========================================================================================================
     /**
     * The starting point for the thread. After calling start(), the newly created thread calls this function.
@@ -305,6 +280,14 @@ public slots:
     */
     void setFeatureExtractionMethod(bool useMEC);
 
+    //=========================================================================================================
+    /**
+    * slot for switching the CCA feature extraction to filter-bank CCA
+    *
+    * @param [in]   useFilterBank     flag for using filter-bank CCA
+    */
+    void setFilterBankCCA(bool useFilterBank);
+
     //=========================================================================================================
     /**
     * slot for adjusting the kind of feature extraction
@@ -437,6 +420,8 @@ private:
     QList<double>           m_lThresholdValues;                 /**< Threshold value for normalized energy probabilities. */
     bool                    m_bRemovePowerLine;                 /**< Flag for removing 50 Hz power line signal. */
     bool                    m_bUseMEC;                          /**< Flag for feature extractiong. If true: use MEC; If false: use CCA. */
+    bool                    m_bUseFilterBankCCA;                /**< Flag for using filter-bank CCA instead of plain CCA. */
+    SsvepBciFeatureExtractor m_featureExtractor;                /**< Calculates the MEC and CCA features with cached reference signals. */
     QList<int>              m_lIndexOfClassResultSensor;        /**< Sensor level: Classification results on sensor level. */
     int                     m_iPowerLine;                       /**< Frequency of the power line [Hz]. */
     bool                    m_bChangeSSVEPParameterFlag;        /**< Flag for chaning SSVEP parameter. */
@@ -0,0 +1,302 @@
+//=============================================================================================================
+/**
+* @file     ssvepbcifeatureextractor.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the implementation of the SsvepBciFeatureExtractor class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "ssvepbcifeatureextractor.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/SVD>
+#include <Eigen/QR>
+#include <Eigen/Eigenvalues>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SSVEPBCIPLUGIN;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SsvepBciFeatureExtractor::SsvepBciFeatureExtractor()
+: m_iNumberOfHarmonics(1)
+, m_dSampleFrequency(128)
+, m_bRemovePowerLine(false)
+, m_iPowerLine(50)
+, m_iNumberOfSubBands(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void SsvepBciFeatureExtractor::setParameters(const QList<double> &lFrequencies,
+                                             int iNumberOfHarmonics,
+                                             double dSampleFrequency,
+                                             bool bRemovePowerLine,
+                                             int iPowerLine)
+{
+    if(m_lFrequencies != lFrequencies || m_iNumberOfHarmonics != iNumberOfHarmonics || m_dSampleFrequency != dSampleFrequency
+            || m_iPowerLine != iPowerLine) {
+        m_mapReferenceBanks.clear();
+    }
+
+    m_lFrequencies = lFrequencies;
+    m_iNumberOfHarmonics = iNumberOfHarmonics;
+    m_dSampleFrequency = dSampleFrequency;
+    m_bRemovePowerLine = bRemovePowerLine;
+    m_iPowerLine = iPowerLine;
+}
+
+
+//*************************************************************************************************************
+
+void SsvepBciFeatureExtractor::setNumberOfSubBands(int iNumberOfSubBands)
+{
+    if(m_iNumberOfSubBands != iNumberOfSubBands) {
+        m_mapReferenceBanks.clear();
+    }
+
+    m_iNumberOfSubBands = iNumberOfSubBands > 0 ? iNumberOfSubBands : 0;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SsvepBciFeatureExtractor::MEC(const MatrixXd &matY)
+{
+    const ReferenceBank &bank = referenceBank(matY.rows());
+    const int iRefCols = 2*m_iNumberOfHarmonics;
+
+    MatrixXd Y = removePowerLine(bank, matY);
+
+    // Correlations of the window with itself and with the references of all targets at once
+    MatrixXd matYY = Y.transpose()*Y;
+    MatrixXd matQY = bank.matQX.transpose()*Y;
+    MatrixXd matXY = bank.matX.transpose()*Y;
+
+    VectorXd power = VectorXd::Zero(m_lFrequencies.size());
+
+    for(int i = 0; i < m_lFrequencies.size(); i++){
+        // Remove SSVEP harmonic frequencies: Ytilde'*Ytilde = Y'*Y - (Q'*Y)'*(Q'*Y)
+        MatrixXd matQYi = matQY.middleRows(i*iRefCols, iRefCols);
+        SelfAdjointEigenSolver<MatrixXd> eigensolver(matYY - matQYi.transpose()*matQYi);
+
+        // Determine number of channels Ns
+        const VectorXd &eigenvalues = eigensolver.eigenvalues();
+        double dSum = eigenvalues.sum();
+        double dCumSum = 0;
+        int Ns;
+        for(Ns = 0; Ns < eigenvalues.size(); Ns++){
+            dCumSum += eigenvalues(Ns);
+            if(dCumSum/dSum > 0.1){
+                break;
+            }
+        }
+        Ns = std::min(Ns + 1, int(eigenvalues.size()));
+
+        // Determine spatial filter matrix W
+        MatrixXd W = eigensolver.eigenvectors().leftCols(Ns);
+        for(int k = 0; k < Ns; k++){
+            W.col(k) *= 1/sqrt(eigenvalues(k));
+        }
+
+        // Calculate signal energy of the channel signals S = Y*W: X'*S = (X'*Y)*W
+        power(i) = (matXY.middleRows(i*iRefCols, iRefCols)*W).squaredNorm() / double(m_iNumberOfHarmonics*Ns);
+    }
+
+    return power;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SsvepBciFeatureExtractor::CCA(const MatrixXd &matY)
+{
+    const ReferenceBank &bank = referenceBank(matY.rows());
+
+    MatrixXd Y = removePowerLine(bank, matY);
+
+    if(bank.lSubBandFilters.isEmpty()){
+        return canonicalCorrelations(bank, Y);
+    }
+
+    // Filter-bank CCA: weighted sum of the squared correlations of all sub-bands
+    VectorXd features = VectorXd::Zero(m_lFrequencies.size());
+
+    for(int i = 0; i < bank.lSubBandFilters.size(); i++){
+        MatrixXd Yfiltered = bank.lSubBandFilters.at(i)->applyFFTFilterRows(Y.transpose()).transpose();
+        double dWeight = pow(double(i + 1), -1.25) + 0.25;
+
+        features += dWeight * canonicalCorrelations(bank, Yfiltered).array().square().matrix();
+    }
+
+    return features;
+}
+
+
+//*************************************************************************************************************
+
+const SsvepBciFeatureExtractor::ReferenceBank& SsvepBciFeatureExtractor::referenceBank(int iSamples)
+{
+    QMap<int, ReferenceBank>::const_iterator it = m_mapReferenceBanks.constFind(iSamples);
+    if(it != m_mapReferenceBanks.constEnd()){
+        return it.value();
+    }
+
+    ReferenceBank bank;
+    const int iRefCols = 2*m_iNumberOfHarmonics;
+
+    // create realtive timeline of the window
+    ArrayXd t = 2*M_PI/m_dSampleFrequency * ArrayXd::LinSpaced(iSamples, 1, iSamples);
+
+    bank.matX.resize(iSamples, m_lFrequencies.size()*iRefCols);
+    bank.matQX.resize(iSamples, m_lFrequencies.size()*iRefCols);
+    bank.matQXCentered.resize(iSamples, m_lFrequencies.size()*iRefCols);
+
+    for(int i = 0; i < m_lFrequencies.size(); i++){
+        // create reference signal matrix X
+        MatrixXd X(iSamples, iRefCols);
+        for(int k = 0; k < m_iNumberOfHarmonics; k++){
+            ArrayXd t_k = t*(k+1)*m_lFrequencies.at(i);
+            X.col(2*k)      = t_k.sin();
+            X.col(2*k+1)    = t_k.cos();
+        }
+
+        bank.matX.middleCols(i*iRefCols, iRefCols) = X;
+
+        HouseholderQR<MatrixXd> qr(X);
+        bank.matQX.middleCols(i*iRefCols, iRefCols) = qr.householderQ() * MatrixXd::Identity(iSamples, iRefCols);
+
+        MatrixXd X_center = X.rowwise() - X.colwise().mean();
+        ColPivHouseholderQR<MatrixXd> qrCentered(X_center);
+        bank.matQXCentered.middleCols(i*iRefCols, iRefCols) = qrCentered.householderQ() * MatrixXd::Identity(iSamples, iRefCols);
+    }
+
+    // power line regressors
+    MatrixXd Zp(iSamples, 2);
+    ArrayXd t_PL = t*m_iPowerLine;
+    Zp.col(0) = t_PL.sin();
+    Zp.col(1) = t_PL.cos();
+    HouseholderQR<MatrixXd> qrPowerLine(Zp);
+    bank.matQPowerLine = qrPowerLine.householderQ() * MatrixXd::Identity(iSamples, 2);
+
+    // band-pass filters of the filter-bank CCA, the n-th sub-band starts below the n-th harmonic of the lowest target
+    if(m_iNumberOfSubBands > 0 && !m_lFrequencies.isEmpty()){
+        double dNyquist = m_dSampleFrequency/2;
+        double dLowestFrequency = m_lFrequencies.first();
+        for(int i = 1; i < m_lFrequencies.size(); i++){
+            dLowestFrequency = std::min(dLowestFrequency, m_lFrequencies.at(i));
+        }
+
+        int iOrder = std::min(32, 2*(iSamples/4));
+        int iFFTLength = 1;
+        while(iFFTLength < iSamples + 2*iOrder){
+            iFFTLength *= 2;
+        }
+
+        for(int n = 1; n <= m_iNumberOfSubBands; n++){
+            double dLower = std::max(1.0, n*dLowestFrequency - 2);
+            double dUpper = 0.9*dNyquist;
+
+            if(dLower >= dUpper){
+                break;
+            }
+
+            bank.lSubBandFilters.append(QSharedPointer<FilterData>(new FilterData(QString("SubBand%1").arg(n),
+                                                                                  FilterData::BPF,
+                                                                                  iOrder,
+                                                                                  (dLower + dUpper)/2/dNyquist,
+                                                                                  (dUpper - dLower)/dNyquist,
+                                                                                  2/dNyquist,
+                                                                                  m_dSampleFrequency,
+                                                                                  iFFTLength)));
+        }
+    }
+
+    return m_mapReferenceBanks.insert(iSamples, bank).value();
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd SsvepBciFeatureExtractor::removePowerLine(const ReferenceBank &bank, const MatrixXd &matY) const
+{
+    if(!m_bRemovePowerLine){
+        return matY;
+    }
+
+    return matY - bank.matQPowerLine*(bank.matQPowerLine.transpose()*matY);
+}
+
+
+//*************************************************************************************************************
+
+VectorXd SsvepBciFeatureExtractor::canonicalCorrelations(const ReferenceBank &bank, const MatrixXd &matY) const
+{
+    const int iRefCols = 2*m_iNumberOfHarmonics;
+
+    // center and decompose the window once for all targets
+    MatrixXd Y_center = matY.rowwise() - matY.colwise().mean();
+    ColPivHouseholderQR<MatrixXd> qr(Y_center);
+    MatrixXd Q2 = qr.householderQ() * MatrixXd::Identity(matY.rows(), matY.cols());
+
+    MatrixXd matQ1Q2 = bank.matQXCentered.transpose()*Q2;
+
+    // SVD decomposition, determine max correlation
+    VectorXd correlations(m_lFrequencies.size());
+    for(int i = 0; i < m_lFrequencies.size(); i++){
+        JacobiSVD<MatrixXd> svd(matQ1Q2.middleRows(i*iRefCols, iRefCols));
+        correlations(i) = svd.singularValues().maxCoeff();
+    }
+
+    return correlations;
+}
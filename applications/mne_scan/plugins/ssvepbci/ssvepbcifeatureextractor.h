@@ -0,0 +1,196 @@
+//=============================================================================================================
+/**
+* @file     ssvepbcifeatureextractor.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the SsvepBciFeatureExtractor class.
+*
+*/
+
+#ifndef SSVEPBCIFEATUREEXTRACTOR_H
+#define SSVEPBCIFEATUREEXTRACTOR_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "ssvepbci_global.h"
+
+#include <utils/filterTools/filterdata.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QMap>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SSVEPBCIPLUGIN
+//=============================================================================================================
+
+namespace SSVEPBCIPLUGIN
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS SsvepBciFeatureExtractor
+*
+* @brief SsvepBciFeatureExtractor calculates the MEC and CCA features of a data window for all target
+* frequencies at once. The reference signals only depend on the window length, since every window starts with
+* its own relative timeline. Their orthonormal bases are therefore calculated once per window length and kept,
+* and the correlations of a window with the references of all targets are calculated with one matrix product.
+*/
+class SSVEPBCISHARED_EXPORT SsvepBciFeatureExtractor
+{
+
+public:
+    //=========================================================================================================
+    /**
+    * constructs a SsvepBciFeatureExtractor object
+    */
+    SsvepBciFeatureExtractor();
+
+    //=========================================================================================================
+    /**
+    * Sets the parameters of the reference signals and clears all cached reference banks.
+    *
+    * @param[in]  lFrequencies          target frequencies [Hz].
+    * @param[in]  iNumberOfHarmonics    number of harmonics of each target frequency.
+    * @param[in]  dSampleFrequency      sample frequency of the data windows [Hz].
+    * @param[in]  bRemovePowerLine      whether the power line signal is removed from the data windows.
+    * @param[in]  iPowerLine            frequency of the power line [Hz].
+    */
+    void setParameters(const QList<double> &lFrequencies,
+                       int iNumberOfHarmonics,
+                       double dSampleFrequency,
+                       bool bRemovePowerLine,
+                       int iPowerLine);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of sub-bands of the filter-bank CCA. With zero sub-bands the plain CCA is calculated.
+    *
+    * @param[in]  iNumberOfSubBands     number of sub-bands.
+    */
+    void setNumberOfSubBands(int iNumberOfSubBands);
+
+    //=========================================================================================================
+    /**
+    * Calculates the Minimum Energy Combination of the data window for all target frequencies.
+    *
+    * @param[in]  matY      data window, one channel per column.
+    *
+    * @return  the MEC signal energy of each target frequency.
+    */
+    Eigen::VectorXd MEC(const Eigen::MatrixXd &matY);
+
+    //=========================================================================================================
+    /**
+    * Calculates the maximal canonical correlation of the data window for all target frequencies. If sub-bands
+    * are set, the weighted squared correlations of the sub-band filtered windows are summed up (filter-bank CCA).
+    *
+    * @param[in]  matY      data window, one channel per column.
+    *
+    * @return  the (filter-bank) CCA feature of each target frequency.
+    */
+    Eigen::VectorXd CCA(const Eigen::MatrixXd &matY);
+
+private:
+    //=========================================================================================================
+    /**
+    * The reference signals of all target frequencies for one window length.
+    */
+    struct ReferenceBank
+    {
+        Eigen::MatrixXd matX;               /**< sin/cos reference signals, 2*harmonics columns per target. */
+        Eigen::MatrixXd matQX;              /**< orthonormal basis of the reference signals of each target. */
+        Eigen::MatrixXd matQXCentered;      /**< orthonormal basis of the centered reference signals of each target. */
+        Eigen::MatrixXd matQPowerLine;      /**< orthonormal basis of the power line signal. */
+        QList<QSharedPointer<UTILSLIB::FilterData> > lSubBandFilters;  /**< band-pass filters of the filter-bank CCA. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Returns the reference bank of the given window length, it is created on first use.
+    *
+    * @param[in]  iSamples      window length.
+    *
+    * @return  the reference bank.
+    */
+    const ReferenceBank& referenceBank(int iSamples);
+
+    //=========================================================================================================
+    /**
+    * Removes the power line signal from the data window if requested.
+    *
+    * @param[in]  bank      reference bank of the window length.
+    * @param[in]  matY      data window, one channel per column.
+    *
+    * @return  the data window without power line signal.
+    */
+    Eigen::MatrixXd removePowerLine(const ReferenceBank &bank, const Eigen::MatrixXd &matY) const;
+
+    //=========================================================================================================
+    /**
+    * Calculates the maximal canonical correlations of a data window with the centered references of all targets.
+    *
+    * @param[in]  bank      reference bank of the window length.
+    * @param[in]  matY      data window, one channel per column.
+    *
+    * @return  the maximal canonical correlation of each target frequency.
+    */
+    Eigen::VectorXd canonicalCorrelations(const ReferenceBank &bank, const Eigen::MatrixXd &matY) const;
+
+    QList<double>               m_lFrequencies;             /**< target frequencies [Hz]. */
+    int                         m_iNumberOfHarmonics;       /**< number of harmonics of each target frequency. */
+    double                      m_dSampleFrequency;         /**< sample frequency of the data windows [Hz]. */
+    bool                        m_bRemovePowerLine;         /**< whether the power line signal is removed. */
+    int                         m_iPowerLine;               /**< frequency of the power line [Hz]. */
+    int                         m_iNumberOfSubBands;        /**< number of sub-bands of the filter-bank CCA, zero for plain CCA. */
+    QMap<int, ReferenceBank>    m_mapReferenceBanks;        /**< cached reference banks, the key is the window length. */
+};
+
+} // NAMESPACE
+
+#endif // SSVEPBCIFEATUREEXTRACTOR_H
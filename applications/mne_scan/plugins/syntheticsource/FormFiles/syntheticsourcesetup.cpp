@@ -0,0 +1,128 @@
+//=============================================================================================================
+/**
+* @file     syntheticsourcesetup.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the definition of the SyntheticSourceSetup class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "syntheticsourcesetup.h"
+#include "../syntheticsource.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SYNTHETICSOURCEPLUGIN;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SyntheticSourceSetup::SyntheticSourceSetup(SyntheticSource* pSyntheticSource, QWidget* parent)
+: QWidget(parent)
+, m_pSyntheticSource(pSyntheticSource)
+{
+    ui.setupUi(this);
+}
+
+
+//*************************************************************************************************************
+
+SyntheticSourceSetup::~SyntheticSourceSetup()
+{
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSourceSetup::initGui()
+{
+    //Init sampling and signal properties. The amplitudes are shown in micro Volt.
+    ui.m_spinBox_SamplingFreq->setValue(m_pSyntheticSource->m_iSamplingFreq);
+    ui.m_spinBox_SamplesPerBlock->setValue(m_pSyntheticSource->m_iSamplesPerBlock);
+    ui.m_spinBox_NumberChannels->setValue(m_pSyntheticSource->m_iNumberChannels);
+    ui.m_doubleSpinBox_TriggerInterval->setValue(m_pSyntheticSource->m_dTriggerInterval);
+    ui.m_doubleSpinBox_NoiseAmplitude->setValue(m_pSyntheticSource->m_dNoiseAmplitude * 1e6);
+    ui.m_doubleSpinBox_SinusoidAmplitude->setValue(m_pSyntheticSource->m_dSinusoidAmplitude * 1e6);
+    ui.m_doubleSpinBox_EvokedAmplitude->setValue(m_pSyntheticSource->m_dEvokedAmplitude * 1e6);
+
+    //Connect after the values were set, so the initialization does not write back rounded values
+    connect(ui.m_spinBox_SamplingFreq, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSamplingProperties);
+    connect(ui.m_spinBox_SamplesPerBlock, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSamplingProperties);
+    connect(ui.m_spinBox_NumberChannels, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSamplingProperties);
+    connect(ui.m_doubleSpinBox_TriggerInterval, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSignalProperties);
+    connect(ui.m_doubleSpinBox_NoiseAmplitude, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSignalProperties);
+    connect(ui.m_doubleSpinBox_SinusoidAmplitude, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSignalProperties);
+    connect(ui.m_doubleSpinBox_EvokedAmplitude, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+            this, &SyntheticSourceSetup::setSignalProperties);
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSourceSetup::setSamplingProperties()
+{
+    m_pSyntheticSource->m_iSamplingFreq = ui.m_spinBox_SamplingFreq->value();
+    m_pSyntheticSource->m_iSamplesPerBlock = ui.m_spinBox_SamplesPerBlock->value();
+    m_pSyntheticSource->m_iNumberChannels = ui.m_spinBox_NumberChannels->value();
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSourceSetup::setSignalProperties()
+{
+    m_pSyntheticSource->m_dTriggerInterval = ui.m_doubleSpinBox_TriggerInterval->value();
+    m_pSyntheticSource->m_dNoiseAmplitude = ui.m_doubleSpinBox_NoiseAmplitude->value() * 1e-6;
+    m_pSyntheticSource->m_dSinusoidAmplitude = ui.m_doubleSpinBox_SinusoidAmplitude->value() * 1e-6;
+    m_pSyntheticSource->m_dEvokedAmplitude = ui.m_doubleSpinBox_EvokedAmplitude->value() * 1e-6;
+}
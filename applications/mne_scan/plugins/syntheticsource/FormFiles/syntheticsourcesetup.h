@@ -0,0 +1,125 @@
+//=============================================================================================================
+/**
+* @file     syntheticsourcesetup.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the SyntheticSourceSetup class.
+*
+*/
+
+#ifndef SYNTHETICSOURCESETUP_H
+#define SYNTHETICSOURCESETUP_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../ui_syntheticsourcesetup.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtWidgets>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SYNTHETICSOURCEPLUGIN
+//=============================================================================================================
+
+namespace SYNTHETICSOURCEPLUGIN
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class SyntheticSource;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS SyntheticSourceSetup
+*
+* @brief The SyntheticSourceSetup class provides the SyntheticSource configuration window.
+*/
+class SyntheticSourceSetup : public QWidget
+{
+    Q_OBJECT
+public:
+
+    //=========================================================================================================
+    /**
+    * Constructs a SyntheticSourceSetup which is a child of parent.
+    *
+    * @param [in] pSyntheticSource  a pointer to the corresponding parent.
+    * @param [in] parent            pointer to parent widget; If parent is 0, the new SyntheticSourceSetup becomes a window. If parent is another widget, SyntheticSourceSetup becomes a child window inside parent. SyntheticSourceSetup is deleted when its parent is deleted.
+    */
+    SyntheticSourceSetup(SyntheticSource* pSyntheticSource, QWidget *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the SyntheticSourceSetup.
+    * All SyntheticSourceSetup's children are deleted first. The application exits if SyntheticSourceSetup is the main widget.
+    */
+    ~SyntheticSourceSetup();
+
+    //=========================================================================================================
+    /**
+    * Initializes the GUI properties.
+    */
+    void initGui();
+
+private:
+    //=========================================================================================================
+    /**
+    * Forward the sampling properties (sampling frequency, samples per block and number of channels).
+    */
+    void setSamplingProperties();
+
+    //=========================================================================================================
+    /**
+    * Forward the signal properties (trigger interval and amplitudes).
+    */
+    void setSignalProperties();
+
+    SyntheticSource*                    m_pSyntheticSource;     /**< A pointer to corresponding SyntheticSource.*/
+    Ui::SyntheticSourceSetupWidget      ui;                     /**< The user interface for the SyntheticSourceSetup.*/
+};
+
+} // NAMESPACE
+
+#endif // SYNTHETICSOURCESETUP_H
@@ -0,0 +1,227 @@
+//=============================================================================================================
+/**
+* @file     syntheticsignalgenerator.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the definition of the SyntheticSignalGenerator class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "syntheticsignalgenerator.h"
+
+#include <random>
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtMath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SYNTHETICSOURCEPLUGIN;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SyntheticSignalGenerator::SyntheticSignalGenerator()
+: m_iNumberChannels(0)
+, m_iSamplesPerBlock(0)
+, m_iTriggerInterval(1)
+, m_iTriggerWidth(1)
+, m_iNoiseTableSize(0)
+, m_dSamplingFreq(1.0)
+, m_dNoiseAmplitude(0.0)
+, m_dSinusoidAmplitude(0.0)
+, m_dEvokedAmplitude(0.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSignalGenerator::setUp(int iNumberChannels,
+                                     double dSamplingFreq,
+                                     int iSamplesPerBlock,
+                                     double dTriggerInterval,
+                                     quint32 uiSeed)
+{
+    const double dTwoPi = 2.0 * M_PI;
+
+    m_iNumberChannels = qMax(iNumberChannels, 1);
+    m_iSamplesPerBlock = qMax(iSamplesPerBlock, 1);
+    m_dSamplingFreq = dSamplingFreq;
+    m_iTriggerInterval = qMax<qint64>(qRound64(dTriggerInterval * dSamplingFreq), 1);
+    m_iTriggerWidth = qBound<qint64>(1, qRound64(0.005 * dSamplingFreq), m_iTriggerInterval);
+
+    //Spread the sinusoids between 2 and 40 Hz and use golden ratio phase offsets, so neighbouring channels differ
+    m_vecOmega.resize(m_iNumberChannels);
+    m_vecPhase.resize(m_iNumberChannels);
+    m_vecEvokedGain.resize(m_iNumberChannels);
+
+    for(int i = 0; i < m_iNumberChannels; ++i) {
+        const double dFreq = 2.0 + (i % 20) * 2.0;
+        m_vecOmega[i] = dTwoPi * dFreq / dSamplingFreq;
+        m_vecPhase[i] = dTwoPi * std::fmod(i * 0.6180339887498949, 1.0);
+        m_vecEvokedGain[i] = std::cos(dTwoPi * i / m_iNumberChannels);
+    }
+
+    m_vecCosOmega = m_vecOmega.array().cos();
+    m_vecSinOmega = m_vecOmega.array().sin();
+
+    //Gaussian noise table from a Box-Muller transform of mt19937. std::normal_distribution is implementation
+    //defined, which would make the data differ between platforms.
+    m_iNoiseTableSize = 1 << 18;
+    m_vecNoiseTable.resize(m_iNoiseTableSize + m_iSamplesPerBlock);
+
+    std::mt19937 generator(uiSeed);
+
+    for(qint64 i = 0; i < m_iNoiseTableSize; i += 2) {
+        const double dU1 = (generator() + 1.0) / 4294967297.0;
+        const double dU2 = generator() / 4294967296.0;
+        const double dRadius = std::sqrt(-2.0 * std::log(dU1));
+
+        m_vecNoiseTable[i] = dRadius * std::cos(dTwoPi * dU2);
+        m_vecNoiseTable[i + 1] = dRadius * std::sin(dTwoPi * dU2);
+    }
+
+    for(qint64 i = 0; i < m_iSamplesPerBlock; ++i) {
+        m_vecNoiseTable[m_iNoiseTableSize + i] = m_vecNoiseTable[i % m_iNoiseTableSize];
+    }
+
+    //N100/P200-like evoked template, cut at the next trigger onset
+    const qint64 iTemplateLength = qMin<qint64>(qRound64(0.5 * dSamplingFreq), m_iTriggerInterval);
+    m_vecEvokedTemplate.resize(iTemplateLength);
+
+    for(qint64 i = 0; i < iTemplateLength; ++i) {
+        const double dTime = i / dSamplingFreq;
+        m_vecEvokedTemplate[i] = - std::exp(-std::pow((dTime - 0.1) / 0.02, 2))
+                                 + 0.6 * std::exp(-std::pow((dTime - 0.2) / 0.04, 2));
+    }
+
+    m_vecTime.resize(m_iSamplesPerBlock);
+    m_vecEvoked.resize(m_iSamplesPerBlock);
+    m_vecCos.resize(m_iNumberChannels);
+    m_vecSin.resize(m_iNumberChannels);
+    m_vecCosNext.resize(m_iNumberChannels);
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSignalGenerator::setAmplitudes(double dNoise,
+                                             double dSinusoid,
+                                             double dEvoked)
+{
+    m_dNoiseAmplitude = dNoise;
+    m_dSinusoidAmplitude = dSinusoid;
+    m_dEvokedAmplitude = dEvoked;
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSignalGenerator::generate(qint64 iFirstSample,
+                                        MatrixXd& matBlock)
+{
+    const int iCols = m_iSamplesPerBlock;
+
+    matBlock.resize(rows(), iCols);
+
+    for(int j = 0; j < iCols; ++j) {
+        m_vecTime[j] = double(iFirstSample + j);
+    }
+
+    Block<MatrixXd> matData = matBlock.topRows(m_iNumberChannels);
+
+    //Sinusoids: evaluate the exact phase once per block and rotate all channels sample by sample from there.
+    //This keeps the inner loop to a few vectorized multiply-adds instead of one sin() call per sample.
+    if(m_dSinusoidAmplitude != 0.0) {
+        const ArrayXd vecPhase = m_vecOmega.array() * double(iFirstSample) + m_vecPhase.array();
+        m_vecCos = m_dSinusoidAmplitude * vecPhase.cos();
+        m_vecSin = m_dSinusoidAmplitude * vecPhase.sin();
+
+        for(int j = 0; j < iCols; ++j) {
+            matData.col(j) = m_vecSin.matrix();
+
+            m_vecCosNext = m_vecCos * m_vecCosOmega - m_vecSin * m_vecSinOmega;
+            m_vecSin = m_vecSin * m_vecCosOmega + m_vecCos * m_vecSinOmega;
+            m_vecCos.swap(m_vecCosNext);
+        }
+    } else {
+        matData.setZero();
+    }
+
+    //White noise, read from the table at a channel dependent offset
+    if(m_dNoiseAmplitude != 0.0) {
+        for(int i = 0; i < m_iNumberChannels; ++i) {
+            const qint64 iOffset = (i * qint64(104729) + iFirstSample) % m_iNoiseTableSize;
+            matData.row(i) += m_dNoiseAmplitude * Map<const RowVectorXd>(m_vecNoiseTable.data() + iOffset, iCols);
+        }
+    }
+
+    //Trigger train and the evoked response locked to it
+    const qint64 iTemplateLength = m_vecEvokedTemplate.cols();
+
+    for(int j = 0; j < iCols; ++j) {
+        const qint64 iLatency = (iFirstSample + j) % m_iTriggerInterval;
+
+        matBlock(stimRow(), j) = iLatency < m_iTriggerWidth ? 1.0 : 0.0;
+        m_vecEvoked[j] = iLatency < iTemplateLength ? m_vecEvokedTemplate[iLatency] : 0.0;
+    }
+
+    if(m_dEvokedAmplitude != 0.0) {
+        matData.noalias() += (m_dEvokedAmplitude * m_vecEvokedGain) * m_vecEvoked;
+    }
+
+    matBlock.row(sampleRow()) = m_vecTime;
+    matBlock.row(timeRow()).setZero();
+}
@@ -0,0 +1,255 @@
+//=============================================================================================================
+/**
+* @file     syntheticsignalgenerator.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the SyntheticSignalGenerator class.
+*
+*/
+
+#ifndef SYNTHETICSIGNALGENERATOR_H
+#define SYNTHETICSIGNALGENERATOR_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtGlobal>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SYNTHETICSOURCEPLUGIN
+//=============================================================================================================
+
+namespace SYNTHETICSOURCEPLUGIN
+{
+
+
+//=============================================================================================================
+/**
+* The generated block holds the data channels followed by a stimulus channel, a sample counter and a
+* timestamp row. All signals are a pure function of the seed and the absolute sample index, so two runs with
+* the same settings produce identical data regardless of block size or pacing.
+*
+* @brief Deterministic, vectorized generator for the synthetic source data blocks.
+*/
+class SyntheticSignalGenerator
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a SyntheticSignalGenerator.
+    */
+    SyntheticSignalGenerator();
+
+    //=========================================================================================================
+    /**
+    * Sets up the per-channel signal parameters, the noise table and the evoked template.
+    *
+    * @param [in] iNumberChannels       The number of data channels.
+    * @param [in] dSamplingFreq         The sampling frequency in Hertz.
+    * @param [in] iSamplesPerBlock      The number of samples per generated block.
+    * @param [in] dTriggerInterval      The time between two trigger onsets in seconds.
+    * @param [in] uiSeed                The seed of the noise table.
+    */
+    void setUp(int iNumberChannels,
+               double dSamplingFreq,
+               int iSamplesPerBlock,
+               double dTriggerInterval = 1.0,
+               quint32 uiSeed = 42);
+
+    //=========================================================================================================
+    /**
+    * Sets the amplitudes of the signal components. A zero amplitude skips the component.
+    *
+    * @param [in] dNoise        The standard deviation of the white noise.
+    * @param [in] dSinusoid     The amplitude of the per-channel sinusoids.
+    * @param [in] dEvoked       The peak amplitude of the evoked response.
+    */
+    void setAmplitudes(double dNoise,
+                       double dSinusoid,
+                       double dEvoked);
+
+    //=========================================================================================================
+    /**
+    * Generates the block starting at the absolute sample iFirstSample. The timestamp row is set to zero and
+    * meant to be stamped by the caller right before the block is emitted.
+    *
+    * @param [in] iFirstSample      The absolute index of the first sample in the block.
+    * @param [out] matBlock         The generated block of size rows() x samplesPerBlock().
+    */
+    void generate(qint64 iFirstSample,
+                  Eigen::MatrixXd& matBlock);
+
+    //=========================================================================================================
+    /**
+    * Returns the total number of rows of a generated block.
+    *
+    * @return The number of data channels plus the stimulus, sample counter and timestamp rows.
+    */
+    inline int rows() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples per generated block.
+    *
+    * @return The number of samples per block.
+    */
+    inline int samplesPerBlock() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the sampling frequency the generator was set up with.
+    *
+    * @return The sampling frequency in Hertz.
+    */
+    inline double samplingFreq() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the row index of the stimulus channel.
+    *
+    * @return The stimulus row.
+    */
+    inline int stimRow() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the row index of the sample counter.
+    *
+    * @return The sample counter row.
+    */
+    inline int sampleRow() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the row index of the timestamp.
+    *
+    * @return The timestamp row.
+    */
+    inline int timeRow() const;
+
+private:
+    int                 m_iNumberChannels;          /**< The number of data channels.*/
+    int                 m_iSamplesPerBlock;         /**< The number of samples per block.*/
+    qint64              m_iTriggerInterval;         /**< The trigger interval in samples.*/
+    qint64              m_iTriggerWidth;            /**< The width of a trigger pulse in samples.*/
+    qint64              m_iNoiseTableSize;          /**< The period of the noise table in samples.*/
+
+    double              m_dSamplingFreq;            /**< The sampling frequency in Hertz.*/
+
+    double              m_dNoiseAmplitude;          /**< The standard deviation of the white noise.*/
+    double              m_dSinusoidAmplitude;       /**< The amplitude of the sinusoids.*/
+    double              m_dEvokedAmplitude;         /**< The peak amplitude of the evoked response.*/
+
+    Eigen::VectorXd     m_vecOmega;                 /**< The angular frequency of each channel's sinusoid in radians per sample.*/
+    Eigen::VectorXd     m_vecPhase;                 /**< The phase offset of each channel's sinusoid.*/
+    Eigen::ArrayXd      m_vecCosOmega;              /**< The cosine of m_vecOmega, used to rotate the sinusoids by one sample.*/
+    Eigen::ArrayXd      m_vecSinOmega;              /**< The sine of m_vecOmega, used to rotate the sinusoids by one sample.*/
+    Eigen::VectorXd     m_vecEvokedGain;            /**< The spatial pattern of the evoked response.*/
+    Eigen::VectorXd     m_vecNoiseTable;            /**< The Gaussian noise table, padded by one block to allow contiguous reads.*/
+    Eigen::RowVectorXd  m_vecEvokedTemplate;        /**< The evoked response time course starting at the trigger onset.*/
+    Eigen::RowVectorXd  m_vecTime;                  /**< Workspace: the absolute sample indices of the current block.*/
+    Eigen::RowVectorXd  m_vecEvoked;                /**< Workspace: the evoked time course of the current block.*/
+    Eigen::ArrayXd      m_vecCos;                   /**< Workspace: the cosine of each channel's current phase.*/
+    Eigen::ArrayXd      m_vecSin;                   /**< Workspace: the sine of each channel's current phase.*/
+    Eigen::ArrayXd      m_vecCosNext;               /**< Workspace: the cosine of each channel's phase one sample ahead.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int SyntheticSignalGenerator::rows() const
+{
+    return m_iNumberChannels + 3;
+}
+
+
+//*************************************************************************************************************
+
+inline int SyntheticSignalGenerator::samplesPerBlock() const
+{
+    return m_iSamplesPerBlock;
+}
+
+
+//*************************************************************************************************************
+
+inline double SyntheticSignalGenerator::samplingFreq() const
+{
+    return m_dSamplingFreq;
+}
+
+
+//*************************************************************************************************************
+
+inline int SyntheticSignalGenerator::stimRow() const
+{
+    return m_iNumberChannels;
+}
+
+
+//*************************************************************************************************************
+
+inline int SyntheticSignalGenerator::sampleRow() const
+{
+    return m_iNumberChannels + 1;
+}
+
+
+//*************************************************************************************************************
+
+inline int SyntheticSignalGenerator::timeRow() const
+{
+    return m_iNumberChannels + 2;
+}
+
+} // NAMESPACE
+
+#endif // SYNTHETICSIGNALGENERATOR_H
@@ -0,0 +1,352 @@
+//=============================================================================================================
+/**
+* @file     syntheticsource.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the definition of the SyntheticSource class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "syntheticsource.h"
+#include "FormFiles/syntheticsourcesetup.h"
+
+#include <fiff/fiff.h>
+#include <scMeas/realtimemultisamplearray.h>
+
+#include <chrono>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSettings>
+#include <QElapsedTimer>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace SYNTHETICSOURCEPLUGIN;
+using namespace SCSHAREDLIB;
+using namespace SCMEASLIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SyntheticSource::SyntheticSource()
+: m_iSamplingFreq(1000)
+, m_iNumberChannels(128)
+, m_iSamplesPerBlock(100)
+, m_dTriggerInterval(1.0)
+, m_dNoiseAmplitude(10e-6)
+, m_dSinusoidAmplitude(20e-6)
+, m_dEvokedAmplitude(5e-6)
+, m_bIsRunning(false)
+, m_pRMTSA_SyntheticSource(PluginOutputData<RealTimeMultiSampleArray>::create(this, "SyntheticSource", "Synthetic output data"))
+, m_pFiffInfo(QSharedPointer<FiffInfo>::create())
+{
+}
+
+
+//*************************************************************************************************************
+
+SyntheticSource::~SyntheticSource()
+{
+    //If the program is closed while the sampling is in process
+    if(this->isRunning())
+        this->stop();
+
+    //Store settings for next use
+    QSettings settings;
+    settings.setValue(QString("SYNTHETICSOURCE/sFreq"), m_iSamplingFreq);
+    settings.setValue(QString("SYNTHETICSOURCE/samplesPerBlock"), m_iSamplesPerBlock);
+    settings.setValue(QString("SYNTHETICSOURCE/numberChannels"), m_iNumberChannels);
+    settings.setValue(QString("SYNTHETICSOURCE/triggerInterval"), m_dTriggerInterval);
+    settings.setValue(QString("SYNTHETICSOURCE/noiseAmplitude"), m_dNoiseAmplitude);
+    settings.setValue(QString("SYNTHETICSOURCE/sinusoidAmplitude"), m_dSinusoidAmplitude);
+    settings.setValue(QString("SYNTHETICSOURCE/evokedAmplitude"), m_dEvokedAmplitude);
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<IPlugin> SyntheticSource::clone() const
+{
+    QSharedPointer<SyntheticSource> pSyntheticSourceClone(new SyntheticSource());
+    return pSyntheticSourceClone;
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSource::init()
+{
+    m_outputConnectors.append(m_pRMTSA_SyntheticSource);
+
+    QSettings settings;
+    m_iSamplingFreq = settings.value(QString("SYNTHETICSOURCE/sFreq"), 1000).toInt();
+    m_iSamplesPerBlock = settings.value(QString("SYNTHETICSOURCE/samplesPerBlock"), 100).toInt();
+    m_iNumberChannels = settings.value(QString("SYNTHETICSOURCE/numberChannels"), 128).toInt();
+    m_dTriggerInterval = settings.value(QString("SYNTHETICSOURCE/triggerInterval"), 1.0).toDouble();
+    m_dNoiseAmplitude = settings.value(QString("SYNTHETICSOURCE/noiseAmplitude"), 10e-6).toDouble();
+    m_dSinusoidAmplitude = settings.value(QString("SYNTHETICSOURCE/sinusoidAmplitude"), 20e-6).toDouble();
+    m_dEvokedAmplitude = settings.value(QString("SYNTHETICSOURCE/evokedAmplitude"), 5e-6).toDouble();
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSource::unload()
+{
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSource::setUpFiffInfo()
+{
+    //
+    //Clear old fiff info data
+    //
+    m_pFiffInfo->clear();
+
+    //
+    //Set number of channels, sampling frequency and high/-lowpass. The stimulus, sample counter and timestamp
+    //channels follow the data channels.
+    //
+    m_pFiffInfo->nchan = m_iNumberChannels + 3;
+    m_pFiffInfo->sfreq = m_iSamplingFreq;
+    m_pFiffInfo->highpass = 0.001f;
+    m_pFiffInfo->lowpass = m_iSamplingFreq/2;
+
+    //
+    //Set up the channel info
+    //
+    QStringList QSLChNames;
+    m_pFiffInfo->chs.clear();
+
+    for(int i = 0; i < m_pFiffInfo->nchan; ++i)
+    {
+        FiffChInfo fChInfo;
+
+        fChInfo.logNo = i + 1;
+        fChInfo.scanNo = i + 1;
+        fChInfo.coord_frame = FIFFV_COORD_HEAD;
+
+        fChInfo.chpos.ex << 1, 0, 0;
+        fChInfo.chpos.ey << 0, 1, 0;
+        fChInfo.chpos.ez << 0, 0, 1;
+
+        if(i < m_iNumberChannels) {
+            //Data channels
+            fChInfo.ch_name = QString("EEG %1").arg(i + 1, 3, 10, QChar('0'));
+            fChInfo.kind = FIFFV_EEG_CH;
+            fChInfo.unit = FIFF_UNIT_V;
+        } else if(i == m_iNumberChannels) {
+            //Trigger train
+            fChInfo.ch_name = QString("STI 014");
+            fChInfo.kind = FIFFV_STIM_CH;
+            fChInfo.unit = FIFF_UNIT_NONE;
+        } else if(i == m_iNumberChannels + 1) {
+            //Absolute sample index, to detect dropped blocks downstream
+            fChInfo.ch_name = QString("SAMPLE");
+            fChInfo.kind = FIFFV_MISC_CH;
+            fChInfo.unit = FIFF_UNIT_NONE;
+        } else {
+            //Emission time in microseconds since epoch, to measure the end-to-end latency downstream
+            fChInfo.ch_name = QString("TIME");
+            fChInfo.kind = FIFFV_MISC_CH;
+            fChInfo.unit = FIFF_UNIT_NONE;
+        }
+
+        QSLChNames << fChInfo.ch_name;
+
+        m_pFiffInfo->chs.append(fChInfo);
+    }
+
+    //Set channel names in fiff_info_base
+    m_pFiffInfo->ch_names = QSLChNames;
+
+    //
+    //Set head projection
+    //
+    m_pFiffInfo->dev_head_t.from = FIFFV_COORD_DEVICE;
+    m_pFiffInfo->dev_head_t.to = FIFFV_COORD_HEAD;
+    m_pFiffInfo->ctf_head_t.from = FIFFV_COORD_DEVICE;
+    m_pFiffInfo->ctf_head_t.to = FIFFV_COORD_HEAD;
+}
+
+
+//*************************************************************************************************************
+
+bool SyntheticSource::start()
+{
+    //Check if the thread is already or still running.
+    //This can happen if the start button is pressed immediately after the stop button was pressed.
+    //In this case the stopping process is not finished yet but the start process is initiated.
+    if(this->isRunning()) {
+        this->wait();
+    }
+
+    //Setup fiff info before setting up the RMTSA because we need it to init the RTMSA
+    setUpFiffInfo();
+
+    //Set the channel size of the RMTSA - this needs to be done here and NOT in the init() function because the user can change the number of channels during runtime
+    m_pRMTSA_SyntheticSource->data()->initFromFiffInfo(m_pFiffInfo);
+    m_pRMTSA_SyntheticSource->data()->setMultiArraySize(1);
+
+    m_generator.setUp(m_iNumberChannels,
+                      m_iSamplingFreq,
+                      m_iSamplesPerBlock,
+                      m_dTriggerInterval);
+    m_generator.setAmplitudes(m_dNoiseAmplitude,
+                              m_dSinusoidAmplitude,
+                              m_dEvokedAmplitude);
+
+    m_bIsRunning = true;
+
+    QThread::start(QThread::HighPriority);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool SyntheticSource::stop()
+{
+    //Wait until this thread (SyntheticSource) is stopped
+    m_bIsRunning = false;
+    this->wait();
+
+    m_pRMTSA_SyntheticSource->data()->clear();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+IPlugin::PluginType SyntheticSource::getType() const
+{
+    return _ISensor;
+}
+
+
+//*************************************************************************************************************
+
+QString SyntheticSource::getName() const
+{
+    return "Synthetic Source";
+}
+
+
+//*************************************************************************************************************
+
+QWidget* SyntheticSource::setupWidget()
+{
+    SyntheticSourceSetup* widget = new SyntheticSourceSetup(this);//widget is later destroyed by CentralWidget - so it has to be created everytime new
+
+    //init properties dialog
+    widget->initGui();
+
+    return widget;
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSource::run()
+{
+    //The setup widget may change the members while running, so stick to the values the generator was set up with
+    const int iSamplesPerBlock = m_generator.samplesPerBlock();
+    const double dSamplingFreq = m_generator.samplingFreq();
+
+    MatrixXd matData;
+    qint64 iFirstSample = 0;
+    qint64 iBlocks = 0;
+    qint64 iLateBlocks = 0;
+
+    //Blocks are scheduled against absolute deadlines on a monotonic clock, so sleep jitter does not accumulate
+    QElapsedTimer timer;
+    timer.start();
+
+    while(m_bIsRunning) {
+        m_generator.generate(iFirstSample, matData);
+        iFirstSample += iSamplesPerBlock;
+
+        //The block is due once its last sample would have been acquired
+        const qint64 iDueNs = qint64(double(iFirstSample) * 1.0e9 / dSamplingFreq);
+        const qint64 iRemainingNs = iDueNs - timer.nsecsElapsed();
+
+        if(iRemainingNs < 0) {
+            ++iLateBlocks;
+        } else {
+            //Sleep coarsely and yield for the last millisecond to meet the deadline closely
+            if(iRemainingNs > 2000000) {
+                QThread::usleep((iRemainingNs - 1000000) / 1000);
+            }
+
+            while(timer.nsecsElapsed() < iDueNs) {
+                QThread::yieldCurrentThread();
+            }
+        }
+
+        const qint64 iNowUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        matData.row(m_generator.timeRow()).setConstant(double(iNowUs));
+
+        m_pRMTSA_SyntheticSource->data()->setValue(matData);
+        ++iBlocks;
+    }
+
+    if(iLateBlocks > 0) {
+        qWarning() << "SyntheticSource::run - " << iLateBlocks << "of" << iBlocks << "blocks could not be generated in time.";
+    }
+}
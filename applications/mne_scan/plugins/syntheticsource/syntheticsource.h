@@ -0,0 +1,197 @@
+//=============================================================================================================
+/**
+* @file     syntheticsource.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Contains the declaration of the SyntheticSource class.
+*
+*/
+
+#ifndef SYNTHETICSOURCE_H
+#define SYNTHETICSOURCE_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "syntheticsource_global.h"
+#include "syntheticsignalgenerator.h"
+
+#include <scShared/Interfaces/ISensor.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace SCMEASLIB {
+    class RealTimeMultiSampleArray;
+}
+
+namespace FIFFLIB {
+    class FiffInfo;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE SYNTHETICSOURCEPLUGIN
+//=============================================================================================================
+
+namespace SYNTHETICSOURCEPLUGIN
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// SYNTHETICSOURCEPLUGIN FORWARD DECLARATIONS
+//=============================================================================================================
+
+class SyntheticSourceSetup;
+
+
+//=============================================================================================================
+/**
+* The SyntheticSource class generates deterministic multi-channel data (noise, sinusoids, an evoked response
+* and a trigger train) at an arbitrary channel count and sampling frequency. Blocks are emitted on a schedule
+* derived from a monotonic high resolution clock, so the plugin can be used as a reference workload for
+* benchmarking downstream plugins. Besides the data channels, each block carries a stimulus channel, a sample
+* counter (to detect dropped blocks) and the wall clock time the block was emitted, in microseconds since
+* epoch (to measure end-to-end latency).
+*
+* @brief The SyntheticSource class provides a synthetic data source for load testing.
+*/
+class SYNTHETICSOURCESHARED_EXPORT SyntheticSource : public SCSHAREDLIB::ISensor
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID "scsharedlib/1.0" FILE "syntheticsource.json") //New Qt5 Plugin system replaces Q_EXPORT_PLUGIN2 macro
+    // Use the Q_INTERFACES() macro to tell Qt's meta-object system about the interfaces
+    Q_INTERFACES(SCSHAREDLIB::ISensor)
+
+    friend class SyntheticSourceSetup;
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a SyntheticSource.
+    */
+    SyntheticSource();
+
+    //=========================================================================================================
+    /**
+    * Destroys the SyntheticSource.
+    */
+    virtual ~SyntheticSource();
+
+    //=========================================================================================================
+    /**
+    * Clone the plugin
+    */
+    virtual QSharedPointer<SCSHAREDLIB::IPlugin> clone() const;
+
+    //=========================================================================================================
+    /**
+    * Initialise input and output connectors.
+    */
+    virtual void init();
+
+    //=========================================================================================================
+    /**
+    * Is called when plugin is detached of the stage. Can be used to safe settings.
+    */
+    virtual void unload();
+
+    //=========================================================================================================
+    /**
+    * Sets up the fiff info with the current data chosen by the user.
+    */
+    void setUpFiffInfo();
+
+    //=========================================================================================================
+    /**
+    * Starts the SyntheticSource by starting the generator thread.
+    */
+    virtual bool start();
+
+    //=========================================================================================================
+    /**
+    * Stops the SyntheticSource by stopping the generator thread.
+    */
+    virtual bool stop();
+
+    virtual IPlugin::PluginType getType() const;
+    virtual QString getName() const;
+    virtual QWidget* setupWidget();
+
+protected:
+    //=========================================================================================================
+    /**
+    * The starting point for the thread. After calling start(), the newly created thread calls this function.
+    * Returning from this method will end the execution of the thread.
+    * Pure virtual method inherited by QThread.
+    */
+    virtual void run();
+
+    int                     m_iSamplingFreq;                /**< The sampling frequency defined by the user via the GUI (in Hertz).*/
+    int                     m_iNumberChannels;              /**< The number of data channels to be generated.*/
+    int                     m_iSamplesPerBlock;             /**< The number of samples per block to be generated.*/
+    double                  m_dTriggerInterval;             /**< The time between two trigger onsets (in seconds).*/
+    double                  m_dNoiseAmplitude;              /**< The standard deviation of the white noise (in Volt).*/
+    double                  m_dSinusoidAmplitude;           /**< The amplitude of the sinusoids (in Volt).*/
+    double                  m_dEvokedAmplitude;             /**< The peak amplitude of the evoked response (in Volt).*/
+    bool                    m_bIsRunning;                   /**< Whether SyntheticSource is running.*/
+
+    SyntheticSignalGenerator    m_generator;                /**< The generator of the data blocks. Only used by the plugin's thread while running.*/
+
+    QSharedPointer<SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeMultiSampleArray> >     m_pRMTSA_SyntheticSource;   /**< The RealTimeSampleArray to provide the generated data.*/
+    QSharedPointer<FIFFLIB::FiffInfo>                                                       m_pFiffInfo;                /**< Fiff measurement info.*/
+};
+
+} // NAMESPACE
+
+#endif // SYNTHETICSOURCE_H
@@ -127,7 +127,10 @@ void TMSI::init()
     m_iSamplesPerBlock = 16;
     m_iTriggerInterval = 5000;
     m_iSplitFileSizeMs = 10;
-    m_iSplitCount = 0;
+
+    //The recorder writes to disk on its own thread
+    m_pRawRecorder = FiffRawRecorder::SPtr(new FiffRawRecorder());
+    m_pRawWriter = FiffRollingRawWriter::SPtr(new FiffRollingRawWriter());
 
     m_bUseChExponent = true;
     m_bUseUnitGain = true;
@@ -611,45 +614,10 @@ void TMSI::setKeyboardTriggerType(int type)
 }
 
 
-//*************************************************************************************************************
-
-void TMSI::splitRecordingFile()
-{
-    qDebug() << "Split recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sOutputFilePath.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    /*
-    * Write the link to the next file
-    */
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_fileOut.setFileName(nextFileName);
-    m_pOutfid = Fiff::start_writing_raw(m_fileOut, *m_pFiffInfo, m_cals);
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-}
-
-
 //*************************************************************************************************************
 
 void TMSI::run()
 {
-    qint32 size = 0;
-
     while(m_bIsRunning)
     {
         //std::cout<<"TMSI::run(s)"<<std::endl;
@@ -681,19 +649,10 @@ void TMSI::run()
             if(m_bUseKeyboardTrigger && m_iTriggerType!=0)
                 matValue(136, m_iSamplesPerBlock-1) = m_iTriggerType;
 
-            //Write raw data to fif file
+            //Write raw data to fif file. The recorder only queues the data, the disk is accessed on its own thread.
             if(m_bWriteToFile) {
-                m_pOutfid->write_raw_buffer(matValue.cast<double>(), m_cals);
-                size += matValue.cols();
-
-//                qDebug()<<"size"<<size;
-//                qDebug()<<"(m_iSplitFileSizeMs/1000)*m_pFiffInfo->sfreq"<<(double(m_iSplitFileSizeMs)/1000.0)*m_pFiffInfo->sfreq;
-                if(size > (double(m_iSplitFileSizeMs)/1000.0)*m_pFiffInfo->sfreq && m_bSplitFile) {
-                    size = 0;
-                    splitRecordingFile();
-                }
-            } else
-                size = 0;
+                m_pRawRecorder->write(matValue);
+            }
 
             // TODO: Use preprocessing if wanted by the user
             if(m_bUseFiltering)
@@ -779,8 +738,10 @@ void TMSI::run()
     //Close the fif output stream
     if(m_bWriteToFile)
     {
-        m_pOutfid->finish_writing_raw();
+        //Write all queued data before finishing the file
         m_bWriteToFile = false;
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
         m_pTimerRecordingChange->stop();
         m_pActionStartRecording->setIcon(QIcon(":/images/record.png"));
     }
@@ -831,13 +792,13 @@ void TMSI::showSetupProjectDialog()
 
 void TMSI::showStartRecording()
 {
-    m_iSplitCount = 0;
-
     //Setup writing to file
     if(m_bWriteToFile)
     {
-        m_pOutfid->finish_writing_raw();
+        //Write all queued data before finishing the file
         m_bWriteToFile = false;
+        m_pRawRecorder->stopRecording();
+        m_pRawWriter->finish();
         m_pTimerRecordingChange->stop();
         m_pActionStartRecording->setIcon(QIcon(":/images/record.png"));
     }
@@ -883,9 +844,14 @@ void TMSI::showStartRecording()
             dir.mkpath(fileDir);
         }
 
-        m_pOutfid = Fiff::start_writing_raw(m_fileOut, *m_pFiffInfo, m_cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        //Split the file after m_iSplitFileSizeMs of samples
+        m_pRawWriter->setMaxFileDuration(m_bSplitFile ? double(m_iSplitFileSizeMs)/1000.0 : 0.0);
+
+        if(!m_pRawWriter->start(m_sOutputFilePath, *m_pFiffInfo, m_cals)) {
+            return;
+        }
+
+        m_pRawRecorder->startRecording(m_pRawWriter, m_cals);
 
         m_bWriteToFile = true;
 
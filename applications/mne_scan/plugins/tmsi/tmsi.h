@@ -80,6 +80,7 @@
 //=============================================================================================================
 
 #include <fiff/fiff.h>
+#include <fiff/fiff_raw_recorder.h>
 
 
 //*************************************************************************************************************
@@ -187,8 +188,6 @@ public:
 
     void setKeyboardTriggerType(int type);
 
-    void splitRecordingFile();
-
 protected:
     //=========================================================================================================
     /**
@@ -239,7 +238,6 @@ private:
     int                                 m_iSamplingFreq;                    /**< The sampling frequency defined by the user via the GUI (in Hertz).*/
     int                                 m_iNumberOfChannels;                /**< The number of channels defined by the user via the GUI.*/
     int                                 m_iSamplesPerBlock;                 /**< The samples per block defined by the user via the GUI.*/
-    qint32                              m_iSplitCount;                      /**< File split count */
 
     int                                 m_iTriggerInterval;                 /**< The gap between the trigger signals which request the subject to do something (in ms).*/
     QTime                               m_qTimerTrigger;                    /**< Time stemp of the last trigger event (in ms).*/
@@ -265,7 +263,8 @@ private:
     QString                             m_sOutputFilePath;                  /**< Holds the path for the sample output file. Defined by the user via the GUI.*/
     QString                             m_sElcFilePath;                     /**< Holds the path for the .elc file (electrode positions). Defined by the user via the GUI.*/
     QFile                               m_fileOut;                          /**< QFile for writing to fif file.*/
-    FiffStream::SPtr                    m_pOutfid;                          /**< QFile for writing to fif file.*/
+    FiffRollingRawWriter::SPtr          m_pRawWriter;                       /**< Writes the recording to one or more fif files.*/
+    FiffRawRecorder::SPtr               m_pRawRecorder;                     /**< Writes the raw data to m_pRawWriter on its own thread.*/
     QSharedPointer<FiffInfo>            m_pFiffInfo;                        /**< Fiff measurement info.*/
     RowVectorXd                         m_cals;
 
@@ -102,6 +102,7 @@ SOURCES += \
     plots/graph.cpp \
     plots/tfplot.cpp \
     plots/helpers/colormap.cpp \
+    plots/helpers/colormaplut.cpp \
     viewers/filterdesignview.cpp \
     viewers/averagelayoutview.cpp \
     viewers/spectrumview.cpp \
@@ -138,6 +139,8 @@ SOURCES += \
     viewers/helpers/frequencyspectrumdelegate.cpp \
     viewers/helpers/frequencyspectrummodel.cpp \
     viewers/helpers/channeldatamodel.cpp \
+    viewers/helpers/minmaxpyramid.cpp \
+    viewers/helpers/evokedpolylinecache.cpp \
     viewers/helpers/channeldatadelegate.cpp \
 
 HEADERS += \
@@ -147,6 +150,7 @@ HEADERS += \
     plots/graph.h \
     plots/tfplot.h \
     plots/helpers/colormap.h \
+    plots/helpers/colormaplut.h \
     viewers/filterdesignview.h \
     viewers/averagelayoutview.h \
     viewers/spectrumview.h \
@@ -183,6 +187,8 @@ HEADERS += \
     viewers/helpers/frequencyspectrumdelegate.h \
     viewers/helpers/frequencyspectrummodel.h \
     viewers/helpers/channeldatamodel.h \
+    viewers/helpers/minmaxpyramid.h \
+    viewers/helpers/evokedpolylinecache.h \
     viewers/helpers/channeldatadelegate.h \
 
 qtHaveModule(charts) {
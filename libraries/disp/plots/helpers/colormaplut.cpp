@@ -0,0 +1,226 @@
+//=============================================================================================================
+/**
+* @file     colormaplut.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the ColorMapLut class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "colormaplut.h"
+#include "colormap.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISPLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+ColorMapLut::ColorMapLut()
+: m_functionHandlerColorMap(ColorMap::valueToJet)
+, m_vecTable(1024)
+, m_fScale(0.0f)
+{
+    setColorMap(ColorMap::valueToJet);
+}
+
+
+//*************************************************************************************************************
+
+ColorMapLut::ColorMapLut(QRgb (*functionHandlerColorMap)(double v), int iSize)
+: m_functionHandlerColorMap(functionHandlerColorMap)
+, m_vecTable(iSize < 2 ? 2 : iSize)
+, m_fScale(0.0f)
+{
+    setColorMap(functionHandlerColorMap);
+}
+
+
+//*************************************************************************************************************
+
+void ColorMapLut::setColorMap(QRgb (*functionHandlerColorMap)(double v))
+{
+    m_functionHandlerColorMap = functionHandlerColorMap;
+
+    const int iSize = m_vecTable.size();
+    m_fScale = static_cast<float>(iSize - 1);
+    m_matTableRgbF.resize(iSize, 3);
+
+    for(int i = 0; i < iSize; ++i) {
+        const QRgb qRgb = m_functionHandlerColorMap(static_cast<double>(i) / (iSize - 1));
+        m_vecTable[i] = qRgb;
+        m_matTableRgbF(i,0) = (float)qRed(qRgb)/255.0f;
+        m_matTableRgbF(i,1) = (float)qGreen(qRgb)/255.0f;
+        m_matTableRgbF(i,2) = (float)qBlue(qRgb)/255.0f;
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool ColorMapLut::setColorMap(const QString& sColorMap)
+{
+    QRgb (*functionHandlerColorMap)(double v) = colorMapFunction(sColorMap);
+
+    if(!functionHandlerColorMap) {
+        return false;
+    }
+
+    setColorMap(functionHandlerColorMap);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QRgb (*ColorMapLut::colorMapFunction(const QString& sColorMap))(double v)
+{
+    if(sColorMap == QStringLiteral("Jet")) {
+        return ColorMap::valueToJet;
+    } else if(sColorMap == QStringLiteral("Hot")) {
+        return ColorMap::valueToHot;
+    } else if(sColorMap == QStringLiteral("HotNeg1") || sColorMap == QStringLiteral("Hot Negative 1")) {
+        return ColorMap::valueToHotNegative1;
+    } else if(sColorMap == QStringLiteral("HotNeg2") || sColorMap == QStringLiteral("Hot Negative 2")) {
+        return ColorMap::valueToHotNegative2;
+    } else if(sColorMap == QStringLiteral("Bone")) {
+        return ColorMap::valueToBone;
+    } else if(sColorMap == QStringLiteral("RedBlue")) {
+        return ColorMap::valueToRedBlue;
+    }
+
+    return Q_NULLPTR;
+}
+
+
+//*************************************************************************************************************
+
+QImage ColorMapLut::toImage(const MatrixXd& matValues,
+                            bool bFlipVertical) const
+{
+    const int iRows = matValues.rows();
+    const int iCols = matValues.cols();
+
+    QImage image(iCols, iRows, QImage::Format_RGB32);
+
+    if(image.isNull()) {
+        return image;
+    }
+
+    //Detach here once. The threads below only write to disjoint scan lines.
+    uchar* pBits = image.bits();
+    const int iBytesPerLine = image.bytesPerLine();
+    const QRgb* pTable = m_vecTable.constData();
+    const float fScale = m_fScale;
+
+    //Convert blocks of rows, which keeps the reads from the column major matrix contiguous
+    const int iBlockSize = 32;
+    QVector<int> vecBlockStarts;
+    for(int r = 0; r < iRows; r += iBlockSize) {
+        vecBlockStarts.append(r);
+    }
+
+    QtConcurrent::blockingMap(vecBlockStarts, [&](const int& iStart) {
+        const int iNumRows = qMin(iBlockSize, iRows - iStart);
+
+        //Clamp to [0,1]. NaN fails the comparison and ends up at the lower end.
+        ArrayXXf matBlock = matValues.middleRows(iStart, iNumRows).cast<float>().array();
+        matBlock = (matBlock > 0.0f).select(matBlock, 0.0f).min(1.0f);
+        const ArrayXXi matIndex = (matBlock * fScale + 0.5f).cast<int>();
+
+        for(int r = 0; r < iNumRows; ++r) {
+            const int iLine = bFlipVertical ? iRows - 1 - (iStart + r) : iStart + r;
+            QRgb* pLine = reinterpret_cast<QRgb*>(pBits + iLine * iBytesPerLine);
+
+            for(int c = 0; c < iCols; ++c) {
+                pLine[c] = pTable[matIndex(r,c)];
+            }
+        }
+    });
+
+    return image;
+}
+
+
+//*************************************************************************************************************
+
+void ColorMapLut::mapThresholded(const VectorXf& vecData,
+                                 MatrixX3f& matColor,
+                                 float fThresholdX,
+                                 float fThresholdZ) const
+{
+    if(vecData.rows() != matColor.rows()) {
+        qDebug() << "ColorMapLut::mapThresholded - Sizes of input data (" << vecData.rows() <<") do not match output data ("<< matColor.rows() <<"). Returning ...";
+        return;
+    }
+
+    const float fTresholdDiff = fThresholdZ - fThresholdX;
+
+    //Take the absolute values because the histogram threshold is also calcualted using the absolute values
+    const ArrayXf vecAbs = vecData.array().abs();
+
+    //Normalize all values at once, values above the upper threshold are mapped to one
+    ArrayXf vecNormalized;
+    if(fTresholdDiff != 0.0f) {
+        vecNormalized = ((vecAbs - fThresholdX) / fTresholdDiff).min(1.0f);
+    } else {
+        vecNormalized = (vecAbs >= fThresholdZ).cast<float>();
+    }
+
+    for(int r = 0; r < vecData.rows(); ++r) {
+        //Values below the lower threshold keep their original color
+        if(vecAbs(r) >= fThresholdX) {
+            matColor.row(r) = m_matTableRgbF.row(index(vecNormalized(r)));
+        }
+    }
+}
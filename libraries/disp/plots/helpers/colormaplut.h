@@ -0,0 +1,250 @@
+//=============================================================================================================
+/**
+* @file     colormaplut.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the ColorMapLut class.
+*
+*/
+
+#ifndef COLORMAPLUT_H
+#define COLORMAPLUT_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QColor>
+#include <QImage>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISPLIB
+//=============================================================================================================
+
+namespace DISPLIB
+{
+
+
+//=============================================================================================================
+/**
+* Samples one of the ColorMap functions once into a lookup table, so that mapping values to colors costs a
+* multiplication and a table access instead of evaluating the fuzzy sets per value.
+*
+* @brief Lookup table for ColorMap transformations
+*/
+class DISPSHARED_EXPORT ColorMapLut
+{
+public:
+    typedef QSharedPointer<ColorMapLut> SPtr;            /**< Shared pointer type for ColorMapLut class. */
+    typedef QSharedPointer<const ColorMapLut> ConstSPtr; /**< Const shared pointer type for ColorMapLut class. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a Jet lookup table.
+    */
+    ColorMapLut();
+
+    //=========================================================================================================
+    /**
+    * Constructs a lookup table for the given color map function.
+    *
+    * @param[in] functionHandlerColorMap    The color map function, e.g. ColorMap::valueToHot.
+    * @param[in] iSize                      The number of table entries spanning [0,1].
+    */
+    explicit ColorMapLut(QRgb (*functionHandlerColorMap)(double v), int iSize = 1024);
+
+    //=========================================================================================================
+    /**
+    * Resamples the table for a new color map function.
+    *
+    * @param[in] functionHandlerColorMap    The color map function, e.g. ColorMap::valueToHot.
+    */
+    void setColorMap(QRgb (*functionHandlerColorMap)(double v));
+
+    //=========================================================================================================
+    /**
+    * Resamples the table for a color map given by its name. The short names used by the plots ("HotNeg1") and the
+    * names used by disp3D ("Hot Negative 1") are both accepted.
+    *
+    * @param[in] sColorMap      The color map name, e.g. "Jet", "Hot", "Hot Negative 1", "Bone" or "RedBlue".
+    *
+    * @return false if the name is unknown. The table is left unchanged in this case.
+    */
+    bool setColorMap(const QString& sColorMap);
+
+    //=========================================================================================================
+    /**
+    * Returns the color map function which corresponds to a color map name.
+    *
+    * @param[in] sColorMap      The color map name, e.g. "Jet", "Hot", "Hot Negative 1", "Bone" or "RedBlue".
+    *
+    * @return the color map function or NULL if the name is unknown.
+    */
+    static QRgb (*colorMapFunction(const QString& sColorMap))(double v);
+
+    //=========================================================================================================
+    /**
+    * Converts a matrix of values in [0,1] to an image with one pixel per value. The colors are written directly
+    * into the scan lines. Blocks of rows are converted in parallel. Values outside of [0,1] are clamped and NaN
+    * is mapped to the lower end.
+    *
+    * @param[in] matValues      The values, row i becomes image line i.
+    * @param[in] bFlipVertical  If true, row i becomes image line rows-1-i, i.e. the first row is at the bottom.
+    *
+    * @return the image in QImage::Format_RGB32.
+    */
+    QImage toImage(const Eigen::MatrixXd& matValues,
+                   bool bFlipVertical = false) const;
+
+    //=========================================================================================================
+    /**
+    * Colors all entries whose absolute value reaches the lower threshold. The absolute values are mapped
+    * linearly from [fThresholdX, fThresholdZ] to the table. Values above the upper threshold get the last
+    * table color. Entries below the lower threshold keep their color.
+    *
+    * @param[in] vecData        The data.
+    * @param[in, out] matColor  The RGB colors in [0,1], one row per entry of vecData.
+    * @param[in] fThresholdX    The lower threshold.
+    * @param[in] fThresholdZ    The upper threshold.
+    */
+    void mapThresholded(const Eigen::VectorXf& vecData,
+                        Eigen::MatrixX3f& matColor,
+                        float fThresholdX,
+                        float fThresholdZ) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the table index of a value. Values outside of [0,1] are clamped.
+    *
+    * @param[in] fValue     The value.
+    *
+    * @return the table index.
+    */
+    inline int index(float fValue) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the color of a value. Values outside of [0,1] are clamped.
+    *
+    * @param[in] fValue     The value.
+    *
+    * @return the RGB color.
+    */
+    inline QRgb lookup(float fValue) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the table as RGB values scaled to [0,1], one row per entry.
+    *
+    * @return the table.
+    */
+    inline const Eigen::MatrixX3f& tableRgbF() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of table entries.
+    *
+    * @return the table size.
+    */
+    inline int size() const;
+
+private:
+    QRgb (*m_functionHandlerColorMap)(double v);    /**< The color map function the table was sampled from. */
+    QVector<QRgb>       m_vecTable;                 /**< The sampled colors. */
+    Eigen::MatrixX3f    m_matTableRgbF;             /**< The sampled colors scaled to [0,1]. */
+    float               m_fScale;                   /**< Maps [0,1] to the table index range. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int ColorMapLut::index(float fValue) const
+{
+    //Written such that NaN ends up at the lower end
+    if(!(fValue > 0.0f)) {
+        return 0;
+    }
+    if(fValue >= 1.0f) {
+        return m_vecTable.size() - 1;
+    }
+    return static_cast<int>(fValue * m_fScale + 0.5f);
+}
+
+
+//*************************************************************************************************************
+
+inline QRgb ColorMapLut::lookup(float fValue) const
+{
+    return m_vecTable.at(index(fValue));
+}
+
+
+//*************************************************************************************************************
+
+inline const Eigen::MatrixX3f& ColorMapLut::tableRgbF() const
+{
+    return m_matTableRgbF;
+}
+
+
+//*************************************************************************************************************
+
+inline int ColorMapLut::size() const
+{
+    return m_vecTable.size();
+}
+
+} // NAMESPACE DISPLIB
+
+#endif // COLORMAPLUT_H
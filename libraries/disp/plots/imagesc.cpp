@@ -133,6 +133,7 @@ void ImageSc::init()
 
     //Colormap
     pColorMapper = ColorMap::valueToJet;
+    m_colorMapLut.setColorMap(pColorMapper);
 
     //Colorbar
     m_bColorbar = true;
@@ -201,26 +202,11 @@ void ImageSc::updateMaps()
     if(m_matCentNormData.rows() > 0 && m_matCentNormData.cols() > 0)
     {
         // --Data--
-        qint32 x = m_matCentNormData.cols();
-        qint32 y = m_matCentNormData.rows();
-        qint32 i, j;
-        QImage t_qImageData(x, y, QImage::Format_RGB32);
-        for(i = 0; i < x; ++i)
-            for(j = 0; j < y; ++j)
-                t_qImageData.setPixel(i, j, pColorMapper(m_matCentNormData(j,i)));
+        m_pPixmapData = new QPixmap(QPixmap::fromImage(m_colorMapLut.toImage(m_matCentNormData)));
 
-        m_pPixmapData = new QPixmap(QPixmap::fromImage(t_qImageData));
-
-        // --Colorbar--
-        QImage t_qImageColorbar(1, m_iColorbarGradSteps, QImage::Format_RGB32);
-
-        double t_dQuantile = 1.0/((double)m_iColorbarGradSteps-1);
-        for(j = 0; j < m_iColorbarGradSteps; ++j)
-        {
-            QRgb t_qRgb = pColorMapper(t_dQuantile*((double)(m_iColorbarGradSteps-1-j))*1.0);
-            t_qImageColorbar.setPixel(0, j, t_qRgb);
-        }
-        m_pPixmapColorbar = new QPixmap(QPixmap::fromImage(t_qImageColorbar));
+        // --Colorbar-- (maximum on top)
+        MatrixXd t_matColorbar = VectorXd::LinSpaced(m_iColorbarGradSteps, 1.0, 0.0);
+        m_pPixmapColorbar = new QPixmap(QPixmap::fromImage(m_colorMapLut.toImage(t_matColorbar)));
 
 
         // --Scale Values--
@@ -275,6 +261,8 @@ void ImageSc::setColorMap(const QString &p_sColorMap)
     else
         pColorMapper = ColorMap::valueToJet;
 
+    m_colorMapLut.setColorMap(pColorMapper);
+
     updateMaps();
 }
 
@@ -43,6 +43,7 @@
 
 #include "../disp_global.h"
 #include "graph.h"
+#include "helpers/colormaplut.h"
 
 
 //*************************************************************************************************************
@@ -207,6 +208,7 @@ protected:
     QPen                m_qPenColorbar;             /**< Colorbar pen */
 
     QRgb                (*pColorMapper)(double);    /**< Function pointer to current colormap */
+    ColorMapLut         m_colorMapLut;              /**< Lookup table sampled from the current colormap */
 
 };
 
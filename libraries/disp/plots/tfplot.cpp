@@ -40,6 +40,7 @@
 #include "tfplot.h"
 
 #include "helpers/colormap.h"
+#include "helpers/colormaplut.h"
 
 
 //*************************************************************************************************************
@@ -132,37 +133,32 @@ void TFplot::calc_plot(Eigen::MatrixXd tf_matrix,
     if(std::fabs(mnorm) > norm1) norm1 = mnorm;
     tf_matrix /= norm1;
 
-    //setup image
-    QImage * image_to_tf_plot = new QImage(tf_matrix.cols(), tf_matrix.rows(), QImage::Format_RGB32);
-
-    //setup pixelcolors in image
-    QColor color;
-    for ( qint32 y = 0; y < tf_matrix.rows(); y++ ) {
-        for ( qint32 x = 0; x < tf_matrix.cols(); x++ ) {
-            switch  (cmap) {
-                case Jet:
-                    color.setRgb(ColorMap::valueToJet(std::fabs(tf_matrix(y, x))));
-                    break;
-                case Hot:
-                    color.setRgb(ColorMap::valueToHot(std::fabs(tf_matrix(y, x))));
-                    break;
-                case HotNeg1:
-                    color.setRgb(ColorMap::valueToHotNegative1(std::fabs(tf_matrix(y, x))));
-                    break;
-                case HotNeg2:
-                    color.setRgb(ColorMap::valueToHotNegative2(std::fabs(tf_matrix(y, x))));
-                    break;
-                case Bone:
-                    color.setRgb(ColorMap::valueToBone(std::fabs(tf_matrix(y, x))));
-                    break;
-                case RedBlue:
-                    color.setRgb(ColorMap::valueToRedBlue(std::fabs(tf_matrix(y, x))));
-                    break;
-            }
-            image_to_tf_plot->setPixel(x, tf_matrix.rows() - 1 -  y,  color.rgb());
-        }
+    //Sample the selected colormap once
+    ColorMapLut colorMapLut;
+    switch  (cmap) {
+        case Jet:
+            colorMapLut.setColorMap(ColorMap::valueToJet);
+            break;
+        case Hot:
+            colorMapLut.setColorMap(ColorMap::valueToHot);
+            break;
+        case HotNeg1:
+            colorMapLut.setColorMap(ColorMap::valueToHotNegative1);
+            break;
+        case HotNeg2:
+            colorMapLut.setColorMap(ColorMap::valueToHotNegative2);
+            break;
+        case Bone:
+            colorMapLut.setColorMap(ColorMap::valueToBone);
+            break;
+        case RedBlue:
+            colorMapLut.setColorMap(ColorMap::valueToRedBlue);
+            break;
     }
 
+    //setup image, the lowest frequency is at the bottom
+    QImage * image_to_tf_plot = new QImage(colorMapLut.toImage(tf_matrix.cwiseAbs(), true));
+
     *image_to_tf_plot = image_to_tf_plot->scaled(tf_matrix.cols(), tf_matrix.cols()/2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     *image_to_tf_plot = image_to_tf_plot->scaledToWidth(/*0.9 **/ 1026, Qt::SmoothTransformation);
     //image to pixmap
@@ -171,33 +167,9 @@ void TFplot::calc_plot(Eigen::MatrixXd tf_matrix,
     QGraphicsScene *tf_scene = new QGraphicsScene();
     tf_scene->addItem(tf_pixmap);
 
-    QImage * coeffs_image = new QImage(10, tf_matrix.rows(), QImage::Format_RGB32);
     qreal norm = tf_matrix.maxCoeff();
-    for(qint32 it = 0; it < tf_matrix.rows(); it++) {
-        for ( qint32 x = 0; x < 10; x++ ) {
-            switch  (cmap) {
-                case Jet:
-                    color.setRgb(ColorMap::valueToJet(it*norm/tf_matrix.rows()));
-                    break;
-                case Hot:
-                    color.setRgb(ColorMap::valueToHot(it*norm/tf_matrix.rows()));
-                    break;
-                case HotNeg1:
-                    color.setRgb(ColorMap::valueToHotNegative1(it*norm/tf_matrix.rows()));
-                    break;
-                case HotNeg2:
-                    color.setRgb(ColorMap::valueToHotNegative2(it*norm/tf_matrix.rows()));
-                    break;
-                case Bone:
-                    color.setRgb(ColorMap::valueToBone(it*norm/tf_matrix.rows()));
-                    break;
-                case RedBlue:
-                    color.setRgb(ColorMap::valueToRedBlue(it*norm/tf_matrix.rows()));
-                    break;
-              }
-              coeffs_image->setPixel(x, tf_matrix.rows() - 1 -  it,  color.rgb());
-        }
-    }
+    Eigen::MatrixXd coeffs_matrix = Eigen::VectorXd::LinSpaced(tf_matrix.rows(), 0, (tf_matrix.rows()-1)*norm/tf_matrix.rows()).replicate(1, 10);
+    QImage * coeffs_image = new QImage(colorMapLut.toImage(coeffs_matrix, true));
 
     *coeffs_image = coeffs_image->scaled(10, tf_matrix.cols()/2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     *coeffs_image = coeffs_image->scaledToHeight(image_to_tf_plot->height(), Qt::SmoothTransformation);
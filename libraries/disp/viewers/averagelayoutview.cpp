@@ -272,21 +272,24 @@ void AverageLayoutView::updateData()
     //Get current items from the average scene
     QList<QGraphicsItem *> currentAverageSceneItems = m_pAverageScene->items();
 
-    //Set new data for all averageSceneItems
+    //Get only the necessary data from the average model (use column 2)
+    QList<QPair<QString, DISPLIB::RowVectorPair> > averageData = m_pEvokedSetModel->data(0, 2, EvokedSetModelRoles::GetAverageData).value<QList<QPair<QString, DISPLIB::RowVectorPair> > >();
+
+    //Set new data for all averageSceneItems. Only repaint the items whose data actually changed.
     for(int i = 0; i < currentAverageSceneItems.size(); i++) {
         AverageSceneItem* averageSceneItemTemp = static_cast<AverageSceneItem*>(currentAverageSceneItems.at(i));
 
         averageSceneItemTemp->m_lAverageData.clear();
 
-        //Get only the necessary data from the average model (use column 2)
-        QList<QPair<QString, DISPLIB::RowVectorPair> > averageData = m_pEvokedSetModel->data(0, 2, EvokedSetModelRoles::GetAverageData).value<QList<QPair<QString, DISPLIB::RowVectorPair> > >();
-
         //Get the averageScenItem specific data row
         int channelNumber = m_pChannelInfoModel->getIndexFromMappedChName(averageSceneItemTemp->m_sChannelName);
 
         if(channelNumber != -1) {
             //qDebug() << "Change data for" << channelNumber << "" << averageSceneItemTemp->m_sChannelName;
 
+            QPair<int,int> firstLastSample(averageSceneItemTemp->m_firstLastSample);
+            bool bIsBad = averageSceneItemTemp->m_bIsBad;
+
             averageSceneItemTemp->m_iChannelKind = m_pChannelInfoModel->data(m_pChannelInfoModel->index(channelNumber, 4), ChannelInfoModelRoles::GetChKind).toInt();
             averageSceneItemTemp->m_iChannelUnit = m_pChannelInfoModel->data(m_pChannelInfoModel->index(channelNumber, 6), ChannelInfoModelRoles::GetChUnit).toInt();
             averageSceneItemTemp->m_firstLastSample.first = (-1)*m_pEvokedSetModel->getNumPreStimSamples();
@@ -295,13 +298,25 @@ void AverageLayoutView::updateData()
                 averageSceneItemTemp->m_firstLastSample.second = averageData.first().second.second - m_pEvokedSetModel->getNumPreStimSamples();
             }
 
+            QMap<QString, quint32> qMapAverageRevision;
+            for(int j = 0; j < averageData.size(); ++j) {
+                qMapAverageRevision.insert(averageData.at(j).first, m_pEvokedSetModel->getChannelRevision(averageData.at(j).first, channelNumber));
+            }
+
+            bool bChanged = averageSceneItemTemp->m_iChannelNumber != channelNumber
+                    || firstLastSample != averageSceneItemTemp->m_firstLastSample
+                    || averageSceneItemTemp->m_qMapAverageRevision != qMapAverageRevision;
+
             averageSceneItemTemp->m_iChannelNumber = channelNumber;
             averageSceneItemTemp->m_iTotalNumberChannels = m_pEvokedSetModel->rowCount();
             averageSceneItemTemp->m_lAverageData = averageData;
+            averageSceneItemTemp->m_qMapAverageRevision = qMapAverageRevision;
             averageSceneItemTemp->m_bIsBad = m_pEvokedSetModel->getIsChannelBad(channelNumber);
+
+            if(bChanged || bIsBad != averageSceneItemTemp->m_bIsBad) {
+                averageSceneItemTemp->update();
+            }
         }
     }
-
-    m_pAverageScene->updateScene();
 }
 
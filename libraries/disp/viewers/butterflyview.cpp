@@ -78,6 +78,7 @@ ButterflyView::ButterflyView(QWidget *parent, Qt::WindowFlags f)
 #endif
 , m_pEvokedSetModel(NULL)
 , m_bIsInit(false)
+, m_iNumSamples(0)
 , m_bShowMAG(true)
 , m_bShowGRAD(true)
 , m_bShowEEG(true)
@@ -113,9 +114,19 @@ void ButterflyView::dataUpdate()
         m_bIsInit = true;
     }
 
-    setAverageActivation(m_qMapAverageActivation);
+    //The stimulus bar and time spacers depend on the number of samples -> repaint everything
+    if(m_iNumSamples != m_pEvokedSetModel->getNumSamples()) {
+        m_iNumSamples = m_pEvokedSetModel->getNumSamples();
+        update();
+        return;
+    }
 
-    update();
+    //Only repaint the area covered by the old and new polylines of the channels which changed
+    QRect rectDirty = updatePolylines();
+
+    if(!rectDirty.isEmpty()) {
+        update(rectDirty);
+    }
 }
 
 
@@ -376,57 +387,20 @@ void ButterflyView::showSelectedChannelsOnly(const QStringList& selectedChannels
             painter.restore();
         }
 
-        painter.translate(0,this->height()/2);
-
         //Actual average data
-        for(qint32 r = 0; r < m_pEvokedSetModel->rowCount(); ++r) {
-            if(m_lSelectedChannels.contains(r)) {
-                qint32 kind = m_pEvokedSetModel->getKind(r);
-
-                //Display only selected kinds
-                switch(kind) {
-                    case FIFFV_MEG_CH: {
-                        qint32 unit = m_pEvokedSetModel->getUnit(r);
-                        if(unit == FIFF_UNIT_T_M) {
-                            if(m_modalityMap["GRAD"])
-                                break;
-                            else
-                                continue;
-                        }
-                        else if(unit == FIFF_UNIT_T)
-                        {
-                            if(m_modalityMap["MAG"])
-                                break;
-                            else
-                                continue;
-                        }
-                        continue;
-                    }
-                    case FIFFV_EEG_CH: {
-                        if(m_modalityMap["EEG"])
-                            break;
-                        else
-                            continue;
-                    }
-                    case FIFFV_EOG_CH: {
-                        if(m_modalityMap["EOG"])
-                            break;
-                        else
-                            continue;
-                    }
-                    case FIFFV_MISC_CH: {
-                        if(m_modalityMap["MISC"])
-                            break;
-                        else
-                            continue;
-                    }
-                    default:
-                        continue;
-                }
+#if defined(USE_OPENGL)
+        QRect rectDirty = this->rect();
+#else
+        QRect rectDirty = event->rect();
+#endif
 
+        QList<AvrTypeRowVectorPair> lAverageData = m_pEvokedSetModel->data(0, 2, EvokedSetModelRoles::GetAverageData).value<QList<AvrTypeRowVectorPair> >();
+
+        for(qint32 r = 0; r < m_pEvokedSetModel->rowCount(); ++r) {
+            if(isRowVisible(r)) {
                 painter.save();
 
-                createPlotPath(r, painter);
+                createPlotPath(r, painter, lAverageData, rectDirty);
 
                 painter.restore();
             }
@@ -443,17 +417,154 @@ void ButterflyView::showSelectedChannelsOnly(const QStringList& selectedChannels
 
 //*************************************************************************************************************
 
-void ButterflyView::createPlotPath(qint32 row, QPainter& painter) const
+void ButterflyView::createPlotPath(qint32 row,
+                                   QPainter& painter,
+                                   const QList<QPair<QString, QPair<const double*,qint32> > >& lAverageData,
+                                   const QRect& rectDirty)
 {
-    //get maximum range of respective channel type (range value in FiffChInfo does not seem to contain a reasonable value)
-    qint32 kind = m_pEvokedSetModel->getKind(row);
-    float fMaxValue = 1e-9f;
-    bool bIsBad = m_pEvokedSetModel->getIsChannelBad(row);
+    const qint32 iChannelIdx = m_pEvokedSetModel->getIdxSelMap().value(row, row);
 
-    if(bIsBad) {
+    if(m_pEvokedSetModel->getIsChannelBad(row)) {
         painter.setOpacity(0.20);
     }
 
+    //Do for all average types
+    for(int j = 0; j < lAverageData.size(); ++j) {
+        QString sAvrComment = lAverageData.at(j).first;
+
+        if(!m_qMapAverageActivation->value(sAvrComment)) {
+            continue;
+        }
+
+        // Select color for each average
+        if(m_pEvokedSetModel->isFreezed()) {
+            QColor freezeColor = m_qMapAverageColor->value(sAvrComment);
+            freezeColor.setAlphaF(0.5);
+            painter.setPen(QPen(freezeColor, 1));
+        } else {
+            painter.setPen(QPen(m_qMapAverageColor->value(sAvrComment)));
+        }
+
+        //Polylines are only rebuilt here if the view's geometry or scaling changed since the last data update
+        updatePolyline(row, lAverageData.at(j));
+
+        if(m_polylineCache.boundingRect(sAvrComment, iChannelIdx).intersects(rectDirty)) {
+            painter.drawPolyline(m_polylineCache.polyline(sAvrComment, iChannelIdx));
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+QRectF ButterflyView::updatePolyline(qint32 row,
+                                     const QPair<QString, QPair<const double*,qint32> >& averageData)
+{
+    const qint32 iChannelIdx = m_pEvokedSetModel->getIdxSelMap().value(row, row);
+    const quint32 iRevision = m_pEvokedSetModel->getChannelRevision(averageData.first, iChannelIdx);
+    const qint32 iNumSamples = averageData.second.second;
+
+    //Map the samples to [1, width-1] and center the zero line. Clip the plot to the widget area.
+    EvokedPolylineCache::Mapping mapping;
+    mapping.dX0 = 1.0;
+    mapping.dWidth = this->width() - 2;
+    mapping.dY0 = this->height() / 2;
+    mapping.dScaleY = -this->height() / (2.0 * getMaxValue(row));
+    mapping.dClip = (this->height() - 2) / 2.0;
+
+    if(m_polylineCache.isValid(averageData.first, iChannelIdx, iRevision, mapping, iNumSamples)) {
+        return QRectF();
+    }
+
+    //Evoked matrices are stored in column major
+    return m_polylineCache.update(averageData.first,
+                                  iChannelIdx,
+                                  iRevision,
+                                  mapping,
+                                  averageData.second.first + iChannelIdx,
+                                  iNumSamples,
+                                  m_pEvokedSetModel->rowCount());
+}
+
+
+//*************************************************************************************************************
+
+QRect ButterflyView::updatePolylines()
+{
+    QRectF rectDirty;
+
+    if(!m_bIsInit || !m_pEvokedSetModel) {
+        return QRect();
+    }
+
+    QList<AvrTypeRowVectorPair> lAverageData = m_pEvokedSetModel->data(0, 2, EvokedSetModelRoles::GetAverageData).value<QList<AvrTypeRowVectorPair> >();
+
+    //Remove polylines of averages which are no longer present
+    QStringList lAvrTypes;
+    for(int j = 0; j < lAverageData.size(); ++j) {
+        lAvrTypes << lAverageData.at(j).first;
+    }
+
+    rectDirty = m_polylineCache.retain(lAvrTypes);
+
+    for(qint32 r = 0; r < m_pEvokedSetModel->rowCount(); ++r) {
+        if(isRowVisible(r)) {
+            for(int j = 0; j < lAverageData.size(); ++j) {
+                if(m_qMapAverageActivation->value(lAverageData.at(j).first)) {
+                    rectDirty = rectDirty.united(updatePolyline(r, lAverageData.at(j)));
+                }
+            }
+        }
+    }
+
+    return rectDirty.toAlignedRect();
+}
+
+
+//*************************************************************************************************************
+
+bool ButterflyView::isRowVisible(qint32 row) const
+{
+    if(!m_lSelectedChannels.contains(row)) {
+        return false;
+    }
+
+    //Display only selected kinds
+    switch(m_pEvokedSetModel->getKind(row)) {
+        case FIFFV_MEG_CH: {
+            qint32 unit = m_pEvokedSetModel->getUnit(row);
+            if(unit == FIFF_UNIT_T_M) {
+                return m_modalityMap.value("GRAD");
+            }
+            else if(unit == FIFF_UNIT_T)
+            {
+                return m_modalityMap.value("MAG");
+            }
+            return false;
+        }
+        case FIFFV_EEG_CH: {
+            return m_modalityMap.value("EEG");
+        }
+        case FIFFV_EOG_CH: {
+            return m_modalityMap.value("EOG");
+        }
+        case FIFFV_MISC_CH: {
+            return m_modalityMap.value("MISC");
+        }
+        default:
+            return false;
+    }
+}
+
+
+//*************************************************************************************************************
+
+float ButterflyView::getMaxValue(qint32 row) const
+{
+    //get maximum range of respective channel type (range value in FiffChInfo does not seem to contain a reasonable value)
+    qint32 kind = m_pEvokedSetModel->getKind(row);
+    float fMaxValue = 1e-9f;
+
     switch(kind) {
         case FIFFV_MEG_CH: {
             qint32 unit = m_pEvokedSetModel->getUnit(row);
@@ -507,96 +618,5 @@ void ButterflyView::createPlotPath(qint32 row, QPainter& painter) const
         }
     }
 
-    float fValue;
-    float fScaleY = this->height()/(2*fMaxValue);
-
-    //restrictions for paint performance
-    float fWinMaxVal = ((float)this->height()-2)/2.0f;
-    qint32 iDownSampling = (m_pEvokedSetModel->getNumSamples() * 4 / (this->width()-2));
-    if(iDownSampling < 1) {
-        iDownSampling = 1;
-    }
-
-    QPointF qSamplePosition;
-
-    float fDx = (float)(this->width()-2) / ((float)m_pEvokedSetModel->getNumSamples()-1.0f);//((float)option.rect.width()) / m_pEvokedSetModel->getMaxSamples();
-
-    QList<DISPLIB::AvrTypeRowVector> rowVec = m_pEvokedSetModel->data(row,1).value<QList<DISPLIB::AvrTypeRowVector> >();
-
-    //Do for all average types
-    for(int j = 0; j < rowVec.size(); ++j) {
-        QString sAvrComment = rowVec.at(j).first;
-
-        // Select color for each average
-        if(m_pEvokedSetModel->isFreezed()) {
-            QColor freezeColor = m_qMapAverageColor->value(sAvrComment);
-            freezeColor.setAlphaF(0.5);
-            painter.setPen(QPen(freezeColor, 1));
-        } else {
-            painter.setPen(QPen(m_qMapAverageColor->value(sAvrComment)));
-        }
-
-        if(m_qMapAverageActivation->value(sAvrComment)) {
-            //Calculate downsampling factor of averaged data in respect to the items width
-            int dsFactor;
-            rowVec.at(j).second.cols() / this->width() < 1 ? dsFactor = 1 : dsFactor = rowVec.at(j).second.cols() / this->width();
-            if(dsFactor == 0) {
-                dsFactor = 1;
-            }
-
-            QPainterPath path(QPointF(1,0));
-            float y_base = path.currentPosition().y();
-
-            //Move to initial starting point
-            if(rowVec.at(j).second.cols() > 0)
-            {
-                float val = rowVec.at(j).second[0];
-                fValue = (val/*-rowVec.at(j)[m_pEvokedSetModel->getNumPreStimSamples()-1]*/)*fScaleY;//ToDo -> -2 PreStim is one too short
-
-                float newY = y_base+fValue;
-
-                qSamplePosition.setY(-newY);
-                qSamplePosition.setX(path.currentPosition().x());
-
-                path.moveTo(qSamplePosition);
-            }
-
-            //create lines from one to the next sample
-            qint32 i;
-            for(i = 1; i < rowVec.at(j).second.cols() && path.elementCount() <= this->width(); i += dsFactor) {
-                float val = /*rowVec.at(j)[m_pEvokedSetModel->getNumPreStimSamples()-1] - */rowVec.at(j).second[i]; //remove first sample data[0] as offset
-                fValue = val*fScaleY;
-
-                //Cut plotting if out of widget area
-                fValue = fValue > fWinMaxVal ? fWinMaxVal : fValue < -fWinMaxVal ? -fWinMaxVal : fValue;
-
-                float newY = y_base+fValue;
-
-                qSamplePosition.setY(-newY);
-
-                qSamplePosition.setX(path.currentPosition().x()+fDx);
-
-                path.lineTo(qSamplePosition);
-            }
-
-        //    //create lines from one to the next sample for last path
-        //    qint32 sample_offset = m_pEvokedSetModel->numVLines() + 1;
-        //    qSamplePosition.setX(qSamplePosition.x() + fDx*sample_offset);
-        //    lastPath.moveTo(qSamplePosition);
-
-        //    for(i += sample_offset; i < lastData.size(); ++i) {
-        //        float val = lastData[i] - lastData[0]; //remove first sample lastData[0] as offset
-        //        fValue = val*fScaleY;
-
-        //        float newY = y_base+fValue;
-
-        //        qSamplePosition.setY(newY);
-        //        qSamplePosition.setX(lastPath.currentPosition().x()+fDx);
-
-        //        lastPath.lineTo(qSamplePosition);
-        //    }
-
-            painter.drawPath(path);
-        }
-    }
+    return fMaxValue;
 }
@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include "../disp_global.h"
+#include "helpers/evokedpolylinecache.h"
 
 
 //*************************************************************************************************************
@@ -248,11 +249,58 @@ protected:
 
     //=========================================================================================================
     /**
-    * createPlotPath creates the QPointer path for the data plot.
+    * createPlotPath paints the cached polylines of all averages of the given row. Polylines which do not intersect
+    * the dirty region are skipped.
     *
-    * @param[in] index QModelIndex for accessing associated data and model object.
+    * @param[in] row            The row to plot.
+    * @param[in] painter        The painter used to plot.
+    * @param[in] lAverageData   The average data pointers as provided by the evoked set model (column 2).
+    * @param[in] rectDirty      The region which needs to be repainted.
     */
-    void createPlotPath(qint32 row, QPainter& painter) const;
+    void createPlotPath(qint32 row,
+                        QPainter& painter,
+                        const QList<QPair<QString, QPair<const double*,qint32> > >& lAverageData,
+                        const QRect& rectDirty);
+
+    //=========================================================================================================
+    /**
+    * Rebuilds the cached polyline of a given row and average if it is out of date.
+    *
+    * @param[in] row            The row.
+    * @param[in] averageData    The average type and data pointer as provided by the evoked set model (column 2).
+    *
+    * @return the area covered by the old and new polyline if it was rebuilt, an empty rect otherwise.
+    */
+    QRectF updatePolyline(qint32 row,
+                          const QPair<QString, QPair<const double*,qint32> >& averageData);
+
+    //=========================================================================================================
+    /**
+    * Rebuilds all out of date polylines of the visible rows.
+    *
+    * @return the area which needs to be repainted.
+    */
+    QRect updatePolylines();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the given row is selected and its modality is currently shown.
+    *
+    * @param[in] row    The row.
+    *
+    * @return true if the row is visible.
+    */
+    bool isRowVisible(qint32 row) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the maximum range of the channel type of the given row.
+    *
+    * @param[in] row    The row.
+    *
+    * @return the value which is mapped to half of the view's height.
+    */
+    float getMaxValue(qint32 row) const;
 
     bool        m_bShowMAG;                     /**< Show Magnetometers channels */
     bool        m_bShowGRAD;                    /**< Show Gradiometers channels */
@@ -260,6 +308,7 @@ protected:
     bool        m_bShowEOG;                     /**< Show EEG channels */
     bool        m_bShowMISC;                    /**< Show Miscellaneous channels */
     bool        m_bIsInit;                      /**< Whether this class has been initialized */
+    qint32      m_iNumSamples;                  /**< The number of samples at the last data update */
 
     QColor      m_colCurrentBackgroundColor;    /**< The current background color */
 
@@ -273,6 +322,8 @@ protected:
 
     QSharedPointer<QMap<QString, bool> >    m_qMapAverageActivation;        /**< Average activation status. */
     QSharedPointer<QMap<QString, QColor> >  m_qMapAverageColor;             /**< Average colors. */
+
+    EvokedPolylineCache                     m_polylineCache;                /**< The cached and decimated polylines per average and channel. */
 };
 
 
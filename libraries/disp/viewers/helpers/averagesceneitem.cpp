@@ -237,14 +237,12 @@ void AverageSceneItem::paintAveragePath(QPainter *painter)
     //Plot averaged data
     QRectF boundingRect = this->boundingRect();
     double dScaleY = (boundingRect.height())/(2*dMaxValue);
-    QPointF qSamplePosition;
 
     //do for all currently stored evoked set data
     for(int dataIndex = 0; dataIndex < m_lAverageData.size(); ++dataIndex) {
         QString sAvrComment = m_lAverageData.at(dataIndex).first;
 
         if(m_qMapAverageActivation[sAvrComment]) {
-            //plot data from averaged data m_lAverageData with the calculated downsample factor
             const double* averageData = m_lAverageData.at(dataIndex).second.first;
             int totalCols =  m_lAverageData.at(dataIndex).second.second;
 
@@ -259,10 +257,28 @@ void AverageSceneItem::paintAveragePath(QPainter *painter)
                 dsFactor = 1;
             }
 
-            //Create path
-            //float offset = (*(averageData+(0*m_iTotalNumberChannels)+m_iChannelNumber)); //choose offset to be the signal value at first sample
-            float offset = 0;
-            QPainterPath path = QPainterPath(QPointF(boundingRect.x(), boundingRect.y() + boundingRect.height()/2));
+            //Map the samples to the item's rect. Cut plotting of bad channels if six times bigger than m_iMaxHeigth.
+            EvokedPolylineCache::Mapping mapping;
+            mapping.dX0 = boundingRect.x() + 1;
+            mapping.dWidth = qMin(double(totalCols - 1) / dsFactor, boundingRect.width());
+            mapping.dY0 = boundingRect.y() + boundingRect.height()/2;
+            mapping.dScaleY = -dScaleY;
+            mapping.dClip = m_bIsBad ? 6*m_iMaxHeigth : 0.0;
+
+            //Only rebuild the polyline if the data or scaling changed since the last paint
+            quint32 iRevision = m_qMapAverageRevision.value(sAvrComment);
+
+            if(!m_polylineCache.isValid(sAvrComment, m_iChannelNumber, iRevision, mapping, totalCols)) {
+                //evoked matrix is stored in column major
+                m_polylineCache.update(sAvrComment,
+                                       m_iChannelNumber,
+                                       iRevision,
+                                       mapping,
+                                       averageData + m_iChannelNumber,
+                                       totalCols,
+                                       m_iTotalNumberChannels);
+            }
+
             QPen pen;
             pen.setStyle(Qt::SolidLine);
             pen.setColor(Qt::yellow);
@@ -274,23 +290,7 @@ void AverageSceneItem::paintAveragePath(QPainter *painter)
             pen.setWidthF(3);
             painter->setPen(pen);
 
-            for(int i = 0; i < totalCols && path.elementCount() <= boundingRect.width(); i += dsFactor) {
-                //evoked matrix is stored in column major
-                double val = ((*(averageData+(i*m_iTotalNumberChannels)+m_iChannelNumber))-offset) * dScaleY;
-
-                //Cut plotting if six times bigger than m_iMaxHeigth
-                if(std::fabs(val) > 6*m_iMaxHeigth && m_bIsBad) {
-                    qSamplePosition.setY(-(val/val) * m_iMaxHeigth); //(val/val) used to retrieve sign of val
-                    qSamplePosition.setX(path.currentPosition().x()+1);
-                } else {
-                    qSamplePosition.setY(-val);
-                    qSamplePosition.setX(path.currentPosition().x()+1);
-                }
-
-                path.lineTo(qSamplePosition);
-            }
-
-            painter->drawPath(path);
+            painter->drawPolyline(m_polylineCache.polyline(sAvrComment, m_iChannelNumber));
         }
     }
 }
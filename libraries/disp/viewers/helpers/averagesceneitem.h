@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include "../../disp_global.h"
+#include "evokedpolylinecache.h"
 
 
 //*************************************************************************************************************
@@ -132,6 +133,7 @@ public:
     QMap<qint32,float>                              m_scaleMap;                 /**< Map with all channel types and their current scaling value.*/
     QMap<QString, bool>                             m_qMapAverageActivation;    /**< The average activation information.*/
     QMap<QString, QColor>                           m_qMapAverageColor;         /**< The average color information.*/
+    QMap<QString, quint32>                          m_qMapAverageRevision;      /**< The revision of the average data per average type as reported by the EvokedSetModel.*/
 
     QRectF                                          m_rectBoundingRect;         /**< The bounding rect. */
 
@@ -152,6 +154,8 @@ protected:
     */
     void paintStimLine(QPainter *painter);
 
+    EvokedPolylineCache                             m_polylineCache;            /**< The cached and decimated polylines per average type.*/
+
 signals:
     //=========================================================================================================
     /**
@@ -580,6 +580,15 @@ void ChannelDataDelegate::createPlotPath(const QModelIndex &index,
 
     double val;
 
+    //Zoomed out to more than two samples per pixel -> only draw the min/max envelope of each pixel column
+    const MinMaxPyramid& pyramid = t_pModel->getDecimationPyramid();
+    qint32 iRow = t_pModel->getIdxSelMap().value(index.row(),0);
+
+    if(dDx < 0.5 && pyramid.matches(pyramid.numberChannels(), data.second)) {
+        createDecimatedPlotPath(pyramid, iRow, data, dDx, dScaleY, y_base, currentSampleIndex, lastFirstValue, path, ellipsePos, amplitude);
+        return;
+    }
+
     for(qint32 j=0; j < data.second; ++j)
     {
         if(j<currentSampleIndex)
@@ -607,6 +616,72 @@ void ChannelDataDelegate::createPlotPath(const QModelIndex &index,
 }
 
 
+//*************************************************************************************************************
+
+void ChannelDataDelegate::createDecimatedPlotPath(const MinMaxPyramid& pyramid,
+                                                  qint32 iRow,
+                                                  const RowVectorPair &data,
+                                                  double dDx,
+                                                  double dScaleY,
+                                                  double y_base,
+                                                  int currentSampleIndex,
+                                                  double lastFirstValue,
+                                                  QPainterPath& path,
+                                                  QPointF &ellipsePos,
+                                                  QString &amplitude) const
+{
+    double x_base = path.currentPosition().x();
+    double dSamplesPerPixel = 1.0/dDx;
+    qint32 iMarkerSample = (qint32)(m_markerPosition.x()/dDx);
+
+    double dMin, dMax, dOffset;
+    qint32 iFrom = 0;
+
+    for(qint32 iColumn = 1; iFrom < data.second; ++iColumn) {
+        qint32 iTo = qMin((qint32)(iColumn*dSamplesPerPixel), (qint32)data.second);
+
+        //The offset changes at the current sample index, so never merge samples across it
+        if(iFrom < currentSampleIndex && iTo > currentSampleIndex) {
+            iTo = currentSampleIndex;
+        }
+
+        if(iTo <= iFrom) {
+            continue;
+        }
+
+        if(pyramid.range(data.first, iRow, iFrom, iTo, dMin, dMax)) {
+            if(iFrom<currentSampleIndex)
+                dOffset = *(data.first); //remove first sample data[0] as offset
+            else
+                dOffset = lastFirstValue; //do not remove first sample data[0] as offset because this is the last data part
+
+            double x = x_base + iTo*dDx;
+            double yMin = y_base-(dMin-dOffset)*dScaleY;//Reverse direction -> plot the right way
+            double yMax = y_base-(dMax-dOffset)*dScaleY;
+
+            //Keep the trace direction within the pixel column to avoid spurious vertical jumps
+            if(*(data.first+iTo-1) >= *(data.first+iFrom)) {
+                path.lineTo(x, yMin);
+                path.lineTo(x, yMax);
+            } else {
+                path.lineTo(x, yMax);
+                path.lineTo(x, yMin);
+            }
+
+            //Create ellipse position
+            if(iMarkerSample >= iFrom && iMarkerSample < iTo) {
+                ellipsePos.setX(x+dDx);
+                ellipsePos.setY(y_base-(*(data.first+iMarkerSample)-dOffset)*dScaleY);
+
+                amplitude = QString::number(*(data.first+iMarkerSample));
+            }
+        }
+
+        iFrom = iTo;
+    }
+}
+
+
 //*************************************************************************************************************
 
 void ChannelDataDelegate::createCurrentPositionMarkerPath(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path) const
@@ -79,6 +79,8 @@ namespace DISPLIB
 // DISPLIB FORWARD DECLARATIONS
 //=============================================================================================================
 
+class MinMaxPyramid;
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -182,6 +184,35 @@ private:
                         QString &amplitude,
                         DISPLIB::RowVectorPair &data) const;
 
+    //=========================================================================================================
+    /**
+    * createDecimatedPlotPath creates the data plot path from the min/max values of each pixel column. This is used
+    * instead of plotting every sample if the view is zoomed out to more than two samples per pixel.
+    *
+    * @param[in] pyramid                The min/max decimation pyramid of the data.
+    * @param[in] iRow                   The data row in the pyramid.
+    * @param[in] data                   Current data for the given row.
+    * @param[in] dDx                    The pixel distance between two samples.
+    * @param[in] dScaleY                The vertical scaling.
+    * @param[in] y_base                 The vertical base line.
+    * @param[in] currentSampleIndex     The current sample index, which separates the new from the old data.
+    * @param[in] lastFirstValue         The offset for the old data.
+    * @param[in,out] path               The QPointerPath to create for the data plot.
+    * @param[in] ellipsePos             Position of the ellipse which is plotted at the current channel signal value.
+    * @param[in] amplitude              String which is to be plotted.
+    */
+    void createDecimatedPlotPath(const MinMaxPyramid& pyramid,
+                                 qint32 iRow,
+                                 const DISPLIB::RowVectorPair &data,
+                                 double dDx,
+                                 double dScaleY,
+                                 double y_base,
+                                 int currentSampleIndex,
+                                 double lastFirstValue,
+                                 QPainterPath& path,
+                                 QPointF &ellipsePos,
+                                 QString &amplitude) const;
+
     //=========================================================================================================
     /**
     * createCurrentPositionMarkerPath Creates the QPointer path for the current marker position plot.
@@ -59,6 +59,7 @@
 #include <QCoreApplication>
 #include <QtConcurrent>
 #include <QFuture>
+#include <QMutexLocker>
 
 
 //*************************************************************************************************************
@@ -104,10 +105,39 @@ ChannelDataModel::ChannelDataModel(QObject *parent)
 , m_dTriggerThreshold(0.01)
 , m_iDistanceTimerSpacer(1000)
 , m_iDetectedTriggers(0)
-, m_iCurrentSampleFreeze(0)
 , m_iCurrentTriggerChIndex(0)
 , m_pFiffInfo(FiffInfo::SPtr::create())
+, m_bProcessingScheduled(false)
+, m_iFrontSnapshot(0)
+, m_bSnapshotReady(false)
+, m_bNewTriggers(false)
+, m_bPublishedNewTriggers(false)
+, m_iPublishedDetectedTriggers(0)
 {
+    for(int i = 0; i < 2; ++i) {
+        m_snapshots[i].iCurrentSample = 0;
+        m_snapshots[i].iCurrentBlockSize = 0;
+        m_snapshots[i].bRebuild = true;
+    }
+
+    //All processing is serialized in one dedicated thread which is kept alive while data is streamed
+    m_threadPoolWorker.setMaxThreadCount(1);
+    m_threadPoolWorker.setExpiryTimeout(-1);
+
+    connect(this, &ChannelDataModel::snapshotPublished,
+            this, &ChannelDataModel::onSnapshotPublished, Qt::QueuedConnection);
+}
+
+
+//*************************************************************************************************************
+
+ChannelDataModel::~ChannelDataModel()
+{
+    m_mutexQueue.lock();
+    m_lDataQueue.clear();
+    m_mutexQueue.unlock();
+
+    m_threadPoolWorker.waitForDone();
 }
 
 //*************************************************************************************************************
@@ -156,29 +186,16 @@ QVariant ChannelDataModel::data(const QModelIndex &index, int role) const
 
             switch(role) {
                 case Qt::DisplayRole: {
-                    if(m_bIsFreezed) {
-                        // data freeze
-                        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
-                            rowVectorPair.first = m_matDataFilteredFreeze.data() + row*m_matDataFilteredFreeze.cols();
-                            rowVectorPair.second  = m_matDataFilteredFreeze.cols();
-                            v.setValue(rowVectorPair);
-                        } else {
-                            rowVectorPair.first = m_matDataRawFreeze.data() + row*m_matDataRawFreeze.cols();
-                            rowVectorPair.second  = m_matDataRawFreeze.cols();
-                            v.setValue(rowVectorPair);
-                        }
-                    }
-                    else {
-                        // data stream
-                        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
-                            rowVectorPair.first = m_matDataFiltered.data() + row*m_matDataFiltered.cols();
-                            rowVectorPair.second  = m_matDataFiltered.cols();
-                            v.setValue(rowVectorPair);
-                        } else {
-                            rowVectorPair.first = m_matDataRaw.data() + row*m_matDataRaw.cols();
-                            rowVectorPair.second  = m_matDataRaw.cols();
-                            v.setValue(rowVectorPair);
-                        }
+                    const DisplaySnapshot& snapshot = frontSnapshot();
+
+                    if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+                        rowVectorPair.first = snapshot.matDataFiltered.data() + row*snapshot.matDataFiltered.cols();
+                        rowVectorPair.second  = snapshot.matDataFiltered.cols();
+                        v.setValue(rowVectorPair);
+                    } else {
+                        rowVectorPair.first = snapshot.matDataRaw.data() + row*snapshot.matDataRaw.cols();
+                        rowVectorPair.second  = snapshot.matDataRaw.cols();
+                        v.setValue(rowVectorPair);
                     }
 
                     return v;
@@ -322,10 +339,14 @@ void ChannelDataModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffInf
 
         m_vecBadIdcs = sel;       
 
+        m_mutexData.lock();
         m_pFiffInfo = p_pFiffInfo;
+        m_mutexData.unlock();
 
         resetSelection();
 
+        m_mutexData.lock();
+
         //Resize data matrix without touching the stored values
         m_matDataRaw.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxSamples);
         m_matDataRaw.setZero();
@@ -341,6 +362,9 @@ void ChannelDataModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffInf
 
         m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxFilterLength);
 
+        markDirty();
+        publishSnapshot();
+
         m_matSparseProjMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
         m_matSparseCompMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
         m_matSparseSpharaMult = SparseMatrix<double>(m_pFiffInfo->chs.size(),m_pFiffInfo->chs.size());
@@ -351,6 +375,10 @@ void ChannelDataModel::setFiffInfo(QSharedPointer<FIFFLIB::FiffInfo> &p_pFiffInf
         m_matSparseSpharaMult.setIdentity();
         m_matSparseProjCompMult.setIdentity();
 
+        m_mutexData.unlock();
+
+        swapSnapshot(true);
+
         //Create the initial Compensator projector
         updateCompensator(0);
 
@@ -392,6 +420,8 @@ void ChannelDataModel::setSamplingInfo(float sps, int T, bool bSetZero)
 {
     beginResetModel();
 
+    QMutexLocker locker(&m_mutexData);
+
     m_iT = T;
 
     m_iMaxSamples = (qint32)ceil(sps * T);
@@ -413,7 +443,15 @@ void ChannelDataModel::setSamplingInfo(float sps, int T, bool bSetZero)
         m_iCurrentSample = 0;
     }
 
+    markDirty();
+    publishSnapshot();
+
+    locker.unlock();
+
     endResetModel();
+
+    //Show the resized data right away, even if the display is freezed
+    swapSnapshot(true);
 }
 
 
@@ -421,17 +459,62 @@ void ChannelDataModel::setSamplingInfo(float sps, int T, bool bSetZero)
 
 MatrixXd ChannelDataModel::getLastBlock()
 {
+    const DisplaySnapshot& snapshot = frontSnapshot();
+
     if(!m_filterData.isEmpty() && m_bPerformFiltering) {
-        return m_matDataFiltered.block(0, m_iCurrentSample-m_iCurrentBlockSize, m_matDataFiltered.rows(), m_iCurrentBlockSize);
+        return snapshot.matDataFiltered.block(0, snapshot.iCurrentSample-snapshot.iCurrentBlockSize, snapshot.matDataFiltered.rows(), snapshot.iCurrentBlockSize);
     }
 
-    return m_matDataRaw.block(0, m_iCurrentSample-m_iCurrentBlockSize, m_matDataRaw.rows(), m_iCurrentBlockSize);
+    return snapshot.matDataRaw.block(0, snapshot.iCurrentSample-snapshot.iCurrentBlockSize, snapshot.matDataRaw.rows(), snapshot.iCurrentBlockSize);
 }
 
 
 //*************************************************************************************************************
 
 void ChannelDataModel::addData(const QList<MatrixXd> &data)
+{
+    QMutexLocker locker(&m_mutexQueue);
+
+    m_lDataQueue.append(data);
+
+    if(!m_bProcessingScheduled) {
+        m_bProcessingScheduled = true;
+        QtConcurrent::run(&m_threadPoolWorker, this, &ChannelDataModel::processQueuedData);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::processQueuedData()
+{
+    forever {
+        QList<MatrixXd> data;
+
+        m_mutexQueue.lock();
+        if(m_lDataQueue.isEmpty()) {
+            m_bProcessingScheduled = false;
+            m_mutexQueue.unlock();
+            return;
+        }
+        data.swap(m_lDataQueue);
+        m_mutexQueue.unlock();
+
+        //Everything which arrived in the meantime is processed at once and published as one snapshot
+        QMutexLocker locker(&m_mutexData);
+
+        processData(data);
+
+        if(publishSnapshot()) {
+            emit snapshotPublished();
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::processData(const QList<MatrixXd> &data)
 {
     //SSP
     bool doProj = m_bProjActivated && m_matDataRaw.cols() > 0 && m_matDataRaw.rows() == m_matProj.cols() ? true : false;
@@ -484,12 +567,12 @@ void ChannelDataModel::addData(const QList<MatrixXd> &data)
                 }
             }
 
+            markDirty(m_iCurrentSample, m_iCurrentSample+m_iResidual);
+
             m_iCurrentSample = 0;
 
-            if(!m_bIsFreezed) {
-                m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
-                m_vecLastBlockFirstValuesRaw = m_matDataRaw.col(0);
-            }
+            m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
+            m_vecLastBlockFirstValuesRaw = m_matDataRaw.col(0);
 
             //Store old detected triggers
             m_qMapDetectedTriggerOld = m_qMapDetectedTrigger;
@@ -552,6 +635,13 @@ void ChannelDataModel::addData(const QList<MatrixXd> &data)
             }
         }
 
+        //The overlap add method also touches the filtered data around the current block
+        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+            markDirty(m_iCurrentSample-m_iMaxFilterLength-m_iResidual, m_iCurrentSample+nCol+2*m_iMaxFilterLength);
+        } else {
+            markDirty(m_iCurrentSample, m_iCurrentSample+nCol);
+        }
+
         m_iCurrentSample += nCol;
         m_iCurrentBlockSize = nCol;
 
@@ -559,7 +649,8 @@ void ChannelDataModel::addData(const QList<MatrixXd> &data)
         if(m_bTriggerDetectionActive) {
             int iOldDetectedTriggers = m_qMapDetectedTrigger[m_iCurrentTriggerChIndex].size();
 
-            QList<QPair<int,double> > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksMax(data.at(b), m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, true, 500);
+            m_detectTrigger.detect(data.at(b), m_iCurrentSample-nCol);
+            QList<QPair<int,double> > qMapDetectedTrigger = m_detectTrigger.lastDetected(m_iCurrentTriggerChIndex);
             //QList<QPair<int,double> > qMapDetectedTrigger = DetectTrigger::detectTriggerFlanksGrad(data.at(b), m_iCurrentTriggerChIndex, m_iCurrentSample-nCol, m_dTriggerThreshold, false, "Rising");
 
             //Append results to already found triggers
@@ -570,16 +661,10 @@ void ChannelDataModel::addData(const QList<MatrixXd> &data)
 
             if(newTriggers!=0) {
                 m_iDetectedTriggers += newTriggers;
-                emit triggerDetected(m_iDetectedTriggers, m_qMapDetectedTrigger);
+                m_bNewTriggers = true;
             }
         }
     }
-
-    //Update data content
-    QModelIndex topLeft = this->index(0,1);
-    QModelIndex bottomRight = this->index(m_pFiffInfo->ch_names.size()-1,1);
-    QVector<int> roles; roles << Qt::DisplayRole;
-    emit dataChanged(topLeft, bottomRight, roles);
 }
 
 
@@ -684,13 +769,9 @@ void ChannelDataModel::toggleFreeze(const QModelIndex &)
 {
     m_bIsFreezed = !m_bIsFreezed;
 
-    if(m_bIsFreezed) {
-        m_matDataRawFreeze = m_matDataRaw;
-        m_matDataFilteredFreeze = m_matDataFiltered;
-        m_qMapDetectedTriggerFreeze = m_qMapDetectedTrigger;
-        m_qMapDetectedTriggerOldFreeze = m_qMapDetectedTriggerOld;
-
-        m_iCurrentSampleFreeze = m_iCurrentSample;
+    //While freezed the front snapshot is simply not swapped anymore. Catch up with the latest one when unfreezing.
+    if(!m_bIsFreezed) {
+        swapSnapshot();
     }
 
     //Update data content
@@ -716,6 +797,8 @@ void ChannelDataModel::setScaling(const QMap< qint32,float >& p_qMapChScaling)
 
 void ChannelDataModel::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
 {
+    QMutexLocker locker(&m_mutexData);
+
     //  Update the SSP projector
     if(m_pFiffInfo) {
         //If a minimum of one projector is active set m_bProjActivated to true so that this model applies the ssp to the incoming data
@@ -777,6 +860,8 @@ void ChannelDataModel::updateProjection(const QList<FIFFLIB::FiffProj>& projs)
 
 void ChannelDataModel::updateCompensator(int to)
 {
+    QMutexLocker locker(&m_mutexData);
+
     //  Update the compensator
     if(m_pFiffInfo) {
         if(to == 0) {
@@ -832,6 +917,8 @@ void ChannelDataModel::updateCompensator(int to)
 
 void ChannelDataModel::updateSpharaActivation(bool state)
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_bSpharaActivated = state;
 }
 
@@ -911,6 +998,8 @@ void ChannelDataModel::updateSpharaOptions(const QString& sSytemType, int nBaseF
         }
 
         //Create full multiplication matrix
+        QMutexLocker locker(&m_mutexData);
+
         m_matSparseSpharaMult = matSparseSpharaMultFirst * matSparseSpharaMultSecond;
     }
 }
@@ -920,6 +1009,8 @@ void ChannelDataModel::updateSpharaOptions(const QString& sSytemType, int nBaseF
 
 void ChannelDataModel::setFilter(QList<FilterData> filterData)
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_filterData = filterData;
 
     m_iMaxFilterLength = 1;
@@ -943,6 +1034,8 @@ void ChannelDataModel::setFilter(QList<FilterData> filterData)
 
 void ChannelDataModel::setFilterActive(bool state)
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_bPerformFiltering = state;
 }
 
@@ -951,6 +1044,8 @@ void ChannelDataModel::setFilterActive(bool state)
 
 void ChannelDataModel::setFilterChannelType(QString channelType)
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_sFilterChannelType = channelType;
     m_filterChannelList = m_visibleChannelList;
 
@@ -991,6 +1086,8 @@ void ChannelDataModel::setFilterChannelType(QString channelType)
 
 void ChannelDataModel::createFilterChannelList(QStringList channelNames)
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_filterChannelList.clear();
     m_visibleChannelList = channelNames;
 
@@ -1061,8 +1158,14 @@ void ChannelDataModel::markChBad(QModelIndex ch, bool status)
 
 void ChannelDataModel::triggerInfoChanged(const QMap<double, QColor>& colorMap, bool active, QString triggerCh, double threshold)
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_qMapTriggerColor = colorMap;
-    m_bTriggerDetectionActive = active;    
+
+    //Restart the streaming detection if it is switched on or its parameters changed
+    bool bRestartDetection = (active && !m_bTriggerDetectionActive) || m_dTriggerThreshold != threshold || m_sCurrentTriggerCh != triggerCh;
+
+    m_bTriggerDetectionActive = active;
     m_dTriggerThreshold = threshold;
 
     //Find channel index and initialise detected trigger map if channel name changed
@@ -1082,6 +1185,10 @@ void ChannelDataModel::triggerInfoChanged(const QMap<double, QColor>& colorMap,
     }
 
     m_sCurrentTriggerCh = triggerCh;
+
+    if(bRestartDetection) {
+        m_detectTrigger.setup(QList<int>() << m_iCurrentTriggerChIndex, m_dTriggerThreshold, true, 500);
+    }
 }
 
 
@@ -1101,6 +1208,8 @@ void ChannelDataModel::distanceTimeSpacerChanged(int value)
 
 void ChannelDataModel::resetTriggerCounter()
 {
+    QMutexLocker locker(&m_mutexData);
+
     m_iDetectedTriggers = 0;
 }
 
@@ -1206,9 +1315,9 @@ void ChannelDataModel::filterChannelsConcurrently()
         m_matDataFiltered.row(notFilterChannelIndex.at(i)) = m_matDataRaw.row(notFilterChannelIndex.at(i));
     }
 
-    if(!m_bIsFreezed) {
-        m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
-    }
+    markDirty();
+
+    m_vecLastBlockFirstValuesFiltered = m_matDataFiltered.col(0);
 
     //std::cout<<"END ChannelDataModel::filterChannelsConcurrently"<<std::endl;
 }
@@ -1337,13 +1446,173 @@ void ChannelDataModel::clearModel()
 {
     beginResetModel();
 
+    QMutexLocker locker(&m_mutexData);
+
     m_matDataRaw.setZero();
     m_matDataFiltered.setZero();
-    m_matDataRawFreeze.setZero();
-    m_matDataFilteredFreeze.setZero();
     m_vecLastBlockFirstValuesFiltered.setZero();
     m_vecLastBlockFirstValuesRaw.setZero();
     m_matOverlap.setZero();
 
+    markDirty();
+    publishSnapshot();
+
+    locker.unlock();
+
     endResetModel();
+
+    //Show the cleared data right away, even if the display is freezed
+    swapSnapshot(true);
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::markDirty(int iFrom, int iTo)
+{
+    int iCols = m_matDataRaw.cols();
+
+    if(iCols <= 0) {
+        return;
+    }
+
+    for(int i = 0; i < 2; ++i) {
+        DisplaySnapshot& snapshot = m_snapshots[i];
+
+        if(snapshot.bRebuild) {
+            continue;
+        }
+
+        //A snapshot which was not swapped for a long time (freezed display) is simply copied completely
+        if(snapshot.lDirtyRanges.size() > 64) {
+            snapshot.lDirtyRanges.clear();
+            snapshot.bRebuild = true;
+            continue;
+        }
+
+        //Ranges reaching in front of the first sample wrap around to the end of the circular data matrices
+        if(iFrom < 0) {
+            snapshot.lDirtyRanges.append(QPair<int,int>(qMax(iCols+iFrom, 0), iCols));
+        }
+
+        int iStart = qMax(iFrom, 0);
+        int iEnd = qMin(iTo, iCols);
+
+        if(iStart < iEnd) {
+            snapshot.lDirtyRanges.append(QPair<int,int>(iStart, iEnd));
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::markDirty()
+{
+    for(int i = 0; i < 2; ++i) {
+        m_snapshots[i].lDirtyRanges.clear();
+        m_snapshots[i].bRebuild = true;
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool ChannelDataModel::publishSnapshot()
+{
+    QMutexLocker locker(&m_mutexSnapshot);
+
+    DisplaySnapshot& snapshot = m_snapshots[1-m_iFrontSnapshot];
+
+    if(snapshot.bRebuild
+       || snapshot.matDataRaw.rows() != m_matDataRaw.rows()
+       || snapshot.matDataRaw.cols() != m_matDataRaw.cols()
+       || snapshot.matDataFiltered.cols() != m_matDataFiltered.cols()) {
+        snapshot.matDataRaw = m_matDataRaw;
+        snapshot.matDataFiltered = m_matDataFiltered;
+        snapshot.pyramidRaw.build(snapshot.matDataRaw);
+        snapshot.pyramidFiltered.build(snapshot.matDataFiltered);
+    } else {
+        //Only copy what changed since this snapshot was published the last time
+        for(int i = 0; i < snapshot.lDirtyRanges.size(); ++i) {
+            int iFrom = snapshot.lDirtyRanges.at(i).first;
+            int iNumber = snapshot.lDirtyRanges.at(i).second - iFrom;
+
+            snapshot.matDataRaw.middleCols(iFrom, iNumber) = m_matDataRaw.middleCols(iFrom, iNumber);
+            snapshot.matDataFiltered.middleCols(iFrom, iNumber) = m_matDataFiltered.middleCols(iFrom, iNumber);
+            snapshot.pyramidRaw.update(snapshot.matDataRaw, iFrom, iFrom+iNumber);
+            snapshot.pyramidFiltered.update(snapshot.matDataFiltered, iFrom, iFrom+iNumber);
+        }
+    }
+
+    snapshot.lDirtyRanges.clear();
+    snapshot.bRebuild = false;
+
+    snapshot.vecLastBlockFirstValuesRaw = m_vecLastBlockFirstValuesRaw;
+    snapshot.vecLastBlockFirstValuesFiltered = m_vecLastBlockFirstValuesFiltered;
+    snapshot.iCurrentSample = m_iCurrentSample;
+    snapshot.iCurrentBlockSize = m_iCurrentBlockSize;
+    snapshot.qMapDetectedTrigger = m_qMapDetectedTrigger;
+    snapshot.qMapDetectedTriggerOld = m_qMapDetectedTriggerOld;
+
+    if(m_bNewTriggers) {
+        m_iPublishedDetectedTriggers = m_iDetectedTriggers;
+        m_qMapPublishedDetectedTrigger = m_qMapDetectedTrigger;
+        m_bPublishedNewTriggers = true;
+        m_bNewTriggers = false;
+    }
+
+    bool bWasReady = m_bSnapshotReady;
+    m_bSnapshotReady = true;
+
+    return !bWasReady;
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::swapSnapshot(bool bForce)
+{
+    bool bSwapped = false;
+    bool bNewTriggers = false;
+    int iDetectedTriggers = 0;
+    QMap<int,QList<QPair<int,double> > > qMapDetectedTrigger;
+
+    m_mutexSnapshot.lock();
+
+    if(m_bSnapshotReady && (bForce || !m_bIsFreezed)) {
+        m_iFrontSnapshot = 1-m_iFrontSnapshot;
+        m_bSnapshotReady = false;
+        bSwapped = true;
+    }
+
+    //Trigger detections are reported even if the display is freezed
+    if(m_bPublishedNewTriggers) {
+        bNewTriggers = true;
+        iDetectedTriggers = m_iPublishedDetectedTriggers;
+        qMapDetectedTrigger = m_qMapPublishedDetectedTrigger;
+        m_bPublishedNewTriggers = false;
+    }
+
+    m_mutexSnapshot.unlock();
+
+    if(bNewTriggers) {
+        emit triggerDetected(iDetectedTriggers, qMapDetectedTrigger);
+    }
+
+    if(bSwapped) {
+        //Update data content
+        QModelIndex topLeft = this->index(0,1);
+        QModelIndex bottomRight = this->index(m_pFiffInfo->ch_names.size()-1,1);
+        QVector<int> roles; roles << Qt::DisplayRole;
+        emit dataChanged(topLeft, bottomRight, roles);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ChannelDataModel::onSnapshotPublished()
+{
+    swapSnapshot();
 }
@@ -43,10 +43,12 @@
 //=============================================================================================================
 
 #include "../../disp_global.h"
+#include "minmaxpyramid.h"
 
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_proj.h>
 #include <utils/filterTools/filterdata.h>
+#include <utils/detecttrigger.h>
 
 
 //*************************************************************************************************************
@@ -57,6 +59,8 @@
 #include <QAbstractTableModel>
 #include <QSharedPointer>
 #include <QColor>
+#include <QMutex>
+#include <QThreadPool>
 
 
 //*************************************************************************************************************
@@ -111,6 +115,11 @@ typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> Matr
 * DECLARE CLASS ChannelDataModel
 *
 * @brief The ChannelDataModel class implements the data access model for a real-time multi sample array data stream
+*
+* @details Incoming data is queued and processed (projectors, compensators, SPHARA, filtering and trigger detection)
+*          by a dedicated worker thread. After each processed batch the worker publishes the changed samples to the
+*          back buffer of a pair of display snapshots. The GUI thread only swaps the buffers and reads from the front
+*          snapshot, so painting never waits for the processing and vice versa.
 */
 class DISPSHARED_EXPORT ChannelDataModel : public QAbstractTableModel
 {
@@ -127,6 +136,12 @@ public:
     */
     ChannelDataModel(QObject *parent = 0);
 
+    //=========================================================================================================
+    /**
+    * Destroys the model after the worker thread finished processing.
+    */
+    ~ChannelDataModel();
+
     //=========================================================================================================
     /**
     * Returns the number of rows under the given parent. When the parent is valid it means that rowCount is returning the number of children of parent.
@@ -198,7 +213,8 @@ public:
 
     //=========================================================================================================
     /**
-    * Adds multiple time points (QVector) for a channel set (VectorXd)
+    * Adds multiple time points (QVector) for a channel set (VectorXd). The data is queued and processed by the
+    * worker thread. The view is updated as soon as the resulting snapshot was published.
     *
     * @param[in] data       data to add (Time points of channel samples)
     */
@@ -511,6 +527,15 @@ public:
     */
     inline int getCurrentOverlapAddDelay() const;
 
+    //=========================================================================================================
+    /**
+    * Returns the min/max decimation pyramid of the data which is currently returned by the DisplayRole
+    * (raw or filtered, streamed or freezed).
+    *
+    * @return the current decimation pyramid
+    */
+    inline const MinMaxPyramid& getDecimationPyramid() const;
+
 private:
     //=========================================================================================================
     /**
@@ -539,6 +564,78 @@ private:
     */
     void clearModel();
 
+    //=========================================================================================================
+    /**
+    * Marks the sample range [iFrom, iTo) as changed, so it is copied to both display snapshots on their next
+    * publication. Ranges reaching in front of the first sample wrap around to the end of the data matrices.
+    *
+    * @param [in] iFrom     first changed sample
+    * @param [in] iTo       one past the last changed sample
+    */
+    void markDirty(int iFrom, int iTo);
+
+    //=========================================================================================================
+    /**
+    * Marks all samples as changed, e.g. after the data matrices were resized or cleared.
+    */
+    void markDirty();
+
+    //=========================================================================================================
+    /**
+    * Processes all queued data blocks and publishes the result. Runs in the worker thread.
+    */
+    void processQueuedData();
+
+    //=========================================================================================================
+    /**
+    * Applies projectors, compensators, SPHARA, filtering and trigger detection to the given data blocks and writes
+    * the result to the working data matrices. Must be called with m_mutexData locked.
+    *
+    * @param[in] data       data to add (Time points of channel samples)
+    */
+    void processData(const QList<Eigen::MatrixXd> &data);
+
+    //=========================================================================================================
+    /**
+    * Copies the changed samples of the working data to the back snapshot and updates its decimation pyramids.
+    * Must be called with m_mutexData locked.
+    *
+    * @return true if the back snapshot was not published before, false if it is still waiting to be swapped.
+    */
+    bool publishSnapshot();
+
+    //=========================================================================================================
+    /**
+    * Swaps the front and back snapshot if a new one was published and the display is not freezed. Emits pending
+    * trigger detections. Runs in the GUI thread.
+    *
+    * @param[in] bForce     Swap even if the display is freezed, e.g. after the data matrices were resized.
+    */
+    void swapSnapshot(bool bForce = false);
+
+    //=========================================================================================================
+    /**
+    * Slot which is called in the GUI thread after the worker thread published a new snapshot.
+    */
+    void onSnapshotPublished();
+
+    struct DisplaySnapshot {
+        MatrixXdR                               matDataRaw;                         /**< The raw data */
+        MatrixXdR                               matDataFiltered;                    /**< The filtered data */
+        MinMaxPyramid                           pyramidRaw;                         /**< Min/max decimation of the raw data */
+        MinMaxPyramid                           pyramidFiltered;                    /**< Min/max decimation of the filtered data */
+        Eigen::VectorXd                         vecLastBlockFirstValuesRaw;         /**< The first value of the last complete raw data display block */
+        Eigen::VectorXd                         vecLastBlockFirstValuesFiltered;    /**< The first value of the last complete filtered data display block */
+        qint32                                  iCurrentSample;                     /**< Position in the data matrices the next data will be written to */
+        qint32                                  iCurrentBlockSize;                  /**< Size of the last data block */
+        QMap<int,QList<QPair<int,double> > >    qMapDetectedTrigger;                /**< Detected trigger for each trigger channel. */
+        QMap<int,QList<QPair<int,double> > >    qMapDetectedTriggerOld;             /**< Old detected trigger for each trigger channel. */
+        QList<QPair<int,int> >                  lDirtyRanges;                       /**< Sample ranges which changed since this snapshot was published last */
+        bool                                    bRebuild;                           /**< Whether the snapshot needs to be copied completely */
+    };
+
+    inline const DisplaySnapshot& frontSnapshot() const;
+
     bool                                m_bProjActivated;                           /**< Projections activated */
     bool                                m_bCompActivated;                           /**< Compensator activated */
     bool                                m_bSpharaActivated;                         /**< Sphara activated */
@@ -548,11 +645,11 @@ private:
     bool                                m_bTriggerDetectionActive;                  /**< Trigger detection activation state */
     float                               m_fSps;                                     /**< Sampling rate */
     double                              m_dTriggerThreshold;                        /**< Trigger detection threshold */
+    UTILSLIB::DetectTrigger             m_detectTrigger;                            /**< Streaming trigger detection on the current trigger channel */
     qint32                              m_iT;                                       /**< Time window */
     qint32                              m_iDownsampling;                            /**< Down sampling factor */
     qint32                              m_iMaxSamples;                              /**< Max samples per window */
     qint32                              m_iCurrentSample;                           /**< Current sample which holds the current position in the data matrix */
-    qint32                              m_iCurrentSampleFreeze;                     /**< Current sample which holds the current position in the data matrix when freezing tool is active */
     qint32                              m_iMaxFilterLength;                         /**< Max order of the current filters */
     qint32                              m_iCurrentBlockSize;                        /**< Current block size */
     qint32                              m_iResidual;                                /**< Current amount of samples which were to size */
@@ -571,8 +668,6 @@ private:
 
     MatrixXdR                           m_matDataRaw;                               /**< The raw data */
     MatrixXdR                           m_matDataFiltered;                          /**< The filtered data */
-    MatrixXdR                           m_matDataRawFreeze;                         /**< The raw data in freeze mode */
-    MatrixXdR                           m_matDataFilteredFreeze;                    /**< The raw filtered data in freeze mode */
     Eigen::MatrixXd                     m_matOverlap;                               /**< Last overlap block for the back */
 
     Eigen::VectorXi                     m_vecIndicesFirstVV;                        /**< The indices of the channels to pick for the first SPHARA operator in case of a VectorView system.*/
@@ -598,15 +693,29 @@ private:
     QMap<double, QColor>                m_qMapTriggerColor;                         /**< Current colors for all trigger channels. */
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTrigger;                      /**< Detected trigger for each trigger channel. */
     QList<int>                          m_lTriggerChannelIndices;                   /**< List of all trigger channel indices. */
-    QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerFreeze;                /**< Detected trigger for each trigger channel while display is freezed. */
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOld;                   /**< Old detected trigger for each trigger channel. */
-    QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOldFreeze;             /**< Old detected trigger for each trigger channel while display is freezed. */
     QMap<qint32,float>                  m_qMapChScaling;                            /**< Channel scaling map. */
     QList<UTILSLIB::FilterData>         m_filterData;                               /**< List of currently active filters. */
     QStringList                         m_filterChannelList;                        /**< List of channels which are to be filtered.*/
     QStringList                         m_visibleChannelList;                       /**< List of currently visible channels in the view.*/
     QMap<qint32,qint32>                 m_qMapIdxRowSelection;                      /**< Selection mapping.*/
 
+    QMutex                              m_mutexData;                                /**< Guards the working data and the processing settings shared with the worker thread. */
+    QMutex                              m_mutexQueue;                               /**< Guards the queue of incoming data. */
+    QMutex                              m_mutexSnapshot;                            /**< Guards the snapshot swap and the published trigger detections. */
+    QThreadPool                         m_threadPoolWorker;                         /**< Single thread pool which runs the data processing. */
+    QList<Eigen::MatrixXd>              m_lDataQueue;                               /**< Incoming data which was not processed yet. */
+    bool                                m_bProcessingScheduled;                     /**< Whether the worker thread was started for the queued data. */
+
+    DisplaySnapshot                     m_snapshots[2];                             /**< Double buffered display snapshots. */
+    int                                 m_iFrontSnapshot;                           /**< Index of the snapshot which is read by the GUI thread. */
+    bool                                m_bSnapshotReady;                           /**< Whether the back snapshot was published and waits to be swapped. */
+
+    bool                                m_bNewTriggers;                             /**< Whether new triggers were detected since the last publication. */
+    bool                                m_bPublishedNewTriggers;                    /**< Whether the published trigger detections were not emitted yet. */
+    int                                 m_iPublishedDetectedTriggers;               /**< Published number of detected triggers. */
+    QMap<int,QList<QPair<int,double> > >m_qMapPublishedDetectedTrigger;             /**< Published detected triggers. */
+
 signals:
     //=========================================================================================================
     /**
@@ -629,6 +738,12 @@ signals:
     * Emmited when trigger detection was performed
     */
     void triggerDetected(int numberDetectedTriggers, const QMap<int,QList<QPair<int,double> > >& mapDetectedTriggers);
+
+    //=========================================================================================================
+    /**
+    * Emmited by the worker thread when a new display snapshot was published
+    */
+    void snapshotPublished();
 };
 
 
@@ -647,15 +762,11 @@ inline qint32 ChannelDataModel::getMaxSamples() const
 
 inline qint32 ChannelDataModel::getCurrentSampleIndex() const
 {
-    if(m_bIsFreezed) {
-        return m_iCurrentSampleFreeze;
+    if(!m_bIsFreezed && !m_filterData.isEmpty() && m_bPerformFiltering) {
+        return frontSnapshot().iCurrentSample-m_iMaxFilterLength/2;
     }
 
-    if(!m_filterData.isEmpty() && m_bPerformFiltering) {
-        return m_iCurrentSample-m_iMaxFilterLength/2;
-    }
-
-    return m_iCurrentSample;
+    return frontSnapshot().iCurrentSample;
 }
 
 
@@ -663,13 +774,15 @@ inline qint32 ChannelDataModel::getCurrentSampleIndex() const
 
 inline double ChannelDataModel::getLastBlockFirstValue(int row) const
 {
-    if(row>m_vecLastBlockFirstValuesFiltered.rows() || row>m_vecLastBlockFirstValuesRaw.rows())
+    const DisplaySnapshot& snapshot = frontSnapshot();
+
+    if(row>=snapshot.vecLastBlockFirstValuesFiltered.rows() || row>=snapshot.vecLastBlockFirstValuesRaw.rows())
         return 0;
 
     if(!m_filterData.isEmpty())
-        return m_vecLastBlockFirstValuesFiltered[row];
+        return snapshot.vecLastBlockFirstValuesFiltered[row];
 
-    return m_vecLastBlockFirstValuesRaw[row];
+    return snapshot.vecLastBlockFirstValuesRaw[row];
 }
 
 
@@ -724,11 +837,8 @@ inline QList<QPair<int,double> >  ChannelDataModel::getDetectedTriggers() const
 {
     QList<QPair<int,double> > triggerIndices;
 
-    if(m_bIsFreezed)
-        return m_qMapDetectedTriggerFreeze[m_iCurrentTriggerChIndex];
-
-    if(m_bTriggerDetectionActive) {
-        return m_qMapDetectedTrigger[m_iCurrentTriggerChIndex];
+    if(m_bIsFreezed || m_bTriggerDetectionActive) {
+        return frontSnapshot().qMapDetectedTrigger.value(m_iCurrentTriggerChIndex);
     }
     else
         return triggerIndices;
@@ -741,11 +851,8 @@ inline QList<QPair<int,double> > ChannelDataModel::getDetectedTriggersOld() cons
 {
     QList<QPair<int,double> > triggerIndices;
 
-    if(m_bIsFreezed)
-        return m_qMapDetectedTriggerOldFreeze[m_iCurrentTriggerChIndex];
-
-    if(m_bTriggerDetectionActive) {
-        return m_qMapDetectedTriggerOld[m_iCurrentTriggerChIndex];
+    if(m_bIsFreezed || m_bTriggerDetectionActive) {
+        return frontSnapshot().qMapDetectedTriggerOld.value(m_iCurrentTriggerChIndex);
     }
     else
         return triggerIndices;
@@ -804,6 +911,26 @@ inline int ChannelDataModel::getCurrentOverlapAddDelay() const
 }
 
 
+//*************************************************************************************************************
+
+inline const MinMaxPyramid& ChannelDataModel::getDecimationPyramid() const
+{
+    if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+        return frontSnapshot().pyramidFiltered;
+    }
+
+    return frontSnapshot().pyramidRaw;
+}
+
+
+//*************************************************************************************************************
+
+inline const ChannelDataModel::DisplaySnapshot& ChannelDataModel::frontSnapshot() const
+{
+    return m_snapshots[m_iFrontSnapshot];
+}
+
+
 } // NAMESPACE
 
 #ifndef metatype_rowvectorpair
@@ -0,0 +1,259 @@
+//=============================================================================================================
+/**
+* @file     evokedpolylinecache.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    EvokedPolylineCache class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "evokedpolylinecache.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtMath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISPLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+bool EvokedPolylineCache::Mapping::operator==(const Mapping& other) const
+{
+    return dX0 == other.dX0
+            && dWidth == other.dWidth
+            && dY0 == other.dY0
+            && dScaleY == other.dScaleY
+            && dClip == other.dClip;
+}
+
+
+//*************************************************************************************************************
+
+EvokedPolylineCache::EvokedPolylineCache()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool EvokedPolylineCache::isValid(const QString& sAvrType,
+                                  qint32 iChannelIdx,
+                                  quint32 iRevision,
+                                  const Mapping& mapping,
+                                  qint32 iNumSamples) const
+{
+    QHash<QPair<QString,qint32>, Entry>::const_iterator it = m_hashEntries.constFind(qMakePair(sAvrType, iChannelIdx));
+
+    if(it == m_hashEntries.constEnd()) {
+        return false;
+    }
+
+    return it->iRevision == iRevision
+            && it->iNumSamples == iNumSamples
+            && it->mapping == mapping;
+}
+
+
+//*************************************************************************************************************
+
+QRectF EvokedPolylineCache::update(const QString& sAvrType,
+                                   qint32 iChannelIdx,
+                                   quint32 iRevision,
+                                   const Mapping& mapping,
+                                   const double* pData,
+                                   qint32 iNumSamples,
+                                   qint32 iStride)
+{
+    Entry& entry = m_hashEntries[qMakePair(sAvrType, iChannelIdx)];
+
+    QRectF rectDirty = entry.rectBounding;
+
+    entry.iRevision = iRevision;
+    entry.iNumSamples = iNumSamples;
+    entry.mapping = mapping;
+    entry.polyline = decimate(pData, iNumSamples, iStride, mapping);
+    entry.rectBounding = entry.polyline.isEmpty() ? QRectF() : entry.polyline.boundingRect().adjusted(-1.0, -1.0, 1.0, 1.0);
+
+    return rectDirty.united(entry.rectBounding);
+}
+
+
+//*************************************************************************************************************
+
+const QPolygonF& EvokedPolylineCache::polyline(const QString& sAvrType,
+                                               qint32 iChannelIdx) const
+{
+    QHash<QPair<QString,qint32>, Entry>::const_iterator it = m_hashEntries.constFind(qMakePair(sAvrType, iChannelIdx));
+
+    if(it == m_hashEntries.constEnd()) {
+        return m_emptyPolyline;
+    }
+
+    return it->polyline;
+}
+
+
+//*************************************************************************************************************
+
+QRectF EvokedPolylineCache::boundingRect(const QString& sAvrType,
+                                         qint32 iChannelIdx) const
+{
+    return m_hashEntries.value(qMakePair(sAvrType, iChannelIdx)).rectBounding;
+}
+
+
+//*************************************************************************************************************
+
+QRectF EvokedPolylineCache::retain(const QStringList& lAvrTypes)
+{
+    QRectF rectDirty;
+
+    QMutableHashIterator<QPair<QString,qint32>, Entry> it(m_hashEntries);
+    while(it.hasNext()) {
+        it.next();
+        if(!lAvrTypes.contains(it.key().first)) {
+            rectDirty = rectDirty.united(it.value().rectBounding);
+            it.remove();
+        }
+    }
+
+    return rectDirty;
+}
+
+
+//*************************************************************************************************************
+
+void EvokedPolylineCache::clear()
+{
+    m_hashEntries.clear();
+}
+
+
+//*************************************************************************************************************
+
+QPolygonF EvokedPolylineCache::decimate(const double* pData,
+                                        qint32 iNumSamples,
+                                        qint32 iStride,
+                                        const Mapping& mapping)
+{
+    QPolygonF polyline;
+
+    if(!pData || iNumSamples <= 0) {
+        return polyline;
+    }
+
+    const double dDx = iNumSamples > 1 ? mapping.dWidth / (iNumSamples - 1) : 0.0;
+
+    auto mapValue = [&mapping](double dValue) {
+        double dY = dValue * mapping.dScaleY;
+        if(mapping.dClip > 0.0) {
+            dY = qBound(-mapping.dClip, dY, mapping.dClip);
+        }
+        return mapping.dY0 + dY;
+    };
+
+    const qint32 iColumns = qMax(1, qCeil(mapping.dWidth));
+
+    //Less than two samples per pixel column -> plot every sample
+    if(iNumSamples <= 2 * iColumns) {
+        polyline.reserve(iNumSamples);
+
+        for(qint32 i = 0; i < iNumSamples; ++i) {
+            polyline.append(QPointF(mapping.dX0 + i * dDx, mapValue(pData[i * iStride])));
+        }
+
+        return polyline;
+    }
+
+    //Reduce each pixel column to its min and max in the order they occur
+    polyline.reserve(2 * iColumns);
+
+    qint32 iStart = 0;
+
+    for(qint32 c = 0; c < iColumns; ++c) {
+        const qint32 iEnd = static_cast<qint32>((static_cast<qint64>(c + 1) * iNumSamples) / iColumns);
+
+        if(iEnd <= iStart) {
+            continue;
+        }
+
+        qint32 iMin = iStart;
+        qint32 iMax = iStart;
+
+        for(qint32 i = iStart + 1; i < iEnd; ++i) {
+            const double dValue = pData[i * iStride];
+
+            if(dValue < pData[iMin * iStride]) {
+                iMin = i;
+            } else if(dValue > pData[iMax * iStride]) {
+                iMax = i;
+            }
+        }
+
+        const double dX = mapping.dX0 + 0.5 * (iStart + iEnd - 1) * dDx;
+        const qint32 iFirst = qMin(iMin, iMax);
+        const qint32 iSecond = qMax(iMin, iMax);
+
+        polyline.append(QPointF(dX, mapValue(pData[iFirst * iStride])));
+
+        if(iSecond != iFirst) {
+            polyline.append(QPointF(dX, mapValue(pData[iSecond * iStride])));
+        }
+
+        iStart = iEnd;
+    }
+
+    return polyline;
+}
@@ -0,0 +1,244 @@
+//=============================================================================================================
+/**
+* @file     evokedpolylinecache.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    EvokedPolylineCache class declaration.
+*
+*/
+
+#ifndef EVOKEDPOLYLINECACHE_H
+#define EVOKEDPOLYLINECACHE_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QHash>
+#include <QPair>
+#include <QPolygonF>
+#include <QRectF>
+#include <QStringList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISPLIB
+//=============================================================================================================
+
+namespace DISPLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DISPLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS EvokedPolylineCache
+*
+* @brief The EvokedPolylineCache class keeps one pre-decimated polyline per average type and channel. An entry is
+*        only rebuilt if the revision reported by the EvokedSetModel or the sample to pixel mapping changed, so
+*        views only pay for the channels which were actually updated.
+*/
+class DISPSHARED_EXPORT EvokedPolylineCache
+{
+public:
+    typedef QSharedPointer<EvokedPolylineCache> SPtr;              /**< Shared pointer type for EvokedPolylineCache. */
+    typedef QSharedPointer<const EvokedPolylineCache> ConstSPtr;   /**< Const shared pointer type for EvokedPolylineCache. */
+
+    //=========================================================================================================
+    /**
+    * Describes how the samples of a channel are mapped to paint device coordinates. Sample i is placed at
+    * x = dX0 + i * dWidth / (n - 1) and a value v at y = dY0 + v * dScaleY. If dClip is larger than zero the
+    * scaled value is clipped to [-dClip, dClip].
+    */
+    struct Mapping {
+        double dX0;
+        double dWidth;
+        double dY0;
+        double dScaleY;
+        double dClip;
+
+        bool operator==(const Mapping& other) const;
+        bool operator!=(const Mapping& other) const { return !(*this == other); }
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs an empty EvokedPolylineCache.
+    */
+    EvokedPolylineCache();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the cached polyline of the given average type and channel is still up to date.
+    *
+    * @param[in] sAvrType       The average type (comment of the evoked data).
+    * @param[in] iChannelIdx    The channel index.
+    * @param[in] iRevision      The current revision of the channel as reported by the EvokedSetModel.
+    * @param[in] mapping        The current sample to pixel mapping.
+    * @param[in] iNumSamples    The current number of samples.
+    *
+    * @return true if the cached polyline can be painted as is.
+    */
+    bool isValid(const QString& sAvrType,
+                 qint32 iChannelIdx,
+                 quint32 iRevision,
+                 const Mapping& mapping,
+                 qint32 iNumSamples) const;
+
+    //=========================================================================================================
+    /**
+    * Rebuilds the polyline of the given average type and channel.
+    *
+    * @param[in] sAvrType       The average type (comment of the evoked data).
+    * @param[in] iChannelIdx    The channel index.
+    * @param[in] iRevision      The current revision of the channel as reported by the EvokedSetModel.
+    * @param[in] mapping        The sample to pixel mapping.
+    * @param[in] pData          Pointer to the first sample of the channel.
+    * @param[in] iNumSamples    The number of samples.
+    * @param[in] iStride        The distance between two consecutive samples in pData (the number of channels for column major data).
+    *
+    * @return the area covered by the old and the new polyline, i.e. the area which needs to be repainted.
+    */
+    QRectF update(const QString& sAvrType,
+                  qint32 iChannelIdx,
+                  quint32 iRevision,
+                  const Mapping& mapping,
+                  const double* pData,
+                  qint32 iNumSamples,
+                  qint32 iStride = 1);
+
+    //=========================================================================================================
+    /**
+    * Returns the cached polyline of the given average type and channel. The polyline is empty if none was built yet.
+    *
+    * @param[in] sAvrType       The average type (comment of the evoked data).
+    * @param[in] iChannelIdx    The channel index.
+    *
+    * @return the cached polyline.
+    */
+    const QPolygonF& polyline(const QString& sAvrType,
+                              qint32 iChannelIdx) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the area covered by the cached polyline of the given average type and channel, including the pen.
+    *
+    * @param[in] sAvrType       The average type (comment of the evoked data).
+    * @param[in] iChannelIdx    The channel index.
+    *
+    * @return the bounding rect of the cached polyline.
+    */
+    QRectF boundingRect(const QString& sAvrType,
+                        qint32 iChannelIdx) const;
+
+    //=========================================================================================================
+    /**
+    * Removes all entries whose average type is not part of the given list.
+    *
+    * @param[in] lAvrTypes      The average types which are still present.
+    *
+    * @return the area covered by the removed polylines.
+    */
+    QRectF retain(const QStringList& lAvrTypes);
+
+    //=========================================================================================================
+    /**
+    * Removes all entries.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Maps the samples to paint device coordinates. If there are more than two samples per pixel column, each
+    * column is reduced to its minimum and maximum (in the order they occur), which keeps all peaks visible.
+    *
+    * @param[in] pData          Pointer to the first sample.
+    * @param[in] iNumSamples    The number of samples.
+    * @param[in] iStride        The distance between two consecutive samples in pData.
+    * @param[in] mapping        The sample to pixel mapping.
+    *
+    * @return the decimated polyline.
+    */
+    static QPolygonF decimate(const double* pData,
+                              qint32 iNumSamples,
+                              qint32 iStride,
+                              const Mapping& mapping);
+
+private:
+    struct Entry {
+        quint32     iRevision;          /**< The revision the polyline was built for. */
+        qint32      iNumSamples;        /**< The number of samples the polyline was built for. */
+        Mapping     mapping;            /**< The mapping the polyline was built for. */
+        QPolygonF   polyline;           /**< The decimated polyline. */
+        QRectF      rectBounding;       /**< The area covered by the polyline, grown by one pixel for the pen. */
+    };
+
+    QHash<QPair<QString,qint32>, Entry>     m_hashEntries;      /**< The cached polylines per average type and channel. */
+    QPolygonF                               m_emptyPolyline;    /**< Returned for unknown entries. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+
+} // NAMESPACE DISPLIB
+
+#endif // EVOKEDPOLYLINECACHE_H
@@ -89,6 +89,8 @@ EvokedSetModel::EvokedSetModel(QObject *parent)
 , m_qMapAverageActivation(QSharedPointer<QMap<QString, bool> >::create())
 , m_qMapAverageColorOld(QSharedPointer<QMap<QString, QColor> >::create())
 , m_qMapAverageActivationOld(QSharedPointer<QMap<QString, bool> >::create())
+, m_iRevisionCounter(0)
+, m_iGlobalRevision(0)
 {
 }
 
@@ -370,9 +372,14 @@ void EvokedSetModel::updateData()
         return;
     }
 
-    m_matData.clear();
-    m_matDataFiltered.clear();
-    m_lAvrTypes.clear();
+    //Keep the previously displayed data in order to find out which channels actually changed
+    QList<MatrixXd> lDataOld;
+    QList<MatrixXd> lDataFilteredOld;
+    QStringList lAvrTypesOld;
+
+    lDataOld.swap(m_matData);
+    lDataFilteredOld.swap(m_matDataFiltered);
+    lAvrTypesOld.swap(m_lAvrTypes);
 
     for(int i = 0; i < m_pEvokedSet->evoked.size(); ++i) {
         bool doProj = m_bProjActivated && m_pEvokedSet->evoked.at(i).data.cols() > 0 && m_pEvokedSet->evoked.at(i).data.rows() == m_matProj.cols() ? true : false;
@@ -408,6 +415,15 @@ void EvokedSetModel::updateData()
         filterChannelsConcurrently();
     }
 
+    //The displayed data does not change while freezed. Toggling the freeze invalidates all channels anyway.
+    if(!m_bIsFreezed) {
+        if(!m_filterData.isEmpty() && m_bPerformFiltering) {
+            updateChannelRevisions(lDataFilteredOld, lAvrTypesOld);
+        } else {
+            updateChannelRevisions(lDataOld, lAvrTypesOld);
+        }
+    }
+
     // Update average selection information map. Use old colors if existing.
     QStringList slCurrentAvrComments;
     int iSizeAvrActivation = m_qMapAverageActivation->size();
@@ -474,6 +490,10 @@ void EvokedSetModel::updateData()
 
 void EvokedSetModel::setFilterActive(bool state)
 {
+    if(m_bPerformFiltering != state) {
+        invalidateChannelRevisions();
+    }
+
     m_bPerformFiltering = state;
 }
 
@@ -873,6 +893,8 @@ void EvokedSetModel::toggleFreeze()
 {
     m_bIsFreezed = !m_bIsFreezed;
 
+    invalidateChannelRevisions();
+
     if(m_bIsFreezed) {
         m_matDataFilteredFreeze = m_matDataFiltered;
         m_matDataFreeze = m_matData;
@@ -893,6 +915,8 @@ void EvokedSetModel::setFilter(const FilterData& filterData)
     m_filterData.clear();
     m_filterData << filterData;
 
+    invalidateChannelRevisions();
+
     m_iMaxFilterLength = 1;
     for(int i=0; i<m_filterData.size(); i++) {
         if(m_iMaxFilterLength < m_filterData.at(i).m_iFilterOrder) {
@@ -1047,3 +1071,67 @@ void EvokedSetModel::filterChannelsConcurrently()
     }
 }
 
+
+//*************************************************************************************************************
+
+quint32 EvokedSetModel::getChannelRevision(const QString& sAvrType, qint32 iChannelIdx) const
+{
+    QMap<QString, QVector<quint32> >::const_iterator it = m_qMapChannelRevision.constFind(sAvrType);
+
+    if(it != m_qMapChannelRevision.constEnd() && iChannelIdx >= 0 && iChannelIdx < it->size()) {
+        return qMax(m_iGlobalRevision, it->at(iChannelIdx));
+    }
+
+    return m_iGlobalRevision;
+}
+
+
+//*************************************************************************************************************
+
+void EvokedSetModel::updateChannelRevisions(const QList<MatrixXd>& lDataOld, const QStringList& lAvrTypesOld)
+{
+    const QList<MatrixXd>& lDataNew = (!m_filterData.isEmpty() && m_bPerformFiltering) ? m_matDataFiltered : m_matData;
+    const quint32 iRevision = ++m_iRevisionCounter;
+
+    for(int i = 0; i < lDataNew.size() && i < m_lAvrTypes.size(); ++i) {
+        const MatrixXd& matNew = lDataNew.at(i);
+        QVector<quint32>& vecRevision = m_qMapChannelRevision[m_lAvrTypes.at(i)];
+
+        int iIdxOld = lAvrTypesOld.indexOf(m_lAvrTypes.at(i));
+        bool bChangedAll = iIdxOld < 0
+                || iIdxOld >= lDataOld.size()
+                || lDataOld.at(iIdxOld).rows() != matNew.rows()
+                || lDataOld.at(iIdxOld).cols() != matNew.cols()
+                || vecRevision.size() != matNew.rows();
+
+        if(bChangedAll) {
+            vecRevision.fill(iRevision, matNew.rows());
+            continue;
+        }
+
+        const MatrixXd& matOld = lDataOld.at(iIdxOld);
+
+        for(int r = 0; r < matNew.rows(); ++r) {
+            if(matOld.row(r) != matNew.row(r)) {
+                vecRevision[r] = iRevision;
+            }
+        }
+    }
+
+    //Remove average types which are no longer present
+    QMutableMapIterator<QString, QVector<quint32> > itr(m_qMapChannelRevision);
+    while(itr.hasNext()) {
+        itr.next();
+        if(!m_lAvrTypes.contains(itr.key())) {
+            itr.remove();
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void EvokedSetModel::invalidateChannelRevisions()
+{
+    m_iGlobalRevision = ++m_iRevisionCounter;
+}
@@ -56,6 +56,7 @@
 #include <QAbstractTableModel>
 #include <QSharedPointer>
 #include <QColor>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -425,6 +426,18 @@ public:
     */
     void createFilterChannelList(QStringList channelNames);
 
+    //=========================================================================================================
+    /**
+    * Returns the revision of the displayed data of a given average type and channel. The revision changes whenever
+    * the displayed samples of this channel change, which lets views keep cached polylines of all other channels.
+    *
+    * @param[in] sAvrType       the average type (comment of the evoked data)
+    * @param[in] iChannelIdx    the channel index (not the selection mapped row)
+    *
+    * @return the current revision
+    */
+    quint32 getChannelRevision(const QString& sAvrType, qint32 iChannelIdx) const;
+
 private:
     //=========================================================================================================
     /**
@@ -432,6 +445,22 @@ private:
     */
     void filterChannelsConcurrently();
 
+    //=========================================================================================================
+    /**
+    * Compares the newly displayed data with the previously displayed data and stamps all channels which changed
+    * with a new revision.
+    *
+    * @param[in] lDataOld       the previously displayed data
+    * @param[in] lAvrTypesOld   the previously present average types
+    */
+    void updateChannelRevisions(const QList<Eigen::MatrixXd>& lDataOld, const QStringList& lAvrTypesOld);
+
+    //=========================================================================================================
+    /**
+    * Invalidates the revisions of all channels, i.e. when switching between freezed, filtered and raw data.
+    */
+    void invalidateChannelRevisions();
+
     QSharedPointer<FIFFLIB::FiffEvokedSet>  m_pEvokedSet;                   /**< The evoked set measurement. */
 
     QMap<qint32,qint32>                     m_qMapIdxRowSelection;          /**< Selection mapping.*/
@@ -469,6 +498,10 @@ private:
     QStringList                             m_filterChannelList;            /**< List of channels which are to be filtered.*/
     QStringList                             m_visibleChannelList;           /**< List of currently visible channels in the view.*/
 
+    QMap<QString, QVector<quint32> >        m_qMapChannelRevision;          /**< Revision of the displayed data per average type and channel. */
+    quint32                                 m_iRevisionCounter;             /**< The last handed out revision. */
+    quint32                                 m_iGlobalRevision;              /**< Revision at which all channels were invalidated. */
+
 signals:
     //=========================================================================================================
     /**
@@ -78,6 +78,8 @@ FrequencySpectrumDelegate::FrequencySpectrumDelegate(QTableView* m_pTableView,QO
 , m_mousex(0)
 , m_mousey(0)
 , m_x_rate(0.0)
+, m_iBinGroupLayoutRevision(0)
+, m_iBinGroupWidth(-1)
 {
     m_tableview = m_pTableView;
     m_tableview->setMouseTracking(true);
@@ -127,24 +129,19 @@ void FrequencySpectrumDelegate::paint(QPainter *painter, const QStyleOptionViewI
 //                painter->setBrushOrigin(oldBO);
 //            }
 
-            //Get data
-            QVariant variant = index.model()->data(index,Qt::DisplayRole);
-            RowVectorXd data = variant.value< RowVectorXd >();
-
-
             const FrequencySpectrumModel* t_pModel = static_cast<const FrequencySpectrumModel*>(index.model());
 
-            if(data.size() > 0)
+            if(t_pModel->getNumStems() > 0)
             {
                 QPainterPath path(QPointF(option.rect.x(),option.rect.y()));//QPointF(option.rect.x()+t_rtmsaModel->relFiffCursor()-1,option.rect.y()));
 
                 //Plot grid
                 painter->setRenderHint(QPainter::Antialiasing, false);
-                createGridPath(index, option, path, data);
+                createGridPath(index, option, path);
                 createGridTick(index, option, painter);
 
                 //capture the mouse
-                capturePoint(index, option, path, data, painter);
+                capturePoint(index, option, painter);
 
                 painter->save();
                 QPen pen;
@@ -154,14 +151,11 @@ void FrequencySpectrumDelegate::paint(QPainter *painter, const QStyleOptionViewI
                 painter->drawPath(path);
                 painter->restore();
 
-
-                //Plot data path
-                path = QPainterPath(QPointF(option.rect.x(),option.rect.y()));//QPointF(option.rect.x()+t_rtmsaModel->relFiffCursor(),option.rect.y()));
-
-                createPlotPath(index, option, path, data);
+                //Plot data polyline
+                const QPolygonF& polyline = plotPolyline(index, option);
 
                 painter->save();
-                painter->translate(0,t_fPlotHeight/2);
+                painter->translate(0,option.rect.y()+t_fPlotHeight/2);
                 painter->setRenderHint(QPainter::Antialiasing, true);
 
                 if(option.state & QStyle::State_Selected)
@@ -169,7 +163,7 @@ void FrequencySpectrumDelegate::paint(QPainter *painter, const QStyleOptionViewI
                 else
                     painter->setPen(QPen(t_pModel->isFreezed() ? Qt::darkGray : Qt::darkBlue, 1, Qt::SolidLine));
 
-                painter->drawPath(path);
+                painter->drawPolyline(polyline);
                 painter->restore();
             }
             painter->restore();
@@ -190,7 +184,6 @@ QSize FrequencySpectrumDelegate::sizeHint(const QStyleOptionViewItem &option, co
         size = QSize(20,option.rect.height());
         break;
     case 1:
-        RowVectorXd data = index.model()->data(index).value< RowVectorXd >();
 //        qint32 nsamples = (static_cast<const FrequencySpectrumModel*>(index.model()))->lastSample()-(static_cast<const FrequencySpectrumModel*>(index.model()))->firstSample();
 
 //        size = QSize(nsamples*m_dDx,m_dPlotHeight);
@@ -208,7 +201,9 @@ QSize FrequencySpectrumDelegate::sizeHint(const QStyleOptionViewItem &option, co
 void FrequencySpectrumDelegate::rcvMouseLoc(int tableview_row, int mousex, int mousey, QRect visRect)
 {
 
-    if(mousex != m_mousex){
+    if(mousex != m_mousex || tableview_row != m_tableview_row){
+
+    QRect rectOld = m_visRect;
 
     m_tableview_row = tableview_row;
     m_mousex = mousex;
@@ -217,22 +212,26 @@ void FrequencySpectrumDelegate::rcvMouseLoc(int tableview_row, int mousex, int m
 
     m_x_rate = (float)m_mousex/(float)m_visRect.width();
 
-
-    m_tableview->viewport()->repaint();
+    //Only the rows showing the old and the new cursor need to be repainted
+    int iWidth = m_tableview->viewport()->width();
+    m_tableview->viewport()->update(QRect(0, rectOld.top(), iWidth, rectOld.height()));
+    m_tableview->viewport()->update(QRect(0, m_visRect.top(), iWidth, m_visRect.height()));
     }
 }
 
 
 //*************************************************************************************************************
 
-void FrequencySpectrumDelegate::capturePoint(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path, RowVectorXd& data, QPainter *painter) const
+void FrequencySpectrumDelegate::capturePoint(const QModelIndex &index, const QStyleOptionViewItem &option, QPainter *painter) const
 {
     Q_UNUSED(option);
-    Q_UNUSED(path);
 
     if (m_tableview_row == index.row()){
     const FrequencySpectrumModel* t_pModel = static_cast<const FrequencySpectrumModel*>(index.model());
 
+    //Only the hovered row needs its data for the cursor label
+    RowVectorXd data = index.model()->data(index,Qt::DisplayRole).value< RowVectorXd >();
+
     qint32 i;
 
     RowVectorXd org_vecFreqScale = t_pModel->getFreqScale();
@@ -324,57 +323,121 @@ void FrequencySpectrumDelegate::capturePoint(const QModelIndex &index, const QSt
 
 //*************************************************************************************************************
 
-void FrequencySpectrumDelegate::createPlotPath(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path, RowVectorXd& data) const
+const QPolygonF& FrequencySpectrumDelegate::plotPolyline(const QModelIndex &index, const QStyleOptionViewItem &option) const
 {
     const FrequencySpectrumModel* t_pModel = static_cast<const FrequencySpectrumModel*>(index.model());
 
-    float fMaxValue = data.maxCoeff();
+    qint32 iChIdx = t_pModel->getIdxSelMap().value(index.row());
 
-    float fValue;
-    float fScaleY = option.rect.height()/(fMaxValue*0.5);
+    PlotCache& cache = m_qHashPlotCache[iChIdx];
 
-    float y_base = path.currentPosition().y();
-    QPointF qSamplePosition;
+    if(cache.polyline.isEmpty()
+       || cache.iDataRevision != t_pModel->getDataRevision()
+       || cache.iLayoutRevision != t_pModel->getLayoutRevision()
+       || cache.size != option.rect.size()) {
+        RowVectorXd data = index.model()->data(index,Qt::DisplayRole).value< RowVectorXd >();
 
-    qint32 lowerIdx = t_pModel->getLowerFrqBound();
-    qint32 upperIdx = t_pModel->getUpperFrqBound();
+        createPlotPolyline(t_pModel, option, data, cache.polyline);
 
-    //Move to initial starting point
-    if(data.size() > 0)
-    {
-        float val = 0;
-        fValue = val*fScaleY;
+        cache.iDataRevision = t_pModel->getDataRevision();
+        cache.iLayoutRevision = t_pModel->getLayoutRevision();
+        cache.size = option.rect.size();
+    }
+
+    return cache.polyline;
+}
 
-        float newY = y_base+fValue;
 
-        qSamplePosition.setY(newY);
-        qSamplePosition.setX((double)option.rect.width()*t_pModel->getFreqScaleBound()[lowerIdx]);
+//*************************************************************************************************************
 
-        path.moveTo(qSamplePosition);
+void FrequencySpectrumDelegate::createPlotPolyline(const FrequencySpectrumModel* pModel, const QStyleOptionViewItem &option, const RowVectorXd& data, QPolygonF& polyline) const
+{
+    polyline.clear();
+
+    qint32 lowerIdx = pModel->getLowerFrqBound();
+    qint32 upperIdx = pModel->getUpperFrqBound();
+
+    if(data.size() <= upperIdx) {
+        return;
     }
 
-    //create lines from one to the next sample
-    qint32 i;
-    for(i = lowerIdx+1; i <= upperIdx; ++i) {
-        float val = data[i]-data[0]; //remove first sample data[0] as offset
-        fValue = val*fScaleY;
+    updateBinGroups(pModel, option.rect.width());
 
-        float newY = y_base+fValue;
+    const RowVectorXd& vecFreqScaleBound = pModel->getFreqScaleBound();
+    double dWidth = option.rect.width();
 
-        qSamplePosition.setY(newY);
-        qSamplePosition.setX((double)option.rect.width()*t_pModel->getFreqScaleBound()[i]);
+    float fMaxValue = data.maxCoeff();
+    float fScaleY = option.rect.height()/(fMaxValue*0.5);
+
+    polyline.reserve(2 * m_vecBinGroupStart.size());
+
+    //Move to initial starting point
+    polyline.append(QPointF(dWidth*vecFreqScaleBound[lowerIdx], 0.0));
+
+    //create lines from one to the next group of bins, remove first sample data[0] as offset
+    for(qint32 g = 0; g < m_vecBinGroupStart.size()-1; ++g) {
+        qint32 iStart = m_vecBinGroupStart[g];
+        qint32 iEnd = m_vecBinGroupStart[g+1];
 
-        path.lineTo(qSamplePosition);
+        if(iEnd - iStart <= 2) {
+            for(qint32 i = iStart; i < iEnd; ++i) {
+                polyline.append(QPointF(dWidth*vecFreqScaleBound[i], (data[i]-data[0])*fScaleY));
+            }
+        } else {
+            //keep the extrema of the pixel column in the order they occur
+            qint32 iMin, iMax;
+            data.segment(iStart, iEnd-iStart).minCoeff(&iMin);
+            data.segment(iStart, iEnd-iStart).maxCoeff(&iMax);
+            iMin += iStart;
+            iMax += iStart;
+
+            qint32 iFirst = qMin(iMin, iMax);
+            qint32 iSecond = qMax(iMin, iMax);
+
+            polyline.append(QPointF(dWidth*vecFreqScaleBound[iFirst], (data[iFirst]-data[0])*fScaleY));
+            polyline.append(QPointF(dWidth*vecFreqScaleBound[iSecond], (data[iSecond]-data[0])*fScaleY));
+        }
     }
 }
 
 
 //*************************************************************************************************************
 
-void FrequencySpectrumDelegate::createGridPath(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path, RowVectorXd& data) const
+void FrequencySpectrumDelegate::updateBinGroups(const FrequencySpectrumModel* pModel, int iWidth) const
 {
-    Q_UNUSED(data)
+    if(m_iBinGroupWidth == iWidth
+       && m_iBinGroupLayoutRevision == pModel->getLayoutRevision()
+       && !m_vecBinGroupStart.isEmpty()) {
+        return;
+    }
+
+    m_iBinGroupWidth = iWidth;
+    m_iBinGroupLayoutRevision = pModel->getLayoutRevision();
+    m_vecBinGroupStart.clear();
+
+    const RowVectorXd& vecFreqScaleBound = pModel->getFreqScaleBound();
+    qint32 lowerIdx = pModel->getLowerFrqBound();
+    qint32 upperIdx = pModel->getUpperFrqBound();
 
+    qint32 iLastColumn = -1;
+
+    for(qint32 i = lowerIdx+1; i <= upperIdx; ++i) {
+        qint32 iColumn = (qint32)floor(iWidth*vecFreqScaleBound[i]);
+
+        if(m_vecBinGroupStart.isEmpty() || iColumn != iLastColumn) {
+            m_vecBinGroupStart.append(i);
+            iLastColumn = iColumn;
+        }
+    }
+
+    m_vecBinGroupStart.append(upperIdx+1);
+}
+
+
+//*************************************************************************************************************
+
+void FrequencySpectrumDelegate::createGridPath(const QModelIndex &index, const QStyleOptionViewItem &option, QPainterPath& path) const
+{
     const FrequencySpectrumModel* t_pModel = static_cast<const FrequencySpectrumModel*>(index.model());
 
     if(t_pModel->getInfo())
@@ -52,6 +52,9 @@
 
 #include <QAbstractItemDelegate>
 #include <QPointer>
+#include <QHash>
+#include <QVector>
+#include <QPolygonF>
 
 
 //*************************************************************************************************************
@@ -84,6 +87,8 @@ namespace DISPLIB
 // DISPLIB FORWARD DECLARATIONS
 //=============================================================================================================
 
+class FrequencySpectrumModel;
+
 
 //=============================================================================================================
 /**
@@ -158,37 +163,63 @@ private:
     * CapturePoint capture one QPointer .
     *
     * @param[in]        index   QModelIndex for accessing associated data and model object.
-    * @param[in,out]    path    The QPointerPath to create for the data plot.
+    * @param[in]        option  Describes the parameters used to draw an item in a view widget.
+    * @param[in]        painter The painter to draw the cursor and its label with.
     */
     void capturePoint(const QModelIndex &index,
                       const QStyleOptionViewItem &option,
-                      QPainterPath& path,
-                      Eigen::RowVectorXd& data,
                       QPainter *painter) const;
 
     //=========================================================================================================
     /**
-    * createPlotPath creates the QPointer path for the data plot.
+    * Returns the cached polyline of the data plot. The polyline is rebuilt only when the data, the frequency
+    * layout or the size of the item changed. Its origin is the vertical center of the item.
     *
-    * @param[in]        index   QModelIndex for accessing associated data and model object.
-    * @param[in,out]    path    The QPointerPath to create for the data plot.
+    * @param[in] index      QModelIndex for accessing associated data and model object.
+    * @param[in] option     Describes the parameters used to draw an item in a view widget.
+    *
+    * @return the polyline of the data plot.
     */
-    void createPlotPath(const QModelIndex &index,
-                        const QStyleOptionViewItem &option,
-                        QPainterPath& path,
-                        Eigen::RowVectorXd& data) const;
+    const QPolygonF& plotPolyline(const QModelIndex &index,
+                                  const QStyleOptionViewItem &option) const;
+
+    //=========================================================================================================
+    /**
+    * createPlotPolyline creates the polyline for the data plot. Frequency bins which fall into the same pixel
+    * column are reduced to their minimum and maximum.
+    *
+    * @param[in]        pModel      The model holding the frequency scale.
+    * @param[in]        option      Describes the parameters used to draw an item in a view widget.
+    * @param[in]        data        The spectrum of the channel.
+    * @param[in,out]    polyline    The polyline to create for the data plot.
+    */
+    void createPlotPolyline(const FrequencySpectrumModel* pModel,
+                            const QStyleOptionViewItem &option,
+                            const Eigen::RowVectorXd& data,
+                            QPolygonF& polyline) const;
+
+    //=========================================================================================================
+    /**
+    * Groups the plotted frequency bins by the pixel column they are drawn to. This is done once per frequency
+    * layout and item width.
+    *
+    * @param[in] pModel     The model holding the frequency scale.
+    * @param[in] iWidth     The width of the data plot in pixels.
+    */
+    void updateBinGroups(const FrequencySpectrumModel* pModel,
+                         int iWidth) const;
 
     //=========================================================================================================
     /**
     * createGridPath Creates the QPointer path for the grid plot.
     *
-    * @param[in,out] path The row vector of the data matrix <1 x nsamples>.
-    * @param[in] data The row vector of the data matrix <1 x nsamples>.
+    * @param[in]        index   QModelIndex for accessing associated data and model object.
+    * @param[in]        option  Describes the parameters used to draw an item in a view widget.
+    * @param[in,out]    path    The QPointerPath to create for the grid plot.
     */
     void createGridPath(const QModelIndex &index,
                         const QStyleOptionViewItem &option,
-                        QPainterPath& path,
-                        Eigen::RowVectorXd& data) const;
+                        QPainterPath& path) const;
 
     //=========================================================================================================
     /**
@@ -200,8 +231,20 @@ private:
                         const QStyleOptionViewItem &option,
                         QPainter *painter) const;
 
+    struct PlotCache {
+        quint32     iDataRevision;      /**< Data revision of the model the polyline was created for */
+        quint32     iLayoutRevision;    /**< Layout revision of the model the polyline was created for */
+        QSize       size;               /**< Item size the polyline was created for */
+        QPolygonF   polyline;           /**< The cached polyline */
+    };
+
     QPointer<QTableView>    m_tableview; /**< Pointer to the TableView */
 
+    mutable QHash<qint32, PlotCache>    m_qHashPlotCache;           /**< Cached polylines, keyed by the channel index */
+    mutable QVector<qint32>             m_vecBinGroupStart;         /**< First frequency bin of each pixel column group, terminated by upper bound + 1 */
+    mutable quint32                     m_iBinGroupLayoutRevision;  /**< Layout revision the bin groups were created for */
+    mutable int                         m_iBinGroupWidth;           /**< Item width the bin groups were created for */
+
     int         m_tableview_row;    /**< the selected row of the tableview*/
     int         m_mousex;           /**< the mouse x pos */
     int         m_mousey;           /**< the mouse y pos */
@@ -49,6 +49,8 @@
 // Qt INCLUDES
 //=============================================================================================================
 
+#include <QtMath>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -73,6 +75,9 @@ using namespace Eigen;
 
 FrequencySpectrumModel::FrequencySpectrumModel(QObject *parent)
 : QAbstractTableModel(parent)
+, m_dTimeConstant(0.0)
+, m_iDataRevision(0)
+, m_iLayoutRevision(0)
 , m_fSps(1024.0f)
 , m_iT(10)
 , m_bIsFreezed(false)
@@ -215,13 +220,24 @@ void FrequencySpectrumModel::setInfo(FiffInfo::SPtr &info)
 void FrequencySpectrumModel::setScaleType(qint8 ScaleType)
 {
     m_iScaleType = ScaleType;
+    ++m_iLayoutRevision;
 }
 
 //*************************************************************************************************************
 
 void FrequencySpectrumModel::addData(const MatrixXd &data)
 {
-    m_dataCurrent = data;
+    if(m_dTimeConstant > 0.0
+       && m_timerLastData.isValid()
+       && m_dataCurrent.rows() == data.rows()
+       && m_dataCurrent.cols() == data.cols()) {
+        //Exponential moving average, weighted by the time passed since the last estimate
+        double dAlpha = 1.0 - qExp(-(m_timerLastData.restart() / 1000.0) / m_dTimeConstant);
+        m_dataCurrent += dAlpha * (data - m_dataCurrent);
+    } else {
+        m_dataCurrent = data;
+        m_timerLastData.start();
+    }
 
     if(m_vecFreqScale.size() != m_dataCurrent.cols() && m_pFiffInfo)
     {
@@ -247,10 +263,18 @@ void FrequencySpectrumModel::addData(const MatrixXd &data)
         m_iLowerFrqIdx = 0;
         m_iUpperFrqIdx = m_vecFreqScale.size()-1;
 
+        ++m_iLayoutRevision;
 
         m_bInitialized = true;
     }
 
+    //The frozen spectra are displayed until the freeze is released
+    if(m_bIsFreezed) {
+        return;
+    }
+
+    ++m_iDataRevision;
+
     //Update data content
     QModelIndex topLeft = this->index(0,1);
     QModelIndex bottomRight = this->index(m_dataCurrent.rows()-1,1);
@@ -259,6 +283,17 @@ void FrequencySpectrumModel::addData(const MatrixXd &data)
 }
 
 
+//*************************************************************************************************************
+
+void FrequencySpectrumModel::setTimeConstant(double dTimeConstant)
+{
+    m_dTimeConstant = dTimeConstant;
+
+    //Restart the average with the next estimate
+    m_timerLastData.invalidate();
+}
+
+
 //*************************************************************************************************************
 
 void FrequencySpectrumModel::selectRows(const QList<qint32> &selection)
@@ -309,6 +344,8 @@ void FrequencySpectrumModel::toggleFreeze(const QModelIndex & index)
     if(m_bIsFreezed)
         m_dataCurrentFreeze = m_dataCurrent;
 
+    ++m_iDataRevision;
+
     //Update data content
     QModelIndex topLeft = this->index(0,1);
     QModelIndex bottomRight = this->index(m_dataCurrent.rows()-1,1);
@@ -351,5 +388,7 @@ void FrequencySpectrumModel::setBoundaries(float fLowerFrqBound, float fUpperFrq
         m_vecFreqScaleBound[i] = (m_vecFreqScaleBound[i] - m_vecFreqScale[m_iLowerFrqIdx]) / (m_vecFreqScale[m_iUpperFrqIdx] - m_vecFreqScale[m_iLowerFrqIdx]);
     }
 
+    ++m_iLayoutRevision;
+
     endResetModel();
 }
@@ -53,6 +53,7 @@
 
 #include <QAbstractTableModel>
 #include <QSharedPointer>
+#include <QElapsedTimer>
 
 
 //*************************************************************************************************************
@@ -179,6 +180,39 @@ public:
     */
     void addData(const Eigen::MatrixXd &data);
 
+    //=========================================================================================================
+    /**
+    * Sets the time constant of the exponential moving average which is applied to incoming spectra.
+    * A value <= 0 disables the averaging, i.e. each new estimate replaces the previous one.
+    *
+    * @param[in] dTimeConstant  the time constant in seconds
+    */
+    void setTimeConstant(double dTimeConstant);
+
+    //=========================================================================================================
+    /**
+    * Returns the time constant of the exponential moving average
+    *
+    * @return the time constant in seconds
+    */
+    inline double getTimeConstant() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the data revision. It is increased whenever the displayed spectra change.
+    *
+    * @return the data revision
+    */
+    inline quint32 getDataRevision() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the layout revision. It is increased whenever the frequency scale or the boundaries change.
+    *
+    * @return the layout revision
+    */
+    inline quint32 getLayoutRevision() const;
+
     //=========================================================================================================
     /**
     * Returns the fiff info
@@ -193,7 +227,7 @@ public:
     *
     * @return the frequency scale of the x axis
     */
-    inline Eigen::RowVectorXd getFreqScale() const;
+    inline const Eigen::RowVectorXd& getFreqScale() const;
 
     //=========================================================================================================
     /**
@@ -201,7 +235,7 @@ public:
     *
     * @return the frequency scale of the x axis
     */
-    inline Eigen::RowVectorXd getFreqScaleBound() const;
+    inline const Eigen::RowVectorXd& getFreqScaleBound() const;
 
     //=========================================================================================================
     /**
@@ -293,6 +327,11 @@ private:
     Eigen::MatrixXd         m_dataCurrent;          /**< List that holds the current data*/
     Eigen::MatrixXd         m_dataCurrentFreeze;    /**< List that holds the current data when freezed*/
 
+    QElapsedTimer           m_timerLastData;        /**< Measures the time between two incoming spectra */
+
+    double      m_dTimeConstant;        /**< Time constant of the moving average in seconds, <= 0 if disabled */
+    quint32     m_iDataRevision;        /**< Revision of the displayed spectra */
+    quint32     m_iLayoutRevision;      /**< Revision of the frequency scale and boundaries */
     float       m_fSps;                 /**< Sampling rate */
     qint32      m_iT;                   /**< Time window */
     qint32      m_iLowerFrqIdx;         /**< Upper frequency plotting boundary */
@@ -316,7 +355,7 @@ QSharedPointer<FIFFLIB::FiffInfo> FrequencySpectrumModel::getInfo() const
 
 //*************************************************************************************************************
 
-Eigen::RowVectorXd FrequencySpectrumModel::getFreqScale() const
+const Eigen::RowVectorXd& FrequencySpectrumModel::getFreqScale() const
 {
     return m_vecFreqScale;
 }
@@ -324,12 +363,36 @@ Eigen::RowVectorXd FrequencySpectrumModel::getFreqScale() const
 
 //*************************************************************************************************************
 
-Eigen::RowVectorXd FrequencySpectrumModel::getFreqScaleBound() const
+const Eigen::RowVectorXd& FrequencySpectrumModel::getFreqScaleBound() const
 {
     return m_vecFreqScaleBound;
 }
 
 
+//*************************************************************************************************************
+
+inline double FrequencySpectrumModel::getTimeConstant() const
+{
+    return m_dTimeConstant;
+}
+
+
+//*************************************************************************************************************
+
+inline quint32 FrequencySpectrumModel::getDataRevision() const
+{
+    return m_iDataRevision;
+}
+
+
+//*************************************************************************************************************
+
+inline quint32 FrequencySpectrumModel::getLayoutRevision() const
+{
+    return m_iLayoutRevision;
+}
+
+
 //*************************************************************************************************************
 
 inline qint32 FrequencySpectrumModel::getNumStems() const
@@ -0,0 +1,275 @@
+//=============================================================================================================
+/**
+* @file     minmaxpyramid.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the MinMaxPyramid Class.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "minmaxpyramid.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtGlobal>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISPLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MinMaxPyramid::MinMaxPyramid(int iBaseLevel)
+: m_iBaseLevel(iBaseLevel < 1 ? 1 : iBaseLevel)
+, m_iNumberChannels(0)
+, m_iNumberSamples(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::resize(int iNumberChannels, int iNumberSamples)
+{
+    m_iNumberChannels = iNumberChannels < 0 ? 0 : iNumberChannels;
+    m_iNumberSamples = iNumberSamples < 0 ? 0 : iNumberSamples;
+
+    m_qVecMin.clear();
+    m_qVecMax.clear();
+
+    //Add levels until a single bin covers all samples
+    int iShift = m_iBaseLevel;
+    while(m_iNumberSamples > 0) {
+        int iNumberBins = ((m_iNumberSamples - 1) >> iShift) + 1;
+
+        m_qVecMin.append(MatrixXdR::Zero(m_iNumberChannels, iNumberBins));
+        m_qVecMax.append(MatrixXdR::Zero(m_iNumberChannels, iNumberBins));
+
+        if(iNumberBins == 1) {
+            break;
+        }
+
+        ++iShift;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::clear()
+{
+    for(int l = 0; l < m_qVecMin.size(); ++l) {
+        m_qVecMin[l].setZero();
+        m_qVecMax[l].setZero();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::build(const MatrixXdR& matData)
+{
+    if(!matches(matData.rows(), matData.cols())) {
+        resize(matData.rows(), matData.cols());
+    }
+
+    updateBins(&matData, -1, Q_NULLPTR, 0, m_iNumberSamples);
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::update(const MatrixXdR& matData, int iFrom, int iTo)
+{
+    if(!matches(matData.rows(), matData.cols())) {
+        build(matData);
+        return;
+    }
+
+    updateBins(&matData, -1, Q_NULLPTR, iFrom, iTo);
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::updateRow(const double* pRowData, int iRow, int iFrom, int iTo)
+{
+    if(!pRowData || iRow < 0 || iRow >= m_iNumberChannels) {
+        return;
+    }
+
+    updateBins(Q_NULLPTR, iRow, pRowData, iFrom, iTo);
+}
+
+
+//*************************************************************************************************************
+
+bool MinMaxPyramid::range(const double* pRowData, int iRow, int iFrom, int iTo, double& dMin, double& dMax) const
+{
+    iFrom = qMax(iFrom, 0);
+    iTo = qMin(iTo, m_iNumberSamples);
+
+    if(!pRowData || iFrom >= iTo || iRow < 0 || iRow >= m_iNumberChannels) {
+        return false;
+    }
+
+    dMin = std::numeric_limits<double>::max();
+    dMax = -std::numeric_limits<double>::max();
+
+    int iPos = iFrom;
+
+    while(iPos < iTo) {
+        bool bBinUsed = false;
+
+        //Take the coarsest bin which starts at the current position and does not exceed the range
+        for(int l = m_qVecMin.size() - 1; l >= 0; --l) {
+            int iShift = m_iBaseLevel + l;
+
+            if(iPos & ((1 << iShift) - 1)) {
+                continue;
+            }
+
+            int iEnd = qMin(iPos + (1 << iShift), m_iNumberSamples);
+
+            if(iEnd <= iTo) {
+                int iBin = iPos >> iShift;
+                dMin = qMin(dMin, m_qVecMin.at(l).coeff(iRow, iBin));
+                dMax = qMax(dMax, m_qVecMax.at(l).coeff(iRow, iBin));
+                iPos = iEnd;
+                bBinUsed = true;
+                break;
+            }
+        }
+
+        //Unaligned edges are read from the data directly
+        if(!bBinUsed) {
+            double dValue = pRowData[iPos];
+            dMin = qMin(dMin, dValue);
+            dMax = qMax(dMax, dValue);
+            ++iPos;
+        }
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void MinMaxPyramid::updateBins(const MatrixXdR* pMatData, int iRow, const double* pRowData, int iFrom, int iTo)
+{
+    iFrom = qMax(iFrom, 0);
+    iTo = qMin(iTo, m_iNumberSamples);
+
+    if(iFrom >= iTo || m_qVecMin.isEmpty()) {
+        return;
+    }
+
+    //Level 0 is computed from the data
+    int iBinSize = 1 << m_iBaseLevel;
+    int iFirstBin = iFrom >> m_iBaseLevel;
+    int iLastBin = (iTo - 1) >> m_iBaseLevel;
+
+    for(int b = iFirstBin; b <= iLastBin; ++b) {
+        int iStart = b * iBinSize;
+        int iLength = qMin(iBinSize, m_iNumberSamples - iStart);
+
+        if(iRow < 0) {
+            m_qVecMin[0].col(b) = pMatData->block(0, iStart, m_iNumberChannels, iLength).rowwise().minCoeff();
+            m_qVecMax[0].col(b) = pMatData->block(0, iStart, m_iNumberChannels, iLength).rowwise().maxCoeff();
+        } else {
+            Map<const RowVectorXd> rowSegment(pRowData + iStart, iLength);
+            m_qVecMin[0](iRow, b) = rowSegment.minCoeff();
+            m_qVecMax[0](iRow, b) = rowSegment.maxCoeff();
+        }
+    }
+
+    //Coarser levels are merged from their two child bins
+    for(int l = 1; l < m_qVecMin.size(); ++l) {
+        iFirstBin >>= 1;
+        iLastBin >>= 1;
+
+        int iNumberChildBins = m_qVecMin.at(l-1).cols();
+
+        for(int b = iFirstBin; b <= iLastBin; ++b) {
+            int iChild = 2 * b;
+
+            if(iRow < 0) {
+                if(iChild + 1 < iNumberChildBins) {
+                    m_qVecMin[l].col(b) = m_qVecMin.at(l-1).col(iChild).cwiseMin(m_qVecMin.at(l-1).col(iChild+1));
+                    m_qVecMax[l].col(b) = m_qVecMax.at(l-1).col(iChild).cwiseMax(m_qVecMax.at(l-1).col(iChild+1));
+                } else {
+                    m_qVecMin[l].col(b) = m_qVecMin.at(l-1).col(iChild);
+                    m_qVecMax[l].col(b) = m_qVecMax.at(l-1).col(iChild);
+                }
+            } else {
+                if(iChild + 1 < iNumberChildBins) {
+                    m_qVecMin[l](iRow, b) = qMin(m_qVecMin.at(l-1).coeff(iRow, iChild), m_qVecMin.at(l-1).coeff(iRow, iChild+1));
+                    m_qVecMax[l](iRow, b) = qMax(m_qVecMax.at(l-1).coeff(iRow, iChild), m_qVecMax.at(l-1).coeff(iRow, iChild+1));
+                } else {
+                    m_qVecMin[l](iRow, b) = m_qVecMin.at(l-1).coeff(iRow, iChild);
+                    m_qVecMax[l](iRow, b) = m_qVecMax.at(l-1).coeff(iRow, iChild);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,248 @@
+//=============================================================================================================
+/**
+* @file     minmaxpyramid.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the MinMaxPyramid Class.
+*
+*/
+
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISPLIB
+//=============================================================================================================
+
+namespace DISPLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DISPLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS MinMaxPyramid
+*
+* @brief The MinMaxPyramid class holds a multi-resolution min/max decimation of a multi channel data matrix.
+*        Level l stores the minimum and maximum of all bins with 2^(base+l) samples. Any sample range can then be
+*        reduced to its min/max (first and last value are read from the data directly) in O(log(n)) steps, which
+*        keeps the cost of painting a trace independent of the sampling rate.
+*/
+class DISPSHARED_EXPORT MinMaxPyramid
+{
+public:
+    typedef QSharedPointer<MinMaxPyramid> SPtr;              /**< Shared pointer type for MinMaxPyramid. */
+    typedef QSharedPointer<const MinMaxPyramid> ConstSPtr;   /**< Const shared pointer type for MinMaxPyramid. */
+
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> MatrixXdR;
+
+    //=========================================================================================================
+    /**
+    * Constructs a MinMaxPyramid.
+    *
+    * @param[in] iBaseLevel     The bin size of the finest stored level is 2^iBaseLevel samples. Ranges below this size are read from the data directly.
+    */
+    explicit MinMaxPyramid(int iBaseLevel = 3);
+
+    //=========================================================================================================
+    /**
+    * Resizes the pyramid to the given data dimensions. All levels are set to zero, which matches zero data.
+    *
+    * @param[in] iNumberChannels    The number of channels (rows).
+    * @param[in] iNumberSamples     The number of samples (columns).
+    */
+    void resize(int iNumberChannels, int iNumberSamples);
+
+    //=========================================================================================================
+    /**
+    * Sets all levels to zero. Call this whenever the underlying data was set to zero.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Rebuilds the pyramid from scratch. Resizes the pyramid if the dimensions do not match.
+    *
+    * @param[in] matData    The data matrix (channels x samples).
+    */
+    void build(const MatrixXdR& matData);
+
+    //=========================================================================================================
+    /**
+    * Updates all bins which overlap the sample range [iFrom, iTo). Only the touched bins of each level are
+    * recomputed, so the cost is proportional to the number of changed samples.
+    *
+    * @param[in] matData    The data matrix (channels x samples) which was changed.
+    * @param[in] iFrom      The first changed sample.
+    * @param[in] iTo        One past the last changed sample.
+    */
+    void update(const MatrixXdR& matData, int iFrom, int iTo);
+
+    //=========================================================================================================
+    /**
+    * Updates all bins of a single channel which overlap the sample range [iFrom, iTo).
+    *
+    * @param[in] pRowData   Pointer to the first sample of the changed channel.
+    * @param[in] iRow       The channel (row) index.
+    * @param[in] iFrom      The first changed sample.
+    * @param[in] iTo        One past the last changed sample.
+    */
+    void updateRow(const double* pRowData, int iRow, int iFrom, int iTo);
+
+    //=========================================================================================================
+    /**
+    * Returns the minimum and maximum of a channel in the sample range [iFrom, iTo).
+    *
+    * @param[in] pRowData   Pointer to the first sample of the channel. Used for the unaligned edges of the range.
+    * @param[in] iRow       The channel (row) index.
+    * @param[in] iFrom      The first sample of the range.
+    * @param[in] iTo        One past the last sample of the range.
+    * @param[out] dMin      The minimum value of the range.
+    * @param[out] dMax      The maximum value of the range.
+    *
+    * @return false if the range is empty, true otherwise.
+    */
+    bool range(const double* pRowData, int iRow, int iFrom, int iTo, double& dMin, double& dMax) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of channels the pyramid was built for.
+    *
+    * @return the number of channels.
+    */
+    inline int numberChannels() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples the pyramid was built for.
+    *
+    * @return the number of samples.
+    */
+    inline int numberSamples() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the pyramid matches the given data dimensions.
+    *
+    * @param[in] iNumberChannels    The number of channels (rows).
+    * @param[in] iNumberSamples     The number of samples (columns).
+    *
+    * @return true if the dimensions match.
+    */
+    inline bool matches(int iNumberChannels, int iNumberSamples) const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Recomputes the bins [iFirstBin, iLastBin] of level 0 and propagates the change to all coarser levels.
+    *
+    * @param[in] matData    The data matrix (channels x samples).
+    * @param[in] iRow       The channel to update. -1 updates all channels.
+    * @param[in] pRowData   Pointer to the row data in case a single channel is updated.
+    * @param[in] iFrom      The first changed sample.
+    * @param[in] iTo        One past the last changed sample.
+    */
+    void updateBins(const MatrixXdR* pMatData, int iRow, const double* pRowData, int iFrom, int iTo);
+
+    int                     m_iBaseLevel;           /**< The bin size of level 0 is 2^m_iBaseLevel samples. */
+    int                     m_iNumberChannels;      /**< The number of channels. */
+    int                     m_iNumberSamples;       /**< The number of samples. */
+
+    QVector<MatrixXdR>      m_qVecMin;              /**< The bin minima for each level (channels x bins). */
+    QVector<MatrixXdR>      m_qVecMax;              /**< The bin maxima for each level (channels x bins). */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int MinMaxPyramid::numberChannels() const
+{
+    return m_iNumberChannels;
+}
+
+
+//*************************************************************************************************************
+
+inline int MinMaxPyramid::numberSamples() const
+{
+    return m_iNumberSamples;
+}
+
+
+//*************************************************************************************************************
+
+inline bool MinMaxPyramid::matches(int iNumberChannels, int iNumberSamples) const
+{
+    return m_iNumberChannels == iNumberChannels && m_iNumberSamples == iNumberSamples;
+}
+
+} // NAMESPACE DISPLIB
+
+#endif // MINMAXPYRAMID_H
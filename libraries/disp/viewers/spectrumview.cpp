@@ -152,6 +152,16 @@ void SpectrumView::setBoundaries(int iLower,
 }
 
 
+//*************************************************************************************************************
+
+void SpectrumView::setTimeConstant(double dTimeConstant)
+{
+    if(m_pFSModel) {
+        m_pFSModel->setTimeConstant(dTimeConstant);
+    }
+}
+
+
 //*************************************************************************************************************
 
 bool SpectrumView::eventFilter(QObject * watched,
@@ -142,6 +142,14 @@ public:
     void setBoundaries(int iLower,
                        int iUpper);
 
+    //=========================================================================================================
+    /**
+    * Sets the time constant of the moving average the incoming spectra are smoothed with.
+    *
+    * @param [in] dTimeConstant     The time constant in seconds. Values <= 0 disable the averaging.
+    */
+    void setTimeConstant(double dTimeConstant);
+
     //=========================================================================================================
     /**
     * The event filter
@@ -132,7 +132,9 @@ SOURCES += \
     engine/view/customframegraph.cpp \
     engine/model/materials/gpuinterpolationmaterial.cpp \
     engine/model/materials/abstractphongalphamaterial.cpp \
-    engine/view/orbitalcameracontroller.cpp
+    engine/view/orbitalcameracontroller.cpp \
+    engine/view/sourcemovieexporter.cpp \
+    helpers/offscreen/softwarerasterizer.cpp
 
 HEADERS += \
     engine/view/view3D.h \
@@ -188,7 +190,9 @@ HEADERS += \
     engine/view/customframegraph.h \
     engine/model/materials/gpuinterpolationmaterial.h \
     engine/model/materials/abstractphongalphamaterial.h \
-    engine/view/orbitalcameracontroller.h
+    engine/view/orbitalcameracontroller.h \
+    engine/view/sourcemovieexporter.h \
+    helpers/offscreen/softwarerasterizer.h
 
 FORMS += \
     viewers/formfiles/hpiview.ui \
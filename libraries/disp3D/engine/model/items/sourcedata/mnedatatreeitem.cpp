@@ -327,12 +327,6 @@ void MneDataTreeItem::initData(const MNEForwardSolution& tForwardSolution,
 
         m_pRtSourceDataController->setStreamSmoothedData(false);
 
-        connect(m_pRtSourceDataController.data(), &RtSourceDataController::newInterpolationMatrixLeftAvailable,
-                        this, &MneDataTreeItem::onNewInterpolationMatrixLeftAvailable);
-
-        connect(m_pRtSourceDataController.data(), &RtSourceDataController::newInterpolationMatrixRightAvailable,
-                        this, &MneDataTreeItem::onNewInterpolationMatrixRightAvailable);
-
         connect(m_pRtSourceDataController.data(), &RtSourceDataController::newRtRawDataAvailable,
                 this, &MneDataTreeItem::onNewRtRawData);
     } else {
@@ -394,6 +388,17 @@ void MneDataTreeItem::initData(const MNEForwardSolution& tForwardSolution,
                 this, &MneDataTreeItem::onNewRtSmoothedDataAvailable);
     }
 
+    //Keep track of the interpolation matrices in both modes, they are also needed for offscreen rendering
+    connect(m_pRtSourceDataController.data(), &RtSourceDataController::newInterpolationMatrixLeftAvailable,
+            this, &MneDataTreeItem::onNewInterpolationMatrixLeftAvailable,
+            Qt::UniqueConnection);
+
+    connect(m_pRtSourceDataController.data(), &RtSourceDataController::newInterpolationMatrixRightAvailable,
+            this, &MneDataTreeItem::onNewInterpolationMatrixRightAvailable,
+            Qt::UniqueConnection);
+
+    m_pSurfSet = QSharedPointer<FSLIB::SurfaceSet>::create(tSurfSet);
+
     m_pRtSourceDataController->setInterpolationInfo(tForwardSolution.src[0].rr,
                                                     tForwardSolution.src[1].rr,
                                                     tForwardSolution.src[0].neighbor_vert,
@@ -656,6 +661,8 @@ void MneDataTreeItem::onNewRtSmoothedDataAvailable(const Eigen::MatrixX3f &matCo
 void MneDataTreeItem::onNewInterpolationMatrixLeftAvailable(QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrixLeftHemi)
 {
     //qDebug()<<"MneDataTreeItem::onNewInterpolationMatrixLeftAvailable";
+    m_pMatInterpolationMatrixLeft = pMatInterpolationMatrixLeftHemi;
+
     if(m_pInterpolationItemLeftGPU) {
         m_pInterpolationItemLeftGPU->setInterpolationMatrix(pMatInterpolationMatrixLeftHemi);
     }
@@ -667,6 +674,8 @@ void MneDataTreeItem::onNewInterpolationMatrixLeftAvailable(QSharedPointer<Eigen
 void MneDataTreeItem::onNewInterpolationMatrixRightAvailable(QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrixRightHemi)
 {
     //qDebug()<<"MneDataTreeItem::onNewInterpolationMatrixRightAvailable";
+    m_pMatInterpolationMatrixRight = pMatInterpolationMatrixRightHemi;
+
     if(m_pInterpolationItemRightGPU) {
         m_pInterpolationItemRightGPU->setInterpolationMatrix(pMatInterpolationMatrixRightHemi);
     }
@@ -251,6 +251,30 @@ public:
     */
     void setAlpha(float fAlpha);
 
+    //=========================================================================================================
+    /**
+    * Returns the surfaces which were passed to initData(...).
+    *
+    * @return                   The surface set holding the left and right hemisphere surfaces. Null if not initialized.
+    */
+    inline QSharedPointer<FSLIB::SurfaceSet> getSurfaceSet() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the most recent interpolation matrix of the left hemisphere.
+    *
+    * @return                   The interpolation matrix. Null if it was not calculated yet.
+    */
+    inline QSharedPointer<Eigen::SparseMatrix<float> > getInterpolationMatrixLeft() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the most recent interpolation matrix of the right hemisphere.
+    *
+    * @return                   The interpolation matrix. Null if it was not calculated yet.
+    */
+    inline QSharedPointer<Eigen::SparseMatrix<float> > getInterpolationMatrixRight() const;
+
 protected:
     //=========================================================================================================
     /**
@@ -376,6 +400,10 @@ protected:
     QPointer<AbstractMeshTreeItem>      m_pInterpolationItemRightCPU;       /**< This item manages all 3d rendering and calculations for the right hemisphere. */
     QPointer<GpuInterpolationItem>      m_pInterpolationItemRightGPU;       /**< This item manages all 3d rendering and calculations for the right hemisphere. */
 
+    QSharedPointer<FSLIB::SurfaceSet>               m_pSurfSet;                     /**< The surfaces of both hemispheres. */
+    QSharedPointer<Eigen::SparseMatrix<float> >     m_pMatInterpolationMatrixLeft;  /**< The current interpolation matrix of the left hemisphere. */
+    QSharedPointer<Eigen::SparseMatrix<float> >     m_pMatInterpolationMatrixRight; /**< The current interpolation matrix of the right hemisphere. */
+
 signals:
 
 };
@@ -390,6 +418,30 @@ inline bool MneDataTreeItem::isDataInit() const
     return m_bIsDataInit;
 }
 
+
+//*************************************************************************************************************
+
+inline QSharedPointer<FSLIB::SurfaceSet> MneDataTreeItem::getSurfaceSet() const
+{
+    return m_pSurfSet;
+}
+
+
+//*************************************************************************************************************
+
+inline QSharedPointer<Eigen::SparseMatrix<float> > MneDataTreeItem::getInterpolationMatrixLeft() const
+{
+    return m_pMatInterpolationMatrixLeft;
+}
+
+
+//*************************************************************************************************************
+
+inline QSharedPointer<Eigen::SparseMatrix<float> > MneDataTreeItem::getInterpolationMatrixRight() const
+{
+    return m_pMatInterpolationMatrixRight;
+}
+
 } //NAMESPACE DISP3DLIB
 
 #endif // DISP3DLIB_MNEESTIMATTREEITEM_H
@@ -72,6 +72,14 @@ using namespace DISPLIB;
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTSENSORDATA_FRAME_BLOCK_SIZE 8
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -84,9 +92,13 @@ RtSensorDataWorker::RtSensorDataWorker()
 , m_bStreamSmoothedData(true)
 , m_iCurrentSample(0)
 , m_iSampleCtr(0)
+, m_iTickCtr(0)
+, m_iCurrentFrame(0)
+, m_iColorFrameOffset(0)
+, m_bColorFramesDirty(true)
 , m_pMatInterpolationMatrix(QSharedPointer<SparseMatrix<float> >(new SparseMatrix<float>()))
 {
-    m_lVisualizationInfo.functionHandlerColorMap = ColorMap::valueToHot;
+    m_lVisualizationInfo.colorMapLut.setColorMap(ColorMap::valueToHot);
 }
 
 
@@ -119,6 +131,7 @@ void RtSensorDataWorker::setNumberVertices(int iNumberVerts)
 {
     m_lVisualizationInfo.matOriginalVertColor.resize(iNumberVerts,3);
     m_lVisualizationInfo.matOriginalVertColor.setZero();
+    m_bColorFramesDirty = true;
 }
 
 
@@ -135,6 +148,7 @@ void RtSensorDataWorker::setNumberAverages(int iNumAvr)
 void RtSensorDataWorker::setStreamSmoothedData(bool bStreamSmoothedData)
 {
     m_bStreamSmoothedData = bStreamSmoothedData;
+    m_bColorFramesDirty = true;
 }
 
 
@@ -142,16 +156,10 @@ void RtSensorDataWorker::setStreamSmoothedData(bool bStreamSmoothedData)
 
 void RtSensorDataWorker::setColormapType(const QString& sColormapType)
 {
-    //Create function handler to corresponding color map function
-    if(sColormapType == "Hot Negative 1") {
-        m_lVisualizationInfo.functionHandlerColorMap = ColorMap::valueToHotNegative1;
-    } else if(sColormapType == "Hot") {
-        m_lVisualizationInfo.functionHandlerColorMap = ColorMap::valueToHot;
-    } else if(sColormapType == "Hot Negative 2") {
-        m_lVisualizationInfo.functionHandlerColorMap = ColorMap::valueToHotNegative2;
-    } else if(sColormapType == "Jet") {
-        m_lVisualizationInfo.functionHandlerColorMap = ColorMap::valueToJet;
-    }
+    //Resample the lookup table with the corresponding color map function
+    m_lVisualizationInfo.colorMapLut.setColorMap(sColormapType);
+
+    m_bColorFramesDirty = true;
 }
 
 
@@ -161,6 +169,7 @@ void RtSensorDataWorker::setThresholds(const QVector3D& vecThresholds)
 {
     m_lVisualizationInfo.dThresholdX = vecThresholds.x();
     m_lVisualizationInfo.dThresholdZ = vecThresholds.z();
+    m_bColorFramesDirty = true;
 }
 
 
@@ -184,6 +193,7 @@ void RtSensorDataWorker::setSFreq(const double dSFreq)
 
 void RtSensorDataWorker::setInterpolationMatrix(QSharedPointer<SparseMatrix<float> > pMatInterpolationMatrix) {
     m_pMatInterpolationMatrix = pMatInterpolationMatrix;
+    m_bColorFramesDirty = true;
 }
 
 
@@ -191,81 +201,132 @@ void RtSensorDataWorker::setInterpolationMatrix(QSharedPointer<SparseMatrix<floa
 
 void RtSensorDataWorker::streamData()
 {
-    if(m_lDataQ.isEmpty()) {
-        if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
-            if(m_vecAverage.rows() != m_lDataLoopQ.front().rows()) {
-                m_vecAverage = m_lDataLoopQ.front();
-            } else if (m_iCurrentSample < m_lDataLoopQ.size()){
-                m_vecAverage += m_lDataLoopQ.at(m_iCurrentSample);
-            }
-
-            //Set iterator back to the front if needed
-            if(m_iCurrentSample == m_lDataLoopQ.size()) {
-                m_iCurrentSample = 0;
-            }
-        } else {
-            return;
+    if(m_iCurrentFrame >= m_matFrameBlock.cols() && !prepareFrames()) {
+        return;
+    }
+
+    //Every frame averages m_iAverageSamples samples, hence one frame is streamed per m_iAverageSamples calls
+    if(++m_iTickCtr < m_iAverageSamples) {
+        return;
+    }
+    m_iTickCtr = 0;
+
+    if(m_bStreamSmoothedData) {
+        if(m_bColorFramesDirty) {
+            generateColorsFromSensorValues();
         }
+        emit newRtSmoothedData(m_vecColorFrames.at(m_iCurrentFrame - m_iColorFrameOffset));
     } else {
-        if(m_vecAverage.rows() != m_lDataQ.front().rows()) {
-            m_vecAverage = m_lDataQ.takeFirst();
-        } else {
-            m_vecAverage += m_lDataQ.takeFirst();
-        }
+        emit newRtRawData(m_matFrameBlock.col(m_iCurrentFrame));
+    }
 
+    m_iCurrentFrame++;
+
+    //qDebug()<<"RtSensorDataWorker::streamData - this->thread() "<< this->thread();
+    //qDebug()<<"RtSensorDataWorker::streamData - m_lDataQ.size()"<<m_lDataQ.size();
+}
+
+
+//*************************************************************************************************************
+
+bool RtSensorDataWorker::takeSample(VectorXd& vecSample)
+{
+    if(!m_lDataQ.isEmpty()) {
+        vecSample = m_lDataQ.takeFirst();
+        return true;
+    }
+
+    if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
         //Set iterator back to the front if needed
-        if(m_iCurrentSample == m_lDataQ.size()) {
+        if(m_iCurrentSample >= m_lDataLoopQ.size()) {
             m_iCurrentSample = 0;
         }
+        vecSample = m_lDataLoopQ.at(m_iCurrentSample++);
+        return true;
     }
 
-    m_iCurrentSample++;
-    m_iSampleCtr++;
+    return false;
+}
+
 
-    if(m_iSampleCtr % m_iAverageSamples == 0
-        && m_iAverageSamples != 0) {
-        //Perform the actual interpolation and send signal
-        m_vecAverage /= (double)m_iAverageSamples;
-        if(m_bStreamSmoothedData) {
-            emit newRtSmoothedData(generateColorsFromSensorValues(m_vecAverage));
+//*************************************************************************************************************
+
+bool RtSensorDataWorker::prepareFrames()
+{
+    if(m_iAverageSamples <= 0) {
+        return false;
+    }
+
+    QList<VectorXd> lFrames;
+    VectorXd vecSample;
+
+    while(lFrames.size() < RTSENSORDATA_FRAME_BLOCK_SIZE && takeSample(vecSample)) {
+        if(m_vecAverage.rows() != vecSample.rows()) {
+            //The number of channels changed, start over
+            lFrames.clear();
+            m_vecAverage = vecSample;
+            m_iSampleCtr = 1;
         } else {
-            emit newRtRawData(m_vecAverage);
+            m_vecAverage += vecSample;
+            m_iSampleCtr++;
         }
-        m_vecAverage.setZero(m_vecAverage.rows());
 
-        //reset sample counter
-        m_iSampleCtr = 0;
+        if(m_iSampleCtr >= m_iAverageSamples) {
+            lFrames.append(m_vecAverage / (double)m_iAverageSamples);
+            m_vecAverage.setZero(m_vecAverage.rows());
+            m_iSampleCtr = 0;
+        }
     }
 
-    //qDebug()<<"RtSensorDataWorker::streamData - this->thread() "<< this->thread();
-    //qDebug()<<"RtSensorDataWorker::streamData - m_lDataQ.size()"<<m_lDataQ.size();
+    if(lFrames.isEmpty()) {
+        return false;
+    }
+
+    m_matFrameBlock.resize(lFrames.first().rows(), lFrames.size());
+    for(int i = 0; i < lFrames.size(); ++i) {
+        m_matFrameBlock.col(i) = lFrames.at(i);
+    }
+
+    m_iCurrentFrame = 0;
+    m_bColorFramesDirty = true;
+
+    return true;
 }
 
 
 //*************************************************************************************************************
 
-MatrixX3f RtSensorDataWorker::generateColorsFromSensorValues(const VectorXd& vecSensorValues)
+void RtSensorDataWorker::generateColorsFromSensorValues()
 {
-    if(vecSensorValues.rows() != m_pMatInterpolationMatrix->cols()) {
-        qDebug() << "RtSensorDataWorker::generateColorsFromSensorValues - Number of new vertex colors (" << vecSensorValues.rows() << ") do not match with previously set number of sensors (" << m_pMatInterpolationMatrix->cols() << "). Returning...";
-        MatrixX3f matColor = m_lVisualizationInfo.matOriginalVertColor;
-        return matColor;
+    //Only the frames which were not streamed yet need colors
+    const int iNumberFrames = m_matFrameBlock.cols() - m_iCurrentFrame;
+    m_iColorFrameOffset = m_iCurrentFrame;
+    m_vecColorFrames.resize(iNumberFrames);
+    m_bColorFramesDirty = false;
+
+    if(m_matFrameBlock.rows() != m_pMatInterpolationMatrix->cols()) {
+        qDebug() << "RtSensorDataWorker::generateColorsFromSensorValues - Number of new vertex colors (" << m_matFrameBlock.rows() << ") do not match with previously set number of sensors (" << m_pMatInterpolationMatrix->cols() << "). Returning...";
+        for(int i = 0; i < iNumberFrames; ++i) {
+            m_vecColorFrames[i] = m_lVisualizationInfo.matOriginalVertColor;
+        }
+        return;
     }
 
-    // interpolate sensor signals
-    VectorXf vecIntrpltdVals = Interpolation::interpolateSignal(*m_pMatInterpolationMatrix, vecSensorValues.cast<float>());
+    // interpolate the sensor signals of all frames at once
+    MatrixXf matIntrpltdVals = Interpolation::interpolateSignals(*m_pMatInterpolationMatrix,
+                                                                 m_matFrameBlock.rightCols(iNumberFrames).cast<float>());
 
-    // Reset to original color as default
-    m_lVisualizationInfo.matFinalVertColor = m_lVisualizationInfo.matOriginalVertColor;
+    for(int i = 0; i < iNumberFrames; ++i) {
+        // Reset to original color as default
+        m_vecColorFrames[i] = m_lVisualizationInfo.matOriginalVertColor;
 
-    //Generate color data for vertices
-    normalizeAndTransformToColor(vecIntrpltdVals,
-                                    m_lVisualizationInfo.matFinalVertColor,
-                                    m_lVisualizationInfo.dThresholdX,
-                                    m_lVisualizationInfo.dThresholdZ,
-                                    m_lVisualizationInfo.functionHandlerColorMap);
-
-    return m_lVisualizationInfo.matFinalVertColor;
+        //Generate color data for vertices
+        normalizeAndTransformToColor(matIntrpltdVals.col(i),
+                                     m_vecColorFrames[i],
+                                     m_lVisualizationInfo.dThresholdX,
+                                     m_lVisualizationInfo.dThresholdZ,
+                                     m_lVisualizationInfo.colorMapLut);
+    }
 }
 
 
@@ -275,7 +336,7 @@ void RtSensorDataWorker::normalizeAndTransformToColor(const VectorXf& vecData,
                                                       MatrixX3f& matFinalVertColor,
                                                       double dThresholdX,
                                                       double dThreholdZ,
-                                                      QRgb (*functionHandlerColorMap)(double v))
+                                                      const ColorMapLut& colorMapLut)
 {
     //Note: This function needs to be implemented extremly efficient.
     if(vecData.rows() != matFinalVertColor.rows()) {
@@ -283,33 +344,6 @@ void RtSensorDataWorker::normalizeAndTransformToColor(const VectorXf& vecData,
         return;
     }
 
-    float fSample;
-    QRgb qRgb;
-    const double dTresholdDiff = dThreholdZ - dThresholdX;
-
-    for(int r = 0; r < vecData.rows(); ++r) {
-        //Take the absolute values because the histogram threshold is also calcualted using the absolute values
-        fSample = std::fabs(vecData(r));
-
-        if(fSample >= dThresholdX) {
-            //Check lower and upper thresholds and normalize to one
-            if(fSample >= dThreholdZ) {
-                fSample = 1.0f;
-            } else {
-                if(fSample != 0.0f && dTresholdDiff != 0.0 ) {
-                    fSample = (fSample - dThresholdX) / (dTresholdDiff);
-                } else {
-                    fSample = 0.0f;
-                }
-            }
-
-            qRgb = functionHandlerColorMap(fSample);
-
-            matFinalVertColor(r,0) = (float)qRed(qRgb)/255.0f;
-            matFinalVertColor(r,1) = (float)qGreen(qRgb)/255.0f;
-            matFinalVertColor(r,2) = (float)qBlue(qRgb)/255.0f;
-        }
-    }
+    //Values below the lower threshold keep their original color
+    colorMapLut.mapThresholded(vecData, matFinalVertColor, dThresholdX, dThreholdZ);
 }
-
-//*************************************************************************************************************
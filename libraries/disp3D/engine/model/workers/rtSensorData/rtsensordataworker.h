@@ -44,6 +44,7 @@
 //=============================================================================================================
 
 #include "../../../../disp3D_global.h"
+#include <disp/plots/helpers/colormaplut.h>
 
 
 //*************************************************************************************************************
@@ -54,6 +55,7 @@
 #include <QRgb>
 #include <QSharedPointer>
 #include <QLinkedList>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -192,29 +194,44 @@ public:
 protected:
     //=========================================================================================================
     /**
-    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to rgb using the specified color converter
+    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to rgb using the specified color lookup table
     *
     * @param[in] vecData                       The final values for each vertex of the surface
     * @param[in,out] matFinalVertColor         The color matrix which the results are to be written to
     * @param[in] dThresholdX                   Lower threshold for normalizing
     * @param[in] dThreholdZ                    Upper threshold for normalizing
-    * @param[in] functionHandlerColorMap       The pointer to the function which converts scalar values to rgb
+    * @param[in] colorMapLut                   The lookup table which converts normalized values to rgb
     */
     void normalizeAndTransformToColor(const Eigen::VectorXf& vecData,
                                       Eigen::MatrixX3f& matFinalVertColor,
                                       double dThresholdX,
                                       double dThreholdZ,
-                                      QRgb (*functionHandlerColorMap)(double v));
+                                      const DISPLIB::ColorMapLut& colorMapLut);
 
     //=========================================================================================================
     /**
-    * @brief generateColorsFromSensorValues        Produces the final color matrix that is to be emitted
+    * @brief generateColorsFromSensorValues        Produces the color matrices of all frames in m_matFrameBlock which were not streamed yet.
+    *                                              The frames are interpolated with a single sparse x dense product.
+    */
+    void generateColorsFromSensorValues();
+
+    //=========================================================================================================
+    /**
+    * @brief prepareFrames                  Averages the next block of samples into m_matFrameBlock.
+    *
+    * @return                               True if at least one frame is ready to be streamed.
+    */
+    bool prepareFrames();
+
+    //=========================================================================================================
+    /**
+    * @brief takeSample                     Takes the next sample from the data queue, or from the loop queue if looping is on.
     *
-    * @param[in] vecSensorValues                   A vector of sensor signals
+    * @param[out] vecSample                 The sample.
     *
-    * @return The final color values for the underlying mesh surface
+    * @return                               True if a sample was available.
     */
-    Eigen::MatrixX3f generateColorsFromSensorValues(const Eigen::VectorXd& vecSensorValues);
+    bool takeSample(Eigen::VectorXd& vecSample);
 
     QList<Eigen::VectorXd>                              m_lDataQ;                           /**< List that holds the fiff matrix data <n_channels x n_samples>. */
     QList<Eigen::VectorXd>                              m_lDataLoopQ;                       /**< List that holds the matrix data <n_channels x n_samples> for looping. */
@@ -228,6 +245,13 @@ protected:
     int                                                 m_iCurrentSample;                   /**< Iterator to current sample which is/was streamed. */
     int                                                 m_iAverageSamples;                  /**< Number of average to compute. */
     int                                                 m_iSampleCtr;                       /**< The sample counter. */
+    int                                                 m_iTickCtr;                         /**< Counts the streamData calls since the last emitted frame. */
+    int                                                 m_iCurrentFrame;                    /**< The next column of m_matFrameBlock to be streamed. */
+    int                                                 m_iColorFrameOffset;                /**< The column of m_matFrameBlock which corresponds to the first entry of m_vecColorFrames. */
+    bool                                                m_bColorFramesDirty;                /**< Whether m_vecColorFrames needs to be recomputed, e.g. after the thresholds changed. */
+
+    Eigen::MatrixXd                                     m_matFrameBlock;                    /**< Averaged frames which are ready to be streamed <n_channels x n_frames>. */
+    QVector<Eigen::MatrixX3f>                           m_vecColorFrames;                   /**< The precomputed vertex colors of the frames in m_matFrameBlock. */
 
     double                                              m_dSFreq;                           /**< The current sampling frequency. */
 
@@ -242,7 +266,7 @@ protected:
         Eigen::MatrixX3f            matOriginalVertColor;
         Eigen::MatrixX3f            matFinalVertColor;
 
-        QRgb (*functionHandlerColorMap)(double v);
+        DISPLIB::ColorMapLut        colorMapLut;
     } m_lVisualizationInfo;               /**< Container for the visualization info. */
 
 
@@ -74,6 +74,14 @@ using namespace DISPLIB;
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTSOURCEDATA_FRAME_BLOCK_SIZE 8
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -86,11 +94,15 @@ RtSourceDataWorker::RtSourceDataWorker()
 , m_bStreamSmoothedData(true)
 , m_iCurrentSample(0)
 , m_iSampleCtr(0)
+, m_iTickCtr(0)
+, m_iCurrentFrame(0)
+, m_iColorFrameOffset(0)
+, m_bColorFramesDirty(true)
 {
     VisualizationInfo leftHemiInfo;
     VisualizationInfo rightHemiInfo;
-    leftHemiInfo.functionHandlerColorMap = ColorMap::valueToHot;
-    rightHemiInfo.functionHandlerColorMap = ColorMap::valueToHot;
+    leftHemiInfo.colorMapLut.setColorMap(ColorMap::valueToHot);
+    rightHemiInfo.colorMapLut.setColorMap(ColorMap::valueToHot);
     leftHemiInfo.pMatInterpolationMatrix = QSharedPointer<SparseMatrix<float> >(new SparseMatrix<float>());
     rightHemiInfo.pMatInterpolationMatrix = QSharedPointer<SparseMatrix<float> >(new SparseMatrix<float>());
     m_lHemiVisualizationInfo << leftHemiInfo << rightHemiInfo;
@@ -127,6 +139,7 @@ void RtSourceDataWorker::setNumberVertices(int iNumberVertsLeft,
 {
     m_lHemiVisualizationInfo[0].matOriginalVertColor.setZero(iNumberVertsLeft,3);
     m_lHemiVisualizationInfo[1].matOriginalVertColor.setZero(iNumberVertsRight,3);
+    m_bColorFramesDirty = true;
 }
 
 
@@ -143,6 +156,7 @@ void RtSourceDataWorker::setNumberAverages(int iNumAvr)
 void RtSourceDataWorker::setStreamSmoothedData(bool bStreamSmoothedData)
 {
     m_bStreamSmoothedData = bStreamSmoothedData;
+    m_bColorFramesDirty = true;
 }
 
 
@@ -150,19 +164,13 @@ void RtSourceDataWorker::setStreamSmoothedData(bool bStreamSmoothedData)
 
 void RtSourceDataWorker::setColormapType(const QString& sColormapType)
 {
-    //Create function handler to corresponding color map function
-    if(sColormapType == QStringLiteral("Hot Negative 1")) {
-        m_lHemiVisualizationInfo[0].functionHandlerColorMap = ColorMap::valueToHotNegative1;
-        m_lHemiVisualizationInfo[1].functionHandlerColorMap = ColorMap::valueToHotNegative1;
-    } else if(sColormapType == QStringLiteral("Hot")) {
-        m_lHemiVisualizationInfo[0].functionHandlerColorMap = ColorMap::valueToHot;
-        m_lHemiVisualizationInfo[1].functionHandlerColorMap = ColorMap::valueToHot;
-    } else if(sColormapType == QStringLiteral("Hot Negative 2")) {
-        m_lHemiVisualizationInfo[0].functionHandlerColorMap = ColorMap::valueToHotNegative2;
-        m_lHemiVisualizationInfo[1].functionHandlerColorMap = ColorMap::valueToHotNegative2;
-    } else if(sColormapType == QStringLiteral("Jet")) {
-        m_lHemiVisualizationInfo[0].functionHandlerColorMap = ColorMap::valueToJet;
-        m_lHemiVisualizationInfo[1].functionHandlerColorMap = ColorMap::valueToJet;
+    //Resample the lookup tables with the corresponding color map function
+    QRgb (*functionHandlerColorMap)(double v) = ColorMapLut::colorMapFunction(sColormapType);
+
+    if(functionHandlerColorMap) {
+        m_lHemiVisualizationInfo[0].colorMapLut.setColorMap(functionHandlerColorMap);
+        m_lHemiVisualizationInfo[1].colorMapLut.setColorMap(functionHandlerColorMap);
+        m_bColorFramesDirty = true;
     }
 }
 
@@ -175,6 +183,7 @@ void RtSourceDataWorker::setThresholds(const QVector3D& vecThresholds)
     m_lHemiVisualizationInfo[0].dThresholdZ = vecThresholds.z();
     m_lHemiVisualizationInfo[1].dThresholdX = vecThresholds.x();
     m_lHemiVisualizationInfo[1].dThresholdZ = vecThresholds.z();
+    m_bColorFramesDirty = true;
 }
 
 
@@ -199,6 +208,7 @@ void RtSourceDataWorker::setSFreq(const double dSFreq)
 void RtSourceDataWorker::setInterpolationMatrixLeft(QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrixLeft)
 {
     m_lHemiVisualizationInfo[0].pMatInterpolationMatrix = pMatInterpolationMatrixLeft;
+    m_bColorFramesDirty = true;
 }
 
 
@@ -207,7 +217,7 @@ void RtSourceDataWorker::setInterpolationMatrixLeft(QSharedPointer<Eigen::Sparse
 void RtSourceDataWorker::setInterpolationMatrixRight(QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrixRight)
 {
     m_lHemiVisualizationInfo[1].pMatInterpolationMatrix = pMatInterpolationMatrixRight;
-
+    m_bColorFramesDirty = true;
 }
 
 
@@ -217,66 +227,141 @@ void RtSourceDataWorker::streamData()
 {
     //QElapsedTimer time;
     //time.start();
-    if(m_lDataQ.isEmpty()) {
-        if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
-            if(m_vecAverage.rows() != m_lDataLoopQ.front().rows()) {
-                m_vecAverage = m_lDataLoopQ.front();
-            } else if (m_iCurrentSample < m_lDataLoopQ.size()){
-                m_vecAverage += m_lDataLoopQ.at(m_iCurrentSample);
-            }
-
-            //Set iterator back to the front if needed
-            if(m_iCurrentSample == m_lDataLoopQ.size()) {
-                m_iCurrentSample = 0;
-            }
-        } else {
-            return;
+    if(m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols() == 0
+       || m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols() == 0) {
+        return;
+    }
+
+    if(m_iCurrentFrame >= m_matFrameBlock.cols() && !prepareFrames()) {
+        return;
+    }
+
+    //Every frame averages m_iAverageSamples samples, hence one frame is streamed per m_iAverageSamples calls
+    if(++m_iTickCtr < m_iAverageSamples) {
+        return;
+    }
+    m_iTickCtr = 0;
+
+    const int iColsLeft = m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols();
+    const int iColsRight = m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols();
+
+    if(m_bStreamSmoothedData) {
+        if(m_bColorFramesDirty) {
+            generateColorFrames();
         }
-    } else {
-        if(m_vecAverage.rows() != m_lDataQ.front().rows()) {
-            m_vecAverage = m_lDataQ.takeFirst();
-        } else {
-            m_vecAverage += m_lDataQ.takeFirst();
+
+        const int iColorFrame = m_iCurrentFrame - m_iColorFrameOffset;
+
+        if(iColorFrame < m_lHemiVisualizationInfo[0].vecFinalVertColors.size()
+           && iColorFrame < m_lHemiVisualizationInfo[1].vecFinalVertColors.size()) {
+            emit newRtSmoothedData(m_lHemiVisualizationInfo[0].vecFinalVertColors.at(iColorFrame),
+                                   m_lHemiVisualizationInfo[1].vecFinalVertColors.at(iColorFrame));
         }
+    } else if(m_matFrameBlock.rows() >= iColsLeft + iColsRight) {
+        emit newRtRawData(m_matFrameBlock.col(m_iCurrentFrame).segment(0, iColsLeft),
+                          m_matFrameBlock.col(m_iCurrentFrame).segment(iColsLeft, iColsRight));
+    }
+
+    m_iCurrentFrame++;
+
+    //qDebug()<<"RtSourceDataWorker::streamData - this->thread() "<< this->thread();
+    //qDebug()<<"RtSourceDataWorker::streamData - time.elapsed()" << time.elapsed();
+}
+
 
+//*************************************************************************************************************
+
+bool RtSourceDataWorker::takeSample(VectorXd& vecSample)
+{
+    if(!m_lDataQ.isEmpty()) {
+        vecSample = m_lDataQ.takeFirst();
+        return true;
+    }
+
+    if(m_bIsLooping && !m_lDataLoopQ.isEmpty()) {
         //Set iterator back to the front if needed
-        if(m_iCurrentSample == m_lDataQ.size()) {
+        if(m_iCurrentSample >= m_lDataLoopQ.size()) {
             m_iCurrentSample = 0;
         }
+        vecSample = m_lDataLoopQ.at(m_iCurrentSample++);
+        return true;
+    }
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+bool RtSourceDataWorker::prepareFrames()
+{
+    if(m_iAverageSamples <= 0) {
+        return false;
     }
 
-    m_iCurrentSample++;
-    m_iSampleCtr++;
-
-    if(m_iSampleCtr % m_iAverageSamples == 0
-       && m_iAverageSamples != 0
-       && m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols() != 0
-       && m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols() != 0) {
-        //Perform the actual interpolation and send signal
-        m_vecAverage /= (double)m_iAverageSamples;
-        if(m_bStreamSmoothedData) {
-            m_lHemiVisualizationInfo[0].vecSensorValues = m_vecAverage.segment(0, m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols());
-            m_lHemiVisualizationInfo[1].vecSensorValues = m_vecAverage.segment(m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols(), m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols());
-
-            //Do calculations for both hemispheres in parallel
-            QFuture<void> result = QtConcurrent::map(m_lHemiVisualizationInfo,
-                                                     generateColorsFromSensorValues);
-            result.waitForFinished();
-
-            emit newRtSmoothedData(m_lHemiVisualizationInfo[0].matFinalVertColor,
-                                   m_lHemiVisualizationInfo[1].matFinalVertColor);
+    QList<VectorXd> lFrames;
+    VectorXd vecSample;
+
+    while(lFrames.size() < RTSOURCEDATA_FRAME_BLOCK_SIZE && takeSample(vecSample)) {
+        if(m_vecAverage.rows() != vecSample.rows()) {
+            //The number of sources changed, start over
+            lFrames.clear();
+            m_vecAverage = vecSample;
+            m_iSampleCtr = 1;
         } else {
-            emit newRtRawData(m_vecAverage.segment(0, m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols()),
-                              m_vecAverage.segment(m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols(), m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols()));
+            m_vecAverage += vecSample;
+            m_iSampleCtr++;
         }
-        m_vecAverage.setZero(m_vecAverage.rows());
 
-        //reset sample counter
-        m_iSampleCtr = 0;
+        if(m_iSampleCtr >= m_iAverageSamples) {
+            lFrames.append(m_vecAverage / (double)m_iAverageSamples);
+            m_vecAverage.setZero(m_vecAverage.rows());
+            m_iSampleCtr = 0;
+        }
     }
 
-    //qDebug()<<"RtSourceDataWorker::streamData - this->thread() "<< this->thread();
-    //qDebug()<<"RtSourceDataWorker::streamData - time.elapsed()" << time.elapsed();
+    if(lFrames.isEmpty()) {
+        return false;
+    }
+
+    m_matFrameBlock.resize(lFrames.first().rows(), lFrames.size());
+    for(int i = 0; i < lFrames.size(); ++i) {
+        m_matFrameBlock.col(i) = lFrames.at(i);
+    }
+
+    m_iCurrentFrame = 0;
+    m_bColorFramesDirty = true;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RtSourceDataWorker::generateColorFrames()
+{
+    //Only the frames which were not streamed yet need colors
+    const int iNumberFrames = m_matFrameBlock.cols() - m_iCurrentFrame;
+    const int iColsLeft = m_lHemiVisualizationInfo[0].pMatInterpolationMatrix->cols();
+    const int iColsRight = m_lHemiVisualizationInfo[1].pMatInterpolationMatrix->cols();
+
+    m_iColorFrameOffset = m_iCurrentFrame;
+    m_bColorFramesDirty = false;
+
+    if(m_matFrameBlock.rows() < iColsLeft + iColsRight) {
+        qDebug() << "RtSourceDataWorker::generateColorFrames - Number of sources (" << m_matFrameBlock.rows() << ") do not match with previously set interpolation matrices (" << iColsLeft + iColsRight << "). Returning...";
+        m_lHemiVisualizationInfo[0].vecFinalVertColors.clear();
+        m_lHemiVisualizationInfo[1].vecFinalVertColors.clear();
+        return;
+    }
+
+    m_lHemiVisualizationInfo[0].matSensorValues = m_matFrameBlock.block(0, m_iCurrentFrame, iColsLeft, iNumberFrames);
+    m_lHemiVisualizationInfo[1].matSensorValues = m_matFrameBlock.block(iColsLeft, m_iCurrentFrame, iColsRight, iNumberFrames);
+
+    //Do calculations for both hemispheres in parallel
+    QFuture<void> result = QtConcurrent::map(m_lHemiVisualizationInfo,
+                                             generateColorsFromSensorValues);
+    result.waitForFinished();
 }
 
 
@@ -284,23 +369,29 @@ void RtSourceDataWorker::streamData()
 
 void RtSourceDataWorker::generateColorsFromSensorValues(VisualizationInfo &visualizationInfoHemi)
 {
-    if(visualizationInfoHemi.vecSensorValues.rows() != visualizationInfoHemi.pMatInterpolationMatrix->cols()) {
-        qDebug() << "RtSourceDataWorker::generateColorsFromSensorValues - Number of new vertex colors (" << visualizationInfoHemi.vecSensorValues.rows() << ") do not match with previously set number of sensors (" << visualizationInfoHemi.pMatInterpolationMatrix->cols() << "). Returning...";
+    if(visualizationInfoHemi.matSensorValues.rows() != visualizationInfoHemi.pMatInterpolationMatrix->cols()) {
+        qDebug() << "RtSourceDataWorker::generateColorsFromSensorValues - Number of new vertex colors (" << visualizationInfoHemi.matSensorValues.rows() << ") do not match with previously set number of sensors (" << visualizationInfoHemi.pMatInterpolationMatrix->cols() << "). Returning...";
+        visualizationInfoHemi.vecFinalVertColors.clear();
         return;
     }
 
-    // interpolate sensor signals
-    VectorXf vecIntrpltdVals = Interpolation::interpolateSignal(*visualizationInfoHemi.pMatInterpolationMatrix, visualizationInfoHemi.vecSensorValues.cast<float>());
+    // interpolate the sensor signals of all frames at once
+    MatrixXf matIntrpltdVals = Interpolation::interpolateSignals(*visualizationInfoHemi.pMatInterpolationMatrix,
+                                                                 visualizationInfoHemi.matSensorValues.cast<float>());
 
-    // Reset to original color as default
-    visualizationInfoHemi.matFinalVertColor = visualizationInfoHemi.matOriginalVertColor;
+    visualizationInfoHemi.vecFinalVertColors.resize(matIntrpltdVals.cols());
 
-    //Generate color data for vertices
-    normalizeAndTransformToColor(vecIntrpltdVals,
-                                 visualizationInfoHemi.matFinalVertColor,
-                                 visualizationInfoHemi.dThresholdX,
-                                 visualizationInfoHemi.dThresholdZ,
-                                 visualizationInfoHemi.functionHandlerColorMap);
+    for(int i = 0; i < matIntrpltdVals.cols(); ++i) {
+        // Reset to original color as default
+        visualizationInfoHemi.vecFinalVertColors[i] = visualizationInfoHemi.matOriginalVertColor;
+
+        //Generate color data for vertices
+        normalizeAndTransformToColor(matIntrpltdVals.col(i),
+                                     visualizationInfoHemi.vecFinalVertColors[i],
+                                     visualizationInfoHemi.dThresholdX,
+                                     visualizationInfoHemi.dThresholdZ,
+                                     visualizationInfoHemi.colorMapLut);
+    }
 }
 
 
@@ -310,7 +401,7 @@ void RtSourceDataWorker::normalizeAndTransformToColor(const VectorXf& vecData,
                                                       MatrixX3f& matFinalVertColor,
                                                       double dThresholdX,
                                                       double dThresholdZ,
-                                                      QRgb (*functionHandlerColorMap)(double v))
+                                                      const ColorMapLut& colorMapLut)
 {
     //Note: This function needs to be implemented extremly efficient.
     if(vecData.rows() != matFinalVertColor.rows()) {
@@ -318,31 +409,6 @@ void RtSourceDataWorker::normalizeAndTransformToColor(const VectorXf& vecData,
         return;
     }
 
-    float fSample;
-    QRgb qRgb;
-    const double dTresholdDiff = dThresholdZ - dThresholdX;
-
-    for(int r = 0; r < vecData.rows(); ++r) {
-        //Take the absolute values because the histogram threshold is also calcualted using the absolute values
-        fSample = std::fabs(vecData(r));
-
-        if(fSample >= dThresholdX) {
-            //Check lower and upper thresholds and normalize to one
-            if(fSample >= dThresholdZ) {
-                fSample = 1.0f;
-            } else {
-                if(fSample != 0.0f && dTresholdDiff != 0.0 ) {
-                    fSample = (fSample - dThresholdX) / (dTresholdDiff);
-                } else {
-                    fSample = 0.0f;
-                }
-            }
-
-            qRgb = functionHandlerColorMap(fSample);
-
-            matFinalVertColor(r,0) = (float)qRed(qRgb)/255.0f;
-            matFinalVertColor(r,1) = (float)qGreen(qRgb)/255.0f;
-            matFinalVertColor(r,2) = (float)qBlue(qRgb)/255.0f;
-        }
-    }
+    //Values below the lower threshold keep their original color
+    colorMapLut.mapThresholded(vecData, matFinalVertColor, dThresholdX, dThresholdZ);
 }
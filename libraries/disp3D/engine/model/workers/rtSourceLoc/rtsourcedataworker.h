@@ -44,6 +44,7 @@
 //=============================================================================================================
 
 #include "../../../../disp3D_global.h"
+#include <disp/plots/helpers/colormaplut.h>
 
 
 //*************************************************************************************************************
@@ -54,6 +55,7 @@
 #include <QRgb>
 #include <QSharedPointer>
 #include <QLinkedList>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -82,13 +84,13 @@ struct VisualizationInfo {
     double                      dThresholdX;
     double                      dThresholdZ;
 
-    Eigen::VectorXd             vecSensorValues;
+    Eigen::MatrixXd             matSensorValues;                                    /**< The sensor values of the frames to be colored, one frame per column. */
     Eigen::MatrixX3f            matOriginalVertColor;
-    Eigen::MatrixX3f            matFinalVertColor;
+    QVector<Eigen::MatrixX3f>   vecFinalVertColors;                                 /**< The vertex colors, one matrix per column of matSensorValues. */
 
     QSharedPointer<Eigen::SparseMatrix<float> >  pMatInterpolationMatrix;         /**< The interpolation matrix. */
 
-    QRgb (*functionHandlerColorMap)(double v);
+    DISPLIB::ColorMapLut        colorMapLut;                                        /**< The lookup table which converts normalized values to rgb. */
 }; /**< The struct specifing visualization info. */
 
 struct ColorComputationInfo {
@@ -225,28 +227,53 @@ public:
 protected:
     //=========================================================================================================
     /**
-    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to rgb using the specified color converter
+    * @brief normalizeAndTransformToColor  This method normalizes final values for all vertices of the mesh and converts them to rgb using the specified color lookup table
     *
     * @param[in] vecData                       The final values for each vertex of the surface
     * @param[in,out] matFinalVertColor         The color matrix which the results are to be written to
     * @param[in] dThresholdX                   Lower threshold for normalizing
     * @param[in] dThresholdZ                    Upper threshold for normalizing
-    * @param[in] functionHandlerColorMap       The pointer to the function which converts scalar values to rgb
+    * @param[in] colorMapLut                   The lookup table which converts normalized values to rgb
     */
     static void normalizeAndTransformToColor(const Eigen::VectorXf& vecData,
-                                      Eigen::MatrixX3f& matFinalVertColor,
-                                      double dThresholdX,
-                                      double dThresholdZ,
-                                      QRgb (*functionHandlerColorMap)(double v));
+                                             Eigen::MatrixX3f& matFinalVertColor,
+                                             double dThresholdX,
+                                             double dThresholdZ,
+                                             const DISPLIB::ColorMapLut& colorMapLut);
 
     //=========================================================================================================
     /**
-    * @brief generateColorsFromSensorValues     Produces the final color matrix that is to be emitted
+    * @brief generateColorsFromSensorValues     Produces the color matrices of all frames in matSensorValues. The frames are
+    *                                           interpolated with a single sparse x dense product.
     *
     * @param[in/out] visualizationInfoHemi      The needed visualization info
     */
     static void generateColorsFromSensorValues(VisualizationInfo &visualizationInfoHemi);
 
+    //=========================================================================================================
+    /**
+    * @brief generateColorFrames            Produces the colors of all frames in m_matFrameBlock which were not streamed yet, for both hemispheres in parallel.
+    */
+    void generateColorFrames();
+
+    //=========================================================================================================
+    /**
+    * @brief prepareFrames                  Averages the next block of samples into m_matFrameBlock.
+    *
+    * @return                               True if at least one frame is ready to be streamed.
+    */
+    bool prepareFrames();
+
+    //=========================================================================================================
+    /**
+    * @brief takeSample                     Takes the next sample from the data queue, or from the loop queue if looping is on.
+    *
+    * @param[out] vecSample                 The sample.
+    *
+    * @return                               True if a sample was available.
+    */
+    bool takeSample(Eigen::VectorXd& vecSample);
+
     QList<Eigen::VectorXd>                              m_lDataQ;                           /**< List that holds the matrix data <n_channels x n_samples>. */
     QList<Eigen::VectorXd>                              m_lDataLoopQ;                       /**< List that holds the matrix data <n_channels x n_samples> for looping. */
     Eigen::VectorXd                                     m_vecAverage;                       /**< The averaged data to be streamed. */
@@ -257,6 +284,12 @@ protected:
     int                                                 m_iCurrentSample;                   /**< Iterator to current sample which is/was streamed. */
     int                                                 m_iAverageSamples;                  /**< Number of average to compute. */
     int                                                 m_iSampleCtr;                       /**< The sample counter. */
+    int                                                 m_iTickCtr;                         /**< Counts the streamData calls since the last emitted frame. */
+    int                                                 m_iCurrentFrame;                    /**< The next column of m_matFrameBlock to be streamed. */
+    int                                                 m_iColorFrameOffset;                /**< The column of m_matFrameBlock which corresponds to the first precomputed color frame. */
+    bool                                                m_bColorFramesDirty;                /**< Whether the precomputed color frames need to be recomputed, e.g. after the thresholds changed. */
+
+    Eigen::MatrixXd                                     m_matFrameBlock;                    /**< Averaged frames which are ready to be streamed <n_sources x n_frames>. */
 
     double                                              m_dSFreq;                           /**< The current sampling frequency. */
 
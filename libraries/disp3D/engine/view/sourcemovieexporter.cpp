@@ -0,0 +1,559 @@
+//=============================================================================================================
+/**
+* @file     sourcemovieexporter.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SourceMovieExporter class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "sourcemovieexporter.h"
+
+#include "../model/items/sourcedata/mnedatatreeitem.h"
+#include "../model/items/freesurfer/fssurfacetreeitem.h"
+#include "../model/items/common/metatreeitem.h"
+#include "../model/items/common/abstractmeshtreeitem.h"
+#include "../model/items/common/types.h"
+#include "../../helpers/interpolation/interpolation.h"
+#include "../../helpers/offscreen/softwarerasterizer.h"
+
+#include <disp/plots/helpers/colormap.h>
+
+#include <fs/surfaceset.h>
+#include <fs/surface.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QFuture>
+#include <QThread>
+#include <QDir>
+#include <QFile>
+#include <QBuffer>
+#include <QImage>
+#include <QMatrix3x3>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISP3DLIB;
+using namespace DISPLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SourceMovieExporter::SourceMovieExporter()
+: m_vecThresholds(0.0, 5.5, 15)
+, m_imageSize(800, 600)
+, m_colBackground(Qt::black)
+, m_iBlockSize(2 * qMax(1, QThread::idealThreadCount()))
+{
+    m_lHemiInfo << HemisphereInfo() << HemisphereInfo();
+    m_colorMapLut.setColorMap(ColorMap::valueToHot);
+}
+
+
+//*************************************************************************************************************
+
+SourceMovieExporter::~SourceMovieExporter()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool SourceMovieExporter::setMneDataItem(MneDataTreeItem* pMneDataItem)
+{
+    if(!pMneDataItem || !pMneDataItem->isDataInit()) {
+        qDebug() << "SourceMovieExporter::setMneDataItem - Item is not initialized. Returning...";
+        return false;
+    }
+
+    QSharedPointer<FSLIB::SurfaceSet> pSurfSet = pMneDataItem->getSurfaceSet();
+    QSharedPointer<SparseMatrix<float> > pMatInterpolationMatrixLeft = pMneDataItem->getInterpolationMatrixLeft();
+    QSharedPointer<SparseMatrix<float> > pMatInterpolationMatrixRight = pMneDataItem->getInterpolationMatrixRight();
+
+    if(!pSurfSet || pSurfSet->size() < 2) {
+        qDebug() << "SourceMovieExporter::setMneDataItem - Two hemispheres were not found. Returning...";
+        return false;
+    }
+
+    if(!pMatInterpolationMatrixLeft || !pMatInterpolationMatrixRight) {
+        qDebug() << "SourceMovieExporter::setMneDataItem - Interpolation matrices were not calculated yet. Returning...";
+        return false;
+    }
+
+    //The items are translated by the negative surface offset
+    for(int i = 0; i < 2; ++i) {
+        const FSLIB::Surface& tSurface = (*pSurfSet)[i];
+        QSharedPointer<SparseMatrix<float> > pMatInterpolationMatrix = i == 0 ? pMatInterpolationMatrixLeft : pMatInterpolationMatrixRight;
+
+        if(!setHemisphere(i,
+                          tSurface.rr().rowwise() - tSurface.offset().transpose(),
+                          tSurface.nn(),
+                          tSurface.tris(),
+                          pMatInterpolationMatrix)) {
+            return false;
+        }
+    }
+
+    setData(pMneDataItem->data(Data3DTreeModelItemRoles::Data).value<MatrixXd>());
+
+    QList<QStandardItem*> lItems = pMneDataItem->findChildren(MetaTreeItemTypes::ColormapType);
+    if(!lItems.isEmpty()) {
+        setColormapType(lItems.first()->data(MetaTreeItemRoles::ColormapType).toString());
+    }
+
+    lItems = pMneDataItem->findChildren(MetaTreeItemTypes::DataThreshold);
+    if(!lItems.isEmpty()) {
+        setThresholds(lItems.first()->data(MetaTreeItemRoles::DataThreshold).value<QVector3D>());
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool SourceMovieExporter::setSurfaceItems(FsSurfaceTreeItem* pSurfaceItemLeft,
+                                          FsSurfaceTreeItem* pSurfaceItemRight)
+{
+    QList<FsSurfaceTreeItem*> lSurfaceItems;
+    lSurfaceItems << pSurfaceItemLeft << pSurfaceItemRight;
+
+    bool bSuccess = true;
+
+    for(int i = 0; i < lSurfaceItems.size(); ++i) {
+        if(!lSurfaceItems.at(i)) {
+            bSuccess = false;
+            continue;
+        }
+
+        MatrixX3f matColor = lSurfaceItems.at(i)->data(Data3DTreeModelItemRoles::SurfaceCurrentColorVert).value<MatrixX3f>();
+
+        if(matColor.rows() != m_lHemiInfo.at(i).matVert.rows()) {
+            qDebug() << "SourceMovieExporter::setSurfaceItems - Number of surface colors (" << matColor.rows() << ") does not match the number of vertices (" << m_lHemiInfo.at(i).matVert.rows() << ").";
+            bSuccess = false;
+            continue;
+        }
+
+        m_lHemiInfo[i].matBaseColor = matColor;
+    }
+
+    return bSuccess;
+}
+
+
+//*************************************************************************************************************
+
+bool SourceMovieExporter::setHemisphere(int iHemi,
+                                        const MatrixX3f& matVert,
+                                        const MatrixX3f& matNorm,
+                                        const MatrixX3i& matTris,
+                                        QSharedPointer<SparseMatrix<float> > pMatInterpolationMatrix)
+{
+    if(iHemi < 0 || iHemi >= m_lHemiInfo.size()) {
+        qDebug() << "SourceMovieExporter::setHemisphere - Hemisphere index" << iHemi << "is out of range. Returning...";
+        return false;
+    }
+
+    if(matNorm.rows() != matVert.rows()
+       || !pMatInterpolationMatrix
+       || pMatInterpolationMatrix->rows() != matVert.rows()) {
+        qDebug() << "SourceMovieExporter::setHemisphere - Number of vertices, normals and interpolation matrix rows do not match. Returning...";
+        return false;
+    }
+
+    HemisphereInfo& hemi = m_lHemiInfo[iHemi];
+    hemi.matVert = matVert;
+    hemi.matNorm = matNorm;
+    hemi.matTris = matTris;
+    hemi.matBaseColor = AbstractMeshTreeItem::createVertColor(matVert.rows());
+    hemi.pMatInterpolationMatrix = pMatInterpolationMatrix;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setData(const MatrixXd& matSourceData)
+{
+    m_matSourceData = matSourceData;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setColormapType(const QString& sColormapType)
+{
+    m_colorMapLut.setColorMap(sColormapType);
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setThresholds(const QVector3D& vecThresholds)
+{
+    m_vecThresholds = vecThresholds;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setImageSize(const QSize& size)
+{
+    m_imageSize = size;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setBackgroundColor(const QColor& colBackground)
+{
+    m_colBackground = colBackground;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setViewRotation(const QQuaternion& rotation)
+{
+    m_viewRotation = rotation;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::setBlockSize(int iBlockSize)
+{
+    m_iBlockSize = qMax(1, iBlockSize);
+}
+
+
+//*************************************************************************************************************
+
+bool SourceMovieExporter::exportFrames(const QString& sDirectory,
+                                       const QString& sFormat,
+                                       int iFirstFrame,
+                                       int iLastFrame,
+                                       int iStep)
+{
+    for(int i = 0; i < m_lHemiInfo.size(); ++i) {
+        if(!m_lHemiInfo.at(i).pMatInterpolationMatrix) {
+            qDebug() << "SourceMovieExporter::exportFrames - Hemisphere" << i << "was not set. Returning...";
+            return false;
+        }
+    }
+
+    const int iColsLeft = m_lHemiInfo.at(0).pMatInterpolationMatrix->cols();
+    const int iColsRight = m_lHemiInfo.at(1).pMatInterpolationMatrix->cols();
+
+    if(m_matSourceData.rows() != iColsLeft + iColsRight) {
+        qDebug() << "SourceMovieExporter::exportFrames - Number of sources (" << m_matSourceData.rows() << ") does not match the interpolation matrices (" << iColsLeft + iColsRight << "). Returning...";
+        return false;
+    }
+
+    if(iLastFrame < 0 || iLastFrame >= m_matSourceData.cols()) {
+        iLastFrame = m_matSourceData.cols() - 1;
+    }
+
+    if(iStep < 1 || iFirstFrame < 0 || iFirstFrame > iLastFrame) {
+        qDebug() << "SourceMovieExporter::exportFrames - Invalid frame range. Returning...";
+        return false;
+    }
+
+    bool bRaw = false;
+    if(sFormat.compare(QStringLiteral("raw"), Qt::CaseInsensitive) == 0) {
+        bRaw = true;
+    } else if(sFormat.compare(QStringLiteral("png"), Qt::CaseInsensitive) != 0) {
+        qDebug() << "SourceMovieExporter::exportFrames - Unknown format" << sFormat << ". Returning...";
+        return false;
+    }
+
+    if(!QDir().mkpath(sDirectory)) {
+        qDebug() << "SourceMovieExporter::exportFrames - Could not create directory" << sDirectory << ". Returning...";
+        return false;
+    }
+
+    QFile rawFile;
+    if(bRaw) {
+        rawFile.setFileName(QDir(sDirectory).filePath(QString("frames_%1x%2_rgb24.raw").arg(m_imageSize.width()).arg(m_imageSize.height())));
+
+        if(!rawFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qDebug() << "SourceMovieExporter::exportFrames - Could not open" << rawFile.fileName() << ". Returning...";
+            return false;
+        }
+    }
+
+    //The geometry does not change in between frames, hence rasterize it only once
+    SoftwareRasterizer rasterizer(m_imageSize);
+
+    if(!prepareScene(rasterizer)) {
+        return false;
+    }
+
+    QVector<int> vecFrames;
+    for(int i = iFirstFrame; i <= iLastFrame; i += iStep) {
+        vecFrames.append(i);
+    }
+
+    QFuture<bool> writeResult;
+    bool bWriting = false;
+    bool bSuccess = true;
+
+    for(int iStart = 0; iStart < vecFrames.size() && bSuccess; iStart += m_iBlockSize) {
+        const int iNumberFrames = qMin(m_iBlockSize, vecFrames.size() - iStart);
+
+        MatrixXf matBlock(m_matSourceData.rows(), iNumberFrames);
+        QVector<FrameJob> vecJobs(iNumberFrames);
+
+        for(int j = 0; j < iNumberFrames; ++j) {
+            matBlock.col(j) = m_matSourceData.col(vecFrames.at(iStart + j)).cast<float>();
+            vecJobs[j].iFrame = vecFrames.at(iStart + j);
+            vecJobs[j].iColumn = j;
+        }
+
+        //Interpolate all frames of the block with one sparse matrix product per hemisphere
+        QList<MatrixXf> lInterpolated;
+        lInterpolated << Interpolation::interpolateSignals(*m_lHemiInfo.at(0).pMatInterpolationMatrix, matBlock.topRows(iColsLeft))
+                      << Interpolation::interpolateSignals(*m_lHemiInfo.at(1).pMatInterpolationMatrix, matBlock.bottomRows(iColsRight));
+
+        //Color, render and encode the frames in parallel
+        QtConcurrent::blockingMap(vecJobs, [this, &rasterizer, &lInterpolated, bRaw](FrameJob& job) {
+            renderFrame(rasterizer, lInterpolated, job, bRaw);
+        });
+
+        //Wait for the previous block to be written before handing over this one. This keeps at most two blocks in memory.
+        if(bWriting) {
+            writeResult.waitForFinished();
+            bSuccess = writeResult.result();
+        }
+
+        if(bSuccess) {
+            writeResult = QtConcurrent::run(writeFrames, sDirectory, bRaw ? static_cast<QIODevice*>(&rawFile) : Q_NULLPTR, vecJobs);
+            bWriting = true;
+        } else {
+            bWriting = false;
+        }
+    }
+
+    if(bWriting) {
+        writeResult.waitForFinished();
+        bSuccess = bSuccess && writeResult.result();
+    }
+
+    if(!bSuccess) {
+        qDebug() << "SourceMovieExporter::exportFrames - Writing frames to" << sDirectory << "failed.";
+    }
+
+    return bSuccess;
+}
+
+
+//*************************************************************************************************************
+
+bool SourceMovieExporter::prepareScene(SoftwareRasterizer& rasterizer)
+{
+    //Orthographic projection along the z axis of the rotated scene
+    const QMatrix3x3 rotation = m_viewRotation.normalized().toRotationMatrix();
+    Matrix3f matRotation;
+    for(int r = 0; r < 3; ++r) {
+        for(int c = 0; c < 3; ++c) {
+            matRotation(r,c) = rotation(r,c);
+        }
+    }
+
+    QList<MatrixX3f> lVertView;
+    Vector3f vecMin = Vector3f::Constant(std::numeric_limits<float>::max());
+    Vector3f vecMax = Vector3f::Constant(-std::numeric_limits<float>::max());
+
+    for(int i = 0; i < m_lHemiInfo.size(); ++i) {
+        MatrixX3f matVertView = m_lHemiInfo.at(i).matVert * matRotation.transpose();
+
+        if(matVertView.rows() > 0) {
+            vecMin = vecMin.cwiseMin(matVertView.colwise().minCoeff().transpose());
+            vecMax = vecMax.cwiseMax(matVertView.colwise().maxCoeff().transpose());
+        }
+
+        lVertView << matVertView;
+    }
+
+    if((vecMax.array() < vecMin.array()).any()) {
+        qDebug() << "SourceMovieExporter::prepareScene - No vertices to render. Returning...";
+        return false;
+    }
+
+    //Fit the scene into the frame with a small margin
+    const float fExtentX = qMax(vecMax.x() - vecMin.x(), 1e-6f);
+    const float fExtentY = qMax(vecMax.y() - vecMin.y(), 1e-6f);
+    const float fScale = 0.95f * qMin(m_imageSize.width() / fExtentX, m_imageSize.height() / fExtentY);
+    const float fCenterX = 0.5f * (vecMax.x() + vecMin.x());
+    const float fCenterY = 0.5f * (vecMax.y() + vecMin.y());
+
+    rasterizer.setSize(m_imageSize);
+
+    for(int i = 0; i < m_lHemiInfo.size(); ++i) {
+        HemisphereInfo& hemi = m_lHemiInfo[i];
+        const MatrixX3f& matVertView = lVertView.at(i);
+
+        MatrixX3f matVertScreen(matVertView.rows(), 3);
+        matVertScreen.col(0) = ((matVertView.col(0).array() - fCenterX) * fScale + 0.5f * m_imageSize.width()).matrix();
+        matVertScreen.col(1) = ((fCenterY - matVertView.col(1).array()) * fScale + 0.5f * m_imageSize.height()).matrix();
+        matVertScreen.col(2) = matVertView.col(2);
+
+        rasterizer.addMesh(matVertScreen, hemi.matTris);
+
+        //Two sided headlight shading
+        const MatrixX3f matNormView = hemi.matNorm * matRotation.transpose();
+        const ArrayXf vecNormLength = matNormView.rowwise().norm().array().max(1e-12f);
+        hemi.vecShading = (0.3f + 0.7f * (matNormView.col(2).array().abs() / vecNormLength)).matrix();
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::applyColormap(const VectorXf& vecData,
+                                        MatrixX3f& matColor) const
+{
+    if(vecData.rows() != matColor.rows()) {
+        qDebug() << "SourceMovieExporter::applyColormap - Sizes of input data (" << vecData.rows() <<") do not match output data ("<< matColor.rows() <<"). Returning ...";
+        return;
+    }
+
+    m_colorMapLut.mapThresholded(vecData, matColor, m_vecThresholds.x(), m_vecThresholds.z());
+}
+
+
+//*************************************************************************************************************
+
+void SourceMovieExporter::renderFrame(const SoftwareRasterizer& rasterizer,
+                                      const QList<MatrixXf>& lInterpolated,
+                                      FrameJob& job,
+                                      bool bRaw) const
+{
+    QList<MatrixX3f> lVertColors;
+
+    for(int i = 0; i < m_lHemiInfo.size(); ++i) {
+        const HemisphereInfo& hemi = m_lHemiInfo.at(i);
+
+        MatrixX3f matColor = hemi.matBaseColor;
+        applyColormap(lInterpolated.at(i).col(job.iColumn), matColor);
+        matColor.array().colwise() *= hemi.vecShading.array();
+
+        lVertColors << matColor;
+    }
+
+    QImage image = rasterizer.render(lVertColors, m_colBackground);
+
+    if(bRaw) {
+        //Tightly packed RGB without scanline padding
+        const QImage imageRgb = image.convertToFormat(QImage::Format_RGB888);
+        const int iBytesPerLine = 3 * imageRgb.width();
+
+        job.baEncoded.resize(iBytesPerLine * imageRgb.height());
+        for(int y = 0; y < imageRgb.height(); ++y) {
+            memcpy(job.baEncoded.data() + y * iBytesPerLine, imageRgb.constScanLine(y), iBytesPerLine);
+        }
+    } else {
+        QBuffer buffer(&job.baEncoded);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool SourceMovieExporter::writeFrames(const QString& sDirectory,
+                                      QIODevice* pRawDevice,
+                                      const QVector<FrameJob>& vecJobs)
+{
+    const QDir dir(sDirectory);
+
+    for(int i = 0; i < vecJobs.size(); ++i) {
+        const FrameJob& job = vecJobs.at(i);
+
+        if(job.baEncoded.isEmpty()) {
+            return false;
+        }
+
+        if(pRawDevice) {
+            if(pRawDevice->write(job.baEncoded) != job.baEncoded.size()) {
+                return false;
+            }
+        } else {
+            QFile file(dir.filePath(QString("frame_%1.png").arg(job.iFrame, 6, 10, QChar('0'))));
+
+            if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+               || file.write(job.baEncoded) != job.baEncoded.size()) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,332 @@
+//=============================================================================================================
+/**
+* @file     sourcemovieexporter.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SourceMovieExporter class declaration.
+*
+*/
+
+#ifndef DISP3DLIB_SOURCEMOVIEEXPORTER_H
+#define DISP3DLIB_SOURCEMOVIEEXPORTER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp3D_global.h"
+
+#include <disp/plots/helpers/colormaplut.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QList>
+#include <QSize>
+#include <QColor>
+#include <QVector3D>
+#include <QQuaternion>
+#include <QByteArray>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QIODevice;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISP3DLIB
+//=============================================================================================================
+
+namespace DISP3DLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DISP3DLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+class MneDataTreeItem;
+class FsSurfaceTreeItem;
+class SoftwareRasterizer;
+
+
+//=============================================================================================================
+/**
+* Renders source activity movies without a window, OpenGL context or View3D. The meshes, interpolation matrices,
+* data and visualization settings are taken from the MneDataTreeItem (and optionally the curvature colors from the
+* FsSurfaceTreeItems) and all frames are rendered with the SoftwareRasterizer. Frames are processed in blocks:
+* the sources of a block are interpolated with one sparse matrix product per hemisphere, colored, rasterized and
+* encoded in parallel, and handed to a writer which stores the previous block while the next one is computed.
+* At most two blocks are held in memory at any time.
+*
+* @brief Headless batch renderer for source activity movies.
+*/
+class DISP3DSHARED_EXPORT SourceMovieExporter
+{
+
+public:
+    typedef QSharedPointer<SourceMovieExporter> SPtr;             /**< Shared pointer type for SourceMovieExporter class. */
+    typedef QSharedPointer<const SourceMovieExporter> ConstSPtr;  /**< Const shared pointer type for SourceMovieExporter class. */
+
+    //=========================================================================================================
+    /**
+    * Default constructor
+    */
+    SourceMovieExporter();
+
+    //=========================================================================================================
+    /**
+    * Default destructor
+    */
+    ~SourceMovieExporter();
+
+    //=========================================================================================================
+    /**
+    * Takes the surfaces, interpolation matrices, source data, colormap and thresholds from an initialized MNE data
+    * item. Since the interpolation matrices are calculated in a background thread, this fails until the item has
+    * received them.
+    *
+    * @param[in] pMneDataItem       The MNE data item.
+    *
+    * @return                       True if all needed information was available, false otherwise.
+    */
+    bool setMneDataItem(MneDataTreeItem* pMneDataItem);
+
+    //=========================================================================================================
+    /**
+    * Takes the current vertex colors (curvature or annotation) of the surface items as background colors for
+    * vertices below the lower threshold. Must be called after setMneDataItem(...) or setHemisphere(...).
+    *
+    * @param[in] pSurfaceItemLeft   The surface item of the left hemisphere.
+    * @param[in] pSurfaceItemRight  The surface item of the right hemisphere.
+    *
+    * @return                       True if the number of vertices matched for both hemispheres, false otherwise.
+    */
+    bool setSurfaceItems(FsSurfaceTreeItem* pSurfaceItemLeft,
+                         FsSurfaceTreeItem* pSurfaceItemRight);
+
+    //=========================================================================================================
+    /**
+    * Sets the mesh and interpolation matrix of one hemisphere directly. The background colors are reset to gray.
+    *
+    * @param[in] iHemi                      The hemisphere (0 = left, 1 = right).
+    * @param[in] matVert                    The vertices in world coordinates.
+    * @param[in] matNorm                    The vertex normals.
+    * @param[in] matTris                    The triangles.
+    * @param[in] pMatInterpolationMatrix    The interpolation matrix <n_vertices x n_sources>.
+    *
+    * @return                               True if the input was consistent, false otherwise.
+    */
+    bool setHemisphere(int iHemi,
+                       const Eigen::MatrixX3f& matVert,
+                       const Eigen::MatrixX3f& matNorm,
+                       const Eigen::MatrixX3i& matTris,
+                       QSharedPointer<Eigen::SparseMatrix<float> > pMatInterpolationMatrix);
+
+    //=========================================================================================================
+    /**
+    * Sets the source data. The rows hold the sources of the left hemisphere followed by the sources of the right
+    * hemisphere, each column is one frame.
+    *
+    * @param[in] matSourceData      The source data <n_sources x n_frames>.
+    */
+    void setData(const Eigen::MatrixXd& matSourceData);
+
+    //=========================================================================================================
+    /**
+    * Sets the colormap ("Hot Negative 1", "Hot", "Hot Negative 2" or "Jet").
+    *
+    * @param[in] sColormapType      The name of the colormap.
+    */
+    void setColormapType(const QString& sColormapType);
+
+    //=========================================================================================================
+    /**
+    * Sets the thresholds. Absolute values below x keep their background color, values above z are saturated.
+    *
+    * @param[in] vecThresholds      The thresholds.
+    */
+    void setThresholds(const QVector3D& vecThresholds);
+
+    //=========================================================================================================
+    /**
+    * Sets the size of the exported frames.
+    *
+    * @param[in] size               The frame size in pixels.
+    */
+    void setImageSize(const QSize& size);
+
+    //=========================================================================================================
+    /**
+    * Sets the background color of the exported frames.
+    *
+    * @param[in] colBackground      The background color.
+    */
+    void setBackgroundColor(const QColor& colBackground);
+
+    //=========================================================================================================
+    /**
+    * Sets the view rotation. The identity looks down the z axis, i.e. shows the brain from the top with anterior
+    * pointing up. The scene is projected orthographically and always fitted into the frame.
+    *
+    * @param[in] rotation           The rotation applied to the scene.
+    */
+    void setViewRotation(const QQuaternion& rotation);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of frames which are processed in parallel per block. This bounds the memory footprint of the
+    * export to two blocks of encoded frames. Defaults to twice the ideal thread count.
+    *
+    * @param[in] iBlockSize         The number of frames per block.
+    */
+    void setBlockSize(int iBlockSize);
+
+    //=========================================================================================================
+    /**
+    * Renders the frames and writes them to a directory. With format "png" every frame is written to its own file
+    * frame_000000.png, frame_000001.png, etc. With format "raw" all frames are appended to a single file
+    * frames_<width>x<height>_rgb24.raw holding tightly packed 8 bit RGB, which can be piped into a video encoder.
+    *
+    * @param[in] sDirectory         The output directory. It is created if it does not exist.
+    * @param[in] sFormat            The output format ("png" or "raw").
+    * @param[in] iFirstFrame        The first frame (column of the source data) to export.
+    * @param[in] iLastFrame         The last frame to export. -1 exports up to the last column.
+    * @param[in] iStep              The step in between exported frames.
+    *
+    * @return                       True if all frames were written, false otherwise.
+    */
+    bool exportFrames(const QString& sDirectory,
+                      const QString& sFormat = QStringLiteral("png"),
+                      int iFirstFrame = 0,
+                      int iLastFrame = -1,
+                      int iStep = 1);
+
+private:
+    struct HemisphereInfo {
+        Eigen::MatrixX3f                                matVert;                    /**< The vertices in world coordinates. */
+        Eigen::MatrixX3f                                matNorm;                    /**< The vertex normals. */
+        Eigen::MatrixX3i                                matTris;                    /**< The triangles. */
+        Eigen::MatrixX3f                                matBaseColor;               /**< The colors of vertices below the lower threshold. */
+        Eigen::VectorXf                                 vecShading;                 /**< The per vertex shading factor of the current view. */
+        QSharedPointer<Eigen::SparseMatrix<float> >     pMatInterpolationMatrix;    /**< The interpolation matrix <n_vertices x n_sources>. */
+    };
+
+    struct FrameJob {
+        int                         iFrame;                     /**< The frame index in the source data. */
+        int                         iColumn;                    /**< The column in the interpolated block. */
+        QByteArray                  baEncoded;                  /**< The encoded frame. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Projects the meshes into screen space, computes the shading and fills the visibility buffer of the rasterizer.
+    *
+    * @param[in, out] rasterizer    The rasterizer.
+    *
+    * @return                       True if the scene could be set up, false otherwise.
+    */
+    bool prepareScene(SoftwareRasterizer& rasterizer);
+
+    //=========================================================================================================
+    /**
+    * Thresholds the values and converts them to colors using the colormap lookup table. Vertices whose absolute
+    * value is below the lower threshold keep their color.
+    *
+    * @param[in] vecData                The interpolated values of one frame.
+    * @param[in, out] matColor          The vertex colors, initialized with the background colors.
+    */
+    void applyColormap(const Eigen::VectorXf& vecData,
+                       Eigen::MatrixX3f& matColor) const;
+
+    //=========================================================================================================
+    /**
+    * Colors, renders and encodes a single frame.
+    *
+    * @param[in] rasterizer         The prepared rasterizer.
+    * @param[in] lInterpolated      The interpolated values of the current block, one matrix per hemisphere.
+    * @param[in, out] job           The frame to render. The encoded frame is stored in job.baEncoded.
+    * @param[in] bRaw               Whether to encode raw RGB instead of PNG.
+    */
+    void renderFrame(const SoftwareRasterizer& rasterizer,
+                     const QList<Eigen::MatrixXf>& lInterpolated,
+                     FrameJob& job,
+                     bool bRaw) const;
+
+    //=========================================================================================================
+    /**
+    * Writes a block of encoded frames.
+    *
+    * @param[in] sDirectory         The output directory, used for png files.
+    * @param[in] pRawDevice         The open device which raw frames are appended to. Null for png files.
+    * @param[in] vecJobs            The encoded frames.
+    *
+    * @return                       True if all frames were written, false otherwise.
+    */
+    static bool writeFrames(const QString& sDirectory,
+                            QIODevice* pRawDevice,
+                            const QVector<FrameJob>& vecJobs);
+
+    QList<HemisphereInfo>       m_lHemiInfo;                    /**< The meshes and interpolation matrices of both hemispheres. */
+    Eigen::MatrixXd             m_matSourceData;                /**< The source data <n_sources x n_frames>. */
+
+    DISPLIB::ColorMapLut        m_colorMapLut;                  /**< The colormap lookup table. */
+    QVector3D                   m_vecThresholds;                /**< The thresholds. */
+
+    QSize                       m_imageSize;                    /**< The size of the exported frames. */
+    QColor                      m_colBackground;                /**< The background color. */
+    QQuaternion                 m_viewRotation;                 /**< The view rotation. */
+    int                         m_iBlockSize;                   /**< The number of frames per block. */
+};
+
+} // NAMESPACE DISP3DLIB
+
+#endif // DISP3DLIB_SOURCEMOVIEEXPORTER_H
@@ -42,6 +42,7 @@
 #include "geometryinfo.h"
 
 #include <fiff/fiff_info.h>
+#include <utils/spatialindex/kdtree.h>
 
 
 //*************************************************************************************************************
@@ -49,9 +50,10 @@
 // INCLUDES
 //=============================================================================================================
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
-#include <set>
+#include <functional>
 
 
 //*************************************************************************************************************
@@ -76,6 +78,7 @@
 using namespace DISP3DLIB;
 using namespace Eigen;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -117,12 +120,13 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
     }
 
     // start threads with their respective parts of the final subset
-    qint32 iSubArraySize = ceil(vecVertSubset.size() / iCores);
+    qint32 iSubArraySize = (vecVertSubset.size() + iCores - 1) / iCores;
     QVector<QFuture<void> > vecThreads(iCores - 1);
     qint32 iBegin = 0;
     qint32 iEnd = iSubArraySize;
 
     for (int i = 0; i < vecThreads.size(); ++i) {
+        iEnd = std::min(iEnd, (qint32)vecVertSubset.size());
         vecThreads[i] = QtConcurrent::run(std::bind(iterativeDijkstra,
                                                     returnMat,
                                                     std::cref(matVertices),
@@ -131,7 +135,7 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
                                                     iBegin,
                                                     iEnd,
                                                     dCancelDist));
-        iBegin += iSubArraySize;
+        iBegin = iEnd;
         iEnd += iSubArraySize;
     }
 
@@ -155,100 +159,109 @@ QSharedPointer<MatrixXd> GeometryInfo::scdc(const MatrixX3f &matVertices,
 
 //*************************************************************************************************************
 
-QVector<qint32> GeometryInfo::projectSensors(const MatrixX3f &matVertices,
-                                             const QVector<Vector3f> &vecSensorPositions)
+QSharedPointer<SparseMatrix<double, RowMajor> > GeometryInfo::scdcSparse(const MatrixX3f &matVertices,
+                                                                        const QVector<QVector<int> > &vecNeighborVertices,
+                                                                        QVector<qint32> &vecVertSubset,
+                                                                        double dCancelDist)
 {
-    QVector<qint32> vecOutputArray;
+    // check for empty subset:
+    if(vecVertSubset.empty()) {
+        // caller passed an empty subset, need to fill in all vertex IDs
+        qDebug() << "[WARNING] SCDC received empty subset, calculating distances for all vertices !";
+        vecVertSubset.reserve(matVertices.rows());
+        for(qint32 id = 0; id < matVertices.rows(); ++id) {
+            vecVertSubset.push_back(id);
+        }
+    }
 
-    qint32 iCores = QThread::idealThreadCount();
-    if (iCores <= 0)
-    {
+    // distribute calculation on cores, each thread collects its own triplets
+    int iCores = QThread::idealThreadCount();
+    if (iCores <= 0) {
         // assume that we have at least two available cores
         iCores = 2;
     }
 
-    const qint32 iSubArraySize = ceil(vecSensorPositions.size() / iCores);
+    qint32 iSubArraySize = (vecVertSubset.size() + iCores - 1) / iCores;
+    QVector<std::vector<Triplet<double> > > vecTriplets(iCores);
+    QVector<QFuture<void> > vecThreads(iCores - 1);
+    qint32 iBegin = 0;
+    qint32 iEnd = iSubArraySize;
 
-    //small input size no threads needed
-    if(iSubArraySize <= 1)
-    {
-        vecOutputArray.append(nearestNeighbor(matVertices,
-                                              vecSensorPositions.constBegin(),
-                                              vecSensorPositions.constEnd()));
-        return vecOutputArray;
-    }
-    // split input array + thread start
-    QVector<QFuture<QVector<qint32> > > vecThreads(iCores - 1);
-    qint32 iBeginOffset = iSubArraySize;
-    qint32 iEndOffset = iBeginOffset + iSubArraySize;
-    for(qint32 i = 0; i < vecThreads.size(); ++i)
-    {
-        //last round
-        if(i == vecThreads.size() -1)
-        {
-            vecThreads[i] = QtConcurrent::run(nearestNeighbor,
-                                              matVertices,
-                                              vecSensorPositions.constBegin() + iBeginOffset,
-                                              vecSensorPositions.constEnd());
-            break;
-        }
-        else
-        {
-            vecThreads[i] = QtConcurrent::run(nearestNeighbor,
-                                              matVertices,
-                                              vecSensorPositions.constBegin() + iBeginOffset,
-                                              vecSensorPositions.constBegin() + iEndOffset);
-            iBeginOffset = iEndOffset;
-            iEndOffset += iSubArraySize;
-        }
+    for (int i = 0; i < vecThreads.size(); ++i) {
+        iEnd = std::min(iEnd, (qint32)vecVertSubset.size());
+        vecThreads[i] = QtConcurrent::run(std::bind(iterativeSparseDijkstra,
+                                                    std::ref(vecTriplets[i]),
+                                                    std::cref(matVertices),
+                                                    std::cref(vecNeighborVertices),
+                                                    std::cref(vecVertSubset),
+                                                    iBegin,
+                                                    iEnd,
+                                                    dCancelDist));
+        iBegin = iEnd;
+        iEnd += iSubArraySize;
     }
-    //calc while waiting for other threads
-    vecOutputArray.append(nearestNeighbor(matVertices,
-                                          vecSensorPositions.constBegin(),
-                                          vecSensorPositions.constBegin() + iSubArraySize));
 
-    //wait for threads to finish
-    for (QFuture<QVector<qint32> >& f : vecThreads) {
+    // use main thread to calculate last part of the final subset
+    iterativeSparseDijkstra(vecTriplets.last(),
+                            matVertices,
+                            vecNeighborVertices,
+                            vecVertSubset,
+                            iBegin,
+                            vecVertSubset.size(),
+                            dCancelDist);
+
+    // wait for all other threads to finish
+    for (QFuture<void>& f : vecThreads) {
         f.waitForFinished();
     }
 
-    //move sub arrays back into output
-    for(qint32 i = 0; i < vecThreads.size(); ++i)
-    {
-        vecOutputArray.append(std::move(vecThreads[i].result()));
+    // merge the triplets of all threads
+    size_t iNumberEntries = 0;
+    for (const std::vector<Triplet<double> >& t : vecTriplets) {
+        iNumberEntries += t.size();
     }
 
-    return vecOutputArray;
+    std::vector<Triplet<double> > vecAllTriplets;
+    vecAllTriplets.reserve(iNumberEntries);
+    for (std::vector<Triplet<double> >& t : vecTriplets) {
+        vecAllTriplets.insert(vecAllTriplets.end(), t.begin(), t.end());
+        std::vector<Triplet<double> >().swap(t);
+    }
+
+    // convention: first dimension in distance table is "from", second dimension "to"
+    QSharedPointer<SparseMatrix<double, RowMajor> > returnMat = QSharedPointer<SparseMatrix<double, RowMajor> >::create(matVertices.rows(), vecVertSubset.size());
+    returnMat->setFromTriplets(vecAllTriplets.begin(), vecAllTriplets.end());
+
+    return returnMat;
+}
+
+
+//*************************************************************************************************************
+
+QVector<qint32> GeometryInfo::projectSensors(const MatrixX3f &matVertices,
+                                             const QVector<Vector3f> &vecSensorPositions)
+{
+    //the tree is built once per surface, afterwards each sensor costs a logarithmic search only
+    const KdTree kdTree(matVertices);
+
+    return nearestNeighbor(kdTree,
+                           vecSensorPositions.constBegin(),
+                           vecSensorPositions.constEnd());
 }
 
 
 //*************************************************************************************************************
 
-QVector<qint32> GeometryInfo::nearestNeighbor(const MatrixX3f &matVertices,
+QVector<qint32> GeometryInfo::nearestNeighbor(const KdTree &kdTree,
                                               QVector<Vector3f>::const_iterator itSensorBegin,
                                               QVector<Vector3f>::const_iterator itSensorEnd)
 {
-    ///lin search sensor positions
     QVector<qint32> vecMappedSensors;
     vecMappedSensors.reserve(std::distance(itSensorBegin, itSensorEnd));
 
     for(auto sensor = itSensorBegin; sensor != itSensorEnd; ++sensor)
     {
-        qint32 iChampionId;
-        double iChampDist = std::numeric_limits<double>::max();
-        for(qint32 i = 0; i < matVertices.rows(); ++i)
-        {
-            //calculate 3d euclidian distance
-            double dDist = sqrt(squared(matVertices(i, 0) - (*sensor)[0])  // x-cord
-                    + squared(matVertices(i, 1) - (*sensor)[1])    // y-cord
-                    + squared(matVertices(i, 2) - (*sensor)[2]));  // z-cord
-            if(dDist < iChampDist)
-            {
-                iChampionId = i;
-                iChampDist = dDist;
-            }
-        }
-        vecMappedSensors.push_back(iChampionId);
+        vecMappedSensors.push_back(kdTree.nearest(*sensor));
     }
     return vecMappedSensors;
 }
@@ -263,57 +276,119 @@ void GeometryInfo::iterativeDijkstra(QSharedPointer<MatrixXd> matOutputDistMatri
                                      qint32 iBegin,
                                      qint32 iEnd,
                                      double dCancelDistance) {
-    // initialization
-    const QVector<QVector<int> > &vecAdjacency = vecNeighborVertices;
-    qint32 n = vecAdjacency.size();
-    QVector<double> vecMinDists(n);
-    std::set< std::pair< double, qint32> > vertexQ;
+    // initialization of the workspace, which is reset via the touched list after each root
     const double INF = FLOAT_INFINITY;
+    QVector<double> vecMinDists(vecNeighborVertices.size(), INF);
+    QVector<qint32> vecTouched;
+    std::vector<std::pair<double, qint32> > vecHeap;
 
     // outer loop, iterated for each vertex of 'vertSubset' between 'begin' and 'end'
     for (qint32 i = iBegin; i < iEnd; ++i) {
-        // init phase of dijkstra: set source node for current iteration and reset data fields
-        qint32 iRoot = vecVertSubset.at(i);
-        vertexQ.clear();
-        vecMinDists.fill(INF);
-        vecMinDists[iRoot] = 0.0;
-        vertexQ.insert(std::make_pair(vecMinDists[iRoot], iRoot));
-
-        // dijkstra main loop
-        while (vertexQ.empty() == false) {
-            // remove next vertex from queue
-            const double dDist = vertexQ.begin()->first;
-            const qint32 u = vertexQ.begin()->second;
-            vertexQ.erase(vertexQ.begin());
-
-            // check if we are still below cancel distance
-            if (dDist <= dCancelDistance) {
-                // visit each neighbour of u
-                const QVector<int>& vecNeighbours = vecAdjacency[u];
-
-                for (qint32 ne = 0; ne < vecNeighbours.length(); ++ne) {
-                    qint32 v = vecNeighbours[ne];
-
-                    // distance from source (i.e. root) to v, using u as its predecessor
-                    // calculate inline since designated function was magnitudes slower (even when declared as inline)
-                    const double dDistX = matVertices(u, 0) - matVertices(v, 0);
-                    const double dDistY = matVertices(u, 1) - matVertices(v, 1);
-                    const double dDistZ = matVertices(u, 2) - matVertices(v, 2);
-                    const double dDistWithU = dDist + sqrt(dDistX * dDistX + dDistY * dDistY + dDistZ * dDistZ);
-
-                    if (dDistWithU < vecMinDists[v]) {
-                        // this is a combination of insert and decreaseKey
-                        vertexQ.erase(std::make_pair(vecMinDists[v], v));
-                        vecMinDists[v] = dDistWithU;
-                        vertexQ.insert(std::make_pair(vecMinDists[v], v));
-                    }
-                }
-            }
-        }
+        boundedDijkstra(matVertices,
+                        vecNeighborVertices,
+                        vecVertSubset.at(i),
+                        dCancelDistance,
+                        vecMinDists,
+                        vecTouched,
+                        vecHeap);
 
         // save results for current root in matrix
-        for (qint32 m = 0; m < vecMinDists.size(); ++m) {
-            matOutputDistMatrix->coeffRef(m , i) = vecMinDists[m];
+        matOutputDistMatrix->col(i).setConstant(INF);
+        for (qint32 m : vecTouched) {
+            matOutputDistMatrix->coeffRef(m, i) = vecMinDists[m];
+            vecMinDists[m] = INF;
+        }
+        vecTouched.clear();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void GeometryInfo::iterativeSparseDijkstra(std::vector<Triplet<double> > &vecOutputTriplets,
+                                           const MatrixX3f &matVertices,
+                                           const QVector<QVector<int> > &vecNeighborVertices,
+                                           const QVector<qint32> &vecVertSubset,
+                                           qint32 iBegin,
+                                           qint32 iEnd,
+                                           double dCancelDistance) {
+    // initialization of the workspace, which is reset via the touched list after each root
+    const double INF = FLOAT_INFINITY;
+    QVector<double> vecMinDists(vecNeighborVertices.size(), INF);
+    QVector<qint32> vecTouched;
+    std::vector<std::pair<double, qint32> > vecHeap;
+
+    // outer loop, iterated for each vertex of 'vertSubset' between 'begin' and 'end'
+    for (qint32 i = iBegin; i < iEnd; ++i) {
+        boundedDijkstra(matVertices,
+                        vecNeighborVertices,
+                        vecVertSubset.at(i),
+                        dCancelDistance,
+                        vecMinDists,
+                        vecTouched,
+                        vecHeap);
+
+        // save results for current root as triplets
+        for (qint32 m : vecTouched) {
+            vecOutputTriplets.push_back(Triplet<double>(m, i, vecMinDists[m]));
+            vecMinDists[m] = INF;
+        }
+        vecTouched.clear();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void GeometryInfo::boundedDijkstra(const MatrixX3f &matVertices,
+                                   const QVector<QVector<int> > &vecNeighborVertices,
+                                   qint32 iRoot,
+                                   double dCancelDistance,
+                                   QVector<double> &vecMinDists,
+                                   QVector<qint32> &vecTouched,
+                                   std::vector<std::pair<double, qint32> > &vecHeap) {
+    // min heap, outdated entries are skipped when popped instead of decreasing their keys
+    const std::greater<std::pair<double, qint32> > compare;
+    const double INF = FLOAT_INFINITY;
+
+    vecHeap.clear();
+    vecMinDists[iRoot] = 0.0;
+    vecTouched.push_back(iRoot);
+    vecHeap.push_back(std::make_pair(0.0, iRoot));
+
+    // dijkstra main loop
+    while (!vecHeap.empty()) {
+        // remove next vertex from heap
+        std::pop_heap(vecHeap.begin(), vecHeap.end(), compare);
+        const double dDist = vecHeap.back().first;
+        const qint32 u = vecHeap.back().second;
+        vecHeap.pop_back();
+
+        if (dDist > vecMinDists[u]) {
+            continue;
+        }
+
+        // visit each neighbour of u
+        const QVector<int>& vecNeighbours = vecNeighborVertices[u];
+
+        for (qint32 ne = 0; ne < vecNeighbours.length(); ++ne) {
+            qint32 v = vecNeighbours[ne];
+
+            // distance from source (i.e. root) to v, using u as its predecessor
+            const double dDistX = matVertices(u, 0) - matVertices(v, 0);
+            const double dDistY = matVertices(u, 1) - matVertices(v, 1);
+            const double dDistZ = matVertices(u, 2) - matVertices(v, 2);
+            const double dDistWithU = dDist + sqrt(dDistX * dDistX + dDistY * dDistY + dDistZ * dDistZ);
+
+            // vertices beyond the cancel distance are never queued, this bounds the search
+            if (dDistWithU <= dCancelDistance && dDistWithU < vecMinDists[v]) {
+                if (vecMinDists[v] == INF) {
+                    vecTouched.push_back(v);
+                }
+                vecMinDists[v] = dDistWithU;
+                vecHeap.push_back(std::make_pair(dDistWithU, v));
+                std::push_heap(vecHeap.begin(), vecHeap.end(), compare);
+            }
         }
     }
 }
@@ -324,6 +399,46 @@ void GeometryInfo::iterativeDijkstra(QSharedPointer<MatrixXd> matOutputDistMatri
 QVector<qint32> GeometryInfo::filterBadChannels(QSharedPointer<Eigen::MatrixXd> matDistanceTable,
                                                 const FIFFLIB::FiffInfo& fiffInfo,
                                                 qint32 iSensorType) {
+    QVector<qint32> vecBadColumns = badChannelColumns(fiffInfo, iSensorType);
+
+    // found index of our bad channel, set whole column to infinity
+    for(qint32 col : vecBadColumns){
+        matDistanceTable->col(col).setConstant(FLOAT_INFINITY);
+    }
+
+    return vecBadColumns;
+}
+
+
+//*************************************************************************************************************
+
+QVector<qint32> GeometryInfo::filterBadChannels(QSharedPointer<SparseMatrix<double, RowMajor> > matDistanceTable,
+                                                const FIFFLIB::FiffInfo& fiffInfo,
+                                                qint32 iSensorType) {
+    QVector<qint32> vecBadColumns = badChannelColumns(fiffInfo, iSensorType);
+
+    if(vecBadColumns.isEmpty()) {
+        return vecBadColumns;
+    }
+
+    // missing entries are treated as infinity, so remove all entries of the bad columns
+    QVector<bool> vecIsBad(matDistanceTable->cols(), false);
+    for(qint32 col : vecBadColumns){
+        vecIsBad[col] = true;
+    }
+
+    matDistanceTable->prune([&vecIsBad](const Index&, const Index& col, const double&) {
+        return !vecIsBad[col];
+    });
+
+    return vecBadColumns;
+}
+
+
+//*************************************************************************************************************
+
+QVector<qint32> GeometryInfo::badChannelColumns(const FIFFLIB::FiffInfo& fiffInfo,
+                                                qint32 iSensorType) {
     // use pointer to avoid copying of FiffChInfo objects
     QVector<qint32> vecBadColumns;
     QVector<const FiffChInfo*> vecSensors;
@@ -338,11 +453,7 @@ QVector<qint32> GeometryInfo::filterBadChannels(QSharedPointer<Eigen::MatrixXd>
     for(const QString& b : fiffInfo.bads){
         for(int col = 0; col < vecSensors.size(); ++col){
             if(vecSensors[col]->ch_name == b){
-                // found index of our bad channel, set whole column to infinity
                 vecBadColumns.push_back(col);
-                for(int row = 0; row < matDistanceTable->rows(); ++row){
-                    matDistanceTable->coeffRef(row, col) = FLOAT_INFINITY;
-                }
                 break;
             }
         }
@@ -51,6 +51,7 @@
 //=============================================================================================================
 
 #include <limits>
+#include <vector>
 
 
 //*************************************************************************************************************
@@ -68,6 +69,7 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 
 
 //*************************************************************************************************************
@@ -75,6 +77,10 @@
 // FORWARD DECLARATIONS
 //=============================================================================================================
 
+namespace UTILSLIB {
+    class KdTree;
+}
+
 namespace MNELIB {
     class MNEmatVertices;
 }
@@ -136,6 +142,25 @@ public:
                                                 QVector<qint32> &pVecVertSubset,
                                                 double dCancelDist = FLOAT_INFINITY);
 
+    //=========================================================================================================
+    /**
+    * @brief scdcSparse                     Calculates surface constrained distances on a mesh and only stores the distances below the cancel distance.
+    *                                       The search of each subset vertex stops at the cancel distance, so the runtime and memory only depend
+    *                                       on the number of vertices within the cancel distance, not on the size of the mesh.
+    *
+    * @param[in] matVertices                The surface on which distances should be calculated.
+    * @param[in] vecNeighborVertices        The neighbor vertex information.
+    * @param[in/out] pVecVertSubset         The subset of IDs for which the distances should be calculated.
+    * @param[in] dCancelDist                Distances higher than this are not stored.
+    *
+    * @return                               A sparse row major (CSR) double matrix. One column represents the distances for one vertex inside of the passed subset.
+    *                                       Missing entries are to be treated as infinity.
+    */
+    static QSharedPointer<Eigen::SparseMatrix<double, Eigen::RowMajor> > scdcSparse(const Eigen::MatrixX3f &matVertices,
+                                                                                    const QVector<QVector<int> > &vecNeighborVertices,
+                                                                                    QVector<qint32> &pVecVertSubset,
+                                                                                    double dCancelDist = FLOAT_INFINITY);
+
     //=========================================================================================================
     /**
     * @brief                            Calculates the nearest neighbor (euclidian distance) vertex to each sensor
@@ -162,6 +187,20 @@ public:
                                              const FIFFLIB::FiffInfo& fiffInfo,
                                              qint32 iSensorType);
 
+    //=========================================================================================================
+    /**
+    * @brief filterBadChannels          Filters bad channels from a sparse distance table by removing their entries
+    *
+    * @param[out] matDistanceTable      Result of scdcSparse.
+    * @param[in] fiffInfo               Container for sensors.
+    * @param[in] iSensorType            Sensor type to be filtered out, use fiff constants.
+    *
+    * @return Vector of bad channel indices.
+    */
+    static QVector<qint32> filterBadChannels(QSharedPointer<Eigen::SparseMatrix<double, Eigen::RowMajor> > matDistanceTable,
+                                             const FIFFLIB::FiffInfo& fiffInfo,
+                                             qint32 iSensorType);
+
 protected:
     //=========================================================================================================
     /**
@@ -175,15 +214,15 @@ protected:
 
     //=========================================================================================================
     /**
-    * @brief nearestNeighbor        Calculates the nearest vertex of an MNEmatVertices for each position between the two iterators
+    * @brief nearestNeighbor        Calculates the nearest vertex for each position between the two iterators
     *
-    * @param[in] matVertices        The MNEmatVertices that holds the vertex information
+    * @param[in] kdTree             The k-d tree built over the vertex positions
     * @param[in] itSensorBegin      The iterator that indicates the start of the wanted section of positions
     * @param[in] itSensorEnd        The iterator that indicates the end of the wanted section of positions
     *
     * @return                       A vector of nearest vertex IDs that corresponds to the subvector between the two iterators
     */
-    static QVector<qint32> nearestNeighbor(const Eigen::MatrixX3f &matVertices,
+    static QVector<qint32> nearestNeighbor(const UTILSLIB::KdTree &kdTree,
                                            QVector<Eigen::Vector3f>::const_iterator itSensorBegin,
                                            QVector<Eigen::Vector3f>::const_iterator itSensorEnd);
 
@@ -206,6 +245,61 @@ protected:
                                   qint32 iBegin,
                                   qint32 iEnd,
                                   double dCancelDistance);
+
+    //=========================================================================================================
+    /**
+    * @brief iterativeSparseDijkstra   Calculates shortest distances on the mesh for each vertex of the passed vector that lies between the two indices
+    *                                  and stores all distances below the cancel distance as triplets
+    *
+    * @param[out] vecOutputTriplets    The triplets (vertex, subset index, distance) in which the distances will be stored
+    * @param[in] matVertices           The surface on which distances should be calculated
+    * @param[in] vecNeighborVertices   The neighbor vertex information.
+    * @param[in] vecVertSubset         The subset of vertices
+    * @param[in] iBegin                Start index of distance calculation
+    * @param[in] iEnd                  End index of distance calculation, exclusive
+    * @param[in] dCancelDistance       Distance threshold: all vertices that have a higher distance to the respective root vertex are omitted
+    */
+    static void iterativeSparseDijkstra(std::vector<Eigen::Triplet<double> > &vecOutputTriplets,
+                                        const Eigen::MatrixX3f &matVertices,
+                                        const QVector<QVector<int> > &vecNeighborVertices,
+                                        const QVector<qint32> &vecVertSubset,
+                                        qint32 iBegin,
+                                        qint32 iEnd,
+                                        double dCancelDistance);
+
+    //=========================================================================================================
+    /**
+    * @brief boundedDijkstra           Calculates the shortest distances from one root vertex to all vertices within the cancel distance.
+    *                                  Uses a binary heap and only visits vertices within the cancel distance. All vertices whose distance was
+    *                                  set are appended to the touched list, so the caller can reset the workspace without refilling it.
+    *
+    * @param[in] matVertices           The surface on which distances should be calculated
+    * @param[in] vecNeighborVertices   The neighbor vertex information.
+    * @param[in] iRoot                 The root vertex
+    * @param[in] dCancelDistance       Distance threshold at which the search stops
+    * @param[in/out] vecMinDists       Workspace of the size of the mesh, must be infinity for all vertices on entry. Holds the distances on exit.
+    * @param[in/out] vecTouched        Workspace, the IDs of the vertices with a finite distance are appended.
+    * @param[in/out] vecHeap           Workspace for the binary heap.
+    */
+    static void boundedDijkstra(const Eigen::MatrixX3f &matVertices,
+                                const QVector<QVector<int> > &vecNeighborVertices,
+                                qint32 iRoot,
+                                double dCancelDistance,
+                                QVector<double> &vecMinDists,
+                                QVector<qint32> &vecTouched,
+                                std::vector<std::pair<double, qint32> > &vecHeap);
+
+    //=========================================================================================================
+    /**
+    * @brief badChannelColumns         Returns the column indices of the bad channels of the given sensor type in a distance table
+    *
+    * @param[in] fiffInfo              Container for sensors.
+    * @param[in] iSensorType           Sensor type to be filtered out, use fiff constants.
+    *
+    * @return Vector of bad channel indices.
+    */
+    static QVector<qint32> badChannelColumns(const FIFFLIB::FiffInfo& fiffInfo,
+                                             qint32 iSensorType);
 };
 
 
@@ -150,6 +150,74 @@ QSharedPointer<SparseMatrix<float> > Interpolation::createInterpolationMat(const
 }
 
 
+//*************************************************************************************************************
+
+QSharedPointer<SparseMatrix<float> > Interpolation::createInterpolationMat(const QVector<qint32> &vecProjectedSensors,
+                                                                           const QSharedPointer<SparseMatrix<double, RowMajor> > matDistanceTable,
+                                                                           double (*interpolationFunction) (double),
+                                                                           const double dCancelDist,
+                                                                           const QVector<qint32> &vecExcludeIndex)
+{
+
+    if(matDistanceTable->rows() == 0 && matDistanceTable->cols() == 0) {
+        qDebug() << "[WARNING] Interpolation::createInterpolationMat - received an empty distance table.";
+        return QSharedPointer<SparseMatrix<float> >::create();
+    }
+
+    // initialization
+    QSharedPointer<Eigen::SparseMatrix<float> > matInterpolationMatrix = QSharedPointer<SparseMatrix<float> >::create(matDistanceTable->rows(), vecProjectedSensors.size());
+
+    // temporary helper structure for filling sparse matrix
+    QVector<Triplet<float> > vecNonZeroEntries;
+    vecNonZeroEntries.reserve(matDistanceTable->nonZeros());
+    const qint32 iRows = matInterpolationMatrix->rows();
+
+    // insert all sensor nodes into set for faster lookup during later computation. Also consider bad channels here.
+    QSet<qint32> sensorLookup;
+    int idx = 0;
+
+    for(const qint32& s : vecProjectedSensors){
+        if(!vecExcludeIndex.contains(idx)){
+            sensorLookup.insert(s);
+        }
+        idx++;
+    }
+
+    QVector<QPair<qint32, float> > vecBelowThresh;
+
+    // main loop: go through all rows of distance table and calculate weights
+    for (qint32 r = 0; r < iRows; ++r) {
+        if (sensorLookup.contains(r) == false) {
+            // "normal" node, i.e. one which was not assigned a sensor. Only the stored distances need to be visited.
+            vecBelowThresh.clear();
+            float dWeightsSum = 0.0;
+
+            for (SparseMatrix<double, RowMajor>::InnerIterator it(*matDistanceTable, r); it; ++it) {
+                const float dDist = it.value();
+
+                if (dDist < dCancelDist) {
+                    const float dValueWeight = std::fabs(1.0 / interpolationFunction(dDist));
+                    dWeightsSum += dValueWeight;
+                    vecBelowThresh.push_back(qMakePair<qint32, float> (it.col(), dValueWeight));
+                }
+            }
+
+            for (const QPair<qint32, float> &qp : vecBelowThresh) {
+                vecNonZeroEntries.push_back(Eigen::Triplet<float> (r, qp.first, qp.second / dWeightsSum));
+            }
+        } else {
+            // a sensor has been assigned to this node, we do not need to interpolate anything
+            //(final vertex signal is equal to sensor input signal, thus factor 1)
+            vecNonZeroEntries.push_back(Eigen::Triplet<float> (r, vecProjectedSensors.indexOf(r), 1));
+        }
+    }
+
+    matInterpolationMatrix->setFromTriplets(vecNonZeroEntries.begin(), vecNonZeroEntries.end());
+
+    return matInterpolationMatrix;
+}
+
+
 //*************************************************************************************************************
 
 VectorXf Interpolation::interpolateSignal(const QSharedPointer<SparseMatrix<float> > matInterpolationMatrix,
@@ -182,6 +250,22 @@ VectorXf Interpolation::interpolateSignal(const SparseMatrix<float> &matInterpol
 }
 
 
+//*************************************************************************************************************
+
+MatrixXf Interpolation::interpolateSignals(const SparseMatrix<float> &matInterpolationMatrix,
+                                           const MatrixXf &matMeasurementData)
+{
+    if (matInterpolationMatrix.cols() != matMeasurementData.rows()) {
+        qDebug() << "[WARNING] Interpolation::interpolateSignals - Dimension mismatch. Return empty matrix...";
+        return MatrixXf();
+    }
+
+    MatrixXf matOut = matInterpolationMatrix * matMeasurementData;
+
+    return matOut;
+}
+
+
 //*************************************************************************************************************
 
 double Interpolation::linear(const double dIn)
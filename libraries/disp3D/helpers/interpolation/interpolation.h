@@ -134,6 +134,26 @@ public:
                                                                               const double dCancelDist = FLOAT_INFINITY,
                                                                               const QVector<qint32> &vecExcludeIndex = QVector<qint32>());
 
+    //=========================================================================================================
+    /**
+    * This method calculates the weight matrix from a sparse distance table as returned by GeometryInfo::scdcSparse.
+    * Missing entries of the distance table are treated as infinity. Since only the stored distances are visited,
+    * the runtime depends on the number of stored distances instead of vertices times sensors.
+    *
+    * @param[in] vecProjectedSensors           Vector of IDs of sensor vertices
+    * @param[in] matDistanceTable              Sparse row major matrix that contains all needed distances
+    * @param[in] interpolationFunction         Function that computes interpolation coefficients using the distance values
+    * @param[in] dCancelDist                   Distances higher than this are ignored, i.e. the respective coefficients are set to zero
+    * @param[in] vecExcludeIndex               The indices to be excluded from vecProjectedSensors, e.g., bad channels (empty by default)
+    *
+    * @return                                  The distance matrix created
+    */
+    static QSharedPointer<Eigen::SparseMatrix<float> > createInterpolationMat(const QVector<qint32> &vecProjectedSensors,
+                                                                              const QSharedPointer<Eigen::SparseMatrix<double, Eigen::RowMajor> > matDistanceTable,
+                                                                              double (*interpolationFunction) (double),
+                                                                              const double dCancelDist = FLOAT_INFINITY,
+                                                                              const QVector<qint32> &vecExcludeIndex = QVector<qint32>());
+
     //=========================================================================================================
     /**
     * The interpolation essentially corresponds to a matrix * vector multiplication. A vector of sensor data (i.e. a vector of double-values)
@@ -164,6 +184,19 @@ public:
     static Eigen::VectorXf interpolateSignal(const Eigen::SparseMatrix<float> &matInterpolationMatrix,
                                              const Eigen::VectorXf &vecMeasurementData);
 
+    //=========================================================================================================
+    /**
+    * Interpolates a whole block of frames at once. The block is multiplied as one sparse x dense product, which
+    * walks the weight matrix only once instead of once per frame.
+    *
+    * @param[in] matInterpolationMatrix    The weight matrix which should be used for multiplying
+    * @param[in] matMeasurementData        The measured sensor data, one frame per column
+    *
+    * @return                              Interpolated values for all vertices of the mesh, one frame per column
+    */
+    static Eigen::MatrixXf interpolateSignals(const Eigen::SparseMatrix<float> &matInterpolationMatrix,
+                                              const Eigen::MatrixXf &matMeasurementData);
+
     //=========================================================================================================
     /**
     * Serves as a placeholder for other functions and is needed in case a linear interpolation is wanted when calling <i>createInterplationMat</i>.Returns input argument unchanged.
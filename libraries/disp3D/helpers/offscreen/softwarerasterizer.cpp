@@ -0,0 +1,250 @@
+//=============================================================================================================
+/**
+* @file     softwarerasterizer.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SoftwareRasterizer class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "softwarerasterizer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace DISP3DLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SoftwareRasterizer::SoftwareRasterizer(const QSize& size)
+: m_iNumberMeshes(0)
+{
+    setSize(size);
+}
+
+
+//*************************************************************************************************************
+
+void SoftwareRasterizer::setSize(const QSize& size)
+{
+    m_size = size.expandedTo(QSize(1, 1));
+    clear();
+}
+
+
+//*************************************************************************************************************
+
+void SoftwareRasterizer::clear()
+{
+    Fragment emptyFragment;
+    emptyFragment.iMesh = -1;
+
+    m_iNumberMeshes = 0;
+    m_vecDepth.fill(-std::numeric_limits<float>::max(), m_size.width() * m_size.height());
+    m_vecFragments.fill(emptyFragment, m_size.width() * m_size.height());
+}
+
+
+//*************************************************************************************************************
+
+int SoftwareRasterizer::addMesh(const MatrixX3f& matVertScreen,
+                                const MatrixX3i& matTris)
+{
+    const int iWidth = m_size.width();
+    const int iHeight = m_size.height();
+    const int iMesh = m_iNumberMeshes++;
+
+    for(int t = 0; t < matTris.rows(); ++t) {
+        const int i0 = matTris(t,0);
+        const int i1 = matTris(t,1);
+        const int i2 = matTris(t,2);
+
+        if(i0 < 0 || i1 < 0 || i2 < 0
+           || i0 >= matVertScreen.rows() || i1 >= matVertScreen.rows() || i2 >= matVertScreen.rows()) {
+            continue;
+        }
+
+        const float x0 = matVertScreen(i0,0), y0 = matVertScreen(i0,1), z0 = matVertScreen(i0,2);
+        const float x1 = matVertScreen(i1,0), y1 = matVertScreen(i1,1), z1 = matVertScreen(i1,2);
+        const float x2 = matVertScreen(i2,0), y2 = matVertScreen(i2,1), z2 = matVertScreen(i2,2);
+
+        //Twice the signed area, both windings are accepted
+        const float fArea = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+        if(fArea == 0.0f) {
+            continue;
+        }
+        const float fInvArea = 1.0f / fArea;
+
+        //Bounding box of the pixel centers inside the image
+        const int iMinX = std::max(0, (int)std::ceil(std::min(x0, std::min(x1, x2)) - 0.5f));
+        const int iMaxX = std::min(iWidth - 1, (int)std::floor(std::max(x0, std::max(x1, x2)) - 0.5f));
+        const int iMinY = std::max(0, (int)std::ceil(std::min(y0, std::min(y1, y2)) - 0.5f));
+        const int iMaxY = std::min(iHeight - 1, (int)std::floor(std::max(y0, std::max(y1, y2)) - 0.5f));
+
+        for(int y = iMinY; y <= iMaxY; ++y) {
+            const float py = y + 0.5f;
+
+            for(int x = iMinX; x <= iMaxX; ++x) {
+                const float px = x + 0.5f;
+
+                //Barycentric weights from the edge functions
+                const float w0 = ((x1 - px) * (y2 - py) - (x2 - px) * (y1 - py)) * fInvArea;
+                const float w1 = ((x2 - px) * (y0 - py) - (x0 - px) * (y2 - py)) * fInvArea;
+                const float w2 = 1.0f - w0 - w1;
+
+                if(w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                    continue;
+                }
+
+                const float z = w0 * z0 + w1 * z1 + w2 * z2;
+                const int iPixel = y * iWidth + x;
+
+                if(z > m_vecDepth[iPixel]) {
+                    m_vecDepth[iPixel] = z;
+
+                    Fragment& fragment = m_vecFragments[iPixel];
+                    fragment.iMesh = iMesh;
+                    fragment.iVert[0] = i0;
+                    fragment.iVert[1] = i1;
+                    fragment.iVert[2] = i2;
+                    fragment.fWeight[0] = w0;
+                    fragment.fWeight[1] = w1;
+                    fragment.fWeight[2] = w2;
+                }
+            }
+        }
+    }
+
+    return iMesh;
+}
+
+
+//*************************************************************************************************************
+
+int SoftwareRasterizer::numberCoveredPixels() const
+{
+    int iCount = 0;
+
+    for(int i = 0; i < m_vecFragments.size(); ++i) {
+        if(m_vecFragments.at(i).iMesh >= 0) {
+            iCount++;
+        }
+    }
+
+    return iCount;
+}
+
+
+//*************************************************************************************************************
+
+QImage SoftwareRasterizer::render(const QList<MatrixX3f>& lVertColors,
+                                  const QColor& colBackground) const
+{
+    QImage image(m_size, QImage::Format_RGB32);
+    image.fill(colBackground);
+
+    if(lVertColors.size() < m_iNumberMeshes) {
+        qDebug() << "SoftwareRasterizer::render - Number of color matrices (" << lVertColors.size() << ") does not match the number of meshes (" << m_iNumberMeshes << "). Returning background only.";
+        return image;
+    }
+
+    const int iWidth = m_size.width();
+
+    for(int y = 0; y < m_size.height(); ++y) {
+        QRgb* pScanLine = reinterpret_cast<QRgb*>(image.scanLine(y));
+        const Fragment* pFragments = m_vecFragments.constData() + y * iWidth;
+
+        for(int x = 0; x < iWidth; ++x) {
+            const Fragment& fragment = pFragments[x];
+
+            if(fragment.iMesh < 0) {
+                continue;
+            }
+
+            const MatrixX3f& matColors = lVertColors.at(fragment.iMesh);
+
+            if(fragment.iVert[0] >= matColors.rows()
+               || fragment.iVert[1] >= matColors.rows()
+               || fragment.iVert[2] >= matColors.rows()) {
+                continue;
+            }
+
+            float fRgb[3];
+            for(int c = 0; c < 3; ++c) {
+                const float fValue = fragment.fWeight[0] * matColors(fragment.iVert[0],c)
+                                     + fragment.fWeight[1] * matColors(fragment.iVert[1],c)
+                                     + fragment.fWeight[2] * matColors(fragment.iVert[2],c);
+                fRgb[c] = std::min(std::max(fValue, 0.0f), 1.0f);
+            }
+
+            pScanLine[x] = qRgb((int)(fRgb[0] * 255.0f + 0.5f),
+                                (int)(fRgb[1] * 255.0f + 0.5f),
+                                (int)(fRgb[2] * 255.0f + 0.5f));
+        }
+    }
+
+    return image;
+}
@@ -0,0 +1,197 @@
+//=============================================================================================================
+/**
+* @file     softwarerasterizer.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SoftwareRasterizer class declaration.
+*
+*/
+
+#ifndef DISP3DLIB_SOFTWARERASTERIZER_H
+#define DISP3DLIB_SOFTWARERASTERIZER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../../disp3D_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QList>
+#include <QSize>
+#include <QImage>
+#include <QColor>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE DISP3DLIB
+//=============================================================================================================
+
+namespace DISP3DLIB {
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DISP3DLIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+
+//=============================================================================================================
+/**
+* Rasterizes triangle meshes on the CPU, without any OpenGL context or window system. Since the geometry of a
+* source movie does not change from frame to frame, the meshes are rasterized only once into a visibility buffer,
+* which stores the covering triangle and its barycentric weights for every pixel. Rendering a frame then only
+* blends the per vertex colors of the visible triangles, which is cheap and can be done for many frames in parallel.
+*
+* @brief Headless z-buffered rasterizer for meshes with per vertex colors.
+*/
+
+class DISP3DSHARED_EXPORT SoftwareRasterizer
+{
+
+public:
+    typedef QSharedPointer<SoftwareRasterizer> SPtr;            /**< Shared pointer type for SoftwareRasterizer. */
+    typedef QSharedPointer<const SoftwareRasterizer> ConstSPtr; /**< Const shared pointer type for SoftwareRasterizer. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a SoftwareRasterizer object.
+    *
+    * @param[in] size       The size of the rendered images in pixels.
+    */
+    explicit SoftwareRasterizer(const QSize& size = QSize(800, 600));
+
+    //=========================================================================================================
+    /**
+    * Sets the size of the rendered images and clears all rasterized meshes.
+    *
+    * @param[in] size       The size of the rendered images in pixels.
+    */
+    void setSize(const QSize& size);
+
+    //=========================================================================================================
+    /**
+    * Returns the size of the rendered images.
+    *
+    * @return               The size in pixels.
+    */
+    inline QSize size() const;
+
+    //=========================================================================================================
+    /**
+    * Clears the depth and visibility buffers.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Rasterizes a mesh into the visibility buffer. The vertices are given in screen space, i.e. x and y in pixels
+    * with the origin in the upper left corner and z as depth, where larger values are closer to the viewer.
+    * No back face culling is done.
+    *
+    * @param[in] matVertScreen      The vertices in screen space.
+    * @param[in] matTris            The triangles, given as vertex indices.
+    *
+    * @return                       The index of the mesh which is used to pick its colors in render().
+    */
+    int addMesh(const Eigen::MatrixX3f& matVertScreen,
+                const Eigen::MatrixX3i& matTris);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of pixels which are covered by any mesh.
+    *
+    * @return               The number of covered pixels.
+    */
+    int numberCoveredPixels() const;
+
+    //=========================================================================================================
+    /**
+    * Renders an image by interpolating the vertex colors of the visible triangles. This function is thread safe
+    * and can be called for several frames in parallel.
+    *
+    * @param[in] lVertColors        The RGB colors [0,1] per vertex, one matrix per mesh in the order they were added.
+    * @param[in] colBackground      The color of pixels not covered by any mesh.
+    *
+    * @return                       The rendered image in QImage::Format_RGB32.
+    */
+    QImage render(const QList<Eigen::MatrixX3f>& lVertColors,
+                  const QColor& colBackground = Qt::black) const;
+
+private:
+    struct Fragment {
+        qint32  iMesh;                      /**< The mesh index, -1 if the pixel is not covered. */
+        qint32  iVert[3];                   /**< The vertex indices of the visible triangle. */
+        float   fWeight[3];                 /**< The barycentric weights of the vertices. */
+    };
+
+    QSize                   m_size;         /**< The image size. */
+    int                     m_iNumberMeshes;/**< The number of rasterized meshes. */
+    QVector<float>          m_vecDepth;     /**< The depth buffer, one value per pixel. */
+    QVector<Fragment>       m_vecFragments; /**< The visibility buffer, one fragment per pixel. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline QSize SoftwareRasterizer::size() const
+{
+    return m_size;
+}
+
+} // namespace DISP3DLIB
+
+#endif // DISP3DLIB_SOFTWARERASTERIZER_H
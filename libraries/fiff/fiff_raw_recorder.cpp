@@ -0,0 +1,320 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_recorder.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRawRecorder class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_recorder.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawRecorder::FiffRawRecorder(int iQueueSize, QObject *parent)
+: QThread(parent)
+, m_vecQueue(qMax(iQueueSize, 1) + 1)
+, m_iHead(0)
+, m_iTail(0)
+, m_iDroppedBlocks(0)
+, m_iDroppedSamples(0)
+, m_bIsRecording(false)
+, m_bStopRequested(false)
+, m_iStorageType(FIFFT_FLOAT)
+, m_iBatchSize(16)
+, m_syncPolicy(NoSync)
+, m_iSyncIntervalMSec(1000)
+{
+}
+
+
+//*************************************************************************************************************
+
+FiffRawRecorder::~FiffRawRecorder()
+{
+    if(isRunning()) {
+        stopRecording();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawRecorder::setBatchSize(int iBatchSize)
+{
+    m_iBatchSize = qMax(iBatchSize, 1);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawRecorder::setSyncPolicy(SyncPolicy policy, int iSyncIntervalMSec)
+{
+    m_syncPolicy = policy;
+    m_iSyncIntervalMSec = iSyncIntervalMSec;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawRecorder::setStorageType(fiff_int_t type)
+{
+    if(type != FIFFT_FLOAT && type != FIFFT_INT && type != FIFFT_SHORT && type != FIFFT_DAU_PACK16) {
+        qWarning() << "FiffRawRecorder::setStorageType - Data type" << type << "is not supported for raw buffers.";
+        return;
+    }
+
+    m_iStorageType = type;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawRecorder::startRecording(FiffRollingRawWriter::SPtr pWriter, const RowVectorXd& cals)
+{
+    if(isRunning()) {
+        qWarning() << "FiffRawRecorder::startRecording - Recording is already running.";
+        return false;
+    }
+
+    if(!pWriter || !pWriter->isOpen()) {
+        qWarning() << "FiffRawRecorder::startRecording - No started writer to write to.";
+        return false;
+    }
+
+    m_pWriter = pWriter;
+    m_vecCals = cals;
+    m_iHead.store(0);
+    m_iTail.store(0);
+    m_iDroppedBlocks.store(0);
+    m_iDroppedSamples.store(0);
+    m_bStopRequested.store(false);
+    m_bIsRecording.storeRelease(true);
+
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawRecorder::stopRecording()
+{
+    m_bIsRecording.storeRelease(false);
+    m_bStopRequested.storeRelease(true);
+
+    QThread::wait();
+
+    if(m_iDroppedBlocks.load() > 0) {
+        qWarning() << "FiffRawRecorder::stopRecording - Dropped" << m_iDroppedBlocks.load() << "blocks with" << m_iDroppedSamples.load() << "samples.";
+    }
+
+    m_pWriter.clear();
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+bool FiffRawRecorder::enqueue(const MatrixBase<T>& matData)
+{
+    if(!m_bIsRecording.loadAcquire()) {
+        return false;
+    }
+
+    int iHead = m_iHead.load();
+    int iNext = (iHead + 1) % m_vecQueue.size();
+
+    if(iNext == m_iTail.loadAcquire()) {
+        m_iDroppedBlocks.fetchAndAddRelaxed(1);
+        m_iDroppedSamples.fetchAndAddRelaxed(matData.cols());
+        return false;
+    }
+
+    // The slots keep their memory, so blocks of constant size are copied without allocation
+    m_vecQueue[iHead] = matData;
+    m_iHead.storeRelease(iNext);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawRecorder::write(const MatrixXf& matData)
+{
+    return enqueue(matData);
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawRecorder::write(const MatrixXd& matData)
+{
+    return enqueue(matData.cast<float>());
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawRecorder::isRecording() const
+{
+    return m_bIsRecording.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+int FiffRawRecorder::queueDepth() const
+{
+    return (m_iHead.loadAcquire() - m_iTail.loadAcquire() + m_vecQueue.size()) % m_vecQueue.size();
+}
+
+
+//*************************************************************************************************************
+
+int FiffRawRecorder::droppedBlocks() const
+{
+    return m_iDroppedBlocks.load();
+}
+
+
+//*************************************************************************************************************
+
+int FiffRawRecorder::droppedSamples() const
+{
+    return m_iDroppedSamples.load();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawRecorder::run()
+{
+    QElapsedTimer syncTimer;
+    syncTimer.start();
+
+    while(true) {
+        bool bStop = m_bStopRequested.loadAcquire();
+
+        if(writeBatch() == 0) {
+            if(bStop) {
+                break;
+            }
+
+            msleep(2);
+            continue;
+        }
+
+        if(m_syncPolicy == SyncPerBatch || (m_syncPolicy == SyncPeriodic && syncTimer.elapsed() >= m_iSyncIntervalMSec)) {
+            syncToDisk();
+            syncTimer.restart();
+        }
+    }
+
+    if(m_syncPolicy != NoSync) {
+        syncToDisk();
+    }
+}
+
+
+//*************************************************************************************************************
+
+int FiffRawRecorder::writeBatch()
+{
+    const int iQueueSize = m_vecQueue.size();
+    int iTail = m_iTail.load();
+    int iAvailable = (m_iHead.loadAcquire() - iTail + iQueueSize) % iQueueSize;
+
+    if(iAvailable == 0) {
+        return 0;
+    }
+
+    // Collect consecutive blocks with the same number of channels
+    const int iRows = m_vecQueue.at(iTail).rows();
+    int iBlocks = 0;
+    int iCols = 0;
+
+    while(iBlocks < qMin(iAvailable, m_iBatchSize) && m_vecQueue.at((iTail + iBlocks) % iQueueSize).rows() == iRows) {
+        iCols += m_vecQueue.at((iTail + iBlocks) % iQueueSize).cols();
+        ++iBlocks;
+    }
+
+    m_matBatch.resize(iRows, iCols);
+
+    int iCol = 0;
+    for(int i = 0; i < iBlocks; ++i) {
+        const MatrixXf& matBlock = m_vecQueue.at((iTail + i) % iQueueSize);
+        m_matBatch.middleCols(iCol, matBlock.cols()) = matBlock;
+        iCol += matBlock.cols();
+    }
+
+    // Hand the slots back to the producer before touching the disk
+    m_iTail.storeRelease((iTail + iBlocks) % iQueueSize);
+
+    m_pWriter->write(m_matBatch, m_vecCals.size() == iRows ? m_vecCals : RowVectorXd(), m_iStorageType);
+
+    return iBlocks;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawRecorder::syncToDisk()
+{
+    m_pWriter->flush(true);
+}
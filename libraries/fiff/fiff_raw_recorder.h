@@ -0,0 +1,269 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_recorder.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRawRecorder class declaration.
+*
+*/
+
+#ifndef FIFF_RAW_RECORDER_H
+#define FIFF_RAW_RECORDER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_rolling_raw_writer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+
+//=============================================================================================================
+/**
+* Writes raw data buffers to a FiffRollingRawWriter on a dedicated thread. The acquisition thread hands its data blocks
+* over with write(), which only copies the block into a preallocated single producer/single consumer ring and
+* never waits for the disk. The recorder thread drains the ring, concatenates several blocks to one raw
+* buffer per write and optionally syncs the file to disk. If the ring is full the block is dropped and counted.
+*
+* @brief Asynchronous raw data recorder.
+*/
+class FIFFSHARED_EXPORT FiffRawRecorder : public QThread
+{
+    Q_OBJECT
+
+public:
+    typedef QSharedPointer<FiffRawRecorder> SPtr;            /**< Shared pointer type for FiffRawRecorder. */
+    typedef QSharedPointer<const FiffRawRecorder> ConstSPtr; /**< Const shared pointer type for FiffRawRecorder. */
+
+    /**
+    * When the written data is synced to disk.
+    */
+    enum SyncPolicy {
+        NoSync,         /**< Leave flushing to the operating system. */
+        SyncPerBatch,   /**< Sync after every written batch. */
+        SyncPeriodic    /**< Sync after a given time interval. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a FiffRawRecorder.
+    *
+    * @param[in] iQueueSize     Number of data blocks the queue can hold before blocks are dropped.
+    * @param[in] parent         Parent QObject (optional).
+    */
+    explicit FiffRawRecorder(int iQueueSize = 256, QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the FiffRawRecorder. A running recording is stopped, the writer is not finished.
+    */
+    ~FiffRawRecorder();
+
+    //=========================================================================================================
+    /**
+    * Sets the maximal number of queued blocks which are written as one raw buffer.
+    *
+    * @param[in] iBatchSize     Maximal number of blocks per buffer.
+    */
+    void setBatchSize(int iBatchSize);
+
+    //=========================================================================================================
+    /**
+    * Sets when the written data is synced to disk.
+    *
+    * @param[in] policy             The sync policy.
+    * @param[in] iSyncIntervalMSec  The interval for SyncPeriodic in milliseconds.
+    */
+    void setSyncPolicy(SyncPolicy policy, int iSyncIntervalMSec = 1000);
+
+    //=========================================================================================================
+    /**
+    * Sets the data type the raw buffers are stored with. The integer types store the data divided by the
+    * calibration factors, rounded and clipped to the range of the type.
+    *
+    * @param[in] type       FIFFT_FLOAT (default), FIFFT_INT, FIFFT_SHORT or FIFFT_DAU_PACK16.
+    */
+    void setStorageType(fiff_int_t type);
+
+    //=========================================================================================================
+    /**
+    * Starts recording to the given writer. The writer has to be started already and must not be used by
+    * other threads until the recording is stopped. File splitting is done by the writer.
+    *
+    * @param[in] pWriter    The writer to write to.
+    * @param[in] cals       The calibration factors, empty for writing uncalibrated data.
+    *
+    * @return true if the recording was started, false otherwise.
+    */
+    bool startRecording(FiffRollingRawWriter::SPtr pWriter, const Eigen::RowVectorXd& cals = Eigen::RowVectorXd());
+
+    //=========================================================================================================
+    /**
+    * Stops recording. All queued blocks are written before this function returns. The writer is not
+    * finished, so that the caller can still write to it or finish it.
+    */
+    void stopRecording();
+
+    //=========================================================================================================
+    /**
+    * Queues a data block for writing. Never blocks, if the queue is full the block is dropped.
+    * Must only be called from one thread at a time.
+    *
+    * @param[in] matData    The data block, channels x samples.
+    *
+    * @return true if the block was queued, false if it was dropped or no recording is running.
+    */
+    bool write(const Eigen::MatrixXf& matData);
+
+    //=========================================================================================================
+    /**
+    * Queues a double precision data block for writing. The block is stored in single precision, which is the
+    * precision of the written raw buffers. Never blocks, if the queue is full the block is dropped.
+    * Must only be called from one thread at a time.
+    *
+    * @param[in] matData    The data block, channels x samples.
+    *
+    * @return true if the block was queued, false if it was dropped or no recording is running.
+    */
+    bool write(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Returns whether a recording is running.
+    *
+    * @return true if recording.
+    */
+    bool isRecording() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of blocks which are queued but not written yet.
+    *
+    * @return The queue depth.
+    */
+    int queueDepth() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of blocks which were dropped since the recording was started.
+    *
+    * @return The number of dropped blocks.
+    */
+    int droppedBlocks() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples which were dropped since the recording was started.
+    *
+    * @return The number of dropped samples.
+    */
+    int droppedSamples() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * The recorder loop. Writes the queued blocks until the recording is stopped and the queue is empty.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Writes up to the batch size of queued blocks as one raw buffer.
+    *
+    * @return The number of written blocks.
+    */
+    int writeBatch();
+
+    //=========================================================================================================
+    /**
+    * Copies a data block into the next free slot of the queue.
+    *
+    * @param[in] matData    The data block, channels x samples.
+    *
+    * @return true if the block was queued, false if it was dropped or no recording is running.
+    */
+    template<typename T>
+    bool enqueue(const Eigen::MatrixBase<T>& matData);
+
+    //=========================================================================================================
+    /**
+    * Writes the directory of the current file and syncs the file to disk.
+    */
+    void syncToDisk();
+
+    QVector<Eigen::MatrixXf>    m_vecQueue;             /**< The ring of queued blocks. */
+    QAtomicInt                  m_iHead;                /**< Next slot the producer writes to. */
+    QAtomicInt                  m_iTail;                /**< Next slot the recorder thread reads from. */
+    QAtomicInt                  m_iDroppedBlocks;       /**< Number of dropped blocks. */
+    QAtomicInt                  m_iDroppedSamples;      /**< Number of dropped samples. */
+    QAtomicInt                  m_bIsRecording;         /**< Whether blocks are accepted. */
+    QAtomicInt                  m_bStopRequested;       /**< Whether the recorder thread should stop once the queue is empty. */
+
+    FiffRollingRawWriter::SPtr  m_pWriter;              /**< The writer which is written to. */
+    Eigen::RowVectorXd          m_vecCals;              /**< The calibration factors. */
+    Eigen::MatrixXf             m_matBatch;             /**< The concatenated blocks of one batch. */
+    fiff_int_t                  m_iStorageType;         /**< The data type of the written raw buffers. */
+    int                         m_iBatchSize;           /**< Maximal number of blocks per raw buffer. */
+    SyncPolicy                  m_syncPolicy;           /**< When the data is synced to disk. */
+    int                         m_iSyncIntervalMSec;    /**< Interval for SyncPeriodic in milliseconds. */
+};
+
+} // NAMESPACE FIFFLIB
+
+#endif // FIFF_RAW_RECORDER_H
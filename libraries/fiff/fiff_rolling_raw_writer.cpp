@@ -0,0 +1,505 @@
+//=============================================================================================================
+/**
+* @file     fiff_rolling_raw_writer.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRollingRawWriter class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_rolling_raw_writer.h"
+#include "fiff_file.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QFileInfo>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRollingRawWriter::FiffRollingRawWriter()
+: m_iMaxFileSize(2000000000)
+, m_dMaxFileDuration(0.0)
+, m_iPreallocationSize(0)
+, m_iDirPointerPos(-1)
+, m_iTrailerPos(-1)
+, m_iTrailerEnd(-1)
+, m_bIndexWritten(false)
+, m_bResetRange(true)
+, m_iFirstSample(0)
+, m_iSamplesWritten(0)
+, m_iFileSamples(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+FiffRollingRawWriter::~FiffRollingRawWriter()
+{
+    if(isOpen()) {
+        finish();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::setMaxFileSize(qint64 iMaxFileSize)
+{
+    //The directory entries store the tag positions as 32 bit integers
+    m_iMaxFileSize = qBound(qint64(0), iMaxFileSize, qint64(2147483647));
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::setMaxFileDuration(double dMaxFileDuration)
+{
+    m_dMaxFileDuration = qMax(dMaxFileDuration, 0.0);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::setPreallocationSize(qint64 iPreallocationSize)
+{
+    m_iPreallocationSize = qMax(iPreallocationSize, qint64(0));
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRollingRawWriter::start(const QString& sFileName,
+                                 const FiffInfo& info,
+                                 RowVectorXd& cals,
+                                 fiff_int_t iFirstSample,
+                                 bool bResetRange)
+{
+    if(isOpen()) {
+        qWarning() << "FiffRollingRawWriter::start - A recording is already running.";
+        return false;
+    }
+
+    m_info = info;
+    m_sFileName = sFileName;
+    m_lFileNames.clear();
+    m_bResetRange = bResetRange;
+    m_iFirstSample = iFirstSample;
+    m_iSamplesWritten = 0;
+
+    if(!openFile(sFileName, QString())) {
+        return false;
+    }
+
+    cals = m_vecCals;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRollingRawWriter::write(const MatrixXf& buf, const RowVectorXd& cals, fiff_int_t type)
+{
+    if(!isOpen()) {
+        qWarning() << "FiffRollingRawWriter::write - No recording is running.";
+        return false;
+    }
+
+    qint64 iBufferSize = 16 + buf.size() * ((type == FIFFT_SHORT || type == FIFFT_DAU_PACK16) ? 2 : 4);
+
+    //Leave room for the reference block, the trailer and the directory
+    qint64 iReserve = 1024 + (m_lDirEntries.size() + 16) * 16;
+
+    bool bExceedsSize = m_iMaxFileSize > 0 && m_iTrailerPos + iBufferSize + iReserve > m_iMaxFileSize;
+    bool bExceedsDuration = m_dMaxFileDuration > 0.0 && m_iFileSamples + buf.cols() > qRound64(m_dMaxFileDuration * m_info.sfreq);
+
+    if(m_iFileSamples > 0 && (bExceedsSize || bExceedsDuration)) {
+        if(!splitFile()) {
+            return false;
+        }
+    }
+
+    //The directory is overwritten by the new data, so the pointer to it has to be invalidated first
+    if(m_bIndexWritten) {
+        m_pStream->write_dir_pointer(-1, m_iDirPointerPos);
+        m_bIndexWritten = false;
+    }
+
+    m_pStream->device()->seek(m_iTrailerPos);
+
+    bool bWritten;
+    if(cals.size() > 0) {
+        bWritten = m_pStream->write_raw_buffer(buf, cals, type);
+    } else if(type == FIFFT_FLOAT) {
+        bWritten = m_pStream->write_raw_buffer(buf);
+    } else {
+        bWritten = m_pStream->write_raw_buffer(buf, RowVectorXd::Ones(buf.rows()), type);
+    }
+
+    if(!bWritten) {
+        writeTrailer();
+        return false;
+    }
+
+    appendEntry(FIFF_DATA_BUFFER, type, iBufferSize - 16, m_iTrailerPos);
+    m_iFileSamples += buf.cols();
+    m_iSamplesWritten += buf.cols();
+
+    writeTrailer();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::flush(bool bSyncToDisk)
+{
+    if(!isOpen()) {
+        return;
+    }
+
+    writeIndex();
+
+    m_pFile->flush();
+
+    if(bSyncToDisk) {
+#ifdef Q_OS_WIN
+        _commit(m_pFile->handle());
+#else
+        fsync(m_pFile->handle());
+#endif
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::finish()
+{
+    if(!isOpen()) {
+        return;
+    }
+
+    closeFile();
+
+    printf("Wrote %lld samples to %d file(s).\n", m_iSamplesWritten, m_lFileNames.size());
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRollingRawWriter::isOpen() const
+{
+    return m_pStream && m_pFile && m_pFile->isOpen();
+}
+
+
+//*************************************************************************************************************
+
+QStringList FiffRollingRawWriter::fileNames() const
+{
+    return m_lFileNames;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffRollingRawWriter::samplesWritten() const
+{
+    return m_iSamplesWritten;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRollingRawWriter::openFile(const QString& sFileName, const QString& sPrevFileName)
+{
+    m_pFile = QSharedPointer<QFile>(new QFile(sFileName));
+
+    //start_writing_raw does not handle a file which cannot be opened
+    if(!m_pFile->open(QIODevice::WriteOnly)) {
+        qWarning() << "FiffRollingRawWriter::openFile - Could not open" << sFileName;
+        m_pFile.clear();
+        return false;
+    }
+    m_pFile->close();
+
+    m_pStream = FiffStream::start_writing_raw(*m_pFile, m_info, m_vecCals, defaultMatrixXi, m_bResetRange);
+
+    if(m_iPreallocationSize > 0) {
+#ifdef Q_OS_LINUX
+        m_pFile->flush();
+        if(posix_fallocate(m_pFile->handle(), 0, m_iPreallocationSize) != 0) {
+            qWarning() << "FiffRollingRawWriter::openFile - Could not preallocate" << m_iPreallocationSize << "bytes for" << sFileName;
+        }
+#else
+        if(!m_pFile->resize(m_iPreallocationSize)) {
+            qWarning() << "FiffRollingRawWriter::openFile - Could not preallocate" << m_iPreallocationSize << "bytes for" << sFileName;
+        }
+#endif
+    }
+
+    fiff_int_t first = m_iFirstSample + fiff_int_t(m_iSamplesWritten);
+    m_pStream->write_int(FIFF_FIRST_SAMPLE, &first);
+
+    if(!sPrevFileName.isEmpty()) {
+        writeReference(FIFFV_ROLE_PREV_FILE, sPrevFileName, m_lFileNames.size() - 1);
+    }
+
+    writeTrailer();
+    m_pFile->flush();
+
+    //Read back the directory of the header, the data tags are tracked while writing
+    m_lDirEntries.clear();
+    m_iDirPointerPos = -1;
+
+    QFile t_file(sFileName);
+    FiffStream t_stream(&t_file);
+
+    if(t_stream.open()) {
+        for(int i = 0; i < t_stream.dir().size(); ++i) {
+            const FiffDirEntry::SPtr& pEntry = t_stream.dir().at(i);
+
+            if(pEntry->kind == FIFF_DIR_POINTER) {
+                m_iDirPointerPos = pEntry->pos;
+            }
+
+            if(pEntry->kind != -1 && pEntry->pos < m_iTrailerPos) {
+                m_lDirEntries.append(pEntry);
+            }
+        }
+
+        t_stream.close();
+    }
+
+    if(m_iDirPointerPos < 0) {
+        qWarning() << "FiffRollingRawWriter::openFile - Could not read back the header of" << sFileName << ". No directory will be written.";
+    }
+
+    m_lFileNames.append(sFileName);
+    m_bIndexWritten = false;
+    m_iFileSamples = 0;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::closeFile()
+{
+    writeIndex();
+
+    //Cut off the preallocated space
+    if(m_pFile->size() > m_pStream->device()->pos()) {
+        m_pFile->resize(m_pStream->device()->pos());
+    }
+
+    m_pStream->close();
+    m_pStream.clear();
+    m_pFile.clear();
+    m_lDirEntries.clear();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRollingRawWriter::splitFile()
+{
+    QString sCurrentFileName = m_lFileNames.last();
+    QString sNextFileName = partFileName(m_lFileNames.size());
+
+    if(m_bIndexWritten) {
+        m_pStream->write_dir_pointer(-1, m_iDirPointerPos);
+        m_bIndexWritten = false;
+    }
+
+    //Link the current file to the next one from within the raw data block
+    m_pStream->device()->seek(m_iTrailerPos);
+    writeReference(FIFFV_ROLE_NEXT_FILE, sNextFileName, m_lFileNames.size());
+    writeTrailer();
+
+    closeFile();
+
+    printf("Splitting recording, continuing in %s\n", sNextFileName.toUtf8().constData());
+
+    return openFile(sNextFileName, sCurrentFileName);
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::writeReference(fiff_int_t role, const QString& sFileName, fiff_int_t iFileNum)
+{
+    //The parts are stored next to each other, so only the name without the path is referenced
+    QString sName = QFileInfo(sFileName).fileName();
+    fiff_int_t data;
+
+    appendEntry(FIFF_BLOCK_START, FIFFT_INT, 4, m_pStream->start_block(FIFFB_REF));
+    data = role;
+    appendEntry(FIFF_REF_ROLE, FIFFT_INT, 4, m_pStream->write_int(FIFF_REF_ROLE, &data));
+    appendEntry(FIFF_REF_FILE_NAME, FIFFT_STRING, sName.toUtf8().size(), m_pStream->write_string(FIFF_REF_FILE_NAME, sName));
+    if(m_info.meas_id.version != -1) {
+        appendEntry(FIFF_REF_FILE_ID, FIFFT_ID_STRUCT, FiffId::storageSize(), m_pStream->write_id(FIFF_REF_FILE_ID, m_info.meas_id));
+    }
+    data = iFileNum;
+    appendEntry(FIFF_REF_FILE_NUM, FIFFT_INT, 4, m_pStream->write_int(FIFF_REF_FILE_NUM, &data));
+    appendEntry(FIFF_BLOCK_END, FIFFT_INT, 4, m_pStream->end_block(FIFFB_REF));
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::writeTrailer()
+{
+    m_iTrailerPos = m_pStream->device()->pos();
+
+    m_pStream->end_block(FIFFB_RAW_DATA);
+    m_pStream->end_block(FIFFB_MEAS);
+    m_pStream->end_file();
+
+    m_iTrailerEnd = m_pStream->device()->pos();
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::writeIndex()
+{
+    if(m_iDirPointerPos < 0) {
+        m_pStream->device()->seek(m_iTrailerEnd);
+        return;
+    }
+
+    QList<FiffDirEntry::SPtr> dir = m_lDirEntries + trailerEntries();
+
+    FiffDirEntry::SPtr pTerminator(new FiffDirEntry);
+    pTerminator->kind = -1;
+    pTerminator->type = -1;
+    pTerminator->size = -1;
+    pTerminator->pos = -1;
+    dir.append(pTerminator);
+
+    fiff_long_t dirpos = m_pStream->write_dir_entries(dir, m_iTrailerEnd);
+    fiff_long_t dirend = m_pStream->device()->pos();
+
+    m_pStream->write_dir_pointer(fiff_int_t(dirpos), m_iDirPointerPos);
+    m_pStream->device()->seek(dirend);
+
+    m_bIndexWritten = true;
+}
+
+
+//*************************************************************************************************************
+
+QList<FiffDirEntry::SPtr> FiffRollingRawWriter::trailerEntries() const
+{
+    QList<FiffDirEntry::SPtr> entries;
+
+    //Two block ends with one integer each, followed by the closing FIFF_NOP
+    for(int i = 0; i < 3; ++i) {
+        FiffDirEntry::SPtr pEntry(new FiffDirEntry);
+        pEntry->kind = i < 2 ? FIFF_BLOCK_END : FIFF_NOP;
+        pEntry->type = i < 2 ? FIFFT_INT : FIFFT_VOID;
+        pEntry->size = i < 2 ? 4 : 0;
+        pEntry->pos = fiff_int_t(m_iTrailerPos + i * 20);
+        entries.append(pEntry);
+    }
+
+    return entries;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRollingRawWriter::appendEntry(fiff_int_t kind, fiff_int_t type, fiff_int_t size, fiff_long_t pos)
+{
+    FiffDirEntry::SPtr pEntry(new FiffDirEntry);
+    pEntry->kind = kind;
+    pEntry->type = type;
+    pEntry->size = size;
+    pEntry->pos = fiff_int_t(pos);
+
+    m_lDirEntries.append(pEntry);
+}
+
+
+//*************************************************************************************************************
+
+QString FiffRollingRawWriter::partFileName(int iPart) const
+{
+    if(iPart == 0) {
+        return m_sFileName;
+    }
+
+    QString sFileName = m_sFileName;
+
+    if(sFileName.endsWith("_raw.fif")) {
+        sFileName.chop(8);
+        return sFileName + QString("-%1_raw.fif").arg(iPart);
+    }
+
+    if(sFileName.endsWith(".fif")) {
+        sFileName.chop(4);
+    }
+
+    return sFileName + QString("-%1.fif").arg(iPart);
+}
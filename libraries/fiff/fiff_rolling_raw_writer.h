@@ -0,0 +1,306 @@
+//=============================================================================================================
+/**
+* @file     fiff_rolling_raw_writer.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRollingRawWriter class declaration.
+*
+*/
+
+#ifndef FIFF_ROLLING_RAW_WRITER_H
+#define FIFF_ROLLING_RAW_WRITER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_stream.h"
+#include "fiff_info.h"
+#include "fiff_dir_entry.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QList>
+#include <QSharedPointer>
+#include <QStringList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+
+//=============================================================================================================
+/**
+* Writes a raw data recording to one or more FIFF files. A new part is started when the current file would
+* exceed a maximal size or duration. The parts are linked with FIFFB_REF blocks and are named like the first
+* file with a part index appended, e.g. rec_raw.fif, rec-1_raw.fif, rec-2_raw.fif.
+*
+* Every written buffer is followed by the closing tags of the file, so that a file whose recording was
+* interrupted can still be read. The tag directory is kept in memory and written on flush() and when a file
+* is closed, which lets readers open the file without scanning all tags.
+*
+* The writer is not thread safe, all calls have to come from the same thread.
+*
+* @brief Raw data writer which splits a recording into several files.
+*/
+class FIFFSHARED_EXPORT FiffRollingRawWriter
+{
+public:
+    typedef QSharedPointer<FiffRollingRawWriter> SPtr;            /**< Shared pointer type for FiffRollingRawWriter. */
+    typedef QSharedPointer<const FiffRollingRawWriter> ConstSPtr; /**< Const shared pointer type for FiffRollingRawWriter. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a FiffRollingRawWriter.
+    */
+    FiffRollingRawWriter();
+
+    //=========================================================================================================
+    /**
+    * Destroys the FiffRollingRawWriter. A running recording is finished.
+    */
+    ~FiffRollingRawWriter();
+
+    //=========================================================================================================
+    /**
+    * Sets the maximal size of one file. The size is limited to 2GB since tag positions are stored as 32 bit.
+    *
+    * @param[in] iMaxFileSize       Maximal file size in bytes, 0 disables splitting by size.
+    */
+    void setMaxFileSize(qint64 iMaxFileSize);
+
+    //=========================================================================================================
+    /**
+    * Sets the maximal duration of the data in one file.
+    *
+    * @param[in] dMaxFileDuration   Maximal duration in seconds, 0 disables splitting by duration.
+    */
+    void setMaxFileDuration(double dMaxFileDuration);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of bytes which are allocated on disk when a file is created. Allocating the file extents
+    * in advance avoids fragmentation and metadata updates while recording. The file is truncated to its
+    * actual size when it is closed.
+    *
+    * @param[in] iPreallocationSize Number of bytes to allocate, 0 disables the preallocation.
+    */
+    void setPreallocationSize(qint64 iPreallocationSize);
+
+    //=========================================================================================================
+    /**
+    * Creates the first file and writes the measurement info.
+    *
+    * @param[in] sFileName      The name of the first file.
+    * @param[in] info           The measurement info.
+    * @param[out] cals          The calibration factors of the channels.
+    * @param[in] iFirstSample   The first sample of the recording.
+    * @param[in] bResetRange    Whether the channel range is reset to 1.
+    *
+    * @return true if the file was created, false otherwise.
+    */
+    bool start(const QString& sFileName,
+               const FiffInfo& info,
+               Eigen::RowVectorXd& cals,
+               fiff_int_t iFirstSample = 0,
+               bool bResetRange = true);
+
+    //=========================================================================================================
+    /**
+    * Writes a raw data buffer. Starts a new file before if the buffer would exceed the size or duration
+    * limit of the current one.
+    *
+    * @param[in] buf    The data buffer, channels x samples.
+    * @param[in] cals   The calibration factors, empty for writing the data as it is.
+    * @param[in] type   The data type of the stored buffer, see FiffStream::write_raw_buffer.
+    *
+    * @return true if the buffer was written, false otherwise.
+    */
+    bool write(const Eigen::MatrixXf& buf,
+               const Eigen::RowVectorXd& cals = Eigen::RowVectorXd(),
+               fiff_int_t type = FIFFT_FLOAT);
+
+    //=========================================================================================================
+    /**
+    * Writes the tag directory of the current file and flushes the file.
+    *
+    * @param[in] bSyncToDisk    Whether the file is also synced to disk.
+    */
+    void flush(bool bSyncToDisk = false);
+
+    //=========================================================================================================
+    /**
+    * Writes the tag directory and closes the current file.
+    */
+    void finish();
+
+    //=========================================================================================================
+    /**
+    * Returns whether a file is open for writing.
+    *
+    * @return true if a recording is running.
+    */
+    bool isOpen() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the names of all files which were written since start().
+    *
+    * @return The file names.
+    */
+    QStringList fileNames() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples which were written since start().
+    *
+    * @return The number of samples.
+    */
+    qint64 samplesWritten() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Creates a file, writes the header and reads back its tag directory.
+    *
+    * @param[in] sFileName      The name of the file.
+    * @param[in] sPrevFileName  The name of the previous part, empty for the first file.
+    *
+    * @return true if the file was created, false otherwise.
+    */
+    bool openFile(const QString& sFileName, const QString& sPrevFileName);
+
+    //=========================================================================================================
+    /**
+    * Writes the tag directory and closes the current file.
+    */
+    void closeFile();
+
+    //=========================================================================================================
+    /**
+    * Links the current file to the next part, closes it and opens the next part.
+    *
+    * @return true if the next part was created, false otherwise.
+    */
+    bool splitFile();
+
+    //=========================================================================================================
+    /**
+    * Writes a FIFFB_REF block which points to another part of the recording.
+    *
+    * @param[in] role       FIFFV_ROLE_NEXT_FILE or FIFFV_ROLE_PREV_FILE.
+    * @param[in] sFileName  The name of the referenced file.
+    * @param[in] iFileNum   The part index of the referenced file.
+    */
+    void writeReference(fiff_int_t role, const QString& sFileName, fiff_int_t iFileNum);
+
+    //=========================================================================================================
+    /**
+    * Writes the tags which close the raw data and measurement blocks and the file at the current position.
+    */
+    void writeTrailer();
+
+    //=========================================================================================================
+    /**
+    * Writes the tag directory behind the trailer and lets the directory pointer point to it.
+    */
+    void writeIndex();
+
+    //=========================================================================================================
+    /**
+    * Returns the entries of the trailer tags.
+    *
+    * @return The directory entries.
+    */
+    QList<FiffDirEntry::SPtr> trailerEntries() const;
+
+    //=========================================================================================================
+    /**
+    * Adds a directory entry for a tag which was written to the current file.
+    *
+    * @param[in] kind   The tag kind.
+    * @param[in] type   The tag data type.
+    * @param[in] size   The tag data size in bytes.
+    * @param[in] pos    The position of the tag.
+    */
+    void appendEntry(fiff_int_t kind, fiff_int_t type, fiff_int_t size, fiff_long_t pos);
+
+    //=========================================================================================================
+    /**
+    * Returns the file name of a part of the recording.
+    *
+    * @param[in] iPart  The part index, 0 for the first file.
+    *
+    * @return The file name.
+    */
+    QString partFileName(int iPart) const;
+
+    QSharedPointer<QFile>       m_pFile;                /**< The current file. */
+    FiffStream::SPtr            m_pStream;              /**< The stream writing to the current file. */
+    FiffInfo                    m_info;                 /**< The measurement info. */
+    Eigen::RowVectorXd          m_vecCals;              /**< The calibration factors of the channels. */
+    QList<FiffDirEntry::SPtr>   m_lDirEntries;          /**< The entries of the tags in front of the trailer. */
+    QString                     m_sFileName;            /**< The name of the first file. */
+    QStringList                 m_lFileNames;           /**< The names of all written files. */
+    qint64                      m_iMaxFileSize;         /**< Maximal file size in bytes, 0 disables splitting by size. */
+    double                      m_dMaxFileDuration;     /**< Maximal duration per file in seconds, 0 disables splitting by duration. */
+    qint64                      m_iPreallocationSize;   /**< Number of bytes allocated when a file is created. */
+    fiff_long_t                 m_iDirPointerPos;       /**< Position of the FIFF_DIR_POINTER tag. */
+    fiff_long_t                 m_iTrailerPos;          /**< Position of the trailer, the next buffer overwrites it. */
+    fiff_long_t                 m_iTrailerEnd;          /**< Position behind the trailer. */
+    bool                        m_bIndexWritten;        /**< Whether the directory pointer points to a written directory. */
+    bool                        m_bResetRange;          /**< Whether the channel range is reset to 1. */
+    fiff_int_t                  m_iFirstSample;         /**< The first sample of the recording. */
+    qint64                      m_iSamplesWritten;      /**< Number of samples written since start(). */
+    qint64                      m_iFileSamples;         /**< Number of samples written to the current file. */
+};
+
+} // NAMESPACE FIFFLIB
+
+#endif // FIFF_ROLLING_RAW_WRITER_H
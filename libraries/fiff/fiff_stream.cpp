@@ -93,6 +93,7 @@
 
 #include <QFile>
 #include <QTcpSocket>
+#include <QtEndian>
 
 
 //*************************************************************************************************************
@@ -3100,17 +3101,8 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf, const RowVectorXd& cals)
         return false;
     }
 
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> tripletList;
-    tripletList.reserve(cals.cols());
-    for(qint32 i = 0; i < cals.cols(); ++i)
-        tripletList.push_back(T(i, i, 1.0/cals[i]));
-
-    SparseMatrix<double> inv_calsMat(cals.cols(), cals.cols());
-    inv_calsMat.setFromTriplets(tripletList.begin(), tripletList.end());
-
-    MatrixXf tmp = (inv_calsMat*buf).cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    MatrixXf tmp = (buf.array().colwise() * cals.transpose().array().inverse()).cast<float>();
+    this->write_data_buffer(FIFFT_FLOAT,tmp.data(),tmp.rows()*tmp.cols(),4);
     return true;
 }
 
@@ -3130,7 +3122,7 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf, const SparseMatrix<double
         inv_mult.coeffRef(it.row(),it.col()) = 1/it.value();
 
     MatrixXf tmp = (inv_mult*buf).cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    this->write_data_buffer(FIFFT_FLOAT,tmp.data(),tmp.rows()*tmp.cols(),4);
     return true;
 }
 
@@ -3140,7 +3132,84 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf, const SparseMatrix<double
 bool FiffStream::write_raw_buffer(const MatrixXd& buf)
 {
     MatrixXf tmp = buf.cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    this->write_data_buffer(FIFFT_FLOAT,tmp.data(),tmp.rows()*tmp.cols(),4);
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::write_raw_buffer(const MatrixXf& buf, const RowVectorXd& cals, fiff_int_t type)
+{
+    if (buf.rows() != cals.cols())
+    {
+        printf("buffer and calibration sizes do not match\n");
+        return false;
+    }
+
+    if (type == FIFFT_FLOAT) {
+        MatrixXf tmp = buf.array().colwise() * cals.transpose().array().inverse().cast<float>();
+        this->write_data_buffer(FIFFT_FLOAT,tmp.data(),tmp.rows()*tmp.cols(),4);
+        return true;
+    }
+
+    double dMax;
+    if (type == FIFFT_INT)
+        dMax = 2147483647.0;
+    else if (type == FIFFT_SHORT || type == FIFFT_DAU_PACK16)
+        dMax = 32767.0;
+    else {
+        printf("Data storage format %d is not supported for raw buffers\n", type);
+        return false;
+    }
+
+    //
+    //   Scale in double precision to keep all 32 bits, round and clip to the range of the type
+    //
+    ArrayXXd scaled = (buf.cast<double>().array().colwise() * cals.transpose().array().inverse()).round();
+
+    Index nClipped = (scaled > dMax || scaled < -dMax - 1.0).count();
+    if (nClipped > 0)
+        printf("%ld samples exceed the range of the raw buffer type and are clipped\n", (long)nClipped);
+
+    scaled = scaled.max(-dMax - 1.0).min(dMax);
+
+    if (type == FIFFT_INT)
+        return this->write_raw_buffer(MatrixXi(scaled.cast<int>().matrix()));
+
+    return this->write_raw_buffer(MatrixShort(scaled.cast<short>().matrix()), type);
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::write_raw_buffer(const MatrixXf& buf)
+{
+    this->write_data_buffer(FIFFT_FLOAT,buf.data(),buf.rows()*buf.cols(),4);
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::write_raw_buffer(const MatrixXi& buf)
+{
+    this->write_data_buffer(FIFFT_INT,buf.data(),buf.rows()*buf.cols(),4);
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::write_raw_buffer(const MatrixShort& buf, fiff_int_t type)
+{
+    if (type != FIFFT_SHORT && type != FIFFT_DAU_PACK16)
+    {
+        printf("Data storage format %d is not a 16 bit format\n", type);
+        return false;
+    }
+
+    this->write_data_buffer(type,buf.data(),buf.rows()*buf.cols(),2);
     return true;
 }
 
@@ -3151,13 +3220,15 @@ fiff_long_t FiffStream::write_string(fiff_int_t kind, const QString& data)
 {
     fiff_long_t pos = this->device()->pos();
 
-    fiff_int_t datasize = data.size();
+    //The tag size is the number of UTF-8 bytes, which differs from the number of characters for non-ASCII strings
+    QByteArray utf8 = data.toUtf8();
+    fiff_int_t datasize = utf8.size();
     *this << (qint32)kind;
     *this << (qint32)FIFFT_STRING;
     *this << (qint32)datasize;
     *this << (qint32)FIFFV_NEXT_SEQ;
 
-    this->writeRawData(data.toUtf8().constData(),datasize);
+    this->writeRawData(utf8.constData(),datasize);
 
     return pos;
 }
@@ -3178,6 +3249,41 @@ void FiffStream::write_rt_command(fiff_int_t command, const QString& data)
 }
 
 
+//*************************************************************************************************************
+
+fiff_long_t FiffStream::write_data_buffer(fiff_int_t type, const void* data, fiff_int_t nel, int iElementSize)
+{
+    fiff_long_t pos = this->device()->pos();
+
+    fiff_int_t datasize = nel * iElementSize;
+
+    *this << (qint32)FIFF_DATA_BUFFER;
+    *this << (qint32)type;
+    *this << (qint32)datasize;
+    *this << (qint32)FIFFV_NEXT_SEQ;
+
+    //
+    //   Swap the whole buffer to big endian and write it at once
+    //
+    QByteArray buffer(datasize, Qt::Uninitialized);
+    uchar* dest = reinterpret_cast<uchar*>(buffer.data());
+
+    if (iElementSize == 2) {
+        const quint16* src = static_cast<const quint16*>(data);
+        for(fiff_int_t i = 0; i < nel; ++i)
+            qToBigEndian<quint16>(src[i], dest + 2*i);
+    } else {
+        const quint32* src = static_cast<const quint32*>(data);
+        for(fiff_int_t i = 0; i < nel; ++i)
+            qToBigEndian<quint32>(src[i], dest + 4*i);
+    }
+
+    this->writeRawData(buffer.constData(), datasize);
+
+    return pos;
+}
+
+
 //*************************************************************************************************************
 
 QList<FiffDirEntry::SPtr> FiffStream::make_dir(bool *ok)
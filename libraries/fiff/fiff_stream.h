@@ -849,6 +849,52 @@ public:
     */
     bool write_raw_buffer(const MatrixXd& buf);
 
+    //=========================================================================================================
+    /**
+    * Writes a single precision raw buffer. Every channel is divided by its calibration factor and the result is
+    * stored with the given data type. For the integer types the values are rounded and clipped to the range of
+    * the type, 16 bit storage halves the file size if the calibration factors resolve the signal well enough.
+    *
+    * @param[in] buf        the buffer to write
+    * @param[in] cals       calibration factors
+    * @param[in] type       the data type of the written buffer: FIFFT_FLOAT (default), FIFFT_INT, FIFFT_SHORT
+    *                       or FIFFT_DAU_PACK16
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write_raw_buffer(const MatrixXf& buf, const RowVectorXd& cals, fiff_int_t type = FIFFT_FLOAT);
+
+    //=========================================================================================================
+    /**
+    * Writes a single precision raw buffer without calibrations.
+    *
+    * @param[in] buf        the buffer to write
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write_raw_buffer(const MatrixXf& buf);
+
+    //=========================================================================================================
+    /**
+    * Writes a raw buffer of 32 bit integer samples (FIFFT_INT), e.g. the unscaled values of an acquisition device.
+    *
+    * @param[in] buf        the buffer to write
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write_raw_buffer(const MatrixXi& buf);
+
+    //=========================================================================================================
+    /**
+    * Writes a raw buffer of 16 bit integer samples, e.g. the unscaled values of an acquisition device.
+    *
+    * @param[in] buf        the buffer to write
+    * @param[in] type       the data type of the written buffer: FIFFT_SHORT (default) or FIFFT_DAU_PACK16
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write_raw_buffer(const MatrixShort& buf, fiff_int_t type = FIFFT_SHORT);
+
     //=========================================================================================================
     /**
     * Writes a string tag
@@ -893,6 +939,20 @@ private:
     */
     QList<FiffDirEntry::SPtr> make_dir(bool *ok=Q_NULLPTR);
 
+    //=========================================================================================================
+    /**
+    * Writes a FIFF_DATA_BUFFER tag. The samples are converted to big endian in one go and written with a single
+    * call instead of streaming every value.
+    *
+    * @param[in] type           The data type of the samples
+    * @param[in] data           The samples in host byte order
+    * @param[in] nel            Number of samples
+    * @param[in] iElementSize   Size of one sample in bytes, 2 or 4
+    *
+    * @return the position where the buffer was written to
+    */
+    fiff_long_t write_data_buffer(fiff_int_t type, const void* data, fiff_int_t nel, int iElementSize);
+
 private:
 
 //    char         *file_name;    /**< Name of the file */ -> Use streamName() instead
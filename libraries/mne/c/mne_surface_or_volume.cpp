@@ -59,6 +59,7 @@
 
 #include <utils/sphere.h>
 #include <utils/ioutils.h>
+#include <utils/spatialindex/kdtree.h>
 
 #include <QFile>
 #include <QCoreApplication>
@@ -464,7 +465,7 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
     MneSourceSpaceOld* s;
     int k,p1,p2;
     float r1[3];
-    float mindist,dist,diff[3];
+    float mindist;
     int   minnode;
     int   omit,omit_outside;
     double tot_angle;
@@ -489,6 +490,14 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
     if (limit > 0.0)
         printf("and at least %6.1f mm away",1000*limit);
     printf(" (will take a few...)\n");
+    /*
+     * The closest surface vertices are looked up in a k-d tree instead of going through all vertices
+     */
+    Eigen::MatrixX3f surf_rr(surf->np,3);
+    for (p2 = 0; p2 < surf->np; p2++)
+        surf_rr.row(p2) = Eigen::Map<Eigen::RowVector3f>(surf->rr[p2]);
+    UTILSLIB::KdTree surf_tree(surf_rr);
+
     omit         = 0;
     omit_outside = 0;
     for (k = 0; k < nspace; k++) {
@@ -514,17 +523,8 @@ int MneSurfaceOrVolume::mne_filter_source_spaces(MneSurfaceOld* surf, float limi
                     /*
                         * Check the distance limit
                         */
-                    mindist = 1.0;
-                    minnode = 0;
-                    for (p2 = 0; p2 < surf->np; p2++) {
-                        VEC_DIFF_17(r1,surf->rr[p2],diff);
-                        dist = VEC_LEN_17(diff);
-                        if (dist < mindist) {
-                            mindist = dist;
-                            minnode = p2;
-                        }
-                    }
-                    if (mindist < limit) {
+                    minnode = surf_tree.nearest(Eigen::Map<Eigen::Vector3f>(r1),&mindist);
+                    if (minnode >= 0 && mindist < limit) {
                         omit++;
                         s->inuse[p1] = FALSE;
                         s->nuse--;
@@ -1520,7 +1520,11 @@ int MneSurfaceOrVolume::mne_project_to_surface(MneSurfaceOld* s, void *proj_data
 
     p0 = q0 = 0.0;
     dist0 = 0.0;
+    MneProjData* pd = (MneProjData*)proj_data;
+
     for (best = -1, k = 0; k < s->ntri; k++) {
+        if (pd && !pd->act[k])
+            continue;
         if (nearest_triangle_point(r,s,proj_data,k,&p,&q,&dist)) {
             if (best < 0 || std::fabs(dist) < std::fabs(dist0)) {
                 dist0 = dist;
@@ -1570,13 +1574,25 @@ void MneSurfaceOrVolume::mne_find_closest_on_surface_approx(MneSurfaceOld* s, fl
     float mydist;
 
     fprintf(stderr,"%s for %d points %d steps...",nearest[0] < 0 ? "Closest" : "Approx closest",np,nstep);
+    /*
+     * Only vertices which belong to a triangle can be the starting point of the search
+     */
+    Eigen::MatrixX3f vert_rr(s->np,3);
+    Eigen::VectorXi  vert_sel(s->np);
+    int              nsel = 0;
+    for (k = 0; k < s->np; k++) {
+        vert_rr.row(k) = Eigen::Map<Eigen::RowVector3f>(s->rr[k]);
+        if (s->nneighbor_tri[k] > 0)
+            vert_sel[nsel++] = k;
+    }
+    UTILSLIB::KdTree vert_tree(vert_rr,vert_sel.head(nsel));
 
     for (k = 0; k < np; k++) {
         was = nearest[k];
-        decide_search_restriction(s,p,nearest[k],nstep,r[k]);
+        decide_search_restriction(s,p,nearest[k],nstep,r[k],&vert_tree);
         nearest[k] =  mne_project_to_surface(s,p,r[k],0,dist ? dist+k : &mydist);
         if (nearest[k] < 0) {
-            decide_search_restriction(s,p,-1,nstep,r[k]);
+            decide_search_restriction(s,p,-1,nstep,r[k],&vert_tree);
             nearest[k] =  mne_project_to_surface(s,p,r[k],0,dist ? dist+k : &mydist);
         }
     }
@@ -1594,7 +1610,8 @@ void MneSurfaceOrVolume::decide_search_restriction(MneSurfaceOld* s,
                                                    int        approx_best, /* We know the best triangle approximately
                                                                                       * already */
                                                    int        nstep,
-                                                   float      *r)
+                                                   float      *r,
+                                                   const UTILSLIB::KdTree* vert_tree)
 /*
       * Restrict the search only to feasible triangles
       */
@@ -1606,7 +1623,15 @@ void MneSurfaceOrVolume::decide_search_restriction(MneSurfaceOld* s,
     for (k = 0; k < s->ntri; k++)
         p->act[k] = FALSE;
 
-    if (approx_best < 0) {
+    if (approx_best < 0 && vert_tree && !vert_tree->isEmpty()) {
+        /*
+        * Look up the closest vertex in the tree
+        */
+        minvert = vert_tree->nearest(Eigen::Map<Eigen::Vector3f>(r),&mindist);
+        if (mindist >= 1000.0)
+            minvert = 0;
+    }
+    else if (approx_best < 0) {
         /*
         * Search for the closest vertex
         */
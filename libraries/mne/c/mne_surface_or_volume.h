@@ -90,6 +90,10 @@ namespace FIFFLIB {
     class FiffDigitizerData;
 }
 
+namespace UTILSLIB {
+    class KdTree;
+}
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -261,7 +265,8 @@ public:
                           int        approx_best, /* We know the best triangle approximately
                                        * already */
                           int        nstep,
-                          float      *r);
+                          float      *r,
+                          const UTILSLIB::KdTree* vert_tree = NULL);   /* Vertices with neighboring triangles (optional) */
 
     static void activate_neighbors(MneSurfaceOld* s, int start, int *act, int nstep);
 
@@ -124,15 +124,17 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
     if (!(p_MNEBemSurf.tri_nn.isZero(0)))
     {
         nn = p_MNEBemSurf.tri_nn.cast<float>();
+        nn.rowwise().normalize();
     }
     else
     {
         for (int i = 0; i < p_MNEBemSurf.ntri; ++i)
         {
-            nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).transpose();
+            nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).normalized().transpose();
         }
     }
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+    bvh.build(p_MNEBemSurf.rr, p_MNEBemSurf.tris);
 }
 
 
@@ -150,16 +152,17 @@ MNEProjectToSurface::MNEProjectToSurface(const MNESurface &p_MNESurf)
 {
     for (int i = 0; i < p_MNESurf.ntri; ++i)
     {
-        r1.row(i) = p_MNESurf.rr.row(p_MNESurf.tris(i,0));
-        r12.row(i) = p_MNESurf.rr.row(p_MNESurf.tris(i,1)) - r1.row(i);
-        r13.row(i) = p_MNESurf.rr.row(p_MNESurf.tris(i,2)) - r1.row(i);
-        nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).transpose();
+        r1.row(i) = p_MNESurf.rr.col(p_MNESurf.tris(0,i)).transpose();
+        r12.row(i) = p_MNESurf.rr.col(p_MNESurf.tris(1,i)).transpose() - r1.row(i);
+        r13.row(i) = p_MNESurf.rr.col(p_MNESurf.tris(2,i)).transpose() - r1.row(i);
+        nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).normalized().transpose();
         a(i) = r12.row(i) * r12.row(i).transpose();
         b(i) = r13.row(i) * r13.row(i).transpose();
         c(i) = r12.row(i) * r13.row(i).transpose();
     }
 
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+    bvh.build(p_MNESurf.rr.transpose(), p_MNESurf.tris.transpose());
 }
 
 
@@ -180,10 +183,6 @@ bool MNEProjectToSurface::mne_find_closest_on_surface(const MatrixXf &r, const i
     Vector3f rTriK;
     for (int k = 0; k < np; ++k)
     {
-        /*
-         * To do: decide_search_restriction for the use in an iterative closest point to plane algorithm
-         * For now it's OK to go through all triangles.
-         */
         if (!this->mne_project_to_surface(r.row(k).transpose(), rTriK, bestTri, bestDist))
         {
             qDebug() << "The projection of point number " << k << " didn't work./n";
@@ -201,28 +200,30 @@ bool MNEProjectToSurface::mne_find_closest_on_surface(const MatrixXf &r, const i
 
 bool MNEProjectToSurface::mne_project_to_surface(const Vector3f &r, Vector3f &rTri, int &bestTri, float &bestDist)
 {
-    float p = 0, q = 0, p0 = 0, q0 = 0, dist0 = 0;
-    bestDist = 0.0f;
-    bestTri = -1;
-    for (int tri = 0; tri < a .size(); ++tri)
+    float p = 0, q = 0;
+    bool bSucceeded = true;
+
+    // only the triangles whose bounding boxes are closer than the best triangle found so far are investigated
+    bestTri = bvh.nearest(r,
+                          [this, &r, &p, &q, &bSucceeded](int tri, float &dist0) {
+                              if (!this->nearest_triangle_point(r, tri, p, q, dist0))
+                              {
+                                  qDebug() << "The projection on triangle " << tri << " didn't work./n";
+                                  bSucceeded = false;
+                                  return false;
+                              }
+                              return true;
+                          },
+                          bestDist);
+
+    if (!bSucceeded)
     {
-        if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
-        {
-            qDebug() << "The projection on triangle " << tri << " didn't work./n";
-            return false;
-        }
-
-        if ((bestTri < 0) || (std::fabs(dist0) < std::fabs(bestDist)))
-        {
-            bestDist = dist0;
-            p = p0;
-            q = q0;
-            bestTri = tri;
-        }
+        return false;
     }
 
     if (bestTri >= 0)
     {
+        this->nearest_triangle_point(r, bestTri, p, q, bestDist);
         if (!this->project_to_triangle(rTri, p, q, bestTri))
         {
             qDebug() << "The coordinate transform to cartesian system didn't work./n";
@@ -44,6 +44,8 @@
 
 #include "mne_global.h"
 
+#include <utils/spatialindex/trianglebvh.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -195,6 +197,7 @@ private:
     Eigen::VectorXf b;           /**< r13*r13 */
     Eigen::VectorXf c;           /**< r12*r13 */
     Eigen::VectorXf det;         /**< Determinant of the Matrix [a c, c b] */
+    UTILSLIB::TriangleBvh bvh;   /**< Bounding volume hierarchy over the triangles, restricts the search to nearby triangles */
 };
 
 
@@ -257,7 +257,8 @@ void RtAveWorker::setBaselineTo(int toSamp, int toMSec)
 void RtAveWorker::doAveraging(const MatrixXd& rawSegment)
 {
     //Detect trigger
-    QList<QPair<int,double> > lDetectedTriggers = DetectTrigger::detectTriggerFlanksMax(rawSegment, m_iTriggerChIndex, 0, m_fTriggerThreshold, true);
+    m_detectTrigger.detect(rawSegment, 0);
+    QList<QPair<int,double> > lDetectedTriggers = m_detectTrigger.lastDetected(m_iTriggerChIndex);
 
     //TODO: This does not permit the same trigger type twice in one data block
     for(int i = 0; i < lDetectedTriggers.size(); ++i) {
@@ -566,6 +567,12 @@ void RtAveWorker::reset()
     m_iTriggerChIndex = m_iNewTriggerIndex;
     //m_iAverageMode = m_iNewAverageMode;
 
+    //The offset is taken from the first sample of the stream instead of the first sample of every block. The per block
+    //offset kept a trigger which was still high at the start of a block from being counted again. The detector now
+    //carries the channel state across blocks and only reports crossings from below, so this is no longer needed and
+    //a trigger rising right at a block start is not swallowed by the offset anymore.
+    m_detectTrigger.setup(QList<int>() << m_iTriggerChIndex, m_fTriggerThreshold, true);
+
     //Clear all evoked data information
     m_stimEvokedSet.evoked.clear();
 
@@ -47,6 +47,7 @@
 //=============================================================================================================
 
 #include <iostream>
+#include <algorithm>
 
 
 //*************************************************************************************************************
@@ -56,6 +57,7 @@
 
 #include <QMapIterator>
 #include <QTime>
+#include <QDebug>
 
 
 //*************************************************************************************************************
@@ -73,6 +75,11 @@ using namespace UTILSLIB;
 //=============================================================================================================
 
 DetectTrigger::DetectTrigger()
+: m_iEventsWritten(0)
+, m_iLastBlockEvents(0)
+, m_dThreshold(0.0)
+, m_bRemoveOffset(true)
+, m_iBurstLengthSamp(100)
 {
 
 }
@@ -304,4 +311,173 @@ QList<QPair<int,double> > DetectTrigger::detectTriggerFlanksGrad(const MatrixXd
 }
 
 
+//*************************************************************************************************************
+
+void DetectTrigger::setup(const QList<int>& lTriggerChannels,
+                          double dThreshold,
+                          bool bRemoveOffset,
+                          int iBurstLengthSamp,
+                          int iEventBufferSize)
+{
+    m_dThreshold = dThreshold;
+    m_bRemoveOffset = bRemoveOffset;
+    m_iBurstLengthSamp = iBurstLengthSamp > 0 ? iBurstLengthSamp : 0;
+
+    m_vecChannelStates.resize(lTriggerChannels.size());
+    for(int i = 0; i < lTriggerChannels.size(); ++i) {
+        m_vecChannelStates[i].iChannel = lTriggerChannels.at(i);
+    }
+
+    m_vecEvents.resize(iEventBufferSize > 0 ? iEventBufferSize : 1);
+
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void DetectTrigger::reset()
+{
+    for(int i = 0; i < m_vecChannelStates.size(); ++i) {
+        m_vecChannelStates[i].dOffset = 0.0;
+        m_vecChannelStates[i].bAbove = false;
+        m_vecChannelStates[i].iHoldOff = 0;
+        m_vecChannelStates[i].bInitialized = false;
+    }
+
+    m_iEventsWritten = 0;
+    m_iLastBlockEvents = 0;
+}
+
+
+//*************************************************************************************************************
+
+int DetectTrigger::detect(const MatrixXd &data,
+                          int iOffsetIndex)
+{
+    m_iLastBlockEvents = 0;
+
+    if(m_vecEvents.isEmpty()) {
+        qWarning() << "DetectTrigger::detect - Streaming detection was not set up. Returning.";
+        return 0;
+    }
+
+    const int iCols = data.cols();
+
+    for(int i = 0; i < m_vecChannelStates.size(); ++i) {
+        ChannelState& state = m_vecChannelStates[i];
+
+        if(state.iChannel >= data.rows() || state.iChannel < 0 || iCols == 0) {
+            continue;
+        }
+
+        //Copy the channel to contiguous memory so that the comparisons below are vectorized
+        m_vecRow = data.row(state.iChannel);
+
+        if(!state.bInitialized) {
+            state.dOffset = m_bRemoveOffset ? m_vecRow(0) : 0.0;
+            state.bAbove = m_vecRow(0) - state.dOffset >= m_dThreshold;
+            state.bInitialized = true;
+        }
+
+        const double dLevel = m_dThreshold + state.dOffset;
+
+        //Samples which are still skipped after a flank of the previous block
+        int iStart = std::min(state.iHoldOff, iCols);
+        state.iHoldOff -= iStart;
+
+        if(iStart == iCols) {
+            state.bAbove = m_vecRow(iCols-1) >= dLevel;
+            continue;
+        }
+
+        if(iStart > 0) {
+            state.bAbove = m_vecRow(iStart-1) >= dLevel;
+        }
+
+        //Most blocks do not contain a flank at all: the signal stays below or above the threshold
+        if(!state.bAbove && m_vecRow.tail(iCols-iStart).maxCoeff() < dLevel) {
+            continue;
+        }
+
+        if(state.bAbove && m_vecRow.tail(iCols-iStart).minCoeff() >= dLevel) {
+            continue;
+        }
 
+        for(int j = iStart; j < iCols; ++j) {
+            bool bAbove = m_vecRow(j) >= dLevel;
+
+            if(bAbove && !state.bAbove) {
+                addEvent(state.iChannel, iOffsetIndex + j, m_vecRow(j));
+
+                //Skip the burst, which may reach into the next block
+                if(j + m_iBurstLengthSamp >= iCols) {
+                    state.iHoldOff = j + m_iBurstLengthSamp - iCols + 1;
+                    bAbove = m_vecRow(iCols-1) >= dLevel;
+                    j = iCols;
+                } else {
+                    j += m_iBurstLengthSamp;
+                    bAbove = m_vecRow(j) >= dLevel;
+                }
+            }
+
+            state.bAbove = bAbove;
+        }
+    }
+
+    return m_iLastBlockEvents;
+}
+
+
+//*************************************************************************************************************
+
+int DetectTrigger::eventCount() const
+{
+    return std::min(m_iEventsWritten, qint64(m_vecEvents.size()));
+}
+
+
+//*************************************************************************************************************
+
+const TriggerEvent& DetectTrigger::event(int i) const
+{
+    qint64 iFirst = m_iEventsWritten - eventCount();
+
+    return m_vecEvents.at((iFirst + i) % m_vecEvents.size());
+}
+
+
+//*************************************************************************************************************
+
+QList<QPair<int,double> > DetectTrigger::lastDetected(int iTriggerChannelIdx) const
+{
+    QList<QPair<int,double> > lDetectedTriggers;
+
+    int iCount = eventCount();
+
+    for(int i = iCount - std::min(m_iLastBlockEvents, iCount); i < iCount; ++i) {
+        const TriggerEvent& triggerEvent = event(i);
+
+        if(triggerEvent.iChannel == iTriggerChannelIdx) {
+            lDetectedTriggers.append(qMakePair(triggerEvent.iSample, triggerEvent.dValue));
+        }
+    }
+
+    return lDetectedTriggers;
+}
+
+
+//*************************************************************************************************************
+
+void DetectTrigger::addEvent(int iChannel,
+                             int iSample,
+                             double dValue)
+{
+    TriggerEvent& triggerEvent = m_vecEvents[m_iEventsWritten % m_vecEvents.size()];
+    triggerEvent.iChannel = iChannel;
+    triggerEvent.iSample = iSample;
+    triggerEvent.dValue = dValue;
+
+    ++m_iEventsWritten;
+    ++m_iLastBlockEvents;
+}
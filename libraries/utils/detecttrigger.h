@@ -50,6 +50,9 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QVector>
+#include <QList>
+#include <QPair>
 
 
 //*************************************************************************************************************
@@ -84,7 +87,22 @@ using namespace Eigen;
 
 //=============================================================================================================
 /**
-* Routines for detecting trigger flanks in a given signal
+* A trigger flank found by the streaming detection of DetectTrigger.
+*/
+struct TriggerEvent
+{
+    int     iChannel;       /**< Row index of the trigger channel. */
+    int     iSample;        /**< Sample index of the flank, including the offset index passed to DetectTrigger::detect. */
+    double  dValue;         /**< Signal value at the flank. */
+};
+
+
+//=============================================================================================================
+/**
+* Routines for detecting trigger flanks in a given signal. Besides the static routines, which only look at a
+* single data block, an instance of this class detects rising threshold flanks in a stream of consecutive blocks.
+* The channel state is carried from one block to the next, so that flanks at block boundaries are neither missed
+* nor reported twice, and the found flanks are written to a preallocated ring buffer.
 *
 * @brief Trigger flank detection
 */
@@ -184,6 +202,99 @@ public:
                                                              bool bRemoveOffset,
                                                              const QString& type,
                                                              int iBurstLengthSamp = 100);
+
+    //=========================================================================================================
+    /**
+    * Sets up the streaming detection and resets its state. A flank is detected where the signal of a trigger
+    * channel crosses the threshold from below.
+    *
+    * @param[in]    lTriggerChannels  The indices of the trigger channels
+    * @param[in]    dThreshold  the signal threshold value used to find the trigger flank
+    * @param[in]    bRemoveOffset  remove the first sample of the stream as offset
+    * @param[in]    iBurstLengthSamp  The length in samples which is skipped after a trigger was found
+    * @param[in]    iEventBufferSize  The number of events the ring buffer holds
+    */
+    void setup(const QList<int>& lTriggerChannels,
+               double dThreshold,
+               bool bRemoveOffset = true,
+               int iBurstLengthSamp = 100,
+               int iEventBufferSize = 1024);
+
+    //=========================================================================================================
+    /**
+    * Resets the carried channel states and clears the event buffer. The stream starts anew with the next block.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Scans the next data block of the stream for rising threshold flanks.
+    *
+    * @param[in]    data  the next data block, the trigger channels are addressed by their row index
+    * @param[in]    iOffsetIndex  the offset index gets added to the found trigger flank index
+    *
+    * @return   The number of flanks found in this block.
+    */
+    int detect(const MatrixXd &data,
+               int iOffsetIndex = 0);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of events held by the ring buffer.
+    *
+    * @return   The number of stored events, at most the event buffer size.
+    */
+    int eventCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a stored event. Once the buffer is full, the oldest events are overwritten.
+    *
+    * @param[in]    i  the event index, 0 is the oldest stored event.
+    *
+    * @return   The event.
+    */
+    const TriggerEvent& event(int i) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the flanks found in the last detected block in the format of the static routines.
+    *
+    * @param[in]    iTriggerChannelIdx  the index of the trigger channel in the matrix.
+    *
+    * @return   This list holds the found trigger indices and corresponding signal values.
+    */
+    QList<QPair<int,double> > lastDetected(int iTriggerChannelIdx) const;
+
+private:
+    /**
+    * Detection state of a trigger channel, carried from one block to the next.
+    */
+    struct ChannelState
+    {
+        int     iChannel;       /**< Row index of the trigger channel. */
+        double  dOffset;        /**< Offset which is subtracted from the signal. */
+        bool    bAbove;         /**< Whether the last sample of the previous block was above threshold. */
+        int     iHoldOff;       /**< Number of samples which are still skipped after the last flank. */
+        bool    bInitialized;   /**< Whether the first block has been seen. */
+    };
+
+    QVector<ChannelState>   m_vecChannelStates;     /**< The state of each trigger channel. */
+    QVector<TriggerEvent>   m_vecEvents;            /**< Preallocated ring buffer of the found events. */
+    qint64                  m_iEventsWritten;       /**< Number of events written to the ring buffer since the last reset. */
+    int                     m_iLastBlockEvents;     /**< Number of events found in the last block. */
+    RowVectorXd             m_vecRow;               /**< Contiguous copy of the currently scanned trigger channel. */
+    double                  m_dThreshold;           /**< The signal threshold value. */
+    bool                    m_bRemoveOffset;        /**< Whether to remove the first sample of the stream as offset. */
+    int                     m_iBurstLengthSamp;     /**< Number of samples which are skipped after a flank. */
+
+    //=========================================================================================================
+    /**
+    * Writes an event to the ring buffer.
+    */
+    void addEvent(int iChannel,
+                  int iSample,
+                  double dValue);
 };
 
 //*************************************************************************************************************
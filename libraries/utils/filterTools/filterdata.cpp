@@ -343,6 +343,65 @@ RowVectorXd FilterData::applyFFTFilter(const RowVectorXd& data, bool keepOverhea
 }
 
 
+//*************************************************************************************************************
+
+MatrixXd FilterData::applyFFTFilterRows(const MatrixXd& data, bool keepOverhead, CompensateEdgeEffects compensateEdgeEffects) const
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
+
+    if(data.cols()<m_dCoeffA.cols() && compensateEdgeEffects==MirrorData) {
+        qDebug()<<QString("Error in FilterData: Number of filter taps(%1) bigger then data size(%2). Not enough data to perform mirroring!").arg(m_dCoeffA.cols()).arg(data.cols());
+        return data;
+    }
+
+    if(2*m_dCoeffA.cols() + data.cols()>m_iFFTlength) {
+        qDebug()<<"Error in FilterData: Number of mirroring/zeropadding size plus data size is bigger then fft length!";
+        return data;
+    }
+
+    MatrixXd matFiltered(data.rows(), keepOverhead ? data.cols()+m_dCoeffA.cols() : data.cols());
+
+    //generate fft object and working buffers once for all rows
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    RowVectorXd t_dataZeroPad = RowVectorXd::Zero(m_iFFTlength);
+    RowVectorXcd t_freqData;
+    RowVectorXd t_filteredTime;
+
+    for(int i = 0; i < data.rows(); ++i) {
+        //Do zero padding or mirroring depending on user input
+        switch(compensateEdgeEffects) {
+            case MirrorData:
+                t_dataZeroPad.head(m_dCoeffA.cols()) = data.row(i).head(m_dCoeffA.cols()).reverse();   //front
+                t_dataZeroPad.segment(m_dCoeffA.cols(), data.cols()) = data.row(i);                    //middle
+                t_dataZeroPad.tail(m_dCoeffA.cols()) = data.row(i).tail(m_dCoeffA.cols()).reverse();   //back
+                break;
+
+            default:
+                t_dataZeroPad.head(data.cols()) = data.row(i);
+                break;
+        }
+
+        //fft-transform data sequence and perform frequency-domain filtering in place
+        fft.fwd(t_freqData,t_dataZeroPad);
+        t_freqData.array() *= m_dFFTCoeffA.array();
+
+        //inverse-FFT
+        fft.inv(t_filteredTime,t_freqData);
+
+        if(!keepOverhead)
+            matFiltered.row(i) = t_filteredTime.segment(m_dCoeffA.cols()/2, data.cols());
+        else
+            matFiltered.row(i) = t_filteredTime.head(data.cols()+m_dCoeffA.cols());
+    }
+
+    return matFiltered;
+}
+
+
 //*************************************************************************************************************
 
 QString FilterData::getStringForDesignMethod(const FilterData::DesignMethod &designMethod)
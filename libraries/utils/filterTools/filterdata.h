@@ -169,6 +169,18 @@ public:
     */
     RowVectorXd applyFFTFilter(const RowVectorXd& data, bool keepOverhead = false, CompensateEdgeEffects compensateEdgeEffects = MirrorData) const;
 
+    /**
+    * Applies the current filter to each row of the input data using multiplication in frequency domain. All rows share
+    * the FFT object and the working buffers, which is faster than filtering the rows one by one.
+    *
+    * @param [in] data holds the data to be filtered, one channel per row
+    * @param [in] keepOverhead whether the result should still include the overhead information in front and back of the data
+    * @param [in] compensateEdgeEffects defines how the edge effects should be handlted. Choose between ZeroPad and Mirroring
+    *
+    * @return the filtered data in form of a MatrixXd
+    */
+    MatrixXd applyFFTFilterRows(const MatrixXd& data, bool keepOverhead = false, CompensateEdgeEffects compensateEdgeEffects = MirrorData) const;
+
     /**
      * @brief getStringForDesignMethod returns the current design method as a string
      */
@@ -93,6 +93,7 @@ AdaptiveMp::AdaptiveMp()
 , signal_energy(0)
 , current_energy(0)
 , fix_phase(0)
+, multi_start_count(4)
 , epsilon(0)
 , max_iterations(0)
 {
@@ -150,91 +151,66 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
         gabor_Atom->energy = 0;
         qreal phase = 0;
 
+        //the scales of the dyadic grid are searched in parallel
+        QList<scale_search> scale_searches;
         while(s < sample_count)
         {
-            k = 0;                               //for modulation 2*pi*k/N
-            p = floor(sample_count / 2);         //translation
-            VectorXd envelope = GaborAtom::gauss_function(sample_count, s, p);
-            VectorXcd fft_envelope = RowVectorXcd::Zero(sample_count);
-            fft.fwd(fft_envelope, envelope);
+            scale_search current_search;
+            current_search.residuum = &residuum;
+            current_search.scale = s;
+            current_search.j = j;
+            current_search.channel_count = channel_count;
+            current_search.fix_phase = fix_phase;
+            scale_searches.append(current_search);
 
-            while(k < sample_count/2)
-            {
-                p = floor(sample_count/2);
-                VectorXcd modulation = modulation_function(sample_count, k);
-                VectorXcd modulated_resid = VectorXcd::Zero(sample_count);
-                VectorXcd fft_modulated_resid = VectorXcd::Zero(sample_count);
-                VectorXcd fft_m_e_resid = VectorXcd::Zero(sample_count);
-                VectorXd corr_coeffs = VectorXd::Zero(sample_count);
-
-                //iteration for multichannel, depending on boost setting
-                for(qint32 chn = 0; chn < channel_count; chn++)
-                {
-                    qint32 max_index = 0;
-                    qreal maximum = 0;
-                    phase = 0;
-                    p = floor(sample_count/2);//here is difference to dr. gratkowski´s code (he didn´t reset parameter p)
-
-                    //complex correlation of signal and sinus-modulated gaussfunction
-                    for(qint32 l = 0; l< sample_count; l++)
-                        modulated_resid[l] = residuum(l, chn) * modulation[l];
-
-                    fft.fwd(fft_modulated_resid, modulated_resid);
+            j++;
+            s = pow(2.0,j);
+        }
 
-                    for( qint32 m = 0; m < sample_count; m++)
-                        fft_m_e_resid[m] = fft_modulated_resid[m] * conj(fft_envelope[m]);
+        QtConcurrent::blockingMap(scale_searches, &scale_search::search);
 
-                    fft.inv(corr_coeffs, fft_m_e_resid);
-                    maximum = corr_coeffs[0];
+        //merge in scale order, later atoms win ties as in a sequential search
+        for(qint32 i = 0; i < scale_searches.length(); i++)
+        {
+            const scale_search &current_search = scale_searches.at(i);
 
-                    //find index of maximum correlation-coefficient to use in translation
-                    for(qint32 i = 1; i < corr_coeffs.rows(); i++)
-                        if(maximum < corr_coeffs[i])
-                        {
-                            maximum = corr_coeffs[i];
-                            max_index = i;
-                        }
+            for(qint32 chn = 0; chn < channel_count; chn++)
+            {
+                const VectorXd &atom_parameters = trial_separation ? current_search.channel_best.at(chn) : current_search.best;
+                qint32 bm_channel = trial_separation ? chn : current_search.best_channel;
 
-                    //adapting translation p to create atomtranslation correctly
-                    if(max_index >= p) p = max_index - p + 1;
-                    else p = max_index + p;
+                qreal temp_scalar_product = 0;
+                if(trial_separation) temp_scalar_product = max_scalar_product[chn];
+                else temp_scalar_product = max_scalar_product[0];
 
-                    VectorXd atom_parameters = calculate_atom(sample_count, s, p, k, chn, residuum, RETURNPARAMETERS, fix_phase);
-                    qreal temp_scalar_product = 0;
-                    if(trial_separation) temp_scalar_product = max_scalar_product[chn];
-                    else temp_scalar_product = max_scalar_product[0];
+                if(std::fabs(atom_parameters[4]) >= std::fabs(temp_scalar_product))
+                {
+                    //set highest scalarproduct, in comparison to best matching atom
+                    gabor_Atom->scale              = atom_parameters[0];
+                    gabor_Atom->translation        = atom_parameters[1];
+                    gabor_Atom->modulation         = atom_parameters[2];
+                    gabor_Atom->phase              = atom_parameters[3];
+                    gabor_Atom->max_scalar_product = atom_parameters[4];
+                    gabor_Atom->bm_channel         = bm_channel;
 
-                    if(std::fabs(atom_parameters[4]) >= std::fabs(temp_scalar_product))
+                    if(trial_separation)
                     {
-                        //set highest scalarproduct, in comparison to best matching atom
-                        gabor_Atom->scale              = atom_parameters[0];
-                        gabor_Atom->translation        = atom_parameters[1];
-                        gabor_Atom->modulation         = atom_parameters[2];
-                        gabor_Atom->phase              = atom_parameters[3];
-                        gabor_Atom->max_scalar_product = atom_parameters[4];
-                        gabor_Atom->bm_channel         = chn;
-
-                        if(trial_separation)
-                        {
-                            max_scalar_product[chn]    = atom_parameters[4];
-
-                            if(atoms_in_chns.length() < channel_count)
-                                atoms_in_chns.append(*gabor_Atom);
-                            else
-                                atoms_in_chns.replace(chn, *gabor_Atom);
-                        }
-                        else
-                            max_scalar_product[0]      = atom_parameters[4];
+                        max_scalar_product[chn]    = atom_parameters[4];
 
+                        if(atoms_in_chns.length() < channel_count)
+                            atoms_in_chns.append(*gabor_Atom);
+                        else
+                            atoms_in_chns.replace(chn, *gabor_Atom);
                     }
-
+                    else
+                        max_scalar_product[0]      = atom_parameters[4];
                 }
-                k += pow(2.0,(-j))*sample_count/2;
 
+                if(!trial_separation)
+                    break;
             }
-            j++;
-            s = pow(2.0,j);
         }
+
         std::cout << "\n" << "===============" << " found parameters " << it + 1 << "===============" << ":\n\n"<<
                      "scale: " << gabor_Atom->scale << " trans: " << gabor_Atom->translation <<
                      " modu: " << gabor_Atom->modulation << " phase: " << gabor_Atom->phase << " sclr_prdct: " << gabor_Atom->max_scalar_product << "\n";
@@ -299,8 +275,51 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
             }
         }
         else if(simplex_it != 0)
-            simplex_maximisation(simplex_it, simplex_reflection, simplex_expansion, simplex_contraction, simplex_full_contraction,
-                                 gabor_Atom, max_scalar_product, sample_count, fix_phase, residuum, trial_separation, gabor_Atom->bm_channel);
+        {
+            //start the simplex from the best atom and from the best atoms of the other scales, the starts run in parallel
+            QList<simplex_start> simplex_starts;
+
+            simplex_start best_start;
+            best_start.adaptive_mp = this;
+            best_start.atom = *gabor_Atom;
+            best_start.max_scalar_product = &max_scalar_product;
+            best_start.residuum = &residuum;
+            best_start.sample_count = sample_count;
+            best_start.simplex_it = simplex_it;
+            best_start.simplex_reflection = simplex_reflection;
+            best_start.simplex_expansion = simplex_expansion;
+            best_start.simplex_contraction = simplex_contraction;
+            best_start.simplex_full_contraction = simplex_full_contraction;
+            best_start.fix_phase = fix_phase;
+            simplex_starts.append(best_start);
+
+            QList<QPair<qreal, qint32> > scale_order;
+            for(qint32 i = 0; i < scale_searches.length(); i++)
+                if(scale_searches.at(i).best[0] != gabor_Atom->scale)
+                    scale_order.append(qMakePair(-std::fabs(scale_searches.at(i).best[4]), i));
+            qSort(scale_order);
+
+            for(qint32 i = 0; i < scale_order.length() && simplex_starts.length() < multi_start_count; i++)
+            {
+                const scale_search &current_search = scale_searches.at(scale_order.at(i).second);
+
+                simplex_start current_start = best_start;
+                current_start.atom.scale              = current_search.best[0];
+                current_start.atom.translation        = current_search.best[1];
+                current_start.atom.modulation         = current_search.best[2];
+                current_start.atom.phase              = current_search.best[3];
+                current_start.atom.max_scalar_product = current_search.best[4];
+                current_start.atom.bm_channel         = current_search.best_channel;
+                simplex_starts.append(current_start);
+            }
+
+            QtConcurrent::blockingMap(simplex_starts, &simplex_start::maximise);
+
+            //shared reduction, the start from the best grid atom wins ties
+            for(qint32 i = 0; i < simplex_starts.length(); i++)
+                if(i == 0 || std::fabs(simplex_starts.at(i).atom.max_scalar_product) > std::fabs(gabor_Atom->max_scalar_product))
+                    *gabor_Atom = simplex_starts.at(i).atom;
+        }
 
         //calc multichannel parameters phase and max_scalar_product
         channel_count = signal.cols();
@@ -392,68 +411,117 @@ QList<QList<GaborAtom> > AdaptiveMp::matching_pursuit(MatrixXd signal, qint32 ma
 
 VectorXcd AdaptiveMp::modulation_function(qint32 N, qreal k)
 {
-    VectorXcd modulation = VectorXcd::Zero(N);
+    return Atom::oscillator(N, 2 * PI * k / qreal(N)) / sqrt(qreal(N));
+}
 
-    for(qint32 n = 0; n < N; n++)
+//*************************************************************************************************************
+
+void AdaptiveMp::scale_search::search()
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
+
+    const MatrixXd &resid = *residuum;
+    qint32 sample_count = resid.rows();
+    Eigen::FFT<double> fft;
+
+    best = VectorXd::Zero(5);
+    best_channel = 0;
+    channel_best.clear();
+    for(qint32 chn = 0; chn < channel_count; chn++)
+        channel_best.append(VectorXd::Zero(5));
+
+    qreal k = 0;                                 //for modulation 2*pi*k/N
+    qint32 p = floor(sample_count / 2);          //translation
+    VectorXd envelope = GaborAtom::gauss_function(sample_count, scale, p);
+    VectorXcd fft_envelope;
+    fft.fwd(fft_envelope, envelope);
+
+    VectorXcd modulated_resid;
+    VectorXcd fft_modulated_resid;
+    VectorXd corr_coeffs;
+
+    while(k < sample_count/2)
     {
-        modulation[n] = std::polar(1 / sqrt(qreal(N)), 2 * PI * k / qreal(N) * qreal(n));
+        VectorXcd modulation = AdaptiveMp::modulation_function(sample_count, k);
+
+        //iteration for multichannel, depending on boost setting
+        for(qint32 chn = 0; chn < channel_count; chn++)
+        {
+            std::ptrdiff_t max_index = 0;
+            p = floor(sample_count/2);//here is difference to dr. gratkowski´s code (he didn´t reset parameter p)
+
+            //complex correlation of signal and sinus-modulated gaussfunction
+            modulated_resid = resid.col(chn).cast<std::complex<double> >().cwiseProduct(modulation);
+            fft.fwd(fft_modulated_resid, modulated_resid);
+            fft.inv(corr_coeffs, VectorXcd(fft_modulated_resid.cwiseProduct(fft_envelope.conjugate())));
+
+            //find index of maximum correlation-coefficient to use in translation
+            corr_coeffs.maxCoeff(&max_index);
+
+            //adapting translation p to create atomtranslation correctly
+            if(max_index >= p) p = max_index - p + 1;
+            else p = max_index + p;
+
+            VectorXd atom_parameters = calculate_atom(sample_count, scale, p, k, chn, resid, RETURNPARAMETERS, fix_phase);
+
+            if(std::fabs(atom_parameters[4]) >= std::fabs(best[4]))
+            {
+                best = atom_parameters;
+                best_channel = chn;
+            }
+
+            if(std::fabs(atom_parameters[4]) >= std::fabs(channel_best.at(chn)[4]))
+                channel_best[chn] = atom_parameters;
+        }
+        k += pow(2.0,(-j))*sample_count/2;
     }
-    return modulation;
 }
 
 //*************************************************************************************************************
 
-VectorXd AdaptiveMp::calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, MatrixXd residuum, ReturnValue return_value = RETURNATOM, bool fix_phase = false)
+VectorXd AdaptiveMp::calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, const MatrixXd &residuum, ReturnValue return_value = RETURNATOM, bool fix_phase = false)
 {
-    GaborAtom *gabor_Atom = new GaborAtom();
+    GaborAtom gabor_Atom;
     qreal phase = 0;
     //create complex Gaboratom
-    VectorXcd complex_gabor_atom = gabor_Atom->create_complex(sample_count, scale, translation, modulation);
+    VectorXcd complex_gabor_atom = gabor_Atom.create_complex(sample_count, scale, translation, modulation);
 
     //calculate Inner Product: preparation to find the parameter phase
     std::complex<double> inner_product(0, 0);
 
     if(fix_phase == false)
-    {
-        for(qint32 i = 0; i < sample_count; i++)
-            inner_product += residuum(i, channel) * conj(complex_gabor_atom[i]);
-    }
-    else
-    {
-        for(qint32 chn = 0; chn < residuum.cols(); chn++)
-        {
-            for(qint32 i = 0; i < sample_count; i++)
-                inner_product += residuum(i, chn) * conj(complex_gabor_atom[i]);
-        }
-        if(residuum.cols() != 0)
-            inner_product /= residuum.cols();
-    }
+        inner_product = complex_gabor_atom.dot(residuum.col(channel).cast<std::complex<double> >());
+    else if(residuum.cols() != 0)
+        inner_product = complex_gabor_atom.dot(residuum.rowwise().sum().cast<std::complex<double> >()) / qreal(residuum.cols());
 
     //calculate phase to create realGaborAtoms
     phase = std::arg(inner_product);
     if (phase < 0) phase = 2 * PI - phase;
-    VectorXd real_gabor_atom = gabor_Atom->create_real(sample_count, scale, translation, modulation, phase);
 
-    delete gabor_Atom;
+    //the real atom is the normalized real part of the phase shifted complex atom, as long as both use the same envelope
+    VectorXd real_gabor_atom;
+    if(scale != sample_count || translation == floor(sample_count / 2))
+    {
+        real_gabor_atom = (complex_gabor_atom * std::polar(1.0, phase)).real();
+        qreal norm = real_gabor_atom.norm();
+        if(norm != 0) real_gabor_atom /= norm;
+    }
+    else
+        real_gabor_atom = gabor_Atom.create_real(sample_count, scale, translation, modulation, phase);
 
     switch(return_value)
     {
     case RETURNPARAMETERS:
     {
-
-        qreal scalar_product = 0;
-
-        for(qint32 i = 0; i < sample_count; i++)
-            scalar_product += real_gabor_atom[i] * residuum(i, channel);
-
         VectorXd atom_parameters = VectorXd::Zero(5);
 
         atom_parameters[0] = scale;
         atom_parameters[1] = translation;
         atom_parameters[2] = modulation;
         atom_parameters[3] = phase;
-        atom_parameters[4] = scalar_product;
-
+        atom_parameters[4] = real_gabor_atom.dot(residuum.col(channel));
 
         return atom_parameters;
     }
@@ -467,7 +535,7 @@ VectorXd AdaptiveMp::calculate_atom(qint32 sample_count, qreal scale, qint32 tra
 //*************************************************************************************************************
 
 void AdaptiveMp::simplex_maximisation(qint32 simplex_it, qreal simplex_reflection, qreal simplex_expansion, qreal simplex_contraction, qreal simplex_full_contraction,
-                                      GaborAtom *gabor_Atom, VectorXd max_scalar_product, qint32 sample_count, bool fix_phase, MatrixXd residuum, bool trial_separation, qint32 chn)
+                                      GaborAtom *gabor_Atom, const VectorXd &max_scalar_product, qint32 sample_count, bool fix_phase, const MatrixXd &residuum, bool trial_separation, qint32 chn)
 {
     //Maximisation Simplex Algorithm implemented by Botao Jia, adapted to the MP Algorithm by Martin Henfling. Copyright (C) 2010 Botao Jia
     //ToDo: change to clean use of EIGEN, @present its mixed with Namespace std and <vector>
@@ -132,6 +132,7 @@ public:
     typedef Eigen::MatrixXd MatrixXd;
 
     bool fix_phase;
+    qint32 multi_start_count;   /**< number of grid atoms of different scales the simplex optimisation starts from */
     qreal signal_energy;
     qreal current_energy;
     qreal epsilon;
@@ -173,7 +174,7 @@ public:
     *
     * @return complex modulationvector
     */
-    VectorXcd modulation_function(qint32 N, qreal k);
+    static VectorXcd modulation_function(qint32 N, qreal k);
 
     //=========================================================================================================
     /**
@@ -193,7 +194,7 @@ public:
     *
     * @return depending on returnValue returning the real atom calculated or the manipulated parameters: scale, translation, modulation, phase, scalarproduct
     */
-    static VectorXd calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, MatrixXd residuum, ReturnValue return_value, bool fix_phase);
+    static VectorXd calculate_atom(qint32 sample_count, qreal scale, qint32 translation, qreal modulation, qint32 channel, const MatrixXd &residuum, ReturnValue return_value, bool fix_phase);
 
     //=========================================================================================================
     /**
@@ -217,7 +218,51 @@ public:
     * @return depending on returnValue returning the real atom calculated or the manipulated parameters: scale, translation, modulation, phase, scalarproduct
     */
     void simplex_maximisation(qint32 simplex_it, qreal simplex_reflection, qreal simplex_expansion, qreal simplex_contraction, qreal simplex_full_contraction,
-                              GaborAtom *gabor_Atom, VectorXd max_scalar_product, qint32 sample_count, bool fix_phase, MatrixXd residuum, bool trial_separation, qint32 chn);
+                              GaborAtom *gabor_Atom, const VectorXd &max_scalar_product, qint32 sample_count, bool fix_phase, const MatrixXd &residuum, bool trial_separation, qint32 chn);
+
+    //=========================================================================================================
+    /**
+    * Searches the modulations and translations of one scale of the dyadic grid. The scales are independent of
+    * each other and are searched in parallel, the results are merged in scale order.
+    */
+    struct scale_search
+    {
+        const MatrixXd* residuum;
+        qreal scale;
+        qint32 j;
+        qint32 channel_count;
+        bool fix_phase;
+        VectorXd best;                      /**< parameters of the best atom over all channels, see calculate_atom */
+        qint32 best_channel;
+        QList<VectorXd> channel_best;       /**< parameters of the best atom of each channel */
+
+        void search();
+    };
+
+    //=========================================================================================================
+    /**
+    * One start of the simplex optimisation, so that several starts can be run in parallel.
+    */
+    struct simplex_start
+    {
+        AdaptiveMp* adaptive_mp;
+        GaborAtom atom;
+        const VectorXd* max_scalar_product;
+        const MatrixXd* residuum;
+        qint32 sample_count;
+        qint32 simplex_it;
+        qreal simplex_reflection;
+        qreal simplex_expansion;
+        qreal simplex_contraction;
+        qreal simplex_full_contraction;
+        bool fix_phase;
+
+        void maximise()
+        {
+            adaptive_mp->simplex_maximisation(simplex_it, simplex_reflection, simplex_expansion, simplex_contraction, simplex_full_contraction,
+                                              &atom, *max_scalar_product, sample_count, fix_phase, *residuum, false, atom.bm_channel);
+        }
+    };
 
     //=========================================================================================================
 
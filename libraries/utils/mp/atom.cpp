@@ -127,6 +127,34 @@ MatrixXd Atom::make_tf(qint32 sample_count, qreal scale, quint32 translation, qr
 }
 
 
+//*************************************************************************************************************
+
+VectorXcd Atom::oscillator(qint32 sample_count, qreal frequency, qreal phase, qreal chirp, qreal chirp_center)
+{
+    const qint32 block_size = 64;
+    VectorXcd oscillation(sample_count);
+
+    //phase(n+1) - phase(n) = frequency + chirp * (2 * (n - chirp_center) + 1), its increment is 2 * chirp
+    const std::complex<double> step_rotation = std::polar(1.0, 2 * chirp);
+
+    for(qint32 block = 0; block < sample_count; block += block_size)
+    {
+        qreal t = qreal(block) - chirp_center;
+        std::complex<double> value = std::polar(1.0, frequency * qreal(block) + chirp * t * t + phase);
+        std::complex<double> rotation = std::polar(1.0, frequency + chirp * (2 * t + 1));
+        qint32 block_end = std::min(block + block_size, sample_count);
+
+        for(qint32 n = block; n < block_end; n++)
+        {
+            oscillation[n] = value;
+            value *= rotation;
+            rotation *= step_rotation;
+        }
+    }
+
+    return oscillation;
+}
+
 //*************************************************************************************************************
 
 FixDictAtom::FixDictAtom(qint32 _id, qint32 _sample_count, QString _dict_source)
@@ -233,10 +261,14 @@ VectorXd GaborAtom::gauss_function (qint32 sample_count, qreal scale, quint32 tr
 {
     VectorXd gauss = VectorXd::Zero(sample_count);
 
-    for(qint32 n = 0; n < sample_count; n++)
+    //exp(-PI * t^2) is below 1e-136 for |t| > 10, such samples are left zero
+    qint32 first = std::max(0.0, floor(qreal(translation) - 10 * scale));
+    qint32 last = std::min(qreal(sample_count - 1), ceil(qreal(translation) + 10 * scale));
+
+    if(first <= last)
     {
-        qreal t = (qreal(n) - translation) / scale;
-        gauss[n] = exp(-PI * pow(t, 2))*pow(sqrt(scale),(-1))*pow(qreal(2),(0.25));
+        ArrayXd t = (ArrayXd::LinSpaced(last - first + 1, first, last) - qreal(translation)) / scale;
+        gauss.segment(first, last - first + 1) = ((-PI * t.square()).exp() * (pow(qreal(2), 0.25) / sqrt(scale))).matrix();
     }
 
     return gauss;
@@ -246,33 +278,18 @@ VectorXd GaborAtom::gauss_function (qint32 sample_count, qreal scale, quint32 tr
 
 VectorXcd GaborAtom::create_complex(qint32 sample_count, qreal scale, quint32 translation, qreal modulation)
 {
-    VectorXcd complex_atom(sample_count);
-    qreal norm_atom = 0;
+    VectorXcd complex_atom = Atom::oscillator(sample_count, 2 * PI * modulation / qreal(sample_count));
 
     //if scale == signalLength and translation == middle of signal there is no window or envelope necessary
     //thats a simplification to save calculation time and reduces the windowing effects
-    if(scale == sample_count && translation == floor(sample_count / 2))
-        for(qint32 i = 0; i < sample_count; i++)
-            complex_atom[i] = std::polar(1 / sqrt(qreal(sample_count)), 2 * PI * modulation / qreal(sample_count) * qreal(i));
-
     //else scale is smaler than signalLength and translation is not in the middle an envelopement is required
-    else
-        for(qint32 i = 0; i < sample_count; i++)
-        {
-            qreal t = (qreal(i) - qreal(translation)) / qreal(scale);
-            complex_atom[i] = std::polar(1 / sqrt(sample_count) * pow(2.0, 0.25) * exp( -PI * pow(t, 2.0))
-                                              , 2 * PI * modulation / qreal(sample_count) * qreal(i));
-        }
+    if(scale != sample_count || translation != floor(sample_count / 2))
+        complex_atom.array() *= gauss_function(sample_count, scale, translation).array().cast<std::complex<double> >();
 
     //normalization
-    for(qint32 i = 0; i < sample_count; i++)
-        norm_atom += pow(std::abs(complex_atom[i]), 2.0);
-
-    norm_atom = sqrt(norm_atom);
-
+    qreal norm_atom = complex_atom.norm();
     if(norm_atom != 0)
-        for(qint32 i = 0; i < sample_count; i++)
-            complex_atom[i] = complex_atom[i] / norm_atom;
+        complex_atom /= norm_atom;
 
     return complex_atom;
 }
@@ -281,21 +298,13 @@ VectorXcd GaborAtom::create_complex(qint32 sample_count, qreal scale, quint32 tr
 
 VectorXd GaborAtom::create_real(qint32 sample_count, qreal scale, quint32 translation, qreal modulation, qreal phase)
 {
-    VectorXd real_atom(sample_count);
-    qreal norm = 0;
+    VectorXd real_atom = Atom::oscillator(sample_count, 2 * PI * modulation / sample_count, phase).real();
 
-    if(scale == sample_count)
-        for(qint32 i = 0; i < sample_count; i++)
-            real_atom[i] = 1 / sqrt(sample_count) * cos( 2 * PI * modulation / sample_count * qreal(i) + phase);
-    else
-    {
-        VectorXd envelope = GaborAtom::gauss_function(sample_count, scale, translation);
-        for(qint32 i = 0; i < sample_count; i++)
-            real_atom[i] = envelope[i] * cos(2 * PI * modulation / sample_count * qreal(i) + phase);
-    }
+    if(scale != sample_count)
+        real_atom.array() *= GaborAtom::gauss_function(sample_count, scale, translation).array();
 
     //normalization
-    norm = real_atom.norm();
+    qreal norm = real_atom.norm();
     if(norm != 0) real_atom /= norm;
 
     return real_atom; //length of the vector realAtom is 1 after normalization
@@ -305,37 +314,21 @@ VectorXd GaborAtom::create_real(qint32 sample_count, qreal scale, quint32 transl
 
 VectorXd ChirpAtom::gauss_function (qint32 sample_count, qreal scale, quint32 translation)
 {
-    VectorXd gauss = VectorXd::Zero(sample_count);
-
-    for(qint32 n = 0; n < sample_count; n++)
-    {
-        qreal t = (qreal(n) - translation) / scale;
-        gauss[n] = exp(-PI * pow(t, 2)) * pow(sqrt(scale), (-1)) * pow(qreal(2),(0.25));
-    }
-
-    return gauss;
+    return GaborAtom::gauss_function(sample_count, scale, translation);
 }
 
 //*************************************************************************************************************
 
 VectorXd ChirpAtom::create_real(qint32 sample_count, qreal scale, quint32 translation, qreal modulation, qreal phase, qreal chirp)
 {
-    VectorXd real_atom(sample_count);
-    qreal norm = 0;
+    VectorXd real_atom = Atom::oscillator(sample_count, 2 * PI * modulation / sample_count, phase,
+                                          chirp / (sample_count * qreal(2)), qreal(translation)).real();
 
-
-    if(scale == sample_count)
-        for(qint32 i = 0; i < sample_count; i++)
-            real_atom[i] = 1 / sqrt(sample_count) * cos( 2 * PI * modulation / sample_count * qreal(i) +(chirp / (sample_count * qreal(2))) * pow(qreal(i) - qreal(translation), 2) + phase);
-    else
-    {
-        VectorXd envelope = GaborAtom::gauss_function(sample_count, scale, translation);
-        for(qint32 i = 0; i < sample_count; i++)
-            real_atom[i] = envelope[i] * cos(2 * PI * modulation / sample_count * qreal(i) + (chirp / (sample_count * qreal(2))) * pow(qreal(i) - qreal(translation), 2) + phase);
-    }
+    if(scale != sample_count)
+        real_atom.array() *= GaborAtom::gauss_function(sample_count, scale, translation).array();
 
     //normalization
-    norm = real_atom.norm();
+    qreal norm = real_atom.norm();
     if(norm != 0) real_atom /= norm;
 
     return real_atom; //length of the vector realAtom is 1 after normalization
@@ -127,6 +127,26 @@ public:
     */
     MatrixXd make_tf (qint32 sample_count, qreal scale, quint32 translation, qreal modulation);
 
+    //=========================================================================================================
+    /**
+    * Atom_oscillator
+    *
+    * ### MP toolbox root function ###
+    *
+    * calculates exp(i * (frequency * n + chirp * (n - chirp_center)^2 + phase)) for n = 0..sample_count-1 by
+    * complex rotation instead of evaluating sin and cos for every sample. The recursion is restarted from the
+    * exact value every 64 samples to bound the rounding drift.
+    *
+    * @param[in] sample_count   number of samples
+    * @param[in] frequency      angular frequency in radians per sample
+    * @param[in] phase          phase at n = 0 (without chirp)
+    * @param[in] chirp          quadratic phase coefficient
+    * @param[in] chirp_center   sample around which the chirp is centered
+    *
+    * @return complex oscillation
+    */
+    static VectorXcd oscillator(qint32 sample_count, qreal frequency, qreal phase = 0, qreal chirp = 0, qreal chirp_center = 0);
+
 };
 
 //=============================================================================================================
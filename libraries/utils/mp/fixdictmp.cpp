@@ -51,7 +51,10 @@
 //=============================================================================================================
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
+#include <complex>
+#include <cstring>
 #include <math.h>
 
 
@@ -73,7 +76,9 @@
 #include <QtConcurrent>
 #include <QFuture>
 #include <QFile>
+#include <QFileInfo>
 #include <QStringList>
+#include <QDebug>
 
 
 //*************************************************************************************************************
@@ -83,6 +88,244 @@
 
 using namespace UTILSLIB;
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE STATIC CONSTANTS
+//=============================================================================================================
+
+// binary dictionary layout: header, then per dictionary a header, source and formula string, atom ids, atom
+// lengths, 8 parameters per atom, all atom samples and the conjugated half spectra of all atoms.
+// Every block starts at an 8 byte boundary, so the file can be memory mapped.
+static const char binary_dict_magic[8] = {'M', 'N', 'E', 'M', 'P', 'D', 'I', 'C'};
+static const quint32 binary_dict_byte_order = 0x01020304;
+static const quint32 binary_dict_version = 1;
+static const qint32 binary_dict_param_count = 8;
+
+struct binary_dict_file_header
+{
+    char magic[8];
+    quint32 byte_order;
+    quint32 version;
+    quint32 dict_count;
+    quint32 reserved;
+};
+
+struct binary_dict_header
+{
+    quint32 type;
+    qint32 sample_count;
+    qint32 atom_count;
+    qint32 spectra_sample_count;
+    quint32 source_length;
+    quint32 formula_length;
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+// maps count items of a memory mapped binary dictionary, pos is moved to the next 8 byte boundary
+template<typename T>
+static const T* map_binary_items(const uchar* data, qint64 size, qint64 &pos, qint64 count)
+{
+    // compare item counts, so a corrupt count cannot overflow the byte size
+    if(count < 0 || pos > size || count > (size - pos) / qint64(sizeof(T)))
+        return 0;
+
+    qint64 bytes = count * qint64(sizeof(T));
+
+    const T* items = reinterpret_cast<const T*>(data + pos);
+    pos += (bytes + 7) & ~qint64(7);
+
+    return items;
+}
+
+
+//*************************************************************************************************************
+
+// writes count items to a binary dictionary and pads them to the next 8 byte boundary
+template<typename T>
+static bool write_binary_items(QFile &file, const T* items, qint64 count)
+{
+    qint64 bytes = count * qint64(sizeof(T));
+    static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    if(bytes > 0 && file.write(reinterpret_cast<const char*>(items), bytes) != bytes)
+        return false;
+
+    qint64 pad = ((bytes + 7) & ~qint64(7)) - bytes;
+    return pad == 0 || file.write(padding, pad) == pad;
+}
+
+
+//*************************************************************************************************************
+
+// the 8 parameters of an atom in the binary format, depending on the dictionary type
+static void atom_to_params(const FixDictAtom &atom, AtomType type, double *params)
+{
+    for(qint32 i = 0; i < binary_dict_param_count; i++)
+        params[i] = 0;
+
+    switch(type)
+    {
+    case GABORATOM:
+        params[0] = atom.gabor_atom.scale;
+        params[1] = atom.gabor_atom.modulation;
+        params[2] = atom.gabor_atom.phase;
+        break;
+    case CHIRPATOM:
+        params[0] = atom.chirp_atom.scale;
+        params[1] = atom.chirp_atom.modulation;
+        params[2] = atom.chirp_atom.phase;
+        params[3] = atom.chirp_atom.chirp;
+        break;
+    default:
+        params[0] = atom.formula_atom.a;
+        params[1] = atom.formula_atom.b;
+        params[2] = atom.formula_atom.c;
+        params[3] = atom.formula_atom.d;
+        params[4] = atom.formula_atom.e;
+        params[5] = atom.formula_atom.f;
+        params[6] = atom.formula_atom.g;
+        params[7] = atom.formula_atom.h;
+        break;
+    }
+}
+
+
+//*************************************************************************************************************
+
+static void params_to_atom(const double *params, AtomType type, FixDictAtom &atom)
+{
+    switch(type)
+    {
+    case GABORATOM:
+        atom.gabor_atom.scale = params[0];
+        atom.gabor_atom.modulation = params[1];
+        atom.gabor_atom.phase = params[2];
+        break;
+    case CHIRPATOM:
+        atom.chirp_atom.scale = params[0];
+        atom.chirp_atom.modulation = params[1];
+        atom.chirp_atom.phase = params[2];
+        atom.chirp_atom.chirp = params[3];
+        break;
+    default:
+        atom.formula_atom.a = params[0];
+        atom.formula_atom.b = params[1];
+        atom.formula_atom.c = params[2];
+        atom.formula_atom.d = params[3];
+        atom.formula_atom.e = params[4];
+        atom.formula_atom.f = params[5];
+        atom.formula_atom.g = params[6];
+        atom.formula_atom.h = params[7];
+        break;
+    }
+}
+
+
+//*************************************************************************************************************
+
+// reducing the number of observed channels in the algorithm to increase speed performance
+static qint32 boosted_channel_count(qint32 channel_count, qint32 boost)
+{
+    qint32 boosted_count = channel_count * (boost / 100.0);
+    if(boost == 0 || boosted_count == 0)
+        boosted_count = 1;
+
+    return boosted_count;
+}
+
+
+//*************************************************************************************************************
+
+// cut or zero pad the atom around its center to the signal length and normalize it
+static VectorXd fit_atom(const VectorXd &atom_samples, qint32 sample_count)
+{
+    VectorXd fitted_atom = VectorXd::Zero(sample_count);
+    qint32 p = floor(sample_count / 2);//translation
+
+    VectorXd resized_atom = VectorXd::Zero(sample_count);
+
+    if(atom_samples.rows() > sample_count)
+        for(qint32 k = 0; k < sample_count; k++)
+            resized_atom[k] = atom_samples[k + floor(atom_samples.rows() / 2) - floor(sample_count / 2)];
+    else resized_atom = atom_samples;
+
+    if(resized_atom.rows() < sample_count)
+        for(qint32 k = 0; k < resized_atom.rows(); k++)
+            fitted_atom[(k + p - floor(resized_atom.rows() / 2))] = resized_atom[k];
+    else fitted_atom = resized_atom;
+
+    //normalization
+    qreal norm = fitted_atom.norm();
+    if(norm != 0) fitted_atom /= norm;
+
+    return fitted_atom;
+}
+
+
+//*************************************************************************************************************
+
+// lengths of the circular windows whose energies bound the correlation of localized atoms
+static VectorXi bound_window_lengths(qint32 sample_count)
+{
+    qint32 count = 0;
+    for(qint32 length = 8; length < sample_count; length *= 2)
+        count++;
+
+    VectorXi lengths(count);
+    for(qint32 i = 0; i < count; i++)
+        lengths[i] = 8 << i;
+
+    return lengths;
+}
+
+
+//*************************************************************************************************************
+
+// largest energy of the samples within a circular window, for each window length
+static VectorXd max_window_energy(const VectorXd &samples, const VectorXi &lengths)
+{
+    const qint32 sample_count = samples.rows();
+
+    VectorXd cumulated_energy(2 * sample_count + 1);
+    cumulated_energy[0] = 0;
+    for(qint32 k = 0; k < 2 * sample_count; k++)
+        cumulated_energy[k + 1] = cumulated_energy[k] + samples[k % sample_count] * samples[k % sample_count];
+
+    VectorXd window_energy(lengths.rows());
+    for(qint32 i = 0; i < lengths.rows(); i++)
+        window_energy[i] = (cumulated_energy.segment(lengths[i], sample_count) - cumulated_energy.head(sample_count)).maxCoeff();
+
+    return window_energy;
+}
+
+
+//*************************************************************************************************************
+
+// the correlation jobs of an iteration share their best absolute maximum, non-negative doubles order like their bits
+static double shared_best_value(const QAtomicInteger<qint64> *shared_best)
+{
+    qint64 bits = shared_best->loadAcquire();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void raise_shared_best(QAtomicInteger<qint64> *shared_best, double value)
+{
+    qint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    qint64 current = shared_best->loadAcquire();
+    while(bits > current && !shared_best->testAndSetOrdered(current, bits, current)) {}
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -112,6 +355,7 @@ FixDictMp::~FixDictMp()
 Dictionary::Dictionary()
 : type(GABORATOM)
 , sample_count(0)
+, spectra_sample_count(0)
 {
 
 }
@@ -145,7 +389,7 @@ void FixDictMp::matching_pursuit(MatrixXd signal, qint32 max_iterations, qreal e
     bool sample_count_mismatch = false;
 
     this->residuum = signal;
-    parsed_dicts = parse_xml_dict(path);
+    parsed_dicts = parse_dict(path);
 
     //calculate signal_energy
     for(qint32 channel = 0; channel < channel_count; channel++)
@@ -159,19 +403,40 @@ void FixDictMp::matching_pursuit(MatrixXd signal, qint32 max_iterations, qreal e
 
     std::cout << "absolute energy of signal: " << residuum_energy << "\n";
 
-    while(it < max_iterations && energy_threshold < residuum_energy)
-    {
-        FixDictAtom global_best_matching;
+    //the atom spectra only depend on the signal length and are shared by all iterations
+    for(qint32 i = 0; i < parsed_dicts.length(); i++)
+        parsed_dicts[i].compute_spectra(sample_count);
+
+    qint32 observed_channel_count = boosted_channel_count(channel_count, boost);
 
-        QList<find_best_matching> list_of_best;
-        for(qint32 i = 0; i < parsed_dicts.length(); i++)
+    //split the dictionaries into blocks of atoms, so that large dictionaries are searched in parallel as well
+    const qint32 atoms_per_job = 256;
+    QList<find_best_matching> list_of_best;
+    residuum_spectra_data resid_spectra;
+    QAtomicInteger<qint64> shared_best;
+
+    for(qint32 i = 0; i < parsed_dicts.length(); i++)
+    {
+        for(qint32 first_atom = 0; first_atom < parsed_dicts.at(i).atom_spectra.cols(); first_atom += atoms_per_job)
         {
             find_best_matching current_best_matching;
-            current_best_matching.pdict = parsed_dicts.at(i);
-            current_best_matching.current_resid = this->residuum;
-            current_best_matching.boost = boost;
+            current_best_matching.pdict = &parsed_dicts.at(i);
+            current_best_matching.resid_spectra = &resid_spectra;
+            current_best_matching.sample_count = sample_count;
+            current_best_matching.first_atom = first_atom;
+            current_best_matching.atom_count = qMin(atoms_per_job, qint32(parsed_dicts.at(i).atom_spectra.cols()) - first_atom);
+            current_best_matching.shared_best = &shared_best;
             list_of_best.append(current_best_matching);
         }
+    }
+
+    while(it < max_iterations && energy_threshold < residuum_energy)
+    {
+        FixDictAtom global_best_matching;
+
+        //the residuum does not change within an iteration, so its spectra are computed once for all atoms
+        resid_spectra = residuum_spectra(this->residuum, observed_channel_count);
+        shared_best.storeRelease(0);
 
         QFuture<FixDictAtom> mapped_best_matchings = QtConcurrent::mapped(list_of_best, &find_best_matching::parallel_correlation);// parse_threads;
         mapped_best_matchings.waitForFinished();
@@ -285,91 +550,132 @@ void FixDictMp::matching_pursuit(MatrixXd signal, qint32 max_iterations, qreal e
 //*************************************************************************************************************
 
 // calc scalarproduct of Atom and Signal
-FixDictAtom FixDictMp::correlation(Dictionary current_pdict, MatrixXd current_resid, qint32 boost)
+FixDictAtom FixDictMp::correlation(const Dictionary &current_pdict, const MatrixXd &current_resid, qint32 boost)
 {
-    #ifdef EIGEN_FFTW_DEFAULT
-        fftw_make_planner_thread_safe();
-    #endif
+    residuum_spectra_data resid_spectra = residuum_spectra(current_resid, boosted_channel_count(current_resid.cols(), boost));
 
-    qint32 channel_count = current_resid.cols() * (boost / 100.0); //reducing the number of observed channels in the algorithm to increase speed performance
-    if(boost == 0 || channel_count == 0)
-        channel_count = 1;
+    if(current_pdict.spectra_sample_count == current_resid.rows() && current_pdict.atom_spectra.cols() == current_pdict.atoms.length()
+            && current_pdict.atom_window_energy.cols() == current_pdict.atoms.length())
+        return correlation(current_pdict, resid_spectra, current_resid.rows());
 
-    Eigen::FFT<double> fft;
-    std::ptrdiff_t max_index;
-    VectorXcd fft_atom = VectorXcd::Zero(current_resid.rows());
+    Dictionary fitted_pdict = current_pdict;
+    fitted_pdict.compute_spectra(current_resid.rows());
 
-    FixDictAtom best_matching;
-    qreal max_scalar_product = 0;
+    return correlation(fitted_pdict, resid_spectra, current_resid.rows());
+}
 
-    for(qint32 i = 0; i < current_pdict.atoms.length(); i++)
-    {
-        VectorXd fitted_atom = VectorXd::Zero(current_resid.rows());
-        qint32 p = floor(current_resid.rows() / 2);//translation
 
-        VectorXd resized_atom = VectorXd::Zero(current_resid.rows());
+//*************************************************************************************************************
 
-        if(current_pdict.atoms.at(i).atom_samples.rows() > current_resid.rows())
-            for(qint32 k = 0; k < current_resid.rows(); k++)
-                resized_atom[k] = current_pdict.atoms.at(i).atom_samples[k + floor(current_pdict.atoms.at(i).atom_samples.rows() / 2) - floor(current_resid.rows() / 2)];
-        else resized_atom = current_pdict.atoms.at(i).atom_samples;
+FixDictAtom FixDictMp::correlation(const Dictionary &current_pdict, const residuum_spectra_data &resid_spectra, qint32 sample_count,
+                                   qint32 first_atom, qint32 atom_count, QAtomicInteger<qint64> *shared_best)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+        fftw_make_planner_thread_safe();
+    #endif
 
-        if(resized_atom.rows() < current_resid.rows())
-            for(qint32 k = 0; k < resized_atom.rows(); k++)
-                fitted_atom[(k + p - floor(resized_atom.rows() / 2))] = resized_atom[k];
-        else fitted_atom = resized_atom;
+    if(atom_count < 0)
+        atom_count = current_pdict.atom_spectra.cols() - first_atom;
 
-        //normalization
-        qreal norm = 0;
-        norm = fitted_atom.norm();
-        if(norm != 0) fitted_atom /= norm;
+    if(atom_count <= 0 || resid_spectra.spectra.cols() == 0)
+        return FixDictAtom();
+
+    const qint32 channel_count = resid_spectra.spectra.cols();
 
-        fft.fwd(fft_atom, fitted_atom);
+    //a correlation value is the inverse transform of the product spectrum, so it is at most the weighted sum of the
+    //spectrum magnitudes. This bound is tight for narrow band atoms, one pair of atom and channel per entry.
+    MatrixXd bounds = current_pdict.atom_spectra_abs.middleCols(first_atom, atom_count).transpose() * resid_spectra.spectra_abs;
 
-        for(qint32 chn = 0; chn < channel_count; chn++)
+    //the part of a short atom inside a window meets at most the largest window energy of the channel, the rest of
+    //the atom at most the whole channel
+    if(current_pdict.atom_window_energy.rows() == resid_spectra.window_energy.rows())
+        for(qint32 w = 0; w < resid_spectra.window_energy.rows(); w++)
         {
-            p = floor(current_resid.rows() / 2);//translation
-            VectorXd corr_coeffs = VectorXd::Zero(current_resid.rows());
-            VectorXcd fft_signal = VectorXcd::Zero(current_resid.rows());
-            VectorXcd fft_sig_atom = VectorXcd::Zero(current_resid.rows());
+            ArrayXd inside = current_pdict.atom_window_energy.row(w).segment(first_atom, atom_count).transpose().array().min(1.0);
+            MatrixXd window_bounds = inside.sqrt().matrix() * resid_spectra.window_energy.row(w).cwiseSqrt()
+                                     + (1.0 - inside).sqrt().matrix() * resid_spectra.norms;
+            bounds = bounds.cwiseMin(window_bounds);
+        }
 
-            fft.fwd(fft_signal, current_resid.col(chn));
+    //visit the pairs by decreasing bound, the search ends as soon as no bound exceeds the best maximum
+    std::vector<qint32> order(atom_count * channel_count);
+    for(qint32 k = 0; k < qint32(order.size()); k++)
+        order[k] = k;
 
-            for( qint32 m = 0; m < current_resid.rows(); m++)
-                fft_sig_atom[m] = fft_signal[m] * conj(fft_atom[m]);
+    const double* bound_data = bounds.data();
+    std::sort(order.begin(), order.end(), [bound_data](qint32 a, qint32 b) {
+        return bound_data[a] > bound_data[b] || (bound_data[a] == bound_data[b] && a < b);
+    });
 
-            fft.inv(corr_coeffs, fft_sig_atom);
+    //rounding of the bounds is covered by the slack
+    const double slack = 1.0 + 1e-9;
+    const double scaling = 1.0 / sample_count;
 
-            //find index of maximum correlation-coefficient to use in translation
-            max_scalar_product = corr_coeffs.maxCoeff(&max_index);
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+    fft.SetFlag(fft.Unscaled);
 
-            if(i == 0)
-            {
-                best_matching = current_pdict.atoms.at(i);
-                best_matching.max_scalar_product = max_scalar_product;
+    VectorXcd fft_sig_atom;
+    VectorXd corr_coeffs;
+    std::ptrdiff_t max_index;
 
-                //adapting translation p to create atomtranslation correctly
-                if(max_index >= p && current_resid.rows() % (2) == 0) p = max_index - p;
-                else if(max_index >= p && current_resid.rows() % (2) != 0) p = max_index - p - 1;
-                else p = max_index + p;
+    qint32 best_atom = -1;
+    qint32 best_chn = 0;
+    qint32 best_index = 0;
+    double best_product = 0;
+    double best_abs = -1;
 
-                best_matching.translation = p;
-            }
+    for(qint32 k = 0; k < qint32(order.size()); k++)
+    {
+        const double bound = bound_data[order[k]] * slack;
+        if(bound < best_abs || (shared_best && bound < shared_best_value(shared_best)))
+            break;
 
-            else if(std::fabs(max_scalar_product) > std::fabs(best_matching.max_scalar_product))
-            {
-                best_matching = current_pdict.atoms.at(i);
-                best_matching.max_scalar_product = max_scalar_product;
+        const qint32 atom = order[k] % atom_count;
+        const qint32 chn = order[k] / atom_count;
 
-                //adapting translation p to create atomtranslation correctly
-                if(max_index >= p && current_resid.rows() % (2) == 0) p = max_index - p;
-                else if(max_index >= p && current_resid.rows() % (2) != 0) p = max_index - p - 1;
-                else p = max_index + p;
+        fft_sig_atom = current_pdict.atom_spectra.col(first_atom + atom).cwiseProduct(resid_spectra.spectra.col(chn));
+        fft.inv(corr_coeffs, fft_sig_atom, sample_count);
 
-                best_matching.translation = p;
-            }
+        //find index of maximum correlation-coefficient to use in translation, only this value needs the scaling
+        const double product = corr_coeffs.maxCoeff(&max_index) * scaling;
+
+        //equal maxima are resolved in dictionary order, as by an exhaustive search
+        if(std::fabs(product) > best_abs
+                || (std::fabs(product) == best_abs && (atom < best_atom || (atom == best_atom && chn < best_chn))))
+        {
+            best_atom = atom;
+            best_chn = chn;
+            best_index = max_index;
+            best_product = product;
+            best_abs = std::fabs(product);
+
+            if(shared_best)
+                raise_shared_best(shared_best, best_abs);
         }
     }
+
+    //another job already found a better atom
+    if(best_atom < 0)
+    {
+        FixDictAtom no_matching;
+        no_matching.max_scalar_product = 0;
+        return no_matching;
+    }
+
+    FixDictAtom best_matching = current_pdict.atoms.at(first_atom + best_atom);
+    best_matching.max_scalar_product = best_product;
+
+    //adapting translation p to create atomtranslation correctly
+    qint32 p = floor(sample_count / 2);//translation
+    max_index = best_index;
+
+    if(max_index >= p && sample_count % (2) == 0) p = max_index - p;
+    else if(max_index >= p && sample_count % (2) != 0) p = max_index - p - 1;
+    else p = max_index + p;
+
+    best_matching.translation = p;
+
     best_matching.atom_formula = current_pdict.atom_formula;
     best_matching.dict_source = current_pdict.source;
     best_matching.type = current_pdict.type;
@@ -379,6 +685,39 @@ FixDictAtom FixDictMp::correlation(Dictionary current_pdict, MatrixXd current_re
 }
 
 
+//*************************************************************************************************************
+
+FixDictMp::residuum_spectra_data FixDictMp::residuum_spectra(const MatrixXd &current_resid, qint32 channel_count)
+{
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    channel_count = qMin(channel_count, qint32(current_resid.cols()));
+    const VectorXi window_lengths = bound_window_lengths(current_resid.rows());
+
+    residuum_spectra_data resid_spectra;
+    resid_spectra.spectra.resize(current_resid.rows() / 2 + 1, channel_count);
+    resid_spectra.window_energy.resize(window_lengths.rows(), channel_count);
+    resid_spectra.norms.resize(channel_count);
+
+    VectorXcd fft_signal;
+    VectorXd signal;
+
+    for(qint32 chn = 0; chn < channel_count; chn++)
+    {
+        signal = current_resid.col(chn);
+        fft.fwd(fft_signal, signal);
+        resid_spectra.spectra.col(chn) = fft_signal;
+        resid_spectra.window_energy.col(chn) = max_window_energy(signal, window_lengths);
+        resid_spectra.norms[chn] = signal.norm();
+    }
+
+    resid_spectra.spectra_abs = resid_spectra.spectra.cwiseAbs();
+
+    return resid_spectra;
+}
+
+
 //*************************************************************************************************************
 
 QList<Dictionary> FixDictMp::parse_xml_dict(QString path)
@@ -429,6 +768,250 @@ QList<Dictionary> FixDictMp::parse_xml_dict(QString path)
 }
 
 
+//*************************************************************************************************************
+
+QList<Dictionary> FixDictMp::parse_dict(QString path)
+{
+    QList<Dictionary> parsed_dict;
+
+    if(is_binary_dict(path))
+        parsed_dict = read_binary_dict(path);
+    else
+    {
+        QFileInfo xml_info(path);
+        QFileInfo binary_info(binary_dict_path(path));
+
+        if(binary_info.exists() && (!xml_info.exists() || binary_info.lastModified() >= xml_info.lastModified()))
+            parsed_dict = read_binary_dict(binary_info.filePath());
+
+        if(parsed_dict.isEmpty())
+            return parse_xml_dict(path);
+    }
+
+    for(qint32 i = 0; i < parsed_dict.length(); i++)
+    {
+        if(parsed_dict.at(i).sample_count != this->residuum.rows())
+        {
+            emit send_warning(2);
+            break;
+        }
+    }
+
+    return parsed_dict;
+}
+
+
+//*************************************************************************************************************
+
+bool FixDictMp::convert_xml_dict(QString xml_path, QString binary_path)
+{
+    QList<Dictionary> parsed_dict = parse_xml_dict(xml_path);
+
+    if(parsed_dict.isEmpty())
+    {
+        qWarning() << "FixDictMp::convert_xml_dict - no dictionaries found in" << xml_path;
+        return false;
+    }
+
+    return write_binary_dict(parsed_dict, binary_path);
+}
+
+
+//*************************************************************************************************************
+
+QList<Dictionary> FixDictMp::read_binary_dict(const QString &path)
+{
+    QList<Dictionary> dicts;
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "FixDictMp::read_binary_dict - could not open" << path;
+        return dicts;
+    }
+
+    const qint64 size = file.size();
+    const uchar* data = file.map(0, size);
+    if(!data)
+    {
+        qWarning() << "FixDictMp::read_binary_dict - could not map" << path;
+        return dicts;
+    }
+
+    qint64 pos = 0;
+    const binary_dict_file_header* file_header = map_binary_items<binary_dict_file_header>(data, size, pos, 1);
+
+    if(!file_header || memcmp(file_header->magic, binary_dict_magic, 8) != 0
+            || file_header->byte_order != binary_dict_byte_order || file_header->version != binary_dict_version)
+    {
+        qWarning() << "FixDictMp::read_binary_dict - no binary dictionary of this version and byte order:" << path;
+        file.unmap(const_cast<uchar*>(data));
+        return dicts;
+    }
+
+    for(quint32 d = 0; d < file_header->dict_count; d++)
+    {
+        const binary_dict_header* header = map_binary_items<binary_dict_header>(data, size, pos, 1);
+        if(!header || header->atom_count < 0 || header->type > quint32(FORMULAATOM))
+            break;
+
+        const char* source = map_binary_items<char>(data, size, pos, header->source_length);
+        const char* formula = map_binary_items<char>(data, size, pos, header->formula_length);
+        const qint32* ids = map_binary_items<qint32>(data, size, pos, header->atom_count);
+        const qint32* lengths = map_binary_items<qint32>(data, size, pos, header->atom_count);
+        const double* params = map_binary_items<double>(data, size, pos, qint64(header->atom_count) * binary_dict_param_count);
+
+        if(!source || !formula || !ids || !lengths || !params)
+            break;
+
+        // a negative length would let the sum pass the bounds check while the atoms are read out of bounds
+        qint64 total_length = 0;
+        qint32 checked_count = 0;
+        for(; checked_count < header->atom_count && lengths[checked_count] >= 0; checked_count++)
+            total_length += lengths[checked_count];
+
+        if(checked_count < header->atom_count)
+            break;
+
+        const double* samples = map_binary_items<double>(data, size, pos, total_length);
+        const std::complex<double>* spectra = 0;
+        if(header->spectra_sample_count > 0)
+            spectra = map_binary_items<std::complex<double> >(data, size, pos, qint64(header->spectra_sample_count / 2 + 1) * header->atom_count);
+
+        if(!samples || (header->spectra_sample_count > 0 && !spectra))
+            break;
+
+        Dictionary dict;
+        dict.type = AtomType(header->type);
+        dict.sample_count = header->sample_count;
+        dict.source = QString::fromUtf8(source, header->source_length);
+        dict.atom_formula = QString::fromUtf8(formula, header->formula_length);
+        dict.atoms.reserve(header->atom_count);
+
+        for(qint32 i = 0; i < header->atom_count; i++)
+        {
+            FixDictAtom atom;
+            atom.id = ids[i];
+            params_to_atom(params + qint64(i) * binary_dict_param_count, dict.type, atom);
+            atom.atom_samples = Map<const VectorXd>(samples, lengths[i]);
+            samples += lengths[i];
+
+            dict.atoms.append(atom);
+        }
+
+        if(spectra)
+        {
+            dict.atom_spectra = Map<const MatrixXcd>(spectra, header->spectra_sample_count / 2 + 1, header->atom_count);
+            dict.spectra_sample_count = header->spectra_sample_count;
+        }
+
+        dicts.append(dict);
+    }
+
+    if(dicts.length() != qint32(file_header->dict_count))
+        qWarning() << "FixDictMp::read_binary_dict - file is truncated or corrupt:" << path;
+
+    file.unmap(const_cast<uchar*>(data));
+
+    return dicts;
+}
+
+
+//*************************************************************************************************************
+
+bool FixDictMp::write_binary_dict(const QList<Dictionary> &dicts, const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "FixDictMp::write_binary_dict - could not open" << path;
+        return false;
+    }
+
+    binary_dict_file_header file_header;
+    memcpy(file_header.magic, binary_dict_magic, 8);
+    file_header.byte_order = binary_dict_byte_order;
+    file_header.version = binary_dict_version;
+    file_header.dict_count = dicts.length();
+    file_header.reserved = 0;
+
+    bool ok = write_binary_items(file, &file_header, 1);
+
+    for(qint32 d = 0; ok && d < dicts.length(); d++)
+    {
+        Dictionary dict = dicts.at(d);
+        dict.compute_spectra(dict.sample_count);
+
+        QByteArray source = dict.source.toUtf8();
+        QByteArray formula = dict.atom_formula.toUtf8();
+
+        binary_dict_header header;
+        header.type = dict.type;
+        header.sample_count = dict.sample_count;
+        header.atom_count = dict.atoms.length();
+        header.spectra_sample_count = dict.atom_spectra.cols() == dict.atoms.length() ? dict.spectra_sample_count : 0;
+        header.source_length = source.size();
+        header.formula_length = formula.size();
+
+        QVector<qint32> ids(header.atom_count);
+        QVector<qint32> lengths(header.atom_count);
+        QVector<double> params(header.atom_count * binary_dict_param_count);
+
+        for(qint32 i = 0; i < header.atom_count; i++)
+        {
+            ids[i] = dict.atoms.at(i).id;
+            lengths[i] = dict.atoms.at(i).atom_samples.rows();
+            atom_to_params(dict.atoms.at(i), dict.type, params.data() + i * binary_dict_param_count);
+        }
+
+        ok = write_binary_items(file, &header, 1)
+                && write_binary_items(file, source.constData(), source.size())
+                && write_binary_items(file, formula.constData(), formula.size())
+                && write_binary_items(file, ids.constData(), ids.size())
+                && write_binary_items(file, lengths.constData(), lengths.size())
+                && write_binary_items(file, params.constData(), params.size());
+
+        for(qint32 i = 0; ok && i < header.atom_count; i++)
+            ok = file.write(reinterpret_cast<const char*>(dict.atoms.at(i).atom_samples.data()),
+                            qint64(lengths[i]) * sizeof(double)) == qint64(lengths[i]) * qint64(sizeof(double));
+
+        // the samples are doubles, so the next block is already aligned
+        if(ok && header.spectra_sample_count > 0)
+            ok = write_binary_items(file, dict.atom_spectra.data(), dict.atom_spectra.size());
+    }
+
+    if(!ok)
+    {
+        qWarning() << "FixDictMp::write_binary_dict - could not write" << path;
+        file.remove();
+    }
+
+    return ok;
+}
+
+
+//*************************************************************************************************************
+
+bool FixDictMp::is_binary_dict(const QString &path)
+{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    char magic[8];
+    return file.read(magic, 8) == 8 && memcmp(magic, binary_dict_magic, 8) == 0;
+}
+
+
+//*************************************************************************************************************
+
+QString FixDictMp::binary_dict_path(const QString &path)
+{
+    QFileInfo info(path);
+    return info.path() + "/" + info.completeBaseName() + ".b" + info.suffix();
+}
+
+
 //*************************************************************************************************************
 
 Dictionary FixDictMp::fill_dict(const QDomNode &pdict)
@@ -584,6 +1167,54 @@ qint32 Dictionary::atom_count()
 }
 
 
+//*************************************************************************************************************
+
+void Dictionary::compute_spectra(qint32 signal_sample_count)
+{
+    if(signal_sample_count <= 0)
+        return;
+
+    const bool spectra_fit = spectra_sample_count == signal_sample_count && atom_spectra.cols() == atoms.length();
+
+    if(spectra_fit && atom_spectra_abs.cols() == atoms.length() && atom_window_energy.cols() == atoms.length())
+        return;
+
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    VectorXcd fft_atom;
+    VectorXd fitted_atom;
+    const VectorXi window_lengths = bound_window_lengths(signal_sample_count);
+
+    if(!spectra_fit)
+        atom_spectra.resize(signal_sample_count / 2 + 1, atoms.length());
+    atom_window_energy.resize(window_lengths.rows(), atoms.length());
+
+    for(qint32 i = 0; i < atoms.length(); i++)
+    {
+        fitted_atom = fit_atom(atoms.at(i).atom_samples, signal_sample_count);
+
+        if(!spectra_fit)
+        {
+            fft.fwd(fft_atom, fitted_atom);
+            atom_spectra.col(i) = fft_atom.conjugate();
+        }
+
+        atom_window_energy.col(i) = max_window_energy(fitted_atom, window_lengths);
+    }
+
+    //the inner bins of a real signal count twice in the inverse transform, which divides by the signal length
+    VectorXd weights = VectorXd::Constant(atom_spectra.rows(), 2.0 / signal_sample_count);
+    weights[0] = 1.0 / signal_sample_count;
+    if(signal_sample_count % 2 == 0)
+        weights[weights.rows() - 1] = 1.0 / signal_sample_count;
+
+    atom_spectra_abs = atom_spectra.cwiseAbs().array().colwise() * weights.array();
+
+    spectra_sample_count = signal_sample_count;
+}
+
+
 //*************************************************************************************************************
 
  void Dictionary::clear()
@@ -592,6 +1223,10 @@ qint32 Dictionary::atom_count()
      this->atom_formula = "";
      this->sample_count = 0;
      this->source = "";
+     this->atom_spectra.resize(0, 0);
+     this->spectra_sample_count = 0;
+     this->atom_spectra_abs.resize(0, 0);
+     this->atom_window_energy.resize(0, 0);
  }
 
 
@@ -63,6 +63,7 @@
 //=============================================================================================================
 
 #include <QtXml>
+#include <QAtomicInteger>
 
 
 //*************************************************************************************************************
@@ -120,11 +121,30 @@ public:
     QString source;
     QString atom_formula;
     qint32 sample_count;
+    MatrixXcd atom_spectra;         /**< conjugated half spectra of the fitted, normalized atoms, one column per atom */
+    qint32 spectra_sample_count;    /**< signal length atom_spectra were computed for, 0 if not computed */
+    MatrixXd atom_spectra_abs;      /**< magnitudes of atom_spectra, weighted so that they bound the correlation maximum */
+    MatrixXd atom_window_energy;    /**< largest energy of each fitted atom within a circular window, one row per window length */
 
     qint32 atom_count();
 
     void clear();
 
+    //=========================================================================================================
+    /**
+    * dicitionary_compute_spectra
+    *
+    * ### MP toolbox function ###
+    *
+    * Fits all atoms to the signal length (cut or zero padded around the center), normalizes them and stores
+    * their conjugated half spectra in atom_spectra. Nothing is done if the spectra already fit the signal length.
+    * Also computes atom_spectra_abs and atom_window_energy, which bound the correlation of each atom, if they are
+    * missing, e.g. for spectra read from a binary dictionary.
+    *
+    * @param[in] signal_sample_count    number of samples of the signal the atoms are correlated with
+    */
+    void compute_spectra(qint32 signal_sample_count);
+
 };//class
 
 
@@ -144,6 +164,14 @@ public:
     typedef QList<GaborAtom> adaptive_atom_list;
     typedef QList<FixDictAtom> fix_dict_atom_list;
 
+    struct residuum_spectra_data
+    {
+        MatrixXcd spectra;          /**< half spectra of the residuum channels, one column per channel */
+        MatrixXd spectra_abs;       /**< magnitudes of spectra */
+        MatrixXd window_energy;     /**< largest energy of each channel within a circular window, one row per window length */
+        RowVectorXd norms;          /**< euclidean norm of each channel */
+    };
+
     qreal signal_energy;
     qreal current_energy;
     qreal epsilon;
@@ -180,7 +208,49 @@ public:
 
     //=========================================================================================================
 
-    FixDictAtom correlation(Dictionary current_pdict, MatrixXd current_resid, qint32 boost);
+    FixDictAtom correlation(const Dictionary &current_pdict, const MatrixXd &current_resid, qint32 boost);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_correlation
+    *
+    * ### MP toolbox function ###
+    *
+    * Finds the best matching atom of a dictionary by circular cross-correlation of the atom spectra with the
+    * residuum spectra. Each pair of atom and channel gets an upper bound of its correlation maximum, from the
+    * spectrum magnitudes and from the energies within circular windows. The pairs are transformed back with a
+    * real inverse FFT in order of decreasing bound until no bound exceeds the best maximum found, so the result
+    * is the same as the one of an exhaustive search.
+    *
+    * @param[in] current_pdict      dictionary with precomputed atom_spectra (see Dictionary::compute_spectra)
+    * @param[in] resid_spectra      spectra and bound data of the residuum (see residuum_spectra)
+    * @param[in] sample_count       number of samples of the residuum
+    * @param[in] first_atom         index of the first atom to correlate
+    * @param[in] atom_count         number of atoms to correlate, -1 for all atoms from first_atom on
+    * @param[in] shared_best        largest absolute maximum found by all jobs of the iteration so far, as bit pattern
+    *                               of the double, or 0 if the job runs alone
+    *
+    * @return the best matching atom with max_scalar_product and translation set, max_scalar_product is 0 if no atom
+    *         of the block can beat shared_best
+    */
+    static FixDictAtom correlation(const Dictionary &current_pdict, const residuum_spectra_data &resid_spectra, qint32 sample_count,
+                                   qint32 first_atom = 0, qint32 atom_count = -1, QAtomicInteger<qint64> *shared_best = 0);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_residuum_spectra
+    *
+    * ### MP toolbox function ###
+    *
+    * Computes the half spectra of the first channel_count channels of the residuum together with the data the
+    * correlation bounds need.
+    *
+    * @param[in] current_resid      residuum, one column per channel
+    * @param[in] channel_count      number of channels to transform
+    *
+    * @return the half spectra and bound data, one column per channel
+    */
+    static residuum_spectra_data residuum_spectra(const MatrixXd &current_resid, qint32 channel_count);
 
     //=========================================================================================================
 
@@ -194,21 +264,108 @@ public:
 
     struct find_best_matching
     {
-        Dictionary pdict;
-        MatrixXd current_resid;
-        qint32 boost;
+        const Dictionary* pdict;
+        const residuum_spectra_data* resid_spectra;
+        qint32 sample_count;
+        qint32 first_atom;
+        qint32 atom_count;
+        QAtomicInteger<qint64>* shared_best;
 
         FixDictAtom parallel_correlation() const
         {
-            FixDictAtom best_matching;
-            FixDictMp fix_dict_mp;
-            best_matching = fix_dict_mp.correlation(this->pdict, this->current_resid, this->boost);
-            return best_matching;
+            return FixDictMp::correlation(*this->pdict, *this->resid_spectra, this->sample_count, this->first_atom, this->atom_count,
+                                          this->shared_best);
         }
     };
 
     QList<Dictionary> parse_xml_dict(QString path);
 
+    //=========================================================================================================
+    /**
+    * fixdictMp_parse_dict
+    *
+    * ### MP toolbox function ###
+    *
+    * Loads all dictionaries of a dictionary file. Binary dictionaries are read directly. For an XML dictionary
+    * the binary copy next to it (see binary_dict_path) is read if it is up to date, otherwise the XML is parsed.
+    * Binary copies are only written by convert_xml_dict, e.g. with mne_mp_dict_builder.
+    *
+    * @param[in] path   path of the XML or binary dictionary file
+    *
+    * @return the loaded dictionaries
+    */
+    QList<Dictionary> parse_dict(QString path);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_convert_xml_dict
+    *
+    * ### MP toolbox function ###
+    *
+    * Converts an XML dictionary file to the binary format, including the atom spectra for the dictionary length.
+    *
+    * @param[in] xml_path       path of the XML dictionary file
+    * @param[in] binary_path    path of the binary dictionary file to write
+    *
+    * @return true if the binary dictionary was written
+    */
+    bool convert_xml_dict(QString xml_path, QString binary_path);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_read_binary_dict
+    *
+    * ### MP toolbox function ###
+    *
+    * Reads a binary dictionary file. The file is memory mapped, all blocks are 8 byte aligned so that the atom
+    * samples and spectra are copied in one piece each.
+    *
+    * @param[in] path   path of the binary dictionary file
+    *
+    * @return the dictionaries, empty if the file could not be read
+    */
+    static QList<Dictionary> read_binary_dict(const QString &path);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_write_binary_dict
+    *
+    * ### MP toolbox function ###
+    *
+    * Writes dictionaries to a binary dictionary file. Spectra which were not computed yet are computed for the
+    * sample count of the dictionary.
+    *
+    * @param[in] dicts  dictionaries to write
+    * @param[in] path   path of the binary dictionary file
+    *
+    * @return true if the file was written
+    */
+    static bool write_binary_dict(const QList<Dictionary> &dicts, const QString &path);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_is_binary_dict
+    *
+    * ### MP toolbox function ###
+    *
+    * @param[in] path   path of a dictionary file
+    *
+    * @return true if the file starts with the binary dictionary header
+    */
+    static bool is_binary_dict(const QString &path);
+
+    //=========================================================================================================
+    /**
+    * fixdictMp_binary_dict_path
+    *
+    * ### MP toolbox function ###
+    *
+    * @param[in] path   path of an XML dictionary file
+    *
+    * @return the path of its binary copy, i.e. the suffix prefixed with b (.dict becomes .bdict, .pdict .bpdict)
+    */
+    static QString binary_dict_path(const QString &path);
+
     //=========================================================================================================
 
     Dictionary fill_dict(const QDomNode &pdict);
@@ -0,0 +1,218 @@
+//=============================================================================================================
+/**
+* @file     kdtree.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the KdTree Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "kdtree.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define KDTREE_LEAF_SIZE 8
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+KdTree::KdTree()
+{
+}
+
+
+//*************************************************************************************************************
+
+KdTree::KdTree(const MatrixX3f &matPoints)
+{
+    build(matPoints);
+}
+
+
+//*************************************************************************************************************
+
+KdTree::KdTree(const MatrixX3f &matPoints, const VectorXi &vecSubset)
+{
+    build(matPoints, vecSubset);
+}
+
+
+//*************************************************************************************************************
+
+void KdTree::build(const MatrixX3f &matPoints, const VectorXi &vecSubset)
+{
+    m_vecIds.clear();
+
+    if(vecSubset.size() > 0) {
+        m_vecIds.reserve(vecSubset.size());
+        for(int i = 0; i < vecSubset.size(); ++i) {
+            if(vecSubset[i] >= 0 && vecSubset[i] < matPoints.rows()) {
+                m_vecIds.push_back(vecSubset[i]);
+            }
+        }
+    } else {
+        m_vecIds.resize(matPoints.rows());
+        for(int i = 0; i < matPoints.rows(); ++i) {
+            m_vecIds[i] = i;
+        }
+    }
+
+    m_vecAxis.assign(m_vecIds.size(), 0);
+    buildNode(matPoints, 0, size());
+
+    // store the coordinates in tree order, so that queries walk through contiguous memory
+    m_vecCoords.resize(3 * m_vecIds.size());
+    for(size_t i = 0; i < m_vecIds.size(); ++i) {
+        m_vecCoords[3 * i]     = matPoints(m_vecIds[i], 0);
+        m_vecCoords[3 * i + 1] = matPoints(m_vecIds[i], 1);
+        m_vecCoords[3 * i + 2] = matPoints(m_vecIds[i], 2);
+    }
+}
+
+
+//*************************************************************************************************************
+
+int KdTree::nearest(const Vector3f &vecPoint, float *pDist) const
+{
+    if(isEmpty()) {
+        if(pDist) {
+            *pDist = std::numeric_limits<float>::infinity();
+        }
+        return -1;
+    }
+
+    const float pPoint[3] = {vecPoint[0], vecPoint[1], vecPoint[2]};
+    int iBest = -1;
+    float fBestSq = std::numeric_limits<float>::infinity();
+
+    nearestNode(pPoint, 0, size(), iBest, fBestSq);
+
+    if(pDist) {
+        *pDist = std::sqrt(fBestSq);
+    }
+
+    return m_vecIds[iBest];
+}
+
+
+//*************************************************************************************************************
+
+void KdTree::buildNode(const MatrixX3f &matPoints, int iBegin, int iEnd)
+{
+    if(iEnd - iBegin <= KDTREE_LEAF_SIZE) {
+        return;
+    }
+
+    // split along the axis of largest spread
+    Vector3f vecMin = matPoints.row(m_vecIds[iBegin]).transpose();
+    Vector3f vecMax = vecMin;
+    for(int i = iBegin + 1; i < iEnd; ++i) {
+        vecMin = vecMin.cwiseMin(matPoints.row(m_vecIds[i]).transpose());
+        vecMax = vecMax.cwiseMax(matPoints.row(m_vecIds[i]).transpose());
+    }
+
+    int iAxis;
+    (vecMax - vecMin).maxCoeff(&iAxis);
+
+    const int iMid = iBegin + (iEnd - iBegin) / 2;
+    std::nth_element(m_vecIds.begin() + iBegin,
+                     m_vecIds.begin() + iMid,
+                     m_vecIds.begin() + iEnd,
+                     [&matPoints, iAxis](int a, int b) {
+                         return matPoints(a, iAxis) < matPoints(b, iAxis)
+                                 || (matPoints(a, iAxis) == matPoints(b, iAxis) && a < b);
+                     });
+    m_vecAxis[iMid] = static_cast<unsigned char>(iAxis);
+
+    buildNode(matPoints, iBegin, iMid);
+    buildNode(matPoints, iMid + 1, iEnd);
+}
+
+
+//*************************************************************************************************************
+
+void KdTree::nearestNode(const float *pPoint, int iBegin, int iEnd, int &iBest, float &fBestSq) const
+{
+    if(iEnd - iBegin <= KDTREE_LEAF_SIZE) {
+        for(int i = iBegin; i < iEnd; ++i) {
+            testSlot(pPoint, i, iBest, fBestSq);
+        }
+        return;
+    }
+
+    const int iMid = iBegin + (iEnd - iBegin) / 2;
+    const int iAxis = m_vecAxis[iMid];
+    const float fDiff = pPoint[iAxis] - m_vecCoords[3 * iMid + iAxis];
+
+    testSlot(pPoint, iMid, iBest, fBestSq);
+
+    // descend into the side of the query point first, visit the other side only if it can hold a closer (or equally close) point
+    if(fDiff < 0) {
+        nearestNode(pPoint, iBegin, iMid, iBest, fBestSq);
+        if(fDiff * fDiff <= fBestSq) {
+            nearestNode(pPoint, iMid + 1, iEnd, iBest, fBestSq);
+        }
+    } else {
+        nearestNode(pPoint, iMid + 1, iEnd, iBest, fBestSq);
+        if(fDiff * fDiff <= fBestSq) {
+            nearestNode(pPoint, iBegin, iMid, iBest, fBestSq);
+        }
+    }
+}
@@ -0,0 +1,220 @@
+//=============================================================================================================
+/**
+* @file     kdtree.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    KdTree class declaration.
+*
+*/
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//=============================================================================================================
+/**
+* Static k-d tree over a set of 3D points. The tree is built once, e.g. per surface, and answers nearest point
+* queries in logarithmic time. Queries are read only, hence one tree can be shared between threads.
+*
+* @brief 3D k-d tree for nearest point queries.
+*/
+class UTILSSHARED_EXPORT KdTree
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs an empty KdTree.
+    */
+    KdTree();
+
+    //=========================================================================================================
+    /**
+    * Constructs a KdTree over all points.
+    *
+    * @param[in] matPoints      n x 3 matrix of cartesian point positions.
+    */
+    explicit KdTree(const Eigen::MatrixX3f &matPoints);
+
+    //=========================================================================================================
+    /**
+    * Constructs a KdTree over a subset of the points.
+    *
+    * @param[in] matPoints      n x 3 matrix of cartesian point positions.
+    * @param[in] vecSubset      Row indices of matPoints which are inserted into the tree.
+    */
+    KdTree(const Eigen::MatrixX3f &matPoints, const Eigen::VectorXi &vecSubset);
+
+    //=========================================================================================================
+    /**
+    * (Re)builds the tree. An empty subset inserts all points.
+    *
+    * @param[in] matPoints      n x 3 matrix of cartesian point positions.
+    * @param[in] vecSubset      Row indices of matPoints which are inserted into the tree.
+    */
+    void build(const Eigen::MatrixX3f &matPoints, const Eigen::VectorXi &vecSubset = Eigen::VectorXi());
+
+    //=========================================================================================================
+    /**
+    * Finds the point closest to vecPoint. If several points have the same distance, the one with the lowest
+    * row index is returned, i.e. the result equals the one of a linear search.
+    *
+    * @param[in] vecPoint       The query position.
+    * @param[out] pDist         The euclidean distance to the nearest point (optional).
+    *
+    * @return the row index of the nearest point, -1 if the tree is empty.
+    */
+    int nearest(const Eigen::Vector3f &vecPoint, float *pDist = Q_NULLPTR) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of points stored in the tree.
+    *
+    * @return the number of points.
+    */
+    inline int size() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the tree holds any points.
+    *
+    * @return true if the tree is empty.
+    */
+    inline bool isEmpty() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Recursively sorts the slots [iBegin, iEnd) so that the median along the axis of largest spread is located
+    * in the middle.
+    *
+    * @param[in] matPoints      The point positions.
+    * @param[in] iBegin         First slot of the range.
+    * @param[in] iEnd           End of the range, exclusive.
+    */
+    void buildNode(const Eigen::MatrixX3f &matPoints, int iBegin, int iEnd);
+
+    //=========================================================================================================
+    /**
+    * Recursive nearest point search in the slots [iBegin, iEnd).
+    *
+    * @param[in] pPoint         The query position.
+    * @param[in] iBegin         First slot of the range.
+    * @param[in] iEnd           End of the range, exclusive.
+    * @param[in, out] iBest     The best slot so far.
+    * @param[in, out] fBestSq   The squared distance of the best slot so far.
+    */
+    void nearestNode(const float *pPoint, int iBegin, int iEnd, int &iBest, float &fBestSq) const;
+
+    //=========================================================================================================
+    /**
+    * Compares the slot against the current best and takes it over if it is closer.
+    *
+    * @param[in] pPoint         The query position.
+    * @param[in] iSlot          The slot to test.
+    * @param[in, out] iBest     The best slot so far.
+    * @param[in, out] fBestSq   The squared distance of the best slot so far.
+    */
+    inline void testSlot(const float *pPoint, int iSlot, int &iBest, float &fBestSq) const;
+
+    std::vector<int>            m_vecIds;       /**< Row index of the point stored in each slot. */
+    std::vector<float>          m_vecCoords;    /**< Coordinates of each slot, three floats per slot. */
+    std::vector<unsigned char>  m_vecAxis;      /**< Split axis of the node whose median is located at the slot. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int KdTree::size() const
+{
+    return static_cast<int>(m_vecIds.size());
+}
+
+
+//*************************************************************************************************************
+
+inline bool KdTree::isEmpty() const
+{
+    return m_vecIds.empty();
+}
+
+
+//*************************************************************************************************************
+
+inline void KdTree::testSlot(const float *pPoint, int iSlot, int &iBest, float &fBestSq) const
+{
+    const float* pCoords = &m_vecCoords[3 * iSlot];
+    const float dx = pPoint[0] - pCoords[0];
+    const float dy = pPoint[1] - pCoords[1];
+    const float dz = pPoint[2] - pCoords[2];
+    const float fDistSq = dx * dx + dy * dy + dz * dz;
+
+    if(fDistSq < fBestSq || (fDistSq == fBestSq && (iBest < 0 || m_vecIds[iSlot] < m_vecIds[iBest]))) {
+        fBestSq = fDistSq;
+        iBest = iSlot;
+    }
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // KDTREE_H
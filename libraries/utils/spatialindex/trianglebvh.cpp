@@ -0,0 +1,162 @@
+//=============================================================================================================
+/**
+* @file     trianglebvh.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the TriangleBvh Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "trianglebvh.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define TRIANGLEBVH_LEAF_SIZE 4
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+TriangleBvh::TriangleBvh()
+{
+}
+
+
+//*************************************************************************************************************
+
+TriangleBvh::TriangleBvh(const MatrixX3f &matVertices, const MatrixX3i &matTris)
+{
+    build(matVertices, matTris);
+}
+
+
+//*************************************************************************************************************
+
+void TriangleBvh::build(const MatrixX3f &matVertices, const MatrixX3i &matTris)
+{
+    m_vecNodes.clear();
+    m_vecTris.clear();
+
+    if(matTris.rows() == 0) {
+        return;
+    }
+
+    std::vector<AlignedBox3f> vecBoxes(matTris.rows());
+    std::vector<Vector3f> vecCentroids(matTris.rows());
+    m_vecTris.resize(matTris.rows());
+
+    for(int i = 0; i < matTris.rows(); ++i) {
+        for(int j = 0; j < 3; ++j) {
+            vecBoxes[i].extend(Vector3f(matVertices.row(matTris(i, j)).transpose()));
+        }
+        vecCentroids[i] = vecBoxes[i].center();
+        m_vecTris[i] = i;
+    }
+
+    // a binary tree with leaves of at least one triangle has less than twice as many nodes as triangles
+    m_vecNodes.reserve(2 * matTris.rows());
+    buildNode(vecBoxes, vecCentroids, 0, matTris.rows());
+}
+
+
+//*************************************************************************************************************
+
+int TriangleBvh::buildNode(const std::vector<AlignedBox3f> &vecBoxes,
+                           const std::vector<Vector3f> &vecCentroids,
+                           int iBegin,
+                           int iEnd)
+{
+    const int iNode = static_cast<int>(m_vecNodes.size());
+    m_vecNodes.push_back(Node());
+
+    AlignedBox3f box;
+    AlignedBox3f centroidBox;
+    for(int i = iBegin; i < iEnd; ++i) {
+        box.extend(vecBoxes[m_vecTris[i]]);
+        centroidBox.extend(vecCentroids[m_vecTris[i]]);
+    }
+
+    m_vecNodes[iNode].box = box;
+    m_vecNodes[iNode].iLeft = -1;
+    m_vecNodes[iNode].iRight = -1;
+    m_vecNodes[iNode].iBegin = iBegin;
+    m_vecNodes[iNode].iEnd = iEnd;
+
+    if(iEnd - iBegin <= TRIANGLEBVH_LEAF_SIZE) {
+        return iNode;
+    }
+
+    // median split of the centroids along the axis of largest spread
+    int iAxis;
+    centroidBox.sizes().maxCoeff(&iAxis);
+
+    const int iMid = iBegin + (iEnd - iBegin) / 2;
+    std::nth_element(m_vecTris.begin() + iBegin,
+                     m_vecTris.begin() + iMid,
+                     m_vecTris.begin() + iEnd,
+                     [&vecCentroids, iAxis](int a, int b) {
+                         return vecCentroids[a][iAxis] < vecCentroids[b][iAxis];
+                     });
+
+    // m_vecNodes might be reallocated during the recursion, hence do not keep references into it
+    const int iLeft = buildNode(vecBoxes, vecCentroids, iBegin, iMid);
+    const int iRight = buildNode(vecBoxes, vecCentroids, iMid, iEnd);
+    m_vecNodes[iNode].iLeft = iLeft;
+    m_vecNodes[iNode].iRight = iRight;
+
+    return iNode;
+}
@@ -0,0 +1,258 @@
+//=============================================================================================================
+/**
+* @file     trianglebvh.h
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    TriangleBvh class declaration.
+*
+*/
+
+#ifndef TRIANGLEBVH_H
+#define TRIANGLEBVH_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//=============================================================================================================
+/**
+* Bounding volume hierarchy of axis aligned boxes over the triangles of a surface. The hierarchy is built once
+* per surface. Nearest triangle queries only visit the triangles whose boxes are closer than the best triangle
+* found so far. The distance to a single triangle is provided by the caller, so that the existing projection
+* routines keep their exact semantics.
+*
+* @brief Bounding volume hierarchy for nearest triangle queries.
+*/
+class UTILSSHARED_EXPORT TriangleBvh
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs an empty TriangleBvh.
+    */
+    TriangleBvh();
+
+    //=========================================================================================================
+    /**
+    * Constructs a TriangleBvh.
+    *
+    * @param[in] matVertices    n x 3 matrix of vertex positions.
+    * @param[in] matTris        m x 3 matrix of vertex indices forming the triangles.
+    */
+    TriangleBvh(const Eigen::MatrixX3f &matVertices, const Eigen::MatrixX3i &matTris);
+
+    //=========================================================================================================
+    /**
+    * (Re)builds the hierarchy.
+    *
+    * @param[in] matVertices    n x 3 matrix of vertex positions.
+    * @param[in] matTris        m x 3 matrix of vertex indices forming the triangles.
+    */
+    void build(const Eigen::MatrixX3f &matVertices, const Eigen::MatrixX3i &matTris);
+
+    //=========================================================================================================
+    /**
+    * Finds the triangle closest to vecPoint. The distance to a triangle is evaluated by distanceFunction with the
+    * signature bool(int iTri, float &fDist). It has to return the (possibly signed) distance to a point on the
+    * triangle, i.e. its magnitude must not be smaller than the euclidean distance to the triangle. If several
+    * triangles have the same distance, the one with the lowest index is returned, i.e. the result equals the one
+    * of a linear search.
+    *
+    * @param[in] vecPoint           The query position.
+    * @param[in] distanceFunction   Evaluates the distance to a single triangle, returns false to skip it.
+    * @param[out] fBestDist         The distance reported by distanceFunction for the returned triangle.
+    *
+    * @return the index of the nearest triangle, -1 if no triangle was accepted.
+    */
+    template<typename DistanceFunction>
+    int nearest(const Eigen::Vector3f &vecPoint, DistanceFunction distanceFunction, float &fBestDist) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of triangles stored in the hierarchy.
+    *
+    * @return the number of triangles.
+    */
+    inline int size() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the hierarchy holds any triangles.
+    *
+    * @return true if the hierarchy is empty.
+    */
+    inline bool isEmpty() const;
+
+private:
+    /**
+    * A node of the hierarchy. Inner nodes reference their two children, leaves a range of m_vecTris.
+    */
+    struct Node {
+        Eigen::AlignedBox3f box;    /**< Bounding box of all triangles below this node. */
+        int iLeft;                  /**< Index of the left child, -1 for leaves. */
+        int iRight;                 /**< Index of the right child, -1 for leaves. */
+        int iBegin;                 /**< First entry of m_vecTris, leaves only. */
+        int iEnd;                   /**< End of the m_vecTris range, exclusive, leaves only. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Recursively creates the node for the triangles [iBegin, iEnd) of m_vecTris.
+    *
+    * @param[in] vecBoxes       The bounding box of each triangle.
+    * @param[in] vecCentroids   The centroid of each triangle.
+    * @param[in] iBegin         First entry of the range.
+    * @param[in] iEnd           End of the range, exclusive.
+    *
+    * @return the index of the created node.
+    */
+    int buildNode(const std::vector<Eigen::AlignedBox3f> &vecBoxes,
+                  const std::vector<Eigen::Vector3f> &vecCentroids,
+                  int iBegin,
+                  int iEnd);
+
+    std::vector<Node>   m_vecNodes;     /**< The nodes, the root is located at index 0. */
+    std::vector<int>    m_vecTris;      /**< Triangle indices ordered by leaf. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int TriangleBvh::size() const
+{
+    return static_cast<int>(m_vecTris.size());
+}
+
+
+//*************************************************************************************************************
+
+inline bool TriangleBvh::isEmpty() const
+{
+    return m_vecTris.empty();
+}
+
+
+//*************************************************************************************************************
+
+template<typename DistanceFunction>
+int TriangleBvh::nearest(const Eigen::Vector3f &vecPoint, DistanceFunction distanceFunction, float &fBestDist) const
+{
+    int iBestTri = -1;
+    float fBestAbs = 0.0f;
+    fBestDist = 0.0f;
+
+    if(m_vecNodes.empty()) {
+        return iBestTri;
+    }
+
+    std::vector<int> vecStack;
+    vecStack.reserve(64);
+    vecStack.push_back(0);
+
+    while(!vecStack.empty()) {
+        const Node& node = m_vecNodes[vecStack.back()];
+        vecStack.pop_back();
+
+        // boxes further away than the best triangle cannot hold a closer one
+        if(iBestTri >= 0 && node.box.squaredExteriorDistance(vecPoint) > fBestAbs * fBestAbs) {
+            continue;
+        }
+
+        if(node.iLeft < 0) {
+            for(int i = node.iBegin; i < node.iEnd; ++i) {
+                const int iTri = m_vecTris[i];
+                float fDist;
+
+                if(!distanceFunction(iTri, fDist)) {
+                    continue;
+                }
+
+                const float fAbs = std::fabs(fDist);
+                if(iBestTri < 0 || fAbs < fBestAbs || (fAbs == fBestAbs && iTri < iBestTri)) {
+                    iBestTri = iTri;
+                    fBestAbs = fAbs;
+                    fBestDist = fDist;
+                }
+            }
+            continue;
+        }
+
+        // visit the closer child first, it is pushed last
+        const float fDistLeft = m_vecNodes[node.iLeft].box.squaredExteriorDistance(vecPoint);
+        const float fDistRight = m_vecNodes[node.iRight].box.squaredExteriorDistance(vecPoint);
+
+        if(fDistLeft <= fDistRight) {
+            vecStack.push_back(node.iRight);
+            vecStack.push_back(node.iLeft);
+        } else {
+            vecStack.push_back(node.iLeft);
+            vecStack.push_back(node.iRight);
+        }
+    }
+
+    return iBestTri;
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // TRIANGLEBVH_H
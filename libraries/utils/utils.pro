@@ -83,7 +83,9 @@ SOURCES += \
     generics/circularbuffer.cpp \
     generics/circularmatrixbuffer.cpp \
     generics/observerpattern.cpp \
-    spectral.cpp
+    spectral.cpp \
+    spatialindex/kdtree.cpp \
+    spatialindex/trianglebvh.cpp
 
 HEADERS += \
     kmeans.h\
@@ -115,7 +117,9 @@ HEADERS += \
     generics/commandpattern.h \
     generics/observerpattern.h \
     generics/typename_old.h \
-    spectral.h
+    spectral.h \
+    spatialindex/kdtree.h \
+    spatialindex/trianglebvh.h
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
 INCLUDEPATH += $${MNE_INCLUDE_DIR}
@@ -0,0 +1,268 @@
+//=============================================================================================================
+/**
+* @file     test_detect_trigger.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the streaming trigger detection of DetectTrigger
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/detecttrigger.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestDetectTrigger
+*
+* @brief The TestDetectTrigger class provides streaming trigger detection verification tests
+*
+*/
+class TestDetectTrigger: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDetectTrigger();
+
+private slots:
+    void initTestCase();
+    void compareBlockSizes();
+    void compareHoldOff();
+    void compareRingBuffer();
+    void compareReset();
+    void cleanupTestCase();
+
+private:
+    MatrixXd makePulses(int iSamples, const QList<QPair<int,int> >& lPulses) const;
+
+    QList<int> detectStream(DetectTrigger& detectTrigger, const MatrixXd& data, int iBlockSize) const;
+
+    double      m_dBaseline;
+    double      m_dAmplitude;
+    QList<int>  m_lTriggerChannels;
+};
+
+
+//*************************************************************************************************************
+
+TestDetectTrigger::TestDetectTrigger()
+: m_dBaseline(2.0)
+, m_dAmplitude(5.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::initTestCase()
+{
+    //The trigger channel is the second row, the first row holds unrelated data
+    m_lTriggerChannels << 1;
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareBlockSizes()
+{
+    //Pulses inside a block, across a block boundary, at a block start and one which is longer than most blocks
+    QList<QPair<int,int> > lPulses;
+    lPulses << qMakePair(10,5) << qMakePair(39,4) << qMakePair(80,5) << qMakePair(120,30) << qMakePair(170,2);
+    MatrixXd data = makePulses(200, lPulses);
+
+    QList<int> lExpected;
+    for(int i = 0; i < lPulses.size(); ++i) {
+        lExpected << lPulses[i].first;
+    }
+
+    //Every flank has to be found exactly once, no matter how the stream is split into blocks
+    QList<int> lBlockSizes;
+    lBlockSizes << 1 << 3 << 7 << 40 << 200;
+
+    for(int i = 0; i < lBlockSizes.size(); ++i) {
+        DetectTrigger detectTrigger;
+        detectTrigger.setup(m_lTriggerChannels, 2.5, true, 0);
+
+        QCOMPARE(detectStream(detectTrigger, data, lBlockSizes[i]), lExpected);
+
+        for(int k = 0; k < detectTrigger.eventCount(); ++k) {
+            QCOMPARE(detectTrigger.event(k).iChannel, 1);
+            QCOMPARE(detectTrigger.event(k).dValue, m_dBaseline + m_dAmplitude);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareHoldOff()
+{
+    //The pulse at 14 lies within the burst after 10, the pulse at 45 is still high when the burst after 40 ends
+    QList<QPair<int,int> > lPulses;
+    lPulses << qMakePair(10,2) << qMakePair(14,2) << qMakePair(25,2) << qMakePair(40,2) << qMakePair(45,10);
+    MatrixXd data = makePulses(60, lPulses);
+
+    QList<int> lExpected;
+    lExpected << 10 << 25 << 40;
+
+    //The burst of ten samples reaches into the following blocks for all but the largest block size
+    QList<int> lBlockSizes;
+    lBlockSizes << 1 << 3 << 4 << 7 << 60;
+
+    for(int i = 0; i < lBlockSizes.size(); ++i) {
+        DetectTrigger detectTrigger;
+        detectTrigger.setup(m_lTriggerChannels, 2.5, true, 10);
+
+        QCOMPARE(detectStream(detectTrigger, data, lBlockSizes[i]), lExpected);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareRingBuffer()
+{
+    QList<QPair<int,int> > lPulses;
+    for(int i = 0; i < 10; ++i) {
+        lPulses << qMakePair(5 + 20 * i, 3);
+    }
+    MatrixXd data = makePulses(200, lPulses);
+
+    //A buffer of four events keeps the last four flanks, the oldest first
+    DetectTrigger detectTrigger;
+    detectTrigger.setup(m_lTriggerChannels, 2.5, true, 0, 4);
+
+    QList<int> lExpected;
+    lExpected << 125 << 145 << 165 << 185;
+
+    QCOMPARE(detectStream(detectTrigger, data, 50), lExpected);
+
+    //Only the flanks of the last block are reported in the format of the static routines
+    QList<QPair<int,double> > lLastDetected = detectTrigger.lastDetected(1);
+    QCOMPARE(lLastDetected.size(), 2);
+    QCOMPARE(lLastDetected[0].first, 165);
+    QCOMPARE(lLastDetected[1].first, 185);
+
+    QVERIFY(detectTrigger.lastDetected(0).isEmpty());
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareReset()
+{
+    DetectTrigger detectTrigger;
+    detectTrigger.setup(m_lTriggerChannels, 2.5, false, 50);
+
+    //The flank at 95 leaves a hold off which would reach into the next block
+    QList<QPair<int,int> > lPulses;
+    lPulses << qMakePair(95,3);
+    QCOMPARE(detectTrigger.detect(makePulses(100, lPulses)), 1);
+
+    detectTrigger.reset();
+    QCOMPARE(detectTrigger.eventCount(), 0);
+
+    //The new stream starts high, which is no flank, and the hold off of the old stream must not be carried over
+    lPulses.clear();
+    lPulses << qMakePair(0,3) << qMakePair(5,2);
+    QCOMPARE(detectTrigger.detect(makePulses(20, lPulses)), 1);
+    QCOMPARE(detectTrigger.event(0).iSample, 5);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestDetectTrigger::makePulses(int iSamples, const QList<QPair<int,int> >& lPulses) const
+{
+    MatrixXd data(2, iSamples);
+    data.row(0).setLinSpaced(-10.0, 10.0);
+    data.row(1).setConstant(m_dBaseline);
+
+    for(int i = 0; i < lPulses.size(); ++i) {
+        data.row(1).segment(lPulses[i].first, lPulses[i].second).array() += m_dAmplitude;
+    }
+
+    return data;
+}
+
+
+//*************************************************************************************************************
+
+QList<int> TestDetectTrigger::detectStream(DetectTrigger& detectTrigger, const MatrixXd& data, int iBlockSize) const
+{
+    for(int iFirst = 0; iFirst < data.cols(); iFirst += iBlockSize) {
+        detectTrigger.detect(data.middleCols(iFirst, std::min(iBlockSize, int(data.cols()) - iFirst)), iFirst);
+    }
+
+    QList<int> lSamples;
+    for(int i = 0; i < detectTrigger.eventCount(); ++i) {
+        lSamples << detectTrigger.event(i).iSample;
+    }
+
+    return lSamples;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestDetectTrigger)
+#include "test_detect_trigger.moc"
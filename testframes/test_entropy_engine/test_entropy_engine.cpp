@@ -0,0 +1,297 @@
+//=============================================================================================================
+/**
+* @file     test_entropy_engine.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the incremental and the vectorized entropies of the epidetect EntropyEngine
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <entropyengine.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestEntropyEngine
+*
+* @brief The TestEntropyEngine class provides entropy engine verification tests
+*
+*/
+class TestEntropyEngine: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestEntropyEngine();
+
+private slots:
+    void initTestCase();
+    void compareIncremental();
+    void compareNewStream();
+    void compareVariants();
+    void cleanupTestCase();
+
+private:
+    MatrixXd makeStream(int iSamples) const;
+
+    VectorXd stdDev(const MatrixXd& data) const;
+
+    double bruteSampleEn(const RowVectorXd& data, int dim, double r, double stdDev) const;
+
+    double      m_dEpsilon;
+    int         m_iDim;
+    double      m_dR;
+    double      m_dN;
+    QList<int>  m_lChannels;
+};
+
+
+//*************************************************************************************************************
+
+TestEntropyEngine::TestEntropyEngine()
+: m_dEpsilon(1.0e-12)
+, m_iDim(3)
+, m_dR(0.3)
+, m_dN(2.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestEntropyEngine::initTestCase()
+{
+    m_lChannels << 0 << 1 << 2;
+}
+
+
+//*************************************************************************************************************
+
+void TestEntropyEngine::compareIncremental()
+{
+    //Windows which overlap by half, as in epidetect, with an odd window length as well
+    QList<int> lLengths;
+    lLengths << 64 << 101;
+
+    for(int l = 0; l < lLengths.size(); ++l) {
+        int iLength = lLengths[l];
+        int iOverlap = iLength / 2;
+        MatrixXd matStream = makeStream(iOverlap * 8 + iLength);
+
+        EntropyEngine engine;
+        engine.setParameters(m_iDim, m_dR, m_dN);
+        engine.setOverlap(iOverlap);
+
+        VectorXd vecStreamStdDev;
+
+        for(int w = 0; w < 8; ++w) {
+            MatrixXd matWindow = matStream.middleCols(w * iOverlap, iLength);
+            VectorXd vecStdDev = stdDev(matWindow);
+
+            if(w == 0) {
+                vecStreamStdDev = vecStdDev;
+            }
+
+            VectorXd vecFuzzyEn = engine.fuzzyEn(matWindow, vecStdDev, m_lChannels);
+
+            //Every window equals a full recompute with the normalization of the first window of the stream
+            for(int c = 0; c < m_lChannels.size(); ++c) {
+                double dFull = EntropyEngine::fuzzyEn(matWindow.row(c), m_iDim, m_dR, m_dN, vecStreamStdDev(c));
+                QVERIFY(std::fabs(vecFuzzyEn(c) - dFull) <= m_dEpsilon * std::fabs(dFull));
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestEntropyEngine::compareNewStream()
+{
+    MatrixXd matStream = makeStream(200);
+    MatrixXd matFirst = matStream.leftCols(80);
+    MatrixXd matOther = matStream.rightCols(80);
+    VectorXd vecFirstStdDev = VectorXd::Constant(3, 0.5);
+    VectorXd vecOtherStdDev = VectorXd::Constant(3, 0.9);
+
+    EntropyEngine engine;
+    engine.setParameters(m_iDim, m_dR, m_dN);
+    engine.setOverlap(40);
+    engine.fuzzyEn(matFirst, vecFirstStdDev, m_lChannels);
+
+    //A window which does not continue the previous one is computed from scratch, within the same stream
+    VectorXd vecFuzzyEn = engine.fuzzyEn(matOther, vecOtherStdDev, m_lChannels);
+    for(int c = 0; c < m_lChannels.size(); ++c) {
+        QVERIFY(std::fabs(vecFuzzyEn(c) - EntropyEngine::fuzzyEn(matOther.row(c), m_iDim, m_dR, m_dN, 0.5)) < m_dEpsilon);
+    }
+
+    //After a reset the next window starts a new stream with its own normalization
+    engine.reset();
+    vecFuzzyEn = engine.fuzzyEn(matOther, vecOtherStdDev, m_lChannels);
+    for(int c = 0; c < m_lChannels.size(); ++c) {
+        QVERIFY(std::fabs(vecFuzzyEn(c) - EntropyEngine::fuzzyEn(matOther.row(c), m_iDim, m_dR, m_dN, 0.9)) < m_dEpsilon);
+    }
+
+    //Without an overlap every window is normalized on its own
+    EntropyEngine engineNoOverlap;
+    engineNoOverlap.setParameters(m_iDim, m_dR, m_dN);
+    engineNoOverlap.fuzzyEn(matFirst, vecFirstStdDev, m_lChannels);
+    vecFuzzyEn = engineNoOverlap.fuzzyEn(matOther, vecOtherStdDev, m_lChannels);
+    for(int c = 0; c < m_lChannels.size(); ++c) {
+        QCOMPARE(vecFuzzyEn(c), EntropyEngine::fuzzyEn(matOther.row(c), m_iDim, m_dR, m_dN, 0.9));
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestEntropyEngine::compareVariants()
+{
+    MatrixXd matData = makeStream(120);
+    VectorXd vecStdDev = stdDev(matData);
+    int iDim = 2;
+    double dR = 0.4;
+    int iMaxScale = 3;
+
+    EntropyEngine engine;
+    VectorXd vecSampleEn = engine.sampleEn(matData, vecStdDev, m_lChannels, iDim, dR);
+    VectorXd vecApproximateEn = engine.approximateEn(matData, vecStdDev, m_lChannels, iDim, dR);
+    MatrixXd matMultiscaleEn = engine.multiscaleEn(matData, vecStdDev, m_lChannels, iDim, dR, iMaxScale);
+
+    QCOMPARE(int(matMultiscaleEn.rows()), m_lChannels.size());
+    QCOMPARE(int(matMultiscaleEn.cols()), iMaxScale);
+
+    for(int c = 0; c < m_lChannels.size(); ++c) {
+        //The vectorized sample entropy counts the same matches as the pattern by pattern definition
+        QVERIFY(std::fabs(vecSampleEn(c) - bruteSampleEn(matData.row(c), iDim, dR, vecStdDev(c))) < m_dEpsilon);
+        QCOMPARE(vecApproximateEn(c), EntropyEngine::approximateEn(matData.row(c), iDim, dR, vecStdDev(c)));
+
+        //Scale 1 is the sample entropy of the series itself, scale 2 the one of the averaged sample pairs
+        QCOMPARE(matMultiscaleEn(c, 0), vecSampleEn(c));
+
+        RowVectorXd vecCoarse(matData.cols() / 2);
+        for(int k = 0; k < vecCoarse.cols(); ++k) {
+            vecCoarse(k) = 0.5 * (matData(c, 2 * k) + matData(c, 2 * k + 1));
+        }
+        QVERIFY(std::fabs(matMultiscaleEn(c, 1) - bruteSampleEn(vecCoarse, iDim, dR, vecStdDev(c))) < m_dEpsilon);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestEntropyEngine::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestEntropyEngine::makeStream(int iSamples) const
+{
+    //Oscillations with a deterministic irregular part and a drifting amplitude
+    MatrixXd data(3, iSamples);
+
+    for(int c = 0; c < data.rows(); ++c) {
+        for(int k = 0; k < iSamples; ++k) {
+            data(c, k) = sin(0.2 * (c + 1) * k) + 0.5 * (1.0 + k / 100.0) * sin(0.37 * k * k + 1.3 * c);
+        }
+    }
+
+    return data;
+}
+
+
+//*************************************************************************************************************
+
+VectorXd TestEntropyEngine::stdDev(const MatrixXd& data) const
+{
+    MatrixXd centered = data.colwise() - data.rowwise().mean();
+    return (centered.rowwise().squaredNorm() / (data.cols() - 1)).cwiseSqrt();
+}
+
+
+//*************************************************************************************************************
+
+double TestEntropyEngine::bruteSampleEn(const RowVectorXd& data, int dim, double r, double stdDev) const
+{
+    int length = data.cols();
+    double tolerance = r * stdDev;
+    double matchesM = 0.0;
+    double matchesM1 = 0.0;
+
+    for(int i = 0; i < length - dim; ++i) {
+        for(int j = i + 1; j < length - dim; ++j) {
+            double dist = 0.0;
+            for(int t = 0; t < dim; ++t) {
+                dist = qMax(dist, std::fabs(data(i + t) - data(j + t)));
+            }
+
+            if(dist <= tolerance) {
+                matchesM++;
+                if(qMax(dist, std::fabs(data(i + dim) - data(j + dim))) <= tolerance) {
+                    matchesM1++;
+                }
+            }
+        }
+    }
+
+    return -log(matchesM1 / matchesM);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestEntropyEngine)
+#include "test_entropy_engine.moc"
@@ -40,6 +40,8 @@
 //=============================================================================================================
 
 #include <fiff/fiff.h>
+#include <fiff/fiff_rolling_raw_writer.h>
+#include <fiff/fiff_raw_recorder.h>
 
 #include <iostream>
 
@@ -78,9 +80,16 @@ private slots:
     void compareData();
     void compareTimes();
     void compareInfo();
+    void compareIntegerBuffer();
+    void compareShortBuffer();
+    void compareRollingWriter();
+    void compareRawRecorder();
+    void compareRawRecorderOverrun();
     void cleanupTestCase();
 
 private:
+    bool readRecording(const QStringList& fileNames, MatrixXd& data);
+
     double epsilon;
 
     FiffRawData first_in_raw;
@@ -319,6 +328,256 @@ void TestFiffRWR::compareInfo()
     }
 }
 
+//*************************************************************************************************************
+
+void TestFiffRWR::compareIntegerBuffer()
+{
+    QFile t_fileOut("./mne-cpp-test-data/MEG/sample/sample_audvis_raw_short_test_rwr_int_out.fif");
+
+    //
+    //   Write the last read segment as 32 bit integers
+    //
+    RowVectorXd cals;
+    FiffStream::SPtr outfid = FiffStream::start_writing_raw(t_fileOut,first_in_raw.info, cals);
+    QVERIFY( outfid->write_raw_buffer(MatrixXf(first_in_data.cast<float>()), cals, FIFFT_INT) );
+    outfid->finish_writing_raw();
+
+    //
+    //   Read it again, the integer values resolve the data to half a calibration step
+    //
+    FiffRawData int_in_raw(t_fileOut);
+    MatrixXd int_in_data, int_in_times;
+    QVERIFY( int_in_raw.read_raw_segment(int_in_data, int_in_times, int_in_raw.first_samp, int_in_raw.first_samp + first_in_data.cols() - 1) );
+    QVERIFY( int_in_data.rows() == first_in_data.rows() && int_in_data.cols() == first_in_data.cols() );
+
+    ArrayXXd steps = (first_in_data - int_in_data).array().abs().colwise() / cals.transpose().array();
+    QVERIFY( steps.maxCoeff() < 0.51 );
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRWR::compareShortBuffer()
+{
+    QList<fiff_int_t> types;
+    types << FIFFT_SHORT << FIFFT_DAU_PACK16;
+
+    for(qint32 t = 0; t < types.size(); ++t) {
+        QFile t_fileOut(QString("./mne-cpp-test-data/MEG/sample/sample_audvis_raw_short_test_rwr_short_%1_out.fif").arg(types[t]));
+
+        RowVectorXd cals;
+        FiffStream::SPtr outfid = FiffStream::start_writing_raw(t_fileOut,first_in_raw.info, cals);
+
+        //
+        //   Integer multiples of the calibration covering the whole 16 bit range, both limits included
+        //
+        qint32 nsamp = 100;
+        MatrixXd steps(cals.cols(), nsamp);
+        for(qint32 i = 0; i < steps.rows(); ++i) {
+            for(qint32 j = 0; j < nsamp; ++j) {
+                steps(i,j) = double(((i + 1) * 7919 + j * 104729) % 65536 - 32768);
+            }
+        }
+        steps.col(0).setConstant(-32768.0);
+        steps.col(1).setConstant(32767.0);
+
+        MatrixXd data = steps.array().colwise() * cals.transpose().array();
+
+        QVERIFY( outfid->write_raw_buffer(MatrixXf(data.cast<float>()), cals, types[t]) );
+        outfid->finish_writing_raw();
+
+        //
+        //   Read it again, every value has to come back as the same number of calibration steps
+        //
+        FiffRawData short_in_raw(t_fileOut);
+        MatrixXd short_in_data, short_in_times;
+        QVERIFY( short_in_raw.read_raw_segment(short_in_data, short_in_times, short_in_raw.first_samp, short_in_raw.first_samp + nsamp - 1) );
+        QVERIFY( short_in_data.rows() == steps.rows() && short_in_data.cols() == nsamp );
+
+        ArrayXXd diff = (short_in_data.array().colwise() / cals.transpose().array() - steps.array()).abs();
+        QVERIFY( diff.maxCoeff() < 1e-3 );
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRWR::compareRollingWriter()
+{
+    QString t_sFileName("./mne-cpp-test-data/MEG/sample/sample_audvis_raw_short_test_rwr_rolling_raw.fif");
+
+    //
+    //   Write the last read segment in four buffers, two buffers fit into one file
+    //
+    qint32 nsamp = first_in_data.cols() / 4;
+
+    FiffRollingRawWriter writer;
+    writer.setMaxFileDuration(2.0 * nsamp / first_in_raw.info.sfreq);
+
+    RowVectorXd cals;
+    QVERIFY( writer.start(t_sFileName, first_in_raw.info, cals) );
+
+    for(qint32 i = 0; i < 4; ++i) {
+        QVERIFY( writer.write(MatrixXf(first_in_data.middleCols(i * nsamp, nsamp).cast<float>()), cals) );
+    }
+    writer.finish();
+
+    QStringList fileNames = writer.fileNames();
+    QVERIFY( fileNames.size() == 2 );
+    QVERIFY( writer.samplesWritten() == 4 * nsamp );
+
+    //
+    //   Read both parts, the second one continues where the first one ended
+    //
+    MatrixXd rolling_data(first_in_data.rows(), 4 * nsamp);
+    fiff_int_t next_samp = 0;
+
+    for(qint32 i = 0; i < fileNames.size(); ++i) {
+        QFile t_fileIn(fileNames[i]);
+        FiffRawData part_raw(t_fileIn);
+        QVERIFY( part_raw.first_samp == next_samp );
+        QVERIFY( part_raw.last_samp - part_raw.first_samp + 1 == 2 * nsamp );
+
+        MatrixXd part_data, part_times;
+        QVERIFY( part_raw.read_raw_segment(part_data, part_times, part_raw.first_samp, part_raw.last_samp) );
+        rolling_data.middleCols(2 * i * nsamp, 2 * nsamp) = part_data;
+
+        next_samp = part_raw.last_samp + 1;
+    }
+
+    ArrayXXd data_diff = (first_in_data.leftCols(4 * nsamp) - rolling_data).array().abs();
+    QVERIFY( (data_diff - 1e-5 * first_in_data.leftCols(4 * nsamp).array().abs()).maxCoeff() <= 0.0 );
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRWR::compareRawRecorder()
+{
+    QString t_sFileName("./mne-cpp-test-data/MEG/sample/sample_audvis_raw_short_test_rwr_recorder_raw.fif");
+
+    FiffRollingRawWriter::SPtr pWriter(new FiffRollingRawWriter);
+    RowVectorXd cals;
+    QVERIFY( pWriter->start(t_sFileName, first_in_raw.info, cals) );
+
+    //
+    //   Queue all blocks at once, every block holds its number times the calibration
+    //
+    qint32 nblocks = 20;
+    qint32 nsamp = 10;
+
+    FiffRawRecorder recorder(nblocks);
+    recorder.setBatchSize(3);
+    QVERIFY( recorder.startRecording(pWriter, cals) );
+
+    for(qint32 i = 0; i < nblocks; ++i) {
+        MatrixXd block = (double(i + 1) * cals.transpose()).replicate(1, nsamp);
+        QVERIFY( recorder.write(block) );
+    }
+
+    //
+    //   Stopping drains the queue, so all blocks have to be in the file in the order they were written
+    //
+    recorder.stopRecording();
+    pWriter->finish();
+
+    QVERIFY( recorder.droppedBlocks() == 0 );
+    QVERIFY( pWriter->samplesWritten() == nblocks * nsamp );
+
+    MatrixXd rec_data;
+    QVERIFY( readRecording(pWriter->fileNames(), rec_data) );
+    QVERIFY( rec_data.cols() == nblocks * nsamp );
+
+    for(qint32 i = 0; i < nblocks; ++i) {
+        ArrayXXd steps = rec_data.middleCols(i * nsamp, nsamp).array().colwise() / cals.transpose().array();
+        QVERIFY( (steps - double(i + 1)).abs().maxCoeff() < 1e-5 * (i + 1) );
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffRWR::compareRawRecorderOverrun()
+{
+    QString t_sFileName("./mne-cpp-test-data/MEG/sample/sample_audvis_raw_short_test_rwr_recorder_overrun_raw.fif");
+
+    FiffRollingRawWriter::SPtr pWriter(new FiffRollingRawWriter);
+    RowVectorXd cals;
+    QVERIFY( pWriter->start(t_sFileName, first_in_raw.info, cals) );
+
+    //
+    //   A queue of two blocks cannot take a burst of many blocks, the recorder thread sleeps while the queue is empty
+    //
+    qint32 nblocks = 1000;
+    qint32 nsamp = 10;
+
+    FiffRawRecorder recorder(2);
+    QVERIFY( recorder.startRecording(pWriter, cals) );
+
+    QList<qint32> accepted;
+    for(qint32 i = 0; i < nblocks; ++i) {
+        MatrixXd block = (double(i + 1) * cals.transpose()).replicate(1, nsamp);
+        if(recorder.write(block)) {
+            accepted.append(i + 1);
+        }
+    }
+
+    recorder.stopRecording();
+    pWriter->finish();
+
+    QVERIFY( recorder.droppedBlocks() > 0 );
+    QVERIFY( recorder.droppedBlocks() + accepted.size() == nblocks );
+    QVERIFY( recorder.droppedSamples() == recorder.droppedBlocks() * nsamp );
+
+    //
+    //   Exactly the accepted blocks are written, in order
+    //
+    MatrixXd rec_data;
+    QVERIFY( readRecording(pWriter->fileNames(), rec_data) );
+    QVERIFY( rec_data.cols() == accepted.size() * nsamp );
+
+    for(qint32 i = 0; i < accepted.size(); ++i) {
+        ArrayXXd steps = rec_data.middleCols(i * nsamp, nsamp).array().colwise() / cals.transpose().array();
+        QVERIFY( (steps - double(accepted[i])).abs().maxCoeff() < 1e-5 * accepted[i] );
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool TestFiffRWR::readRecording(const QStringList& fileNames, MatrixXd& data)
+{
+    QList<MatrixXd> parts;
+    qint32 ncols = 0;
+
+    for(qint32 i = 0; i < fileNames.size(); ++i) {
+        QFile t_fileIn(fileNames[i]);
+        FiffRawData part_raw(t_fileIn);
+
+        MatrixXd part_data, part_times;
+        if(!part_raw.read_raw_segment(part_data, part_times, part_raw.first_samp, part_raw.last_samp)) {
+            return false;
+        }
+
+        parts.append(part_data);
+        ncols += part_data.cols();
+    }
+
+    if(parts.isEmpty()) {
+        return false;
+    }
+
+    data.resize(parts.first().rows(), ncols);
+    qint32 col = 0;
+    for(qint32 i = 0; i < parts.size(); ++i) {
+        data.middleCols(col, parts[i].cols()) = parts[i];
+        col += parts[i].cols();
+    }
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 
 void TestFiffRWR::cleanupTestCase()
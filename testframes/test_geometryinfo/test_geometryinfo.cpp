@@ -75,8 +75,10 @@ private slots:
     void initTestCase();
     void testBadChannelFiltering();
     void testEmptyInputsForProjecting();
+    void testProjectingAgainstLinearSearch();
     void testEmptyInputsForSCDC();
     void testDimensionsForSCDC();
+    void testSparseSCDC();
     void cleanupTestCase();
 
 private:
@@ -182,6 +184,27 @@ void TestGeometryInfo::testEmptyInputsForProjecting() {
 }
 
 
+//*************************************************************************************************************
+
+void TestGeometryInfo::testProjectingAgainstLinearSearch() {
+    QVector<Vector3f> vecPositions;
+    for(int i = 0; i < 50; ++i) {
+        vecPositions.push_back(Vector3f::Random());
+    }
+    // positions which coincide with a vertex have to be mapped to that vertex
+    vecPositions.push_back(smallSurface.rr.row(17).transpose());
+
+    QVector<qint32> vecMapping = GeometryInfo::projectSensors(smallSurface.rr, vecPositions);
+    QVERIFY(vecMapping.size() == vecPositions.size());
+
+    for(int i = 0; i < vecPositions.size(); ++i) {
+        qint32 iNearest;
+        (smallSurface.rr.rowwise() - vecPositions[i].transpose()).rowwise().squaredNorm().minCoeff(&iNearest);
+        QVERIFY(vecMapping[i] == iNearest);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void TestGeometryInfo::testEmptyInputsForSCDC() {
@@ -200,6 +223,33 @@ void TestGeometryInfo::testDimensionsForSCDC() {
 }
 
 
+//*************************************************************************************************************
+
+void TestGeometryInfo::testSparseSCDC() {
+    const double dCancelDist = 0.5;
+    QSharedPointer<MatrixXd> denseTable = GeometryInfo::scdc(smallSurface.rr, smallSurface.neighbor_vert, smallSubset, dCancelDist);
+    QSharedPointer<SparseMatrix<double, RowMajor> > sparseTable = GeometryInfo::scdcSparse(smallSurface.rr, smallSurface.neighbor_vert, smallSubset, dCancelDist);
+
+    QVERIFY(sparseTable->rows() == denseTable->rows());
+    QVERIFY(sparseTable->cols() == denseTable->cols());
+
+    // every stored entry has to match the dense result, every missing entry has to be infinite in the dense result
+    qint64 iFiniteCount = 0;
+    for (qint32 row = 0; row < denseTable->rows(); ++row) {
+        for (qint32 col = 0; col < denseTable->cols(); ++col) {
+            if (denseTable->coeff(row, col) != FLOAT_INFINITY) {
+                QVERIFY(denseTable->coeff(row, col) <= dCancelDist);
+                iFiniteCount++;
+            }
+        }
+        for (SparseMatrix<double, RowMajor>::InnerIterator it(*sparseTable, row); it; ++it) {
+            QVERIFY(qAbs(it.value() - denseTable->coeff(row, it.col())) < 1e-9);
+        }
+    }
+    QVERIFY(iFiniteCount == sparseTable->nonZeros());
+}
+
+
 //*************************************************************************************************************
 
 void TestGeometryInfo::cleanupTestCase() {
@@ -0,0 +1,422 @@
+//=============================================================================================================
+/**
+* @file     test_mp_dict.cpp
+* @author   Lorenz Esch <lesch@mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2018
+*
+* @section  LICENSE
+*
+* Copyright (C) 2018, Lorenz Esch and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Test for the binary matching pursuit dictionary format
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/mp/fixdictmp.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <unsupported/Eigen/FFT>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QXmlStreamWriter>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestMpDict
+*
+* @brief The TestMpDict class provides XML to binary dictionary conversion verification tests
+*
+*/
+class TestMpDict: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMpDict();
+
+private slots:
+    void initTestCase();
+    void compareRoundTrip();
+    void compareNoBinaryWritten();
+    void compareCorruptHeader();
+    void comparePrunedCorrelation();
+    void cleanupTestCase();
+
+private:
+    bool writeXmlDict(const QString& sPath) const;
+
+    double exhaustiveCorrelation(const Dictionary& dict, const MatrixXd& matResid, qint32& iBestAtom) const;
+
+    bool patchBinaryDict(const QString& sPath, qint64 iOffset, qint32 iValue) const;
+
+    double          m_dEpsilon;
+    qint32          m_iSampleCount;
+    QTemporaryDir   m_tempDir;
+    QString         m_sXmlPath;
+    QString         m_sBinaryPath;
+};
+
+
+//*************************************************************************************************************
+
+TestMpDict::TestMpDict()
+: m_dEpsilon(1.0e-12)
+, m_iSampleCount(64)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestMpDict::initTestCase()
+{
+    QVERIFY(m_tempDir.isValid());
+
+    m_sXmlPath = m_tempDir.path() + "/test_dict.pdict";
+    m_sBinaryPath = m_tempDir.path() + "/test_dict_converted.bpdict";
+
+    QVERIFY(writeXmlDict(m_sXmlPath));
+
+    FixDictMp fixDictMp;
+    QVERIFY(fixDictMp.convert_xml_dict(m_sXmlPath, m_sBinaryPath));
+    QVERIFY(FixDictMp::is_binary_dict(m_sBinaryPath));
+    QVERIFY(!FixDictMp::is_binary_dict(m_sXmlPath));
+}
+
+
+//*************************************************************************************************************
+
+void TestMpDict::compareRoundTrip()
+{
+    FixDictMp fixDictMp;
+    QList<Dictionary> lXmlDicts = fixDictMp.parse_xml_dict(m_sXmlPath);
+    QList<Dictionary> lBinaryDicts = FixDictMp::read_binary_dict(m_sBinaryPath);
+
+    QCOMPARE(lXmlDicts.size(), 2);
+    QCOMPARE(lBinaryDicts.size(), lXmlDicts.size());
+
+    for(qint32 d = 0; d < lXmlDicts.size(); ++d) {
+        Dictionary& xmlDict = lXmlDicts[d];
+        const Dictionary& binaryDict = lBinaryDicts.at(d);
+
+        QCOMPARE(binaryDict.type, xmlDict.type);
+        QCOMPARE(binaryDict.sample_count, xmlDict.sample_count);
+        QCOMPARE(binaryDict.source, xmlDict.source);
+        QCOMPARE(binaryDict.atom_formula, xmlDict.atom_formula);
+        QCOMPARE(binaryDict.atoms.size(), xmlDict.atoms.size());
+
+        for(qint32 i = 0; i < xmlDict.atoms.size(); ++i) {
+            const FixDictAtom& xmlAtom = xmlDict.atoms.at(i);
+            const FixDictAtom& binaryAtom = binaryDict.atoms.at(i);
+
+            QCOMPARE(binaryAtom.id, xmlAtom.id);
+            QCOMPARE(binaryAtom.atom_samples.size(), xmlAtom.atom_samples.size());
+            QVERIFY(binaryAtom.atom_samples == xmlAtom.atom_samples);
+
+            if(xmlDict.type == GABORATOM) {
+                QCOMPARE(binaryAtom.gabor_atom.scale, xmlAtom.gabor_atom.scale);
+                QCOMPARE(binaryAtom.gabor_atom.modulation, xmlAtom.gabor_atom.modulation);
+                QCOMPARE(binaryAtom.gabor_atom.phase, xmlAtom.gabor_atom.phase);
+            } else {
+                QCOMPARE(binaryAtom.chirp_atom.scale, xmlAtom.chirp_atom.scale);
+                QCOMPARE(binaryAtom.chirp_atom.modulation, xmlAtom.chirp_atom.modulation);
+                QCOMPARE(binaryAtom.chirp_atom.phase, xmlAtom.chirp_atom.phase);
+                QCOMPARE(binaryAtom.chirp_atom.chirp, xmlAtom.chirp_atom.chirp);
+            }
+        }
+
+        //The stored spectra are the ones computed from the XML atoms for the dictionary length
+        xmlDict.compute_spectra(xmlDict.sample_count);
+
+        QCOMPARE(binaryDict.spectra_sample_count, xmlDict.sample_count);
+        QCOMPARE(binaryDict.atom_spectra.rows(), xmlDict.atom_spectra.rows());
+        QCOMPARE(binaryDict.atom_spectra.cols(), xmlDict.atom_spectra.cols());
+        QVERIFY((binaryDict.atom_spectra - xmlDict.atom_spectra).cwiseAbs().maxCoeff() < m_dEpsilon);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMpDict::compareNoBinaryWritten()
+{
+    //Loading an XML dictionary must not leave a binary copy next to it
+    FixDictMp fixDictMp;
+    QList<Dictionary> lDicts = fixDictMp.parse_dict(m_sXmlPath);
+
+    QCOMPARE(lDicts.size(), 2);
+    QVERIFY(!QFile::exists(FixDictMp::binary_dict_path(m_sXmlPath)));
+}
+
+
+//*************************************************************************************************************
+
+void TestMpDict::compareCorruptHeader()
+{
+    //The first dictionary header follows the 24 byte file header: type, sample count, atom count, ...
+    QString sTypePath = m_tempDir.path() + "/test_dict_type.bpdict";
+    QVERIFY(QFile::copy(m_sBinaryPath, sTypePath));
+    QVERIFY(patchBinaryDict(sTypePath, 24, 7));
+    QVERIFY(FixDictMp::read_binary_dict(sTypePath).isEmpty());
+
+    QString sCountPath = m_tempDir.path() + "/test_dict_count.bpdict";
+    QVERIFY(QFile::copy(m_sBinaryPath, sCountPath));
+    QVERIFY(patchBinaryDict(sCountPath, 32, -1));
+    QVERIFY(FixDictMp::read_binary_dict(sCountPath).isEmpty());
+}
+
+
+//*************************************************************************************************************
+
+void TestMpDict::comparePrunedCorrelation()
+{
+    //Atoms of several lengths and frequencies, so that the spectral and the window bounds both prune
+    Dictionary dict;
+    dict.type = GABORATOM;
+    dict.sample_count = m_iSampleCount;
+
+    for(qint32 i = 0; i < 96; ++i) {
+        qint32 iLength = 8 << (i % 4);
+        double dScale = iLength / 2.0;
+        double dModu = 0.1 * (i / 4);
+
+        FixDictAtom atom;
+        atom.id = i;
+        atom.atom_samples.resize(iLength);
+        for(qint32 k = 0; k < iLength; ++k) {
+            double t = k - iLength / 2.0;
+            atom.atom_samples[k] = exp(-PI * t * t / (dScale * dScale)) * cos(dModu * t);
+        }
+        dict.atoms.append(atom);
+    }
+
+    dict.compute_spectra(m_iSampleCount);
+
+    //One atom with a different shift and amplitude in every channel, plus noise of increasing level
+    QList<double> lNoise;
+    lNoise << 0.0 << 0.05 << 0.3 << 1.0;
+
+    for(qint32 n = 0; n < lNoise.size(); ++n) {
+        MatrixXd matResid(m_iSampleCount, 4);
+        for(qint32 c = 0; c < matResid.cols(); ++c) {
+            for(qint32 k = 0; k < m_iSampleCount; ++k) {
+                matResid(k, c) = lNoise[n] * sin(0.37 * k * k + 1.3 * c);
+            }
+
+            const VectorXd& vecSamples = dict.atoms.at(37).atom_samples;
+            for(qint32 k = 0; k < vecSamples.rows(); ++k) {
+                matResid((k + 5 * c) % m_iSampleCount, c) += (c + 1) * vecSamples[k];
+            }
+        }
+
+        qint32 iBestAtom = -1;
+        double dBestProduct = exhaustiveCorrelation(dict, matResid, iBestAtom);
+
+        //The pruned search has to find the same atom as the exhaustive one
+        FixDictMp fixDictMp;
+        FixDictAtom bestMatching = fixDictMp.correlation(dict, matResid, 100);
+
+        QCOMPARE(bestMatching.id, iBestAtom);
+        QVERIFY(std::fabs(bestMatching.max_scalar_product - dBestProduct) < m_dEpsilon);
+
+        //The same holds for blocks of atoms which share their best maximum, as in matching_pursuit
+        FixDictMp::residuum_spectra_data residSpectra = FixDictMp::residuum_spectra(matResid, matResid.cols());
+        QAtomicInteger<qint64> sharedBest;
+        FixDictAtom blocksBestMatching;
+
+        for(qint32 iFirst = 0; iFirst < dict.atoms.size(); iFirst += 16) {
+            FixDictAtom blockBestMatching = FixDictMp::correlation(dict, residSpectra, m_iSampleCount, iFirst, 16, &sharedBest);
+
+            if(iFirst == 0 || std::fabs(blockBestMatching.max_scalar_product) > std::fabs(blocksBestMatching.max_scalar_product)) {
+                blocksBestMatching = blockBestMatching;
+            }
+        }
+
+        QCOMPARE(blocksBestMatching.id, iBestAtom);
+        QCOMPARE(blocksBestMatching.max_scalar_product, bestMatching.max_scalar_product);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMpDict::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool TestMpDict::writeXmlDict(const QString& sPath) const
+{
+    QFile file(sPath);
+    if(!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    //Same layout as written by the dictionary editor of mne_matching_pursuit
+    QXmlStreamWriter xmlWriter(&file);
+    xmlWriter.writeStartDocument();
+    xmlWriter.writeStartElement("COUNT");
+    xmlWriter.writeAttribute("of_atoms", "7");
+
+    QStringList lFormulas;
+    lFormulas << "Gaboratom" << "Chirpatom";
+    QList<qint32> lAtomCounts;
+    lAtomCounts << 4 << 3;
+
+    for(qint32 d = 0; d < lFormulas.size(); ++d) {
+        xmlWriter.writeStartElement("built_Atoms");
+        xmlWriter.writeAttribute("formula", lFormulas[d]);
+        xmlWriter.writeAttribute("sample_count", QString::number(m_iSampleCount));
+        xmlWriter.writeAttribute("atom_count", QString::number(lAtomCounts[d]));
+        xmlWriter.writeAttribute("source_dict", QString("test_%1").arg(lFormulas[d]));
+
+        for(qint32 i = 0; i < lAtomCounts[d]; ++i) {
+            double dScale = 4.0 * (i + 1);
+            double dModu = 2.0 + i;
+            double dPhase = 0.25 * i;
+            double dChirp = 0.01 * (i + 1);
+
+            xmlWriter.writeStartElement("ATOM");
+            xmlWriter.writeAttribute(d == 0 ? "ID" : "id", QString::number(10 * d + i));
+            xmlWriter.writeAttribute("scale", QString::number(dScale));
+            xmlWriter.writeAttribute("modu", QString::number(dModu));
+            xmlWriter.writeAttribute("phase", QString::number(dPhase));
+            if(d == 1) {
+                xmlWriter.writeAttribute("chirp", QString::number(dChirp));
+            }
+
+            //Atoms shorter and longer than the dictionary length
+            qint32 iLength = m_iSampleCount + 16 * (i - 1);
+            QString sSamples;
+            for(qint32 k = 0; k < iLength; ++k) {
+                double t = k - iLength / 2.0;
+                double dSample = exp(-PI * t * t / (dScale * dScale)) * cos(dModu * t / iLength + dPhase + dChirp * t * t);
+                sSamples.append(QString::number(dSample, 'g', 17)).append(":");
+            }
+
+            xmlWriter.writeStartElement("samples");
+            xmlWriter.writeAttribute("samples", sSamples);
+            xmlWriter.writeEndElement();
+
+            xmlWriter.writeEndElement();
+        }
+
+        xmlWriter.writeEndElement();
+    }
+
+    xmlWriter.writeEndElement();
+    xmlWriter.writeEndDocument();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+double TestMpDict::exhaustiveCorrelation(const Dictionary& dict, const MatrixXd& matResid, qint32& iBestAtom) const
+{
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    MatrixXcd matResidSpectra(matResid.rows() / 2 + 1, matResid.cols());
+    VectorXcd vecSpectrum;
+    VectorXd vecSignal;
+
+    for(qint32 c = 0; c < matResid.cols(); ++c) {
+        vecSignal = matResid.col(c);
+        fft.fwd(vecSpectrum, vecSignal);
+        matResidSpectra.col(c) = vecSpectrum;
+    }
+
+    //Every atom and channel in dictionary order, the first of equal maxima wins
+    double dBestProduct = 0.0;
+    VectorXd vecCorrelation;
+
+    for(qint32 i = 0; i < dict.atoms.size(); ++i) {
+        for(qint32 c = 0; c < matResid.cols(); ++c) {
+            vecSpectrum = dict.atom_spectra.col(i).cwiseProduct(matResidSpectra.col(c));
+            fft.inv(vecCorrelation, vecSpectrum, matResid.rows());
+
+            double dProduct = vecCorrelation.maxCoeff();
+            if((i == 0 && c == 0) || std::fabs(dProduct) > std::fabs(dBestProduct)) {
+                dBestProduct = dProduct;
+                iBestAtom = dict.atoms.at(i).id;
+            }
+        }
+    }
+
+    return dBestProduct;
+}
+
+
+//*************************************************************************************************************
+
+bool TestMpDict::patchBinaryDict(const QString& sPath, qint64 iOffset, qint32 iValue) const
+{
+    QFile file(sPath);
+    if(!file.open(QIODevice::ReadWrite) || !file.seek(iOffset)) {
+        return false;
+    }
+
+    return file.write(reinterpret_cast<const char*>(&iValue), sizeof(iValue)) == sizeof(iValue);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestMpDict)
+#include "test_mp_dict.moc"
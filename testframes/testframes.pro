@@ -39,13 +39,16 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     test_codecov \
+    test_detect_trigger \
     test_dipole_fit \
+    test_entropy_engine \
     test_fiff_rwr \
     test_fiff_mne_types_io \
     test_forward_solution \
     test_fiff_cov \
     test_fiff_digitizer \
     test_mne_msh_display_surface_set \
+    test_mp_dict \
 
 !contains(MNECPP_CONFIG, minimalVersion) {
     qtHaveModule(charts) {